@@ -0,0 +1,115 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include <scopi/container.hpp>
+#include <scopi/objects/types/capsule.hpp>
+#include <scopi/objects/types/superellipsoid.hpp>
+#include <scopi/objects/types/worm.hpp>
+#include <scopi/property.hpp>
+#include <scopi/scopi.hpp>
+#include <scopi/solver.hpp>
+
+// Packing of rods in 2D: the same rods are described by capsules, by worms (chains of spheres) or by superellipsoids.
+// Run once per shape, e.g. ./capsule_rods --shape worm --freq 1000000, and compare the times per iteration.
+
+int main(int argc, char** argv)
+{
+    constexpr std::size_t dim = 2;
+    constexpr double pi       = xt::numeric_constants<double>::PI;
+
+    auto& app = scopi::initialize("Packing of rods");
+
+    std::string shape      = "capsule";
+    std::size_t nb_rods    = 400;
+    std::size_t nb_spheres = 5;
+    std::size_t total_it   = 200;
+    double radius          = 0.1;
+    double dt              = 0.005;
+    double squareness      = 0.3;
+    app.add_option("--shape", shape, "Shape of the rods")->capture_default_str()->check(CLI::IsMember({"capsule", "worm", "superellipsoid"}));
+    app.add_option("--nrods", nb_rods, "Number of rods")->capture_default_str();
+    app.add_option("--nspheres", nb_spheres, "Number of spheres of the worms")->capture_default_str();
+    app.add_option("--iterations", total_it, "Number of iterations")->capture_default_str();
+    app.add_option("--squareness", squareness, "Squareness of the superellipsoids")->capture_default_str();
+
+    // the options of the solver are registered by its constructor: the particles are added after the parsing
+    scopi::scopi_container<dim> particles;
+    scopi::ScopiSolver<dim> solver(particles);
+    SCOPI_PARSE(argc, argv);
+
+    auto prop = scopi::property<dim>().mass(1.).moment_inertia(0.1);
+
+    // the axis of the rod goes through the centers of the spheres of the worm
+    double length = 2. * radius * static_cast<double>(nb_spheres - 1);
+    double step   = length + 4. * radius;
+    auto nb_rows  = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(nb_rods))));
+
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> distrib_angle(0., pi);
+
+    for (std::size_t n = 0; n < nb_rods; ++n)
+    {
+        double x      = step * (static_cast<double>(n % nb_rows) - 0.5 * static_cast<double>(nb_rows - 1));
+        double y      = step * (static_cast<double>(n / nb_rows) - 0.5 * static_cast<double>(nb_rows - 1));
+        double angle  = distrib_angle(gen);
+        auto q        = scopi::quaternion(angle);
+        auto rod_prop = prop.desired_velocity({-x, -y});
+
+        if (shape == "capsule")
+        {
+            scopi::capsule<dim> c(
+                {
+                    {x, y}
+            },
+                {q},
+                radius,
+                length);
+            particles.push_back(c, rod_prop);
+        }
+        else if (shape == "superellipsoid")
+        {
+            scopi::superellipsoid<dim> s(
+                {
+                    {x, y}
+            },
+                {q},
+                {{0.5 * length + radius, radius}},
+                squareness);
+            particles.push_back(s, rod_prop);
+        }
+        else
+        {
+            std::vector<scopi::type::position_t<dim>> pos;
+            std::vector<scopi::type::quaternion_t> quat;
+            for (std::size_t k = 0; k < nb_spheres; ++k)
+            {
+                double t = 2. * radius * static_cast<double>(k) - 0.5 * length;
+                pos.push_back({x + t * std::cos(angle), y + t * std::sin(angle)});
+                quat.push_back(q);
+            }
+            scopi::worm<dim> w(pos, quat, radius, nb_spheres);
+            particles.push_back(w, rod_prop);
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    solver.run(dt, total_it);
+    auto end = std::chrono::steady_clock::now();
+
+    double elapsed = std::chrono::duration<double>(end - start).count();
+    std::cout << fmt::format("{:<16} {} rods, {} iterations: {:.3f} s ({:.2f} ms per iteration)",
+                             shape,
+                             nb_rods,
+                             total_it,
+                             elapsed,
+                             1e3 * elapsed / static_cast<double>(total_it))
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <scopi/contact/property.hpp>
+#include <scopi/objects/methods/closest_points.hpp>
+#include <scopi/objects/methods/gjk.hpp>
+#include <scopi/quaternion.hpp>
+
+// Closest points computed by the dedicated methods (Newton for the superellipsoids) against GJK/EPA, pair by pair.
+
+namespace
+{
+    constexpr std::size_t nb_iterations = 10000;
+
+    volatile double sink = 0.;
+
+    template <class F>
+    double time_per_call(F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        double acc = 0.;
+        for (std::size_t k = 0; k < nb_iterations; ++k)
+        {
+            acc += f();
+        }
+        auto end = std::chrono::steady_clock::now();
+        sink     = acc;
+        return std::chrono::duration<double, std::micro>(end - start).count() / nb_iterations;
+    }
+
+    template <class T1, class T2>
+    void compare(const std::string& name, const T1& obj1, const T2& obj2)
+    {
+        using namespace scopi;
+        auto exact = closest_points<NoFriction>(obj1, obj2);
+        auto gjk   = gjk_closest_points<NoFriction>(obj1, obj2);
+
+        double t_exact = time_per_call(
+            [&]()
+            {
+                return closest_points<NoFriction>(obj1, obj2).dij;
+            });
+        double t_gjk = time_per_call(
+            [&]()
+            {
+                return gjk_closest_points<NoFriction>(obj1, obj2).dij;
+            });
+        std::cout << fmt::format("{:<36} closest_points: {:>8.2f} us  gjk: {:>8.2f} us  speedup: {:>6.1f}  |dij - dij_gjk|: {:.2e}",
+                                 name,
+                                 t_exact,
+                                 t_gjk,
+                                 t_exact / t_gjk,
+                                 std::abs(exact.dij - gjk.dij))
+                  << std::endl;
+    }
+}
+
+int main()
+{
+    using namespace scopi;
+    constexpr double pi = xt::numeric_constants<double>::PI;
+
+    superellipsoid<2> e1(
+        {
+            {-0.2, 0.05}
+    },
+        {quaternion(pi / 3)},
+        {{.2, .05}},
+        1);
+    superellipsoid<2> e2(
+        {
+            {0.2, 0.05}
+    },
+        {quaternion(pi / 4)},
+        {{.2, .05}},
+        0.5);
+    compare("superellipsoid/superellipsoid 2D", e1, e2);
+
+    superellipsoid<3> f1(
+        {
+            {-0.2, 0., 0.}
+    },
+        {quaternion(pi / 3)},
+        {{.2, .1, .05}},
+        {{1., 1.}});
+    superellipsoid<3> f2(
+        {
+            {0.2, 0.05, 0.}
+    },
+        {quaternion(pi / 4)},
+        {{.2, .1, .05}},
+        {{0.5, 0.8}});
+    compare("superellipsoid/superellipsoid 3D", f1, f2);
+
+    sphere<3> s(
+        {
+            {0.2, 0.3, 0.}
+    },
+        0.1);
+    compare("sphere/superellipsoid 3D", s, f1);
+
+    plane<3> p(
+        {
+            {0., -0.3, 0.}
+    },
+        pi / 2);
+    compare("superellipsoid/plane 3D", f1, p);
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+#include <fmt/format.h>
+
+#include <xtensor-blas/xlinalg.hpp>
+#include <xtensor/xfixed.hpp>
+
+#include <scopi/contact/property.hpp>
+#include <scopi/objects/methods/closest_points.hpp>
+#include <scopi/objects/types/plane.hpp>
+#include <scopi/objects/types/sphere.hpp>
+#include <scopi/quaternion.hpp>
+#include <scopi/small_math.hpp>
+
+// Micro-benchmarks of the small fixed-size kernels: xtensor (BLAS/LAPACK) against scopi::small.
+
+namespace
+{
+    constexpr std::size_t nb_iterations = 1000000;
+
+    volatile double sink = 0.;
+
+    template <class F>
+    double time_per_call(F&& f)
+    {
+        auto start = std::chrono::steady_clock::now();
+        double acc = 0.;
+        for (std::size_t k = 0; k < nb_iterations; ++k)
+        {
+            acc += f(k);
+        }
+        auto end = std::chrono::steady_clock::now();
+        sink     = acc;
+        return std::chrono::duration<double, std::nano>(end - start).count() / nb_iterations;
+    }
+
+    template <class F1, class F2>
+    void compare(const std::string& name, F1&& f_xtensor, F2&& f_small)
+    {
+        double t_xtensor = time_per_call(f_xtensor);
+        double t_small   = time_per_call(f_small);
+        std::cout << fmt::format("{:<28} xtensor: {:>9.2f} ns  small: {:>9.2f} ns  speedup: {:>6.1f}",
+                                 name,
+                                 t_xtensor,
+                                 t_small,
+                                 t_xtensor / t_small)
+                  << std::endl;
+    }
+}
+
+int main()
+{
+    using namespace scopi;
+
+    xt::xtensor_fixed<double, xt::xshape<3>> x = {1., 2., 3.};
+    xt::xtensor_fixed<double, xt::xshape<3>> y = {-2., 0.5, 1.};
+    auto q                                     = quaternion(0.3);
+
+    compare(
+        "norm (3)",
+        [&](std::size_t k)
+        {
+            x(0) = static_cast<double>(k);
+            return static_cast<double>(xt::linalg::norm(x));
+        },
+        [&](std::size_t k)
+        {
+            x(0) = static_cast<double>(k);
+            return small::norm(small::to_vec<3>(x));
+        });
+
+    compare(
+        "dot (3)",
+        [&](std::size_t k)
+        {
+            x(0) = static_cast<double>(k);
+            return xt::linalg::dot(x, y)[0];
+        },
+        [&](std::size_t k)
+        {
+            x(0) = static_cast<double>(k);
+            return small::dot(small::to_vec<3>(x), small::to_vec<3>(y));
+        });
+
+    compare(
+        "rotation (3)",
+        [&](std::size_t k)
+        {
+            x(0) = static_cast<double>(k);
+            return xt::eval(xt::linalg::dot(rotation_matrix<3>(q), x))(1);
+        },
+        [&](std::size_t k)
+        {
+            x(0) = static_cast<double>(k);
+            return (small::rotation_matrix<3>(small::to_quat(q)) * small::to_vec<3>(x))[1];
+        });
+
+    xt::xtensor_fixed<double, xt::xshape<2, 2>> a2 = {
+        {4., 1.},
+        {2., 3.}
+    };
+    xt::xtensor_fixed<double, xt::xshape<2>> b2 = {1., 2.};
+    compare(
+        "solve (2x2)",
+        [&](std::size_t k)
+        {
+            b2(0) = static_cast<double>(k);
+            return xt::eval(xt::linalg::solve(a2, b2))(0);
+        },
+        [&](std::size_t k)
+        {
+            b2(0) = static_cast<double>(k);
+            return small::solve(small::to_mat<2>(a2), small::to_vec<2>(b2))[0];
+        });
+
+    xt::xtensor_fixed<double, xt::xshape<4, 4>> a4 = {
+        {4., 1., 0., 1.},
+        {2., 5., 1., 0.},
+        {0., 1., 6., 2.},
+        {1., 0., 2., 7.}
+    };
+    xt::xtensor_fixed<double, xt::xshape<4>> b4 = {1., 2., 3., 4.};
+    compare(
+        "solve (4x4)",
+        [&](std::size_t k)
+        {
+            b4(0) = static_cast<double>(k);
+            return xt::eval(xt::linalg::solve(a4, b4))(0);
+        },
+        [&](std::size_t k)
+        {
+            b4(0) = static_cast<double>(k);
+            return small::solve(small::to_mat<4>(a4), small::to_vec<4>(b4))[0];
+        });
+
+    constexpr std::size_t dim = 3;
+    sphere<dim> s1(
+        {
+            {0., 0., 0.}
+    },
+        0.5);
+    sphere<dim> s2(
+        {
+            {1., 0.2, 0.1}
+    },
+        0.4);
+    plane<dim> p(
+        {
+            {0., -1., 0.}
+    },
+        xt::numeric_constants<double>::PI / 2);
+    std::cout << fmt::format("{:<28} {:>9.2f} ns",
+                             "closest_points sphere-sphere",
+                             time_per_call(
+                                 [&](std::size_t)
+                                 {
+                                     return closest_points<NoFriction>(s1, s2).dij;
+                                 }))
+              << std::endl;
+    std::cout << fmt::format("{:<28} {:>9.2f} ns",
+                             "closest_points sphere-plane",
+                             time_per_call(
+                                 [&](std::size_t)
+                                 {
+                                     return closest_points<NoFriction>(s1, p).dij;
+                                 }))
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+
+namespace scopi
+{
+    /**
+     * @brief Number of calls to the global operator new since the start of the program.
+     *
+     * The calls are only counted if SCOPI_COUNT_ALLOCATIONS is defined (CMake option of the same name): the global
+     * operators new and delete of the program are then replaced by those of the library. Otherwise, it returns 0.
+     */
+    std::size_t nb_system_allocations();
+}
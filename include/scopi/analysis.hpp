@@ -0,0 +1,526 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <xtensor/xtensor.hpp>
+
+#include <fmt/format.h>
+
+#include "container.hpp"
+#include "objects/neighbor.hpp"
+
+namespace scopi
+{
+    /**
+     * @brief State of the simulation given to the observables, after the velocities of a time step are computed.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam problem_t Problem solved.
+     */
+    template <std::size_t dim, class problem_t>
+    struct analysis_state
+    {
+        /**
+         * @brief Array of particles, with the velocities of the time step.
+         */
+        const scopi_container<dim>& particles;
+        /**
+         * @brief Contacts of the time step.
+         */
+        const std::vector<neighbor<dim, problem_t>>& contacts;
+        /**
+         * @brief Lagrange multipliers of the contacts: \c dim values per contact.
+         *
+         * The multiplier of a contact is applied to the particle \c i and its opposite to the particle \c j.
+         */
+        const xt::xtensor<double, 1>& lambda;
+        /**
+         * @brief Index of the time iteration.
+         */
+        std::size_t iteration;
+        /**
+         * @brief Time of the iteration.
+         */
+        double time;
+    };
+
+    /**
+     * @brief Quantity computed in situ from the state of the simulation (see analysis_pipeline).
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam problem_t Problem solved.
+     */
+    template <std::size_t dim, class problem_t>
+    class observable
+    {
+      public:
+
+        using state_t = analysis_state<dim, problem_t>;
+
+        virtual ~observable() = default;
+
+        /**
+         * @brief Names of the values of the observable, one column each in the time series.
+         */
+        virtual std::vector<std::string> columns() const = 0;
+
+        /**
+         * @brief Compute the values of the observable.
+         *
+         * @param state [in] State of the simulation.
+         * @param values [out] Array of <tt>columns().size()</tt> values.
+         */
+        virtual void compute(const state_t& state, double* values) const = 0;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Twice the rotation energy \f$J \omega^2\f$ of a particle.
+         */
+        template <std::size_t dim, class moment_t, class rotation_t>
+        double rotation_energy(const moment_t& j, const rotation_t& omega)
+        {
+            if constexpr (dim == 2)
+            {
+                return j * omega * omega;
+            }
+            else
+            {
+                double e = 0.;
+                for (std::size_t d = 0; d < 3; ++d)
+                {
+                    e += j(d) * omega(d) * omega(d);
+                }
+                return e;
+            }
+        }
+
+        /**
+         * @brief Norm of the Lagrange multiplier of the contact \c ic.
+         */
+        inline double contact_force(const xt::xtensor<double, 1>& lambda, std::size_t dim, std::size_t ic)
+        {
+            double norm2 = 0.;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                norm2 += lambda(dim * ic + d) * lambda(dim * ic + d);
+            }
+            return std::sqrt(norm2);
+        }
+    }
+
+    /**
+     * @brief Kinetic energy of the active particles, \f$\frac{1}{2} \sum (m v^2 + J \omega^2)\f$.
+     */
+    template <std::size_t dim, class problem_t>
+    class kinetic_energy : public observable<dim, problem_t>
+    {
+      public:
+
+        using state_t = typename observable<dim, problem_t>::state_t;
+
+        std::vector<std::string> columns() const override
+        {
+            return {"kinetic_energy"};
+        }
+
+        void compute(const state_t& state, double* values) const override
+        {
+            const auto& particles = state.particles;
+            auto m                = particles.m();
+            auto j                = particles.j();
+            auto v                = particles.v();
+            auto omega            = particles.omega();
+
+            double energy = 0.;
+#pragma omp parallel for reduction(+ : energy)
+            for (std::size_t i = particles.nb_inactive(); i < particles.nb_inactive() + particles.nb_active(); ++i)
+            {
+                double v2 = 0.;
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    v2 += v(i)(d) * v(i)(d);
+                }
+                energy += m(i) * v2 + detail::rotation_energy<dim>(j(i), omega(i));
+            }
+            values[0] = 0.5 * energy;
+        }
+    };
+
+    /**
+     * @brief Mean number of contacts with a nonzero force per active particle.
+     *
+     * A contact between two active particles counts for both of them, a contact with an obstacle only for the active
+     * particle.
+     */
+    template <std::size_t dim, class problem_t>
+    class coordination_number : public observable<dim, problem_t>
+    {
+      public:
+
+        using state_t = typename observable<dim, problem_t>::state_t;
+
+        std::vector<std::string> columns() const override
+        {
+            return {"coordination_number"};
+        }
+
+        void compute(const state_t& state, double* values) const override
+        {
+            const auto& contacts  = state.contacts;
+            std::size_t nb_active = state.particles.nb_active();
+            std::size_t offset    = state.particles.nb_inactive();
+
+            std::size_t nb_ends = 0;
+#pragma omp parallel for reduction(+ : nb_ends)
+            for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+            {
+                if (detail::contact_force(state.lambda, dim, ic) > 0.)
+                {
+                    nb_ends += (contacts[ic].i >= offset) + (contacts[ic].j >= offset);
+                }
+            }
+            values[0] = nb_active > 0 ? static_cast<double>(nb_ends) / static_cast<double>(nb_active) : 0.;
+        }
+    };
+
+    /**
+     * @brief Fraction of the domain occupied by the active particles.
+     *
+     * The volume of a particle is its mass divided by the density of the material.
+     */
+    template <std::size_t dim, class problem_t>
+    class packing_fraction : public observable<dim, problem_t>
+    {
+      public:
+
+        using state_t = typename observable<dim, problem_t>::state_t;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param domain_volume [in] Volume (area in 2D) of the domain.
+         * @param density [in] Density of the particles.
+         */
+        packing_fraction(double domain_volume, double density)
+            : m_domain_volume(domain_volume)
+            , m_density(density)
+        {
+        }
+
+        std::vector<std::string> columns() const override
+        {
+            return {"packing_fraction"};
+        }
+
+        void compute(const state_t& state, double* values) const override
+        {
+            const auto& particles = state.particles;
+            auto m                = particles.m();
+
+            double mass = 0.;
+#pragma omp parallel for reduction(+ : mass)
+            for (std::size_t i = particles.nb_inactive(); i < particles.nb_inactive() + particles.nb_active(); ++i)
+            {
+                mass += m(i);
+            }
+            values[0] = mass / (m_density * m_domain_volume);
+        }
+
+      private:
+
+        double m_domain_volume;
+        double m_density;
+    };
+
+    /**
+     * @brief Distribution of the contact forces, given by the norms \f$f\f$ of the Lagrange multipliers.
+     *
+     * The values are the mean and the maximum of the nonzero forces, then the histogram of \f$f / \langle f \rangle\f$:
+     * the fraction of the nonzero forces in each bin of width \c bin_width, the last bin counting all the larger forces.
+     */
+    template <std::size_t dim, class problem_t>
+    class contact_force_distribution : public observable<dim, problem_t>
+    {
+      public:
+
+        using state_t = typename observable<dim, problem_t>::state_t;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param nb_bins [in] Number of bins of the histogram.
+         * @param bin_width [in] Width of a bin, relative to the mean force.
+         */
+        explicit contact_force_distribution(std::size_t nb_bins = 10, double bin_width = 0.5)
+            : m_nb_bins(std::max(nb_bins, std::size_t(1)))
+            , m_bin_width(bin_width)
+        {
+        }
+
+        std::vector<std::string> columns() const override
+        {
+            std::vector<std::string> names = {"force_mean", "force_max"};
+            for (std::size_t b = 0; b < m_nb_bins; ++b)
+            {
+                names.push_back(fmt::format("force_hist_{}", b));
+            }
+            return names;
+        }
+
+        void compute(const state_t& state, double* values) const override
+        {
+            std::size_t nb_contacts = state.contacts.size();
+
+            std::size_t nb_forces = 0;
+            double sum            = 0.;
+            double f_max          = 0.;
+#pragma omp parallel for reduction(+ : nb_forces, sum) reduction(max : f_max)
+            for (std::size_t ic = 0; ic < nb_contacts; ++ic)
+            {
+                double f = detail::contact_force(state.lambda, dim, ic);
+                if (f > 0.)
+                {
+                    ++nb_forces;
+                    sum += f;
+                    f_max = std::max(f_max, f);
+                }
+            }
+
+            double mean = nb_forces > 0 ? sum / static_cast<double>(nb_forces) : 0.;
+            values[0]   = mean;
+            values[1]   = f_max;
+            std::fill(values + 2, values + 2 + m_nb_bins, 0.);
+            if (nb_forces == 0)
+            {
+                return;
+            }
+
+            std::size_t nb_bins = m_nb_bins;
+            std::vector<std::size_t> histogram(nb_bins, 0);
+            std::size_t* counts = histogram.data();
+#pragma omp parallel for reduction(+ : counts[:nb_bins])
+            for (std::size_t ic = 0; ic < nb_contacts; ++ic)
+            {
+                double f = detail::contact_force(state.lambda, dim, ic);
+                if (f > 0.)
+                {
+                    ++counts[std::min(static_cast<std::size_t>(f / (mean * m_bin_width)), nb_bins - 1)];
+                }
+            }
+            for (std::size_t b = 0; b < nb_bins; ++b)
+            {
+                values[2 + b] = static_cast<double>(histogram[b]) / static_cast<double>(nb_forces);
+            }
+        }
+
+      private:
+
+        std::size_t m_nb_bins;
+        double m_bin_width;
+    };
+
+    /**
+     * @brief Stress tensor of the contact forces, \f$\sigma = \frac{1}{V} \sum_c \sum_{p \in c} f_{c,p} \otimes r_{c,p}\f$.
+     *
+     * \f$f_{c,p}\f$ is the Lagrange multiplier of the contact applied to the active particle \f$p\f$ and \f$r_{c,p}\f$
+     * goes from the center of \f$p\f$ to its contact point, as in the optimization problem. The values are the
+     * components \f$\sigma_{ab}\f$, row by row.
+     */
+    template <std::size_t dim, class problem_t>
+    class stress_tensor : public observable<dim, problem_t>
+    {
+      public:
+
+        using state_t = typename observable<dim, problem_t>::state_t;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param domain_volume [in] Volume (area in 2D) of the domain.
+         */
+        explicit stress_tensor(double domain_volume)
+            : m_domain_volume(domain_volume)
+        {
+        }
+
+        std::vector<std::string> columns() const override
+        {
+            std::vector<std::string> names;
+            for (std::size_t a = 0; a < dim; ++a)
+            {
+                for (std::size_t b = 0; b < dim; ++b)
+                {
+                    names.push_back(fmt::format("stress_{}{}", a, b));
+                }
+            }
+            return names;
+        }
+
+        void compute(const state_t& state, double* values) const override
+        {
+            const auto& contacts = state.contacts;
+            const auto& lambda   = state.lambda;
+            auto pos             = state.particles.pos();
+            std::size_t offset   = state.particles.nb_inactive();
+
+            double sigma[dim * dim] = {};
+#pragma omp parallel for reduction(+ : sigma[:dim * dim])
+            for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+            {
+                const auto& c = contacts[ic];
+                for (std::size_t a = 0; a < dim; ++a)
+                {
+                    for (std::size_t b = 0; b < dim; ++b)
+                    {
+                        double fr = 0.;
+                        if (c.i >= offset)
+                        {
+                            fr += lambda(dim * ic + a) * (c.pi(b) - pos(c.i)(b));
+                        }
+                        if (c.j >= offset)
+                        {
+                            fr -= lambda(dim * ic + a) * (c.pj(b) - pos(c.j)(b));
+                        }
+                        sigma[a * dim + b] += fr;
+                    }
+                }
+            }
+            for (std::size_t k = 0; k < dim * dim; ++k)
+            {
+                values[k] = sigma[k] / m_domain_volume;
+            }
+        }
+
+      private:
+
+        double m_domain_volume;
+    };
+
+    /**
+     * @brief Observables computed in situ during the simulation, written as a compact time series.
+     *
+     * Each call to write_row appends one line <tt>iteration,time,values...</tt> to a csv file whose header, written by
+     * write_header, gives the names of the columns. The observables are computed in the order in which they are added.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam problem_t Problem solved.
+     */
+    template <std::size_t dim, class problem_t>
+    class analysis_pipeline
+    {
+      public:
+
+        using observable_t = observable<dim, problem_t>;
+        using state_t      = analysis_state<dim, problem_t>;
+
+        /**
+         * @brief Register an observable.
+         */
+        void add(std::unique_ptr<observable_t> obs)
+        {
+            if (!obs)
+            {
+                throw std::runtime_error("Cannot add a null observable to the analysis");
+            }
+            m_sizes.push_back(obs->columns().size());
+            m_nb_values += m_sizes.back();
+            m_observables.push_back(std::move(obs));
+        }
+
+        /**
+         * @brief Construct and register an observable.
+         *
+         * @return Reference to the observable.
+         */
+        template <class observable_type, class... Args>
+        observable_type& emplace(Args&&... args)
+        {
+            auto obs  = std::make_unique<observable_type>(std::forward<Args>(args)...);
+            auto& ref = *obs;
+            add(std::move(obs));
+            return ref;
+        }
+
+        /**
+         * @brief Whether no observable is registered.
+         */
+        bool empty() const
+        {
+            return m_observables.empty();
+        }
+
+        /**
+         * @brief Names of the columns of the time series.
+         */
+        std::vector<std::string> columns() const
+        {
+            std::vector<std::string> names = {"iteration", "time"};
+            for (const auto& obs : m_observables)
+            {
+                auto obs_names = obs->columns();
+                names.insert(names.end(), obs_names.begin(), obs_names.end());
+            }
+            return names;
+        }
+
+        /**
+         * @brief Compute the values of all the observables, without the iteration and the time.
+         */
+        std::vector<double> compute(const state_t& state) const
+        {
+            std::vector<double> values(m_nb_values);
+            double* first = values.data();
+            for (std::size_t k = 0; k < m_observables.size(); ++k)
+            {
+                m_observables[k]->compute(state, first);
+                first += m_sizes[k];
+            }
+            return values;
+        }
+
+        /**
+         * @brief Write the names of the columns.
+         */
+        void write_header(std::ostream& out) const
+        {
+            auto names = columns();
+            for (std::size_t k = 0; k < names.size(); ++k)
+            {
+                out << (k > 0 ? "," : "") << names[k];
+            }
+            out << "\n";
+        }
+
+        /**
+         * @brief Compute the observables and write them in a line.
+         */
+        void write_row(std::ostream& out, const state_t& state) const
+        {
+            auto values = compute(state);
+            out << fmt::format("{},{}", state.iteration, state.time);
+            for (double value : values)
+            {
+                out << fmt::format(",{}", value);
+            }
+            out << std::endl;
+        }
+
+      private:
+
+        std::vector<std::unique_ptr<observable_t>> m_observables;
+        /**
+         * @brief Number of values of each observable.
+         */
+        std::vector<std::size_t> m_sizes;
+        std::size_t m_nb_values = 0;
+    };
+}
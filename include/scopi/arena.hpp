@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace scopi
+{
+    /**
+     * @brief Monotonic memory resource for the temporaries of a time step.
+     *
+     * The allocations are bumped in a block of memory and the deallocations do nothing: all the memory is
+     * released at once by reset, at the beginning of each time step.
+     * When a step needs more than one block, the blocks are merged into a single block of the total size by
+     * the next reset, so that the following steps of the same size do not call the system allocator.
+     *
+     * The containers use it through \c std::pmr::polymorphic_allocator.
+     */
+    class step_arena : public std::pmr::memory_resource
+    {
+      public:
+
+        static constexpr std::size_t block_alignment = 64;
+
+        explicit step_arena(std::size_t initial_size = std::size_t(1) << 20)
+        {
+            add_block(initial_size);
+        }
+
+        step_arena(const step_arena&)            = delete;
+        step_arena& operator=(const step_arena&) = delete;
+
+        ~step_arena() override
+        {
+            release();
+        }
+
+        /**
+         * @brief Release all the allocations of the step.
+         */
+        void reset()
+        {
+            if (m_blocks.size() > 1)
+            {
+                std::size_t total = 0;
+                for (auto& b : m_blocks)
+                {
+                    total += b.size;
+                }
+                release();
+                add_block(total);
+            }
+            m_offset = 0;
+            m_used   = 0;
+        }
+
+        /**
+         * @brief Number of bytes allocated since the last reset.
+         */
+        std::size_t used() const
+        {
+            return m_used;
+        }
+
+        /**
+         * @brief Largest number of bytes allocated during a step.
+         */
+        std::size_t peak() const
+        {
+            return m_peak;
+        }
+
+        /**
+         * @brief Number of bytes reserved from the system.
+         */
+        std::size_t capacity() const
+        {
+            std::size_t total = 0;
+            for (auto& b : m_blocks)
+            {
+                total += b.size;
+            }
+            return total;
+        }
+
+        /**
+         * @brief Number of blocks requested from the system since the construction.
+         */
+        std::size_t nb_system_allocations() const
+        {
+            return m_nb_system_allocations;
+        }
+
+      private:
+
+        struct block
+        {
+            std::byte* data;
+            std::size_t size;
+        };
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            assert(alignment <= block_alignment);
+            std::size_t start = (m_offset + alignment - 1) / alignment * alignment;
+            if (start + bytes > m_blocks.back().size)
+            {
+                add_block(std::max(2 * m_blocks.back().size, bytes + alignment));
+                start = 0;
+            }
+            m_offset = start + bytes;
+            m_used += bytes;
+            m_peak = std::max(m_peak, m_used);
+            return m_blocks.back().data + start;
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override
+        {
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+        void add_block(std::size_t size)
+        {
+            m_blocks.push_back({static_cast<std::byte*>(::operator new(size, std::align_val_t(block_alignment))), size});
+            m_offset = 0;
+            ++m_nb_system_allocations;
+        }
+
+        void release()
+        {
+            for (auto& b : m_blocks)
+            {
+                ::operator delete(b.data, std::align_val_t(block_alignment));
+            }
+            m_blocks.clear();
+        }
+
+        std::vector<block> m_blocks;
+        std::size_t m_offset                = 0;
+        std::size_t m_used                  = 0;
+        std::size_t m_peak                  = 0;
+        std::size_t m_nb_system_allocations = 0;
+    };
+}
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace scopi
+{
+    /**
+     * @brief Background writer of the output files.
+     *
+     * The writer owns a pool of frames. At output time, the solver takes a free frame with acquire, copies the state
+     * to write into it and hands it to the background thread with submit. The thread serializes and writes the frame
+     * while the next time steps proceed, then gives it back to the pool. The frames are reused, so that staging a frame
+     * mostly copies memory into buffers which are already allocated.
+     *
+     * The queue is bounded by the number of frames: if the thread is late, acquire waits until a frame has been
+     * written. With two frames, one is written while the other is filled.
+     *
+     * An exception thrown by the write function is rethrown by the next call to acquire or flush.
+     *
+     * @tparam Frame Type of the state to write.
+     */
+    template <class Frame>
+    class async_writer
+    {
+      public:
+
+        using write_function = std::function<void(const Frame&)>;
+
+        /**
+         * @brief Constructor, starts the background thread.
+         *
+         * @param write [in] Function which writes a frame, called by the background thread.
+         * @param nb_frames [in] Number of frames of the pool.
+         */
+        explicit async_writer(write_function write, std::size_t nb_frames = 2)
+            : m_write(std::move(write))
+            , m_frames(std::max(nb_frames, std::size_t(1)))
+        {
+            for (std::size_t k = 0; k < m_frames.size(); ++k)
+            {
+                m_free.push_back(k);
+            }
+            m_thread = std::thread(&async_writer::loop, this);
+        }
+
+        async_writer(const async_writer&)            = delete;
+        async_writer& operator=(const async_writer&) = delete;
+
+        /**
+         * @brief Write the submitted frames and stop the background thread.
+         */
+        ~async_writer()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+            }
+            m_cv.notify_all();
+            m_thread.join();
+        }
+
+        /**
+         * @brief Free frame to fill, waits while all the frames are queued.
+         *
+         * Each call must be followed by a call to submit.
+         */
+        Frame& acquire()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock,
+                      [this]()
+                      {
+                          return !m_free.empty() || m_error;
+                      });
+            rethrow_error();
+            m_current = m_free.front();
+            m_free.pop_front();
+            return m_frames[m_current];
+        }
+
+        /**
+         * @brief Queue the frame returned by the last call to acquire.
+         */
+        void submit()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_pending.push_back(m_current);
+            }
+            m_cv.notify_all();
+        }
+
+        /**
+         * @brief Wait until all the submitted frames are written.
+         */
+        void flush()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv.wait(lock,
+                      [this]()
+                      {
+                          return m_free.size() == m_frames.size();
+                      });
+            rethrow_error();
+        }
+
+      private:
+
+        void loop()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true)
+            {
+                m_cv.wait(lock,
+                          [this]()
+                          {
+                              return m_stop || !m_pending.empty();
+                          });
+                if (m_pending.empty())
+                {
+                    return;
+                }
+                std::size_t k = m_pending.front();
+                m_pending.pop_front();
+
+                lock.unlock();
+                std::exception_ptr error;
+                try
+                {
+                    m_write(m_frames[k]);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                lock.lock();
+
+                if (error && !m_error)
+                {
+                    m_error = error;
+                }
+                m_free.push_back(k);
+                m_cv.notify_all();
+            }
+        }
+
+        void rethrow_error()
+        {
+            if (m_error)
+            {
+                auto error = m_error;
+                m_error    = nullptr;
+                std::rethrow_exception(error);
+            }
+        }
+
+        write_function m_write;
+        std::vector<Frame> m_frames;
+        /**
+         * @brief Indices of the frames which can be filled.
+         */
+        std::deque<std::size_t> m_free;
+        /**
+         * @brief Indices of the frames to write, in the order of submission.
+         */
+        std::deque<std::size_t> m_pending;
+        std::size_t m_current = 0;
+        bool m_stop           = false;
+        std::exception_ptr m_error;
+        std::mutex m_mutex;
+        std::condition_variable m_cv;
+        std::thread m_thread;
+    };
+}
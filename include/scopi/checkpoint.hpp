@@ -0,0 +1,382 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include "container.hpp"
+#include "objects/methods/write_objects.hpp"
+#include "objects/neighbor.hpp"
+#include "restart.hpp"
+#include "sleep.hpp"
+#include "small_math.hpp"
+#include "snapshot.hpp"
+
+namespace nl = nlohmann;
+
+namespace scopi
+{
+    namespace detail
+    {
+        template <class Element>
+        constexpr std::size_t checkpoint_components()
+        {
+            return std::is_arithmetic_v<Element> ? 1 : small::fixed_size_v<Element>;
+        }
+
+        template <class Element>
+        auto& checkpoint_component(Element& e, [[maybe_unused]] std::size_t c)
+        {
+            if constexpr (std::is_arithmetic_v<std::remove_const_t<Element>>)
+            {
+                return e;
+            }
+            else
+            {
+                return e(c);
+            }
+        }
+
+        /**
+         * @brief Column of an array of the container, whose elements are scalars or fixed size vectors.
+         */
+        template <class Element>
+        snapshot_column checkpoint_column(const std::string& name, const Element* data, std::size_t count)
+        {
+            return make_snapshot_column<double>(name,
+                                                count,
+                                                checkpoint_components<Element>(),
+                                                [data](std::size_t i, std::size_t c)
+                                                {
+                                                    return checkpoint_component(data[i], c);
+                                                });
+        }
+
+        /**
+         * @brief Description of each shape of the container, from the first object which uses it (see write_objects).
+         *
+         * The grid of an sdf is added (see write_sdf_grid): unlike the other shapes, it is not given by the
+         * description of the object.
+         */
+        template <std::size_t dim>
+        std::string checkpoint_shape_objects(const scopi_container<dim>& particles)
+        {
+            nl::json shapes = nl::json::object();
+            for (std::size_t io = 0; io < particles.size(); ++io)
+            {
+                auto key = std::to_string(particles.shape_id(io));
+                if (!shapes.contains(key))
+                {
+                    auto object = particles[io];
+                    shapes[key] = write_objects_dispatcher<dim>::dispatch(*object, particles.offset(io));
+                    if (auto f = dynamic_cast<const sdf<dim, false>*>(object.get()))
+                    {
+                        shapes[key]["grid"] = write_sdf_grid(f->grid());
+                    }
+                }
+            }
+            return shapes.dump();
+        }
+
+        template <class T>
+        snapshot_array<T>
+        checkpoint_field(const snapshot_reader& reader, const std::string& name, std::size_t count, std::size_t components)
+        {
+            auto f = reader.field<T>(name);
+            if (f.count != count || f.components != components)
+            {
+                throw std::runtime_error(
+                    fmt::format("read_checkpoint: the field {} has {} rows of {} elements instead of {} rows of {}",
+                                name,
+                                f.count,
+                                f.components,
+                                count,
+                                components));
+            }
+            return f;
+        }
+
+        /**
+         * @brief Read the field \c name into an array of the container.
+         */
+        template <class Element>
+        void read_checkpoint_column(const snapshot_reader& reader, const std::string& name, Element* data, std::size_t count)
+        {
+            auto f = checkpoint_field<double>(reader, name, count, checkpoint_components<Element>());
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                for (std::size_t c = 0; c < f.components; ++c)
+                {
+                    checkpoint_component(data[i], c) = f(i, c);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Write a checkpoint, from which a simulation restarts exactly (see read_checkpoint).
+     *
+     * A checkpoint is a snapshot (see write_snapshot) with the other fields of the container, the description of the
+     * shapes needed to rebuild them, the history of the contacts (\c pi, \c pj, \c sij and the properties, such as the
+     * viscous \c gamma), the sleeping state of the particles and the state kept by the optimization method from one
+     * time step to the next (see OptimGradient::solver_state).
+     * The values are written in binary, so that they are restored bit for bit.
+     *
+     * @param filename [in] Name of the file.
+     * @param particles [in] Array of particles, without periodic particles.
+     * @param contacts [in] Contacts of the last time step, from which the properties of the next contacts are transferred.
+     * @param lambda [in] Lagrange multipliers of the contacts, \c dim per contact, or an empty array.
+     * @param iteration [in] Index of the next time iteration.
+     * @param sleep [in] Sleeping state of the particles, or \c nullptr if the particles do not sleep.
+     * @param solver_state [in] State of the optimization method, or \c nullptr if it keeps none.
+     */
+    template <std::size_t dim, class problem_t>
+    void write_checkpoint(const std::string& filename,
+                          const scopi_container<dim>& particles,
+                          const std::vector<neighbor<dim, problem_t>>& contacts,
+                          const xt::xtensor<double, 1>& lambda,
+                          std::size_t iteration,
+                          const sleep_manager<dim>* sleep = nullptr,
+                          const std::vector<char>* solver_state = nullptr)
+    {
+        using detail::checkpoint_column;
+        using detail::make_snapshot_column;
+        using property_t = contact_property<problem_t>;
+        static_assert(std::is_trivially_copyable_v<property_t>);
+
+        std::size_t nb_particles = particles.pos().size();
+        std::size_t nb_contacts  = contacts.size();
+
+        auto columns = detail::snapshot_columns(particles, contacts, lambda);
+        columns.push_back(checkpoint_column("desired_velocity", particles.vd().data(), nb_particles));
+        columns.push_back(checkpoint_column("desired_omega", particles.desired_omega().data(), nb_particles));
+        columns.push_back(checkpoint_column("force", particles.f().data(), nb_particles));
+        columns.push_back(checkpoint_column("mass", particles.m().data(), nb_particles));
+        columns.push_back(checkpoint_column("moment_inertia", particles.j().data(), nb_particles));
+        columns.push_back(make_snapshot_column<std::uint64_t>("nb_inactive",
+                                                              1,
+                                                              1,
+                                                              [&particles](std::size_t, std::size_t)
+                                                              {
+                                                                  return particles.nb_inactive();
+                                                              }));
+        auto shapes = std::make_shared<const std::string>(detail::checkpoint_shape_objects(particles));
+        columns.push_back(make_snapshot_column<char>("shape_objects",
+                                                     shapes->size(),
+                                                     1,
+                                                     [shapes](std::size_t i, std::size_t)
+                                                     {
+                                                         return (*shapes)[i];
+                                                     }));
+
+        columns.push_back(make_snapshot_column<double>("contact_pi",
+                                                       nb_contacts,
+                                                       dim,
+                                                       [&contacts](std::size_t ic, std::size_t c)
+                                                       {
+                                                           return contacts[ic].pi(c);
+                                                       }));
+        columns.push_back(make_snapshot_column<double>("contact_pj",
+                                                       nb_contacts,
+                                                       dim,
+                                                       [&contacts](std::size_t ic, std::size_t c)
+                                                       {
+                                                           return contacts[ic].pj(c);
+                                                       }));
+        columns.push_back(make_snapshot_column<double>("contact_sij",
+                                                       nb_contacts,
+                                                       1,
+                                                       [&contacts](std::size_t ic, std::size_t)
+                                                       {
+                                                           return contacts[ic].sij;
+                                                       }));
+        columns.push_back(make_snapshot_column<char>("contact_property",
+                                                     nb_contacts,
+                                                     sizeof(property_t),
+                                                     [&contacts](std::size_t ic, std::size_t c)
+                                                     {
+                                                         return reinterpret_cast<const char*>(&contacts[ic].property)[c];
+                                                     }));
+
+        std::size_t nb_sleep = sleep ? sleep->sleeping().size() : 0;
+        columns.push_back(make_snapshot_column<char>("sleeping",
+                                                     nb_sleep,
+                                                     1,
+                                                     [sleep](std::size_t i, std::size_t)
+                                                     {
+                                                         return static_cast<char>(sleep->sleeping()[i]);
+                                                     }));
+        columns.push_back(make_snapshot_column<std::uint64_t>("rest_steps",
+                                                              nb_sleep,
+                                                              1,
+                                                              [sleep](std::size_t i, std::size_t)
+                                                              {
+                                                                  return sleep->rest_steps()[i];
+                                                              }));
+        if (nb_sleep > 0)
+        {
+            columns.push_back(checkpoint_column("sleep_force", sleep->sleep_forces().data(), nb_sleep));
+        }
+
+        columns.push_back(make_snapshot_column<char>("solver_state",
+                                                     solver_state ? solver_state->size() : 0,
+                                                     1,
+                                                     [solver_state](std::size_t i, std::size_t)
+                                                     {
+                                                         return (*solver_state)[i];
+                                                     }));
+
+        snapshot_header header{};
+        header.dim          = dim;
+        header.iteration    = iteration;
+        header.nb_particles = nb_particles;
+        header.nb_objects   = particles.size();
+        header.nb_contacts  = nb_contacts;
+        detail::write_snapshot_file(filename, header, columns);
+    }
+
+    /**
+     * @brief Restore the state saved by write_checkpoint.
+     *
+     * The file is mapped in memory (see snapshot_reader) and the arrays are copied in place: only the shapes are
+     * parsed, once per shape, and the objects are appended by their shape id.
+     *
+     * @param filename [in] Name of the file.
+     * @param particles [out] Array of particles, replaced by the one of the checkpoint.
+     * @param contacts [out] Contacts of the last time step.
+     * @param lambda [out] Lagrange multipliers of the contacts.
+     * @param sleep [out] Sleeping state of the particles, not restored if \c nullptr.
+     * @param solver_state [out] State of the optimization method, not restored if \c nullptr.
+     *
+     * @return Index of the next time iteration.
+     */
+    template <std::size_t dim, class problem_t>
+    std::size_t read_checkpoint(const std::string& filename,
+                                scopi_container<dim>& particles,
+                                std::vector<neighbor<dim, problem_t>>& contacts,
+                                xt::xtensor<double, 1>& lambda,
+                                sleep_manager<dim>* sleep = nullptr,
+                                std::vector<char>* solver_state = nullptr)
+    {
+        using detail::checkpoint_field;
+        using detail::read_checkpoint_column;
+        using property_t = contact_property<problem_t>;
+
+        snapshot_reader reader(filename);
+        const auto& header = reader.header();
+        if (header.dim != dim)
+        {
+            throw std::runtime_error(fmt::format("read_checkpoint: {} is a checkpoint in dimension {}", filename, header.dim));
+        }
+        if (!reader.has_field("shape_objects"))
+        {
+            throw std::runtime_error(fmt::format("read_checkpoint: {} is a snapshot, not a checkpoint", filename));
+        }
+
+        std::size_t nb_particles = header.nb_particles;
+        std::size_t nb_objects   = header.nb_objects;
+        std::size_t nb_contacts  = header.nb_contacts;
+
+        // one object of each shape registers the shape
+        particles = scopi_container<dim>();
+        auto text          = reader.field<char>("shape_objects");
+        auto shape_objects = nl::json::parse(text.data, text.data + text.count);
+        std::map<std::uint64_t, std::size_t> shape_ids;
+        for (auto& [key, o] : shape_objects.items())
+        {
+            bool known = make_object_from_json<dim>(o,
+                                                    [&](const auto& s)
+                                                    {
+                                                        shape_ids[std::stoull(key)] = particles.add_shape(s);
+                                                    });
+            if (!known)
+            {
+                throw std::runtime_error(
+                    fmt::format("read_checkpoint: cannot rebuild an object of type {}", o["type"].get<std::string>()));
+            }
+        }
+
+        auto offset      = checkpoint_field<std::uint64_t>(reader, "object_offset", nb_objects + 1, 1);
+        auto shape_id    = checkpoint_field<std::uint64_t>(reader, "shape_id", nb_objects, 1);
+        auto nb_inactive = checkpoint_field<std::uint64_t>(reader, "nb_inactive", 1, 1)(0);
+        particles.reserve(nb_particles);
+        for (std::size_t io = 0; io < nb_objects; ++io)
+        {
+            auto p = property<dim>();
+            if (offset(io) < nb_inactive)
+            {
+                p.deactivate();
+            }
+            particles.push_back_shape(shape_ids.at(shape_id(io)), offset(io + 1) - offset(io), p);
+        }
+
+        read_checkpoint_column(reader, "position", particles.pos().data(), nb_particles);
+        read_checkpoint_column(reader, "quaternion", particles.q().data(), nb_particles);
+        read_checkpoint_column(reader, "velocity", particles.v().data(), nb_particles);
+        read_checkpoint_column(reader, "omega", particles.omega().data(), nb_particles);
+        read_checkpoint_column(reader, "desired_velocity", particles.vd().data(), nb_particles);
+        read_checkpoint_column(reader, "desired_omega", particles.desired_omega().data(), nb_particles);
+        read_checkpoint_column(reader, "force", particles.f().data(), nb_particles);
+        read_checkpoint_column(reader, "mass", particles.m().data(), nb_particles);
+        read_checkpoint_column(reader, "moment_inertia", particles.j().data(), nb_particles);
+
+        auto ci       = checkpoint_field<std::uint64_t>(reader, "contact_i", nb_contacts, 1);
+        auto cj       = checkpoint_field<std::uint64_t>(reader, "contact_j", nb_contacts, 1);
+        auto nij      = checkpoint_field<double>(reader, "contact_normal", nb_contacts, dim);
+        auto dij      = checkpoint_field<double>(reader, "contact_distance", nb_contacts, 1);
+        auto pi       = checkpoint_field<double>(reader, "contact_pi", nb_contacts, dim);
+        auto pj       = checkpoint_field<double>(reader, "contact_pj", nb_contacts, dim);
+        auto sij      = checkpoint_field<double>(reader, "contact_sij", nb_contacts, 1);
+        auto property = checkpoint_field<char>(reader, "contact_property", nb_contacts, sizeof(property_t));
+        contacts.resize(nb_contacts);
+        for (std::size_t ic = 0; ic < nb_contacts; ++ic)
+        {
+            auto& c = contacts[ic];
+            c.i     = ci(ic);
+            c.j     = cj(ic);
+            c.dij   = dij(ic);
+            c.sij   = sij(ic);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                c.nij(d) = nij(ic, d);
+                c.pi(d)  = pi(ic, d);
+                c.pj(d)  = pj(ic, d);
+            }
+            std::memcpy(&c.property, &property(ic), sizeof(property_t));
+        }
+
+        auto contact_lambda = reader.field<double>("contact_lambda");
+        lambda.resize({contact_lambda.count * contact_lambda.components});
+        std::copy(contact_lambda.data, contact_lambda.data + lambda.size(), lambda.begin());
+
+        auto sleeping = reader.field<char>("sleeping");
+        if (sleep != nullptr && sleeping.count > 0)
+        {
+            auto rest_steps = checkpoint_field<std::uint64_t>(reader, "rest_steps", sleeping.count, 1);
+            std::vector<typename sleep_manager<dim>::force_type> forces(sleeping.count);
+            read_checkpoint_column(reader, "sleep_force", forces.data(), sleeping.count);
+            sleep->restore(std::vector<bool>(sleeping.data, sleeping.data + sleeping.count),
+                           std::vector<std::size_t>(rest_steps.data, rest_steps.data + rest_steps.count),
+                           std::move(forces));
+        }
+
+        if (solver_state != nullptr && reader.has_field("solver_state"))
+        {
+            auto state = reader.field<char>("solver_state");
+            solver_state->assign(state.data, state.data + state.count);
+        }
+
+        return header.iteration;
+    }
+}
@@ -2,12 +2,16 @@
 
 #include "../box.hpp"
 #include "../container.hpp"
+#include "../objects/methods/bounding_volume.hpp"
 #include "../objects/methods/closest_points.hpp"
+#include "../objects/methods/members.hpp"
+#include "../objects/methods/mesh_contacts.hpp"
 #include "../objects/methods/select.hpp"
 #include "../objects/methods/write_objects.hpp"
 #include "../objects/neighbor.hpp"
 #include "../params.hpp"
 #include <CLI/CLI.hpp>
+#include <algorithm>
 #include <cstddef>
 
 namespace scopi
@@ -35,6 +39,7 @@ namespace scopi
         void init_options()
         {
             m_params.init_options();
+            this->derived_cast().default_contact_property().init_options();
         }
 
         /**
@@ -61,6 +66,20 @@ namespace scopi
         template <std::size_t dim>
         auto run(scopi_container<dim>& particles, std::size_t active_ptr);
 
+        /**
+         * @brief Compute contacts between particles in an existing array.
+         *
+         * The array is cleared first: its memory is reused when it is passed at each time step.
+         *
+         * @tparam dim Dimension (2 or 3).
+         * @tparam Contacts Type of the array of neighbors.
+         * @param particles [in] Array of particles.
+         * @param active_ptr [in] Index of the first active particle.
+         * @param contacts [out] Array of neighbors.
+         */
+        template <std::size_t dim, class Contacts>
+        void run(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr, Contacts& contacts);
+
         params_t& get_params();
 
       private:
@@ -72,14 +91,23 @@ namespace scopi
     template <std::size_t dim>
     auto contact_base<D>::run(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr)
     {
-        return this->derived_cast().run_impl(box, particles, active_ptr);
+        typename D::template contact_container_t<dim> contacts;
+        this->derived_cast().run_impl(box, particles, active_ptr, contacts);
+        return contacts;
     }
 
     template <class D>
     template <std::size_t dim>
     auto contact_base<D>::run(scopi_container<dim>& particles, std::size_t active_ptr)
     {
-        return this->derived_cast().run_impl(BoxDomain<dim>(), particles, active_ptr);
+        return run(BoxDomain<dim>(), particles, active_ptr);
+    }
+
+    template <class D>
+    template <std::size_t dim, class Contacts>
+    void contact_base<D>::run(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr, Contacts& contacts)
+    {
+        this->derived_cast().run_impl(box, particles, active_ptr, contacts);
     }
 
     template <class D>
@@ -89,31 +117,27 @@ namespace scopi
     }
 
     /**
-     * @brief Compute the exact distance between two particles.
+     * @brief Add the neighbor between two particles if they are close enough.
      *
      * @tparam dim Dimension (2 or 3).
      * @param particles [in] Array of particles.
-     * @param contacts [inout] Array of neighbors, if the distance between the two particles is small enough, add a neighbor in this array.
+     * @param contacts [inout] Array of neighbors.
+     * @param neigh [in] Closest points between the particles \c i and \c j.
      * @param dmax [in] Maximum distance to consider two particles to be neighbors.
      * @param i [in] Index of the first particle.
      * @param j [in] Index of the second particle.
      * @param default_contact_property [in] Default contact property.
      */
     template <class problem_t, std::size_t dim>
-    void compute_exact_distance(const BoxDomain<dim>& box,
-                                scopi_container<dim>& particles,
-                                std::vector<neighbor<dim, problem_t>>& contacts,
-                                double dmax,
-                                std::size_t i,
-                                std::size_t j,
-                                contact_property<problem_t>& default_contact_property)
+    void add_neighbor(const BoxDomain<dim>& box,
+                      const scopi_container<dim>& particles,
+                      std::vector<neighbor<dim, problem_t>>& contacts,
+                      neighbor<dim, problem_t>&& neigh,
+                      double dmax,
+                      std::size_t i,
+                      std::size_t j,
+                      const contact_property<problem_t>& default_contact_property)
     {
-        std::size_t o1 = particles.object_index(i);
-        std::size_t o2 = particles.object_index(j);
-        auto neigh     = closest_points_dispatcher<problem_t, dim>::dispatch(
-            *select_object_dispatcher<dim>::dispatch(*particles[o1], index(i - particles.offset(o1))),
-            *select_object_dispatcher<dim>::dispatch(*particles[o2], index(j - particles.offset(o2))));
-
         if (neigh.dij < dmax && (i < particles.periodic_ptr() || j < particles.periodic_ptr()))
         {
             neigh.i        = (i < particles.periodic_ptr()) ? i : particles.periodic_index(i - particles.periodic_ptr());
@@ -139,6 +163,132 @@ namespace scopi
         }
     }
 
+    /**
+     * @brief Closest points between two objects.
+     *
+     * There is one neighbor for each close primitive if one of the objects is a mesh (see mesh_closest_points),
+     * one neighbor otherwise.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param obj1 [in] Object \c i.
+     * @param kind1 [in] Kind of \c obj1 (see object_kind_dispatcher).
+     * @param obj2 [in] Object \c j.
+     * @param kind2 [in] Kind of \c obj2.
+     * @param dmax [in] Maximum distance of the contacts with a mesh.
+     * @param add [in] Function called with each neighbor between \c i and \c j.
+     */
+    template <class problem_t, std::size_t dim, class Add>
+    void add_closest_points(const object<dim, false>& obj1,
+                            object_kind kind1,
+                            const object<dim, false>& obj2,
+                            object_kind kind2,
+                            double dmax,
+                            Add&& add)
+    {
+        if (kind2 == object_kind::mesh)
+        {
+            const auto& m2 = static_cast<const mesh<dim, false>&>(obj2);
+            for (auto& neigh : mesh_closest_points_dispatcher<problem_t, dim>::dispatch(obj1, m2, dmax))
+            {
+                add(std::move(neigh));
+            }
+        }
+        else if (kind1 == object_kind::mesh)
+        {
+            const auto& m1 = static_cast<const mesh<dim, false>&>(obj1);
+            for (auto& neigh : mesh_closest_points_dispatcher<problem_t, dim>::dispatch(obj2, m1, dmax))
+            {
+                neigh.nij *= -1.;
+                std::swap(neigh.pi, neigh.pj);
+                add(std::move(neigh));
+            }
+        }
+        else
+        {
+            add(closest_points_dispatcher<problem_t, dim>::dispatch(obj1, obj2));
+        }
+    }
+
+    /**
+     * @brief Compute the exact distance between two particles.
+     *
+     * The closest points are not computed if the bounding volumes of the particles are farther than \c dmax
+     * (see early_rejection).
+     *
+     * If a particle is a clump, the closest points are computed for each of its spheres: there can be several
+     * contacts between the same two particles, all of them attached to the clump. The same holds for a mesh, with one
+     * contact for each close primitive. The other pairs have one contact, added directly to \c contacts.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param particles [in] Array of particles.
+     * @param contacts [inout] Array of neighbors, if the distance between the two particles is small enough, add a neighbor in this array.
+     * @param dmax [in] Maximum distance to consider two particles to be neighbors.
+     * @param i [in] Index of the first particle.
+     * @param j [in] Index of the second particle.
+     * @param default_contact_property [in] Default contact property.
+     *
+     * @return The bounding volume which rejected the pair, rejection_tier::none if the closest points were computed.
+     */
+    template <class problem_t, std::size_t dim>
+    rejection_tier compute_exact_distance(const BoxDomain<dim>& box,
+                                          scopi_container<dim>& particles,
+                                          std::vector<neighbor<dim, problem_t>>& contacts,
+                                          double dmax,
+                                          std::size_t i,
+                                          std::size_t j,
+                                          const contact_property<problem_t>& default_contact_property)
+    {
+        std::size_t o1 = particles.object_index(i);
+        std::size_t o2 = particles.object_index(j);
+        auto obj1      = select_object_dispatcher<dim>::dispatch(*particles[o1], index(i - particles.offset(o1)));
+        auto obj2      = select_object_dispatcher<dim>::dispatch(*particles[o2], index(j - particles.offset(o2)));
+
+        auto tier = early_rejection_dispatcher<dim>::dispatch(*obj1, *obj2, dmax);
+        if (tier != rejection_tier::none)
+        {
+            return tier;
+        }
+
+        auto add = [&](neighbor<dim, problem_t>&& neigh)
+        {
+            add_neighbor(box, particles, contacts, std::move(neigh), dmax, i, j, default_contact_property);
+        };
+
+        auto kind1 = object_kind_dispatcher<dim>::dispatch(*obj1);
+        auto kind2 = object_kind_dispatcher<dim>::dispatch(*obj2);
+        if (kind1 != object_kind::clump && kind2 != object_kind::clump)
+        {
+            add_closest_points<problem_t>(*obj1, kind1, *obj2, kind2, dmax, add);
+            return rejection_tier::none;
+        }
+
+        auto members1 = (kind1 == object_kind::clump) ? members(static_cast<const clump<dim, false>&>(*obj1)) : clump_members<dim>();
+        auto members2 = (kind2 == object_kind::clump) ? members(static_cast<const clump<dim, false>&>(*obj2)) : clump_members<dim>();
+        // the spheres of the clumps are views built on the stack
+        auto add_with_obj2 = [&](const object<dim, false>& o1, object_kind k1)
+        {
+            if (members2.empty())
+            {
+                add_closest_points<problem_t>(o1, k1, *obj2, kind2, dmax, add);
+                return;
+            }
+            for (std::size_t k2 = 0; k2 < members2.size(); ++k2)
+            {
+                add_closest_points<problem_t>(o1, k1, members2.get_sphere(k2), object_kind::simple, dmax, add);
+            }
+        };
+        if (members1.empty())
+        {
+            add_with_obj2(*obj1, kind1);
+            return rejection_tier::none;
+        }
+        for (std::size_t k1 = 0; k1 < members1.size(); ++k1)
+        {
+            add_with_obj2(members1.get_sphere(k1), object_kind::simple);
+        }
+        return rejection_tier::none;
+    }
+
     /**
      * @brief Sort contacts.
      *
@@ -63,6 +63,9 @@ namespace scopi
          */
         using base_type = contact_base<contact_brute_force<problem_t>>;
 
+        template <std::size_t dim>
+        using contact_container_t = std::vector<neighbor<dim, problem_t>>;
+
         /**
          * @brief Constructor.
          *
@@ -85,11 +88,13 @@ namespace scopi
          * @tparam dim Dimension (2 or 3).
          * @param particles [in] Array of particles.
          * @param active_ptr [in] Index of the first active particle.
-         *
-         * @return Array of neighbors.
+         * @param contacts [out] Array of neighbors, cleared first.
          */
         template <std::size_t dim>
-        auto run_impl(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr);
+        void run_impl(const BoxDomain<dim>& box,
+                      scopi_container<dim>& particles,
+                      std::size_t active_ptr,
+                      contact_container_t<dim>& contacts);
 
         contact_property<problem_t> m_default_contact_property;
 
@@ -101,19 +106,33 @@ namespace scopi
 
     template <class problem_t>
     template <std::size_t dim>
-    auto contact_brute_force<problem_t>::run_impl(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr)
+    void contact_brute_force<problem_t>::run_impl(const BoxDomain<dim>& box,
+                                                  scopi_container<dim>& particles,
+                                                  std::size_t active_ptr,
+                                                  contact_container_t<dim>& contacts)
     {
-        std::vector<neighbor<dim, problem_t>> contacts;
+        contacts.clear();
 
         add_objects_from_periodicity(box, particles, this->get_params().dmax);
 
+        std::size_t nb_rejected_sphere = 0;
+        std::size_t nb_rejected_box    = 0;
+
         tic();
-#pragma omp parallel for
+#pragma omp parallel for reduction(+ : nb_rejected_sphere, nb_rejected_box)
         for (std::size_t i = active_ptr; i < particles.pos().size() - 1; ++i)
         {
             for (std::size_t j = i + 1; j < particles.pos().size(); ++j)
             {
-                compute_exact_distance<problem_t>(box, particles, contacts, this->get_params().dmax, i, j, m_default_contact_property);
+                auto tier = compute_exact_distance<problem_t>(box,
+                                                              particles,
+                                                              contacts,
+                                                              this->get_params().dmax,
+                                                              i,
+                                                              j,
+                                                              m_default_contact_property);
+                nb_rejected_sphere += (tier == rejection_tier::sphere);
+                nb_rejected_box += (tier == rejection_tier::oriented_box);
             }
         }
 
@@ -122,12 +141,22 @@ namespace scopi
         {
             for (std::size_t j = active_ptr; j < particles.pos().size(); ++j)
             {
-                compute_exact_distance<problem_t>(box, particles, contacts, this->get_params().dmax, i, j, m_default_contact_property);
+                auto tier = compute_exact_distance<problem_t>(box,
+                                                              particles,
+                                                              contacts,
+                                                              this->get_params().dmax,
+                                                              i,
+                                                              j,
+                                                              m_default_contact_property);
+                nb_rejected_sphere += (tier == rejection_tier::sphere);
+                nb_rejected_box += (tier == rejection_tier::oriented_box);
             }
         }
 
         auto duration = toc();
         PLOG_INFO << "----> CPUTIME : compute " << contacts.size() << " contacts = " << duration;
+        PLOG_INFO << "----> Early rejections: " << nb_rejected_sphere << " by bounding spheres, " << nb_rejected_box
+                  << " by oriented boxes";
 
         tic();
         sort_contacts(contacts);
@@ -136,6 +165,5 @@ namespace scopi
 
         particles.reset_periodic();
 
-        return contacts;
     }
 }
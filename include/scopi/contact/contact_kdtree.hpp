@@ -153,6 +153,9 @@ namespace scopi
          */
         using base_type = contact_base<contact_kdtree<problem_t>>;
 
+        template <std::size_t dim>
+        using contact_container_t = std::vector<neighbor<dim, problem_t>>;
+
         /**
          * @brief Constructor.
          *
@@ -177,11 +180,13 @@ namespace scopi
          * @tparam dim Dimension (2 or 3).
          * @param particles [in] Array of particles.
          * @param active_ptr [in] Index of the first active particle.
-         *
-         * @return Array of neighbors.
+         * @param contacts [out] Array of neighbors, cleared first.
          */
         template <std::size_t dim>
-        auto run_impl(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr);
+        void run_impl(const BoxDomain<dim>& box,
+                      scopi_container<dim>& particles,
+                      std::size_t active_ptr,
+                      contact_container_t<dim>& contacts);
 
         auto& default_contact_property()
         {
@@ -199,11 +204,14 @@ namespace scopi
 
     template <class problem_t>
     template <std::size_t dim>
-    auto contact_kdtree<problem_t>::run_impl(const BoxDomain<dim>& box, scopi_container<dim>& particles, std::size_t active_ptr)
+    void contact_kdtree<problem_t>::run_impl(const BoxDomain<dim>& box,
+                                             scopi_container<dim>& particles,
+                                             std::size_t active_ptr,
+                                             contact_container_t<dim>& contacts)
     {
         // std::cout << "----> CONTACTS : run implementation contact_kdtree" << std::endl;
 
-        std::vector<neighbor<dim, problem_t>> contacts;
+        contacts.clear();
 
         add_objects_from_periodicity(box, particles, this->get_params().dmax);
 
@@ -218,8 +226,10 @@ namespace scopi
 
         tic();
 
-        m_nMatches = 0;
-#pragma omp parallel for reduction(+ : m_nMatches) // num_threads(1)
+        m_nMatches                     = 0;
+        std::size_t nb_rejected_sphere = 0;
+        std::size_t nb_rejected_box    = 0;
+#pragma omp parallel for reduction(+ : m_nMatches, nb_rejected_sphere, nb_rejected_box) // num_threads(1)
 
         for (std::size_t i = active_ptr; i < particles.pos().size() - 1; ++i)
         {
@@ -242,7 +252,15 @@ namespace scopi
                 std::size_t j = ret_matches[ic].first + particles.offset(particles.object_index(active_ptr));
                 if (i < j)
                 {
-                    compute_exact_distance<problem_t>(box, particles, contacts, this->get_params().dmax, i, j, m_default_contact_property);
+                    auto tier = compute_exact_distance<problem_t>(box,
+                                                                  particles,
+                                                                  contacts,
+                                                                  this->get_params().dmax,
+                                                                  i,
+                                                                  j,
+                                                                  m_default_contact_property);
+                    nb_rejected_sphere += (tier == rejection_tier::sphere);
+                    nb_rejected_box += (tier == rejection_tier::oriented_box);
                     m_nMatches++;
                 }
             }
@@ -253,13 +271,23 @@ namespace scopi
         {
             for (std::size_t j = active_ptr; j < particles.pos().size(); ++j)
             {
-                compute_exact_distance<problem_t>(box, particles, contacts, this->get_params().dmax, i, j, m_default_contact_property);
+                auto tier = compute_exact_distance<problem_t>(box,
+                                                              particles,
+                                                              contacts,
+                                                              this->get_params().dmax,
+                                                              i,
+                                                              j,
+                                                              m_default_contact_property);
+                nb_rejected_sphere += (tier == rejection_tier::sphere);
+                nb_rejected_box += (tier == rejection_tier::oriented_box);
             }
         }
 
         duration = toc();
         PLOG_INFO << "----> CPUTIME : compute " << contacts.size() << " contacts = " << duration << " compute " << m_nMatches
                   << " distances" << std::endl;
+        PLOG_INFO << "----> Early rejections: " << nb_rejected_sphere << " by bounding spheres, " << nb_rejected_box
+                  << " by oriented boxes" << std::endl;
 
         tic();
         sort_contacts(contacts);
@@ -268,6 +296,5 @@ namespace scopi
 
         particles.reset_periodic();
 
-        return contacts;
     }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <type_traits>
+
 #include <nlohmann/json.hpp>
 
 namespace nl = nlohmann;
@@ -35,12 +37,29 @@ namespace scopi
     {
     };
 
+    /**
+     * @brief Whether the problem is solved by fixed point iterations on the \c sij of the contacts.
+     */
+    template <class problem_t>
+    inline constexpr bool is_fixed_point_problem_v = std::is_same_v<problem_t, FrictionFixedPoint>
+                                                  || std::is_same_v<problem_t, ViscousFriction>;
+
     template <class problem_t>
     struct contact_property;
 
+    /**
+     * @brief Properties of a contact.
+     *
+     * The properties are plain data, copied from the default property of the contact method into each neighbor:
+     * the options of the command line are registered once by \c init_options, not by the constructors.
+     */
     template <>
     struct contact_property<NoFriction>
     {
+        static void init_options()
+        {
+        }
+
         static auto to_json()
         {
             return nl::json{
@@ -52,7 +71,7 @@ namespace scopi
     template <>
     struct contact_property<Friction>
     {
-        contact_property()
+        void init_options()
         {
             auto& sub = get_app();
             if (!check_option(sub, "--mu"))
@@ -75,7 +94,7 @@ namespace scopi
     template <>
     struct contact_property<FixedPoint>
     {
-        contact_property()
+        void init_options()
         {
             auto& sub = get_app();
             if (!check_option(sub, "--fixed-point-tol"))
@@ -101,7 +120,7 @@ namespace scopi
     template <>
     struct contact_property<Viscous>
     {
-        contact_property()
+        void init_options()
         {
             auto& sub = get_app();
             if (!check_option(sub, "--gamma"))
@@ -131,11 +150,11 @@ namespace scopi
     struct contact_property<FrictionFixedPoint> : public contact_property<Friction>,
                                                   contact_property<FixedPoint>
     {
-        // contact_property()
-        //     : contact_property<Friction>()
-        //     , contact_property<FixedPoint>()
-        // {
-        // }
+        void init_options()
+        {
+            contact_property<Friction>::init_options();
+            contact_property<FixedPoint>::init_options();
+        }
 
         auto to_json() const
         {
@@ -153,12 +172,12 @@ namespace scopi
                                                contact_property<Friction>,
                                                contact_property<FixedPoint>
     {
-        // contact_property()
-        //     : contact_property<Viscous>()
-        //     , contact_property<Friction>()
-        //     , contact_property<FixedPoint>()
-        // {
-        // }
+        void init_options()
+        {
+            contact_property<Viscous>::init_options();
+            contact_property<Friction>::init_options();
+            contact_property<FixedPoint>::init_options();
+        }
 
         auto to_json() const
         {
@@ -174,6 +193,9 @@ namespace scopi
         }
     };
 
+    static_assert(std::is_trivially_copyable_v<contact_property<FrictionFixedPoint>>);
+    static_assert(std::is_trivially_copyable_v<contact_property<ViscousFriction>>);
+
     template <class ostream>
     void to_stream(ostream& out, int indent, const contact_property<NoFriction>&)
     {
@@ -6,11 +6,13 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include <xtensor/xadapt.hpp>
 
 #include "crtp.hpp"
+#include "memory.hpp"
 #include "objects/methods/select.hpp"
 #include "objects/types/base.hpp"
 #include "property.hpp"
@@ -18,6 +20,30 @@
 
 namespace scopi
 {
+    namespace detail
+    {
+        /**
+         * @brief Deleter of an object reconstructed from a const container, which owns the positions and the quaternions
+         * viewed by the object.
+         */
+        template <std::size_t dim>
+        struct object_copy_deleter
+        {
+            std::vector<type::position_t<dim>> positions;
+            std::vector<type::quaternion_t> quaternions;
+
+            void operator()(const object<dim, false>* obj) const
+            {
+                delete obj;
+            }
+        };
+    }
+
+    /**
+     * @brief Object reconstructed from a const container (see scopi_container::operator[]).
+     */
+    template <std::size_t dim>
+    using const_object_ptr = std::unique_ptr<const object<dim, false>, detail::object_copy_deleter<dim>>;
 
     ////////////////////////////////
     // scopi_container definition //
@@ -31,6 +57,23 @@ namespace scopi
      * Fictive particles for periodic boundary conditions are placed at the end
      * of the container.
      *
+     * Each field is stored in a contiguous array aligned on a cache line, or on
+     * transparent huge pages if SCOPI_USE_HUGE_PAGES is defined (see memory.hpp).
+     *
+     * The layout is an array of structures: the values of a particle are a
+     * whole vector (position_type, quaternion_type, ...). There is no layout
+     * with one array per component (x[], y[], z[], ...), because
+     *  - the objects returned by operator[] view the positions and the
+     *    quaternions of their particles as arrays of vectors;
+     *  - pos(), q(), v(), ... return arrays of vectors, and their callers
+     *    (solver, kd-tree, checkpoints, snapshots, sleep_manager, tests) use
+     *    <tt>pos()(i)</tt> as a vector and <tt>pos().data()</tt> as a pointer
+     *    to vectors.
+     * Such a layout needs the objects to gather their particles and the
+     * accessors to return (size, dim) views with a stride, which changes all
+     * these callers. Meanwhile, the kernels of integration.hpp loop over the
+     * vectors with a fixed inner size, which the compiler vectorizes.
+     *
      * In the following, "particle" means a base object (sphere, superellipsoid
      * or plane) and an "object" can be a more complex object, such as a worm.
      * Particles are objects.
@@ -82,7 +125,17 @@ namespace scopi
          * @return Object.
          */
         std::unique_ptr<object<Dim, false>> operator[](std::size_t i);
-        const std::unique_ptr<object<Dim, false>> operator[](std::size_t i) const;
+        /**
+         * @brief Reconstructs an object from a const container.
+         *
+         * The object views a copy of its positions and quaternions, owned by the returned pointer, so that the
+         * container cannot be modified through it.
+         *
+         * @param i Index of the object.
+         *
+         * @return Object.
+         */
+        const_object_ptr<Dim> operator[](std::size_t i) const;
 
         /**
          * @brief Appends the given element value to the end of the container.
@@ -104,6 +157,26 @@ namespace scopi
          */
         void push_back(std::size_t i, const std::vector<position_type>& pos);
 
+        /**
+         * @brief Register the shape of an object, so that objects of this shape can be appended by push_back_shape.
+         *
+         * @param s [in] Object whose shape is registered.
+         *
+         * @return Hash of the shape.
+         */
+        std::size_t add_shape(const object<dim>& s);
+        /**
+         * @brief Append an object of a registered shape.
+         *
+         * The particles of the object are at the origin without rotation: their positions and quaternions are set
+         * afterwards through pos() and q(). Used to restore a checkpoint without building each object.
+         *
+         * @param shape_id [in] Hash of the shape (see add_shape).
+         * @param size [in] Number of particles of the object.
+         * @param p [in] Properties of the object (see property.hpp).
+         */
+        void push_back_shape(std::size_t shape_id, std::size_t size, const property<dim>& p = property<dim>());
+
         /**
          * @brief Increase the capacity of the container.
          *
@@ -224,6 +297,10 @@ namespace scopi
          * @return Index of the object.
          */
         std::size_t object_index(std::size_t i) const;
+        /**
+         * @brief Hash of the shape of the object \c i, shared by the objects with the same shape.
+         */
+        std::size_t shape_id(std::size_t i) const;
         /**
          * @brief Convert an object index into a particle index.
          *
@@ -246,47 +323,47 @@ namespace scopi
       private:
 
         /**
-         * @brief
+         * @brief Constructors of the objects, indexed by the hash of their shape.
          *
-         * \todo Write documentation.
+         * The constructors are immutable, so that a copy of the container shares them (see async_writer).
          */
-        std::map<std::size_t, std::unique_ptr<base_constructor<dim>>> m_shape_map;
+        std::map<std::size_t, std::shared_ptr<const base_constructor<dim>>> m_shape_map;
         /**
          * @brief Array of particles' positions.
          */
-        std::vector<position_type> m_positions; // pos()
+        particle_vector<position_type> m_positions; // pos()
         /**
          * @brief Array of particles' quaternions.
          */
-        std::vector<quaternion_type> m_quaternions; // q()
+        particle_vector<quaternion_type> m_quaternions; // q()
         /**
          * @brief Array of particles' forces.
          */
-        std::vector<force_type> m_forces; // f()
+        particle_vector<force_type> m_forces; // f()
         /**
          * @brief Array of particles' masses.
          */
-        std::vector<mass_type> m_masses; // m()
+        particle_vector<mass_type> m_masses; // m()
         /**
          * @brief Array of particles' moments of inertia.
          */
-        std::vector<moment_type> m_moments_inertia; // j()
+        particle_vector<moment_type> m_moments_inertia; // j()
         /**
          * @brief Array of particles' velocities.
          */
-        std::vector<velocity_type> m_velocities; // v()
+        particle_vector<velocity_type> m_velocities; // v()
         /**
          * @brief Array of particles' desired velocities.
          */
-        std::vector<velocity_type> m_desired_velocities; // vd()
+        particle_vector<velocity_type> m_desired_velocities; // vd()
         /**
          * @brief Array of particles' rotations.
          */
-        std::vector<rotation_type> m_omega; // omega()
+        particle_vector<rotation_type> m_omega; // omega()
         /**
          * @brief Array of particles' desired rotations.
          */
-        std::vector<rotation_type> m_desired_omega; // desired_omega()
+        particle_vector<rotation_type> m_desired_omega; // desired_omega()
         /**
          * @brief Array of particles' hashes.
          */
@@ -330,29 +407,63 @@ namespace scopi
     }
 
     template <std::size_t dim>
-    const std::unique_ptr<object<dim, false>> scopi_container<dim>::operator[](std::size_t i) const
+    auto scopi_container<dim>::operator[](std::size_t i) const -> const_object_ptr<dim>
     {
-        return (*m_shape_map[m_shapes_id[i]])(&m_positions[m_offset[i]], &m_quaternions[m_offset[i]]);
+        detail::object_copy_deleter<dim> copy;
+        copy.positions.assign(m_positions.begin() + m_offset[i], m_positions.begin() + m_offset[i + 1]);
+        copy.quaternions.assign(m_quaternions.begin() + m_offset[i], m_quaternions.begin() + m_offset[i + 1]);
+        // moving the deleter into the pointer keeps the buffers of the copies
+        auto obj = (*m_shape_map.at(m_shapes_id[i]))(copy.positions.data(), copy.quaternions.data());
+        return const_object_ptr<dim>(obj.release(), std::move(copy));
     }
 
     template <std::size_t dim>
     void scopi_container<dim>::push_back(const object<dim>& s, const property<dim>& p)
+    {
+        std::size_t first = m_positions.size();
+        push_back_shape(add_shape(s), s.size(), p);
+        for (std::size_t i = 0; i < s.size(); ++i)
+        {
+            m_positions[first + i]   = s.pos(i);
+            m_quaternions[first + i] = s.q(i);
+        }
+    }
+
+    template <std::size_t dim>
+    std::size_t scopi_container<dim>::add_shape(const object<dim>& s)
+    {
+        auto it = m_shape_map.find(s.hash());
+        if (it == m_shape_map.end())
+        {
+            m_shape_map.insert(std::make_pair(s.hash(), std::move(s.construct())));
+        }
+        return s.hash();
+    }
+
+    template <std::size_t dim>
+    void scopi_container<dim>::push_back_shape(std::size_t shape_id, std::size_t size, const property<dim>& p)
     {
         assert(!m_periodic_added);
+        assert(m_shape_map.find(shape_id) != m_shape_map.end());
 
         if (m_offset.empty())
         {
-            m_offset = {0, s.size()};
+            m_offset = {0, size};
         }
         else
         {
-            m_offset.push_back(m_offset.back() + s.size());
+            m_offset.push_back(m_offset.back() + size);
         }
 
-        for (std::size_t i = 0; i < s.size(); ++i)
+        position_type origin;
+        origin.fill(0.);
+        quaternion_type identity;
+        identity.fill(0.);
+        identity(0) = 1.;
+        for (std::size_t i = 0; i < size; ++i)
         {
-            m_positions.push_back(s.pos(i));
-            m_quaternions.push_back(s.q(i));
+            m_positions.push_back(origin);
+            m_quaternions.push_back(identity);
             m_velocities.push_back(p.velocity());
             m_omega.push_back(p.omega());
             m_desired_omega.push_back(p.desired_omega());
@@ -364,7 +475,7 @@ namespace scopi
 
         if (!p.is_active())
         {
-            m_nb_inactive_core_objects += s.size();
+            m_nb_inactive_core_objects += size;
             if (m_nb_inactive_core_objects != m_positions.size())
             {
                 throw std::runtime_error("All the obstacles must be pushed "
@@ -372,14 +483,8 @@ namespace scopi
             }
         }
 
-        auto it = m_shape_map.find(s.hash());
-        if (it == m_shape_map.end())
-        {
-            m_shape_map.insert(std::make_pair(s.hash(), std::move(s.construct())));
-        }
-
-        m_shapes_id.push_back(s.hash());
-        m_periodic_ptr += s.size();
+        m_shapes_id.push_back(shape_id);
+        m_periodic_ptr += size;
         m_periodic_obj_ptr++;
     }
 
@@ -635,6 +740,12 @@ namespace scopi
         return std::distance(m_offset.cbegin(), lower) - 1;
     }
 
+    template <std::size_t dim>
+    std::size_t scopi_container<dim>::shape_id(std::size_t i) const
+    {
+        return m_shapes_id[i];
+    }
+
     template <std::size_t dim>
     std::size_t scopi_container<dim>::offset(std::size_t i) const
     {
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+
+#include <xtensor/xfixed.hpp>
+
+#include "box.hpp"
+#include "container.hpp"
+#include "small_math.hpp"
+#include "types.hpp"
+
+namespace scopi
+{
+    namespace detail
+    {
+        inline small::vec<3> angular_velocity(double w)
+        {
+            return {
+                {0., 0., w}
+            };
+        }
+
+        inline small::vec<3> angular_velocity(const xt::xtensor_fixed<double, xt::xshape<3>>& w)
+        {
+            return small::to_vec<3>(w);
+        }
+    }
+
+    /**
+     * @brief Throughput of a kernel over \c n particles which took \c duration seconds, reported in the logs.
+     */
+    inline double particles_per_second(std::size_t n, double duration)
+    {
+        return duration > 0. ? static_cast<double>(n) / duration : 0.;
+    }
+
+    /**
+     * @brief Explicit Euler step of the positions of \c n consecutive particles: \f$ x \leftarrow x + dt\, v \f$.
+     *
+     * The kernels of this file work directly on the arrays of the container (see scopi_container::pos, ...):
+     * there is no temporary and the particles are independent, so that the loop is split between the threads and
+     * vectorized.
+     *
+     * @param pos [in/out] Positions of the particles.
+     * @param v [in] Velocities of the particles.
+     * @param n [in] Number of particles.
+     * @param dt [in] Time step.
+     * @param skip [in] Predicate on the index in [0, n) of the particles which do not move.
+     */
+    template <class Position, class Velocity, class Skip>
+    void integrate_positions(Position* pos, const Velocity* v, std::size_t n, double dt, const Skip& skip)
+    {
+        static constexpr std::size_t dim = small::fixed_size_v<Position>;
+
+#pragma omp parallel for simd
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            // blend instead of a branch: the skipped particles move by 0, so the body of the simd loop is the same for all
+            double move = dt * static_cast<double>(!skip(i));
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                pos[i](d) += move * v[i](d);
+            }
+        }
+    }
+
+    /**
+     * @brief Explicit Euler step of the orientations of \c n consecutive particles.
+     *
+     * \f$ q \leftarrow q \circ \exp(dt\, \omega / 2) \f$, normalized. The rotation velocity is a scalar in 2D (rotation
+     * around z) and a vector in 3D.
+     *
+     * @param q [in/out] Quaternions of the particles.
+     * @param omega [in] Rotation velocities of the particles.
+     * @param n [in] Number of particles.
+     * @param dt [in] Time step.
+     * @param skip [in] Predicate on the index in [0, n) of the particles which do not move.
+     */
+    template <class Rotation, class Skip>
+    void integrate_orientations(type::quaternion_t* q, const Rotation* omega, std::size_t n, double dt, const Skip& skip)
+    {
+#pragma omp parallel for
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (skip(i))
+            {
+                continue;
+            }
+            auto qi = small::normalized(small::to_quat(q[i]) * small::exp_map(detail::angular_velocity(omega[i]), dt));
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                q[i](k) = qi[k];
+            }
+        }
+    }
+
+    /**
+     * @brief Move by one period the objects which have left a periodic box.
+     *
+     * Along a periodic axis, an object is moved if all its particles are above the upper bound of the box (or all
+     * under the lower bound). The objects are independent: there is one parallel pass over the objects, which checks
+     * all the axes.
+     *
+     * @param box [in] Domain of the simulation.
+     * @param particles [in/out] Array of particles.
+     */
+    template <std::size_t dim>
+    void wrap_periodic_objects(const BoxDomain<dim>& box, scopi_container<dim>& particles)
+    {
+        bool is_periodic = false;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            is_periodic = is_periodic || box.is_periodic(d);
+        }
+        if (!is_periodic)
+        {
+            return;
+        }
+
+        auto* pos = particles.pos().data();
+
+#pragma omp parallel for
+        for (std::size_t io = 0; io < particles.size(); ++io)
+        {
+            std::size_t first = particles.offset(io);
+            std::size_t last  = particles.offset(io + 1);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                if (!box.is_periodic(d))
+                {
+                    continue;
+                }
+
+                std::size_t plus  = 0;
+                std::size_t minus = 0;
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    plus += pos[i](d) > box.upper_bound(d);
+                    minus += pos[i](d) < box.lower_bound(d);
+                }
+
+                double period = box.upper_bound(d) - box.lower_bound(d);
+                double shift  = 0.;
+                if (plus == last - first)
+                {
+                    shift -= period;
+                }
+                if (minus == last - first)
+                {
+                    shift += period;
+                }
+                if (shift != 0.)
+                {
+                    for (std::size_t i = first; i < last; ++i)
+                    {
+                        pos[i](d) += shift;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace nl = nlohmann;
+
+namespace scopi
+{
+    namespace detail
+    {
+        /**
+         * @brief Write the \c n elements returned by \c to_json, in order, without keeping more than a block of them.
+         *
+         * The elements of a block are converted and serialized in parallel by \c serialize, then written one after the
+         * other by \c write.
+         */
+        template <class ToJson, class Serialize, class Write>
+        void stream_elements(std::size_t n, std::size_t block_size, const ToJson& to_json, const Serialize& serialize, const Write& write)
+        {
+            block_size = std::max(block_size, std::size_t(1));
+            std::vector<std::string> buffers(std::min(n, block_size));
+            for (std::size_t first = 0; first < n; first += block_size)
+            {
+                std::size_t last = std::min(n, first + block_size);
+#pragma omp parallel for schedule(dynamic, 64)
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    buffers[i - first] = serialize(to_json(i));
+                }
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    write(i, buffers[i - first]);
+                }
+            }
+        }
+
+        inline void write_bson_int32(std::ostream& out, std::int32_t value)
+        {
+            // BSON is little endian
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                out.put(static_cast<char>((static_cast<std::uint32_t>(value) >> (8 * k)) & 0xff));
+            }
+        }
+
+        /**
+         * @brief Write the size of the BSON document started at \c start, when the stream is at its end.
+         */
+        inline void patch_bson_size(std::ostream& out, std::streampos start)
+        {
+            auto end = out.tellp();
+            out.seekp(start);
+            write_bson_int32(out, static_cast<std::int32_t>(end - start));
+            out.seekp(end);
+        }
+
+        inline void write_bson_key(std::ostream& out, char type, const std::string& key)
+        {
+            out.put(type);
+            out.write(key.data(), static_cast<std::streamsize>(key.size()));
+            out.put('\0');
+        }
+    }
+
+    /**
+     * @brief Number of objects or contacts serialized at once by the streaming writers.
+     */
+    inline constexpr std::size_t json_stream_block_size = 4096;
+
+    /**
+     * @brief Write the output file \c {"contacts": [...], "objects": [...]} in json, one element at a time.
+     *
+     * The bytes are the ones of \c dump of the whole document, without indentation: the keys are sorted and an empty
+     * array is \c null, as it is in the document built by push_back. Only a block of elements is in memory at once.
+     *
+     * @param out [out] Stream of the file.
+     * @param nb_objects [in] Number of objects.
+     * @param object_json [in] Function which returns the json of the object \c i.
+     * @param nb_contacts [in] Number of contacts.
+     * @param contact_json [in] Function which returns the json of the contact \c i.
+     * @param block_size [in] Number of elements serialized at once.
+     */
+    template <class ObjectJson, class ContactJson>
+    void write_json_stream(std::ostream& out,
+                           std::size_t nb_objects,
+                           const ObjectJson& object_json,
+                           std::size_t nb_contacts,
+                           const ContactJson& contact_json,
+                           std::size_t block_size = json_stream_block_size)
+    {
+        auto dump = [](const nl::json& element)
+        {
+            return element.dump();
+        };
+        auto write_array = [&](std::size_t n, const auto& to_json)
+        {
+            if (n == 0)
+            {
+                out << "null";
+                return;
+            }
+            out.put('[');
+            detail::stream_elements(n,
+                                    block_size,
+                                    to_json,
+                                    dump,
+                                    [&](std::size_t i, const std::string& buffer)
+                                    {
+                                        if (i > 0)
+                                        {
+                                            out.put(',');
+                                        }
+                                        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                                    });
+            out.put(']');
+        };
+
+        out << "{\"contacts\":";
+        write_array(nb_contacts, contact_json);
+        out << ",\"objects\":";
+        write_array(nb_objects, object_json);
+        out.put('}');
+    }
+
+    /**
+     * @brief Write the output file \c {"contacts": [...], "objects": [...]} in BSON, one element at a time.
+     *
+     * The bytes are the ones of \c nl::json::to_bson of the whole document. The sizes of the documents are written
+     * once their end is known, so that \c out must be seekable.
+     *
+     * @param out [out] Stream of the file, opened in binary mode.
+     * @param nb_objects [in] Number of objects.
+     * @param object_json [in] Function which returns the json of the object \c i.
+     * @param nb_contacts [in] Number of contacts.
+     * @param contact_json [in] Function which returns the json of the contact \c i.
+     * @param block_size [in] Number of elements serialized at once.
+     */
+    template <class ObjectJson, class ContactJson>
+    void write_bson_stream(std::ostream& out,
+                           std::size_t nb_objects,
+                           const ObjectJson& object_json,
+                           std::size_t nb_contacts,
+                           const ContactJson& contact_json,
+                           std::size_t block_size = json_stream_block_size)
+    {
+        auto to_bson = [](const nl::json& element)
+        {
+            std::string buffer;
+            nl::json::to_bson(element, buffer);
+            return buffer;
+        };
+        auto write_array = [&](const std::string& key, std::size_t n, const auto& to_json)
+        {
+            if (n == 0)
+            {
+                detail::write_bson_key(out, 0x0A, key);
+                return;
+            }
+            detail::write_bson_key(out, 0x04, key);
+            auto start = out.tellp();
+            detail::write_bson_int32(out, 0);
+            detail::stream_elements(n,
+                                    block_size,
+                                    to_json,
+                                    to_bson,
+                                    [&](std::size_t i, const std::string& buffer)
+                                    {
+                                        detail::write_bson_key(out, 0x03, std::to_string(i));
+                                        out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                                    });
+            out.put('\0');
+            detail::patch_bson_size(out, start);
+        };
+
+        auto start = out.tellp();
+        detail::write_bson_int32(out, 0);
+        write_array("contacts", nb_contacts, contact_json);
+        write_array("objects", nb_objects, object_json);
+        out.put('\0');
+        detail::patch_bson_size(out, start);
+    }
+}
@@ -6,6 +6,7 @@
 #include <xtensor/xtensor.hpp>
 #include <xtensor/xview.hpp>
 
+#include "../objects/contact_storage.hpp"
 #include "../quaternion.hpp"
 
 namespace scopi
@@ -48,6 +49,32 @@ namespace scopi
         {
             return cross(std::integral_constant<std::size_t, dim>{}, x, y);
         }
+
+        /**
+         * @brief Number of components of the angular velocity of a particle in the vector of unknowns.
+         *
+         * In 2D, the rotation is around the axis z and only this component is stored.
+         * The vector of unknowns is [v (dim per particle) | omega (rotation_dofs per particle)],
+         * and there are dim rows per contact.
+         */
+        template <std::size_t dim>
+        inline constexpr std::size_t rotation_dofs = dim == 2 ? 1 : 3;
+
+        template <class T>
+        struct contact_dim_impl : contact_dim_impl<typename T::value_type>
+        {
+        };
+
+        template <template <std::size_t, class> class Contact, std::size_t dim, class problem_t>
+        struct contact_dim_impl<Contact<dim, problem_t>> : std::integral_constant<std::size_t, dim>
+        {
+        };
+
+        /**
+         * @brief Dimension of the contacts of an array of neighbors or of a contact_storage.
+         */
+        template <class Contacts_t>
+        inline constexpr std::size_t contact_dim = contact_dim_impl<Contacts_t>::value;
     } // namespace detail
 
     template <class Contacts_t, class Particles_t>
@@ -58,17 +85,31 @@ namespace scopi
         static constexpr std::size_t dim = Particles_t::dim;
 
         AMatrix(const Contacts_t& contacts, const Particles_t& particles)
+            : AMatrix(contacts, particles, m_own_work)
+        {
+        }
+
+        /**
+         * @brief Constructor writing the products in \c work, resized if needed.
+         *
+         * The buffer outlives the operator, so that its memory is reused by the operators of the next time steps.
+         */
+        AMatrix(const Contacts_t& contacts, const Particles_t& particles, xt::xtensor<double, 1>& work)
             : m_contacts{contacts}
             , m_particles{particles}
-            , m_work{xt::zeros<double>({3 * contacts.size()})}
+            , m_work{work}
         {
+            m_work.resize({dim * contacts.size()});
         }
 
+        AMatrix(const AMatrix&)            = delete;
+        AMatrix& operator=(const AMatrix&) = delete;
+
         const auto& mat_mult(const xt::xtensor<double, 1>& u) const
         {
             m_work.fill(0.);
             std::size_t active_offset = m_particles.nb_inactive();
-            std::size_t rot_offset    = 3 * m_particles.nb_active();
+            std::size_t rot_offset    = dim * m_particles.nb_active();
             std::size_t row           = 0;
 
             // for (auto& c : m_contacts)
@@ -103,51 +144,72 @@ namespace scopi
 
             auto pos = m_particles.pos();
             auto q   = m_particles.q();
-            for (auto& c : m_contacts)
+            for (std::size_t ic = 0; ic < m_contacts.size(); ++ic)
             {
-                auto view = xt::view(m_work, xt::range(row, row + 3));
-                if (c.i >= active_offset)
+                auto view     = xt::view(m_work, xt::range(row, row + dim));
+                std::size_t i = contact_i(m_contacts, ic);
+                std::size_t j = contact_j(m_contacts, ic);
+                if (i >= active_offset)
                 {
-                    std::size_t start                            = (c.i - active_offset) * 3;
-                    xt::xtensor_fixed<double, xt::xshape<3>> v_i = xt::view(u, xt::range(start, start + 3));
-
-                    start += rot_offset;
-                    xt::xtensor_fixed<double, xt::xshape<3>> omega_i = xt::view(u, xt::range(start, start + 3));
-                    xt::xtensor_fixed<double, xt::xshape<3>> rij_i   = c.pi - pos(c.i);
-                    auto Ri                                          = rotation_matrix<3>(q(c.i));
-
-                    auto cross = detail::cross<dim>(rij_i, detail::mat_mult(Ri, omega_i));
-                    for (std::size_t d = 0; d < 3; ++d)
+                    auto v_i = point_velocity(u, i - active_offset, rot_offset, contact_pi(m_contacts, ic) - pos(i), q(i));
+                    for (std::size_t d = 0; d < dim; ++d)
                     {
-                        view(d) += v_i(d) - cross(d);
+                        view(d) += v_i(d);
                     }
                 }
-                if (c.j >= active_offset)
+                if (j >= active_offset)
                 {
-                    std::size_t start                            = (c.j - active_offset) * 3;
-                    xt::xtensor_fixed<double, xt::xshape<3>> v_j = xt::view(u, xt::range(start, start + 3));
-
-                    start += rot_offset;
-                    xt::xtensor_fixed<double, xt::xshape<3>> omega_j = xt::view(u, xt::range(start, start + 3));
-                    xt::xtensor_fixed<double, xt::xshape<3>> rij_j   = c.pj - pos(c.j);
-                    auto Rj                                          = rotation_matrix<3>(q(c.j));
-
-                    auto cross = detail::cross<dim>(rij_j, detail::mat_mult(Rj, omega_j));
-                    for (std::size_t d = 0; d < 3; ++d)
+                    auto v_j = point_velocity(u, j - active_offset, rot_offset, contact_pj(m_contacts, ic) - pos(j), q(j));
+                    for (std::size_t d = 0; d < dim; ++d)
                     {
-                        view(d) -= v_j(d) - cross(d);
+                        view(d) -= v_j(d);
                     }
                 }
-                row += 3;
+                row += dim;
             }
             return m_work;
         }
 
       private:
 
+        /**
+         * @brief Velocity of the point at \c rij from the center of the active particle \c k.
+         */
+        template <class Quaternion>
+        auto point_velocity(const xt::xtensor<double, 1>& u,
+                            std::size_t k,
+                            std::size_t rot_offset,
+                            const xt::xtensor_fixed<double, xt::xshape<dim>>& rij,
+                            const Quaternion& q) const
+        {
+            xt::xtensor_fixed<double, xt::xshape<dim>> out;
+            if constexpr (dim == 2)
+            {
+                // the axis z is invariant by the rotation of the particle: omega is the same in both frames
+                double omega = u(rot_offset + k);
+                out(0)       = u(2 * k) - rij(1) * omega;
+                out(1)       = u(2 * k + 1) + rij(0) * omega;
+            }
+            else
+            {
+                std::size_t start                              = 3 * k;
+                xt::xtensor_fixed<double, xt::xshape<3>> v     = xt::view(u, xt::range(start, start + 3));
+                xt::xtensor_fixed<double, xt::xshape<3>> omega = xt::view(u, xt::range(rot_offset + start, rot_offset + start + 3));
+                auto R                                         = rotation_matrix<3>(q);
+
+                auto cross = detail::cross<dim>(rij, detail::mat_mult(R, omega));
+                for (std::size_t d = 0; d < 3; ++d)
+                {
+                    out(d) = v(d) - cross(d);
+                }
+            }
+            return out;
+        }
+
         const Contacts_t& m_contacts;
         const Particles_t& m_particles;
-        mutable xt::xtensor<double, 1> m_work;
+        xt::xtensor<double, 1> m_own_work;
+        xt::xtensor<double, 1>& m_work;
     };
 
     template <class Contacts_t, class Particles_t>
@@ -158,17 +220,31 @@ namespace scopi
         static constexpr std::size_t dim = Particles_t::dim;
 
         ATMatrix(const Contacts_t& contacts, const Particles_t& particles)
+            : ATMatrix(contacts, particles, m_own_work)
+        {
+        }
+
+        /**
+         * @brief Constructor writing the products in \c work, resized if needed.
+         *
+         * The buffer outlives the operator, so that its memory is reused by the operators of the next time steps.
+         */
+        ATMatrix(const Contacts_t& contacts, const Particles_t& particles, xt::xtensor<double, 1>& work)
             : m_contacts{contacts}
             , m_particles{particles}
-            , m_work{xt::zeros<double>({6 * particles.nb_active()})}
+            , m_work{work}
         {
+            m_work.resize({(dim + detail::rotation_dofs<dim>) * particles.nb_active()});
         }
 
+        ATMatrix(const ATMatrix&)            = delete;
+        ATMatrix& operator=(const ATMatrix&) = delete;
+
         const auto& mat_mult(const xt::xtensor<double, 1>& f) const
         {
             m_work.fill(0.);
             std::size_t active_offset = m_particles.nb_inactive();
-            std::size_t rot_offset    = 3 * m_particles.nb_active();
+            std::size_t rot_offset    = dim * m_particles.nb_active();
             std::size_t row           = 0;
 
             // for (auto& c : m_contacts)
@@ -208,56 +284,62 @@ namespace scopi
 
             auto pos = m_particles.pos();
             auto q   = m_particles.q();
-            for (auto& c : m_contacts)
+            for (std::size_t ic = 0; ic < m_contacts.size(); ++ic)
             {
-                auto f_view = xt::view(f, xt::range(row, row + 3));
-
-                if (c.i >= active_offset)
+                std::size_t i = contact_i(m_contacts, ic);
+                std::size_t j = contact_j(m_contacts, ic);
+                if (i >= active_offset)
                 {
-                    std::size_t start = (c.i - active_offset) * 3;
-                    auto v_i          = xt::view(m_work, xt::range(start, start + 3));
-
-                    start += rot_offset;
-                    auto omega_i                                   = xt::view(m_work, xt::range(start, start + 3));
-                    xt::xtensor_fixed<double, xt::xshape<3>> rij_i = c.pi - pos(c.i);
-                    auto R_i                                       = rotation_matrix<3>(q(c.i));
-
-                    xt::xtensor_fixed<double, xt::xshape<3>> result = detail::mat_mult(xt::transpose(R_i), detail::cross<dim>(rij_i, f_view));
-                    for (std::size_t d = 0; d < 3; ++d)
-                    {
-                        v_i(d) += f_view(d);
-                        omega_i(d) += result(d);
-                    }
-                    // omega_i += result;
+                    add_force(f, row, i - active_offset, rot_offset, contact_pi(m_contacts, ic) - pos(i), q(i), 1.);
                 }
-                if (c.j >= active_offset)
+                if (j >= active_offset)
                 {
-                    std::size_t start = (c.j - active_offset) * 3;
-                    auto v_j          = xt::view(m_work, xt::range(start, start + 3));
-
-                    start += rot_offset;
-                    auto omega_j                                   = xt::view(m_work, xt::range(start, start + 3));
-                    xt::xtensor_fixed<double, xt::xshape<3>> rij_j = c.pj - pos(c.j);
-                    auto R_j                                       = rotation_matrix<3>(q(c.j));
-
-                    xt::xtensor_fixed<double, xt::xshape<3>> result = detail::mat_mult(xt::transpose(R_j), detail::cross<dim>(rij_j, f_view));
-                    for (std::size_t d = 0; d < 3; ++d)
-                    {
-                        v_j(d) -= f_view(d);
-                        omega_j(d) -= result(d);
-                    }
-                    // omega_j -= result;
+                    add_force(f, row, j - active_offset, rot_offset, contact_pj(m_contacts, ic) - pos(j), q(j), -1.);
                 }
-                row += 3;
+                row += dim;
             }
             return m_work;
         }
 
       private:
 
+        /**
+         * @brief Add the force \c f(row:row+dim) applied at \c rij from the center of the active particle \c k, and its torque.
+         */
+        template <class Quaternion>
+        void add_force(const xt::xtensor<double, 1>& f,
+                       std::size_t row,
+                       std::size_t k,
+                       std::size_t rot_offset,
+                       const xt::xtensor_fixed<double, xt::xshape<dim>>& rij,
+                       const Quaternion& q,
+                       double sign) const
+        {
+            if constexpr (dim == 2)
+            {
+                m_work(2 * k) += sign * f(row);
+                m_work(2 * k + 1) += sign * f(row + 1);
+                m_work(rot_offset + k) += sign * (rij(0) * f(row + 1) - rij(1) * f(row));
+            }
+            else
+            {
+                std::size_t start = 3 * k;
+                auto f_view       = xt::view(f, xt::range(row, row + 3));
+                auto R            = rotation_matrix<3>(q);
+
+                xt::xtensor_fixed<double, xt::xshape<3>> torque = detail::mat_mult(xt::transpose(R), detail::cross<dim>(rij, f_view));
+                for (std::size_t d = 0; d < 3; ++d)
+                {
+                    m_work(start + d) += sign * f_view(d);
+                    m_work(rot_offset + start + d) += sign * torque(d);
+                }
+            }
+        }
+
         const Contacts_t& m_contacts;
         const Particles_t& m_particles;
-        mutable xt::xtensor<double, 1> m_work;
+        xt::xtensor<double, 1> m_own_work;
+        xt::xtensor<double, 1>& m_work;
     };
 
     template <class Contacts_t>
@@ -265,9 +347,11 @@ namespace scopi
     {
       public:
 
+        static constexpr std::size_t dim = detail::contact_dim<Contacts_t>;
+
         explicit DMatrix(const Contacts_t& contacts)
             : m_contacts{contacts}
-            , m_work{xt::zeros<double>({3 * contacts.size()})}
+            , m_work{xt::zeros<double>({dim * contacts.size()})}
         {
         }
 
@@ -276,14 +360,14 @@ namespace scopi
             m_work.fill(0.);
             std::size_t row = 0;
 
-            for (auto& c : m_contacts)
+            for (std::size_t ic = 0; ic < m_contacts.size(); ++ic)
             {
-                auto f_view   = xt::view(f, xt::range(row, row + c.nij.shape(0)));
-                auto out_view = xt::view(m_work, xt::range(row, row + c.nij.shape(0)));
+                auto f_view   = xt::view(f, xt::range(row, row + dim));
+                auto out_view = xt::view(m_work, xt::range(row, row + dim));
 
-                xt::noalias(out_view) = c.dij * f_view;
+                xt::noalias(out_view) = contact_dij(m_contacts, ic) * f_view;
 
-                row += 3;
+                row += dim;
             }
             return m_work;
         }
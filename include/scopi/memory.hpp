@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace scopi
+{
+    /**
+     * @brief Allocator returning memory aligned on \c Alignment bytes.
+     *
+     * The default alignment is a cache line, which is also enough for the widest SIMD registers.
+     *
+     * @tparam T Type of the elements.
+     * @tparam Alignment Alignment in bytes (a power of two).
+     */
+    template <class T, std::size_t Alignment = 64>
+    struct aligned_allocator
+    {
+        using value_type = T;
+
+        template <class U>
+        struct rebind
+        {
+            using other = aligned_allocator<U, Alignment>;
+        };
+
+        aligned_allocator() noexcept = default;
+
+        template <class U>
+        aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+    };
+
+    template <class T, class U, std::size_t Alignment>
+    bool operator==(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U, std::size_t Alignment>
+    bool operator!=(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief Contiguous array whose data is aligned on a cache line.
+     */
+    template <class T>
+    using aligned_vector = std::vector<T, aligned_allocator<T>>;
+
+    /**
+     * @brief Allocator placing the large arrays on transparent huge pages.
+     *
+     * The allocations of at least a huge page (2 MiB) are aligned on a huge page and advised with
+     * \c MADV_HUGEPAGE, which reduces the TLB misses when streaming over millions of particles.
+     * The smaller allocations are aligned on a cache line.
+     *
+     * @tparam T Type of the elements.
+     */
+    template <class T>
+    struct huge_page_allocator
+    {
+        using value_type = T;
+
+        static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+        template <class U>
+        struct rebind
+        {
+            using other = huge_page_allocator<U>;
+        };
+
+        huge_page_allocator() noexcept = default;
+
+        template <class U>
+        huge_page_allocator(const huge_page_allocator<U>&) noexcept
+        {
+        }
+
+        T* allocate(std::size_t n)
+        {
+            std::size_t bytes = n * sizeof(T);
+            if (bytes < huge_page_size)
+            {
+                return static_cast<T*>(::operator new(bytes, std::align_val_t(64)));
+            }
+            bytes   = (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+            void* p = ::operator new(bytes, std::align_val_t(huge_page_size));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+            madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (n * sizeof(T) < huge_page_size)
+            {
+                ::operator delete(p, std::align_val_t(64));
+            }
+            else
+            {
+                ::operator delete(p, std::align_val_t(huge_page_size));
+            }
+        }
+    };
+
+    template <class T, class U>
+    bool operator==(const huge_page_allocator<T>&, const huge_page_allocator<U>&) noexcept
+    {
+        return true;
+    }
+
+    template <class T, class U>
+    bool operator!=(const huge_page_allocator<T>&, const huge_page_allocator<U>&) noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief Allocator of the per-particle fields of scopi_container.
+     *
+     * Huge pages are used if SCOPI_USE_HUGE_PAGES is defined (CMake option of the same name).
+     */
+#ifdef SCOPI_USE_HUGE_PAGES
+    template <class T>
+    using particle_allocator = huge_page_allocator<T>;
+#else
+    template <class T>
+    using particle_allocator = aligned_allocator<T>;
+#endif
+
+    template <class T>
+    using particle_vector = std::vector<T, particle_allocator<T>>;
+}
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <tuple>
 
 #include <xtensor-blas/xlinalg.hpp>
 #include <xtensor/xarray.hpp>
@@ -23,6 +26,7 @@ using namespace std;
  *
  * \todo Write documentation.
  *
+ * @tparam N Number of unknowns (2 or 4).
  * @tparam F
  * @tparam A
  * @param n
@@ -31,39 +35,22 @@ using namespace std;
  * @param f
  * @param args
  */
-template <typename F, typename A>
+template <std::size_t N, typename F, typename A>
 void fcn(int n, double x[], double fvec[], int&, F f, A args)
 {
-    if (n == 4)
-    { // n=4 dim=3
-        xt::xtensor_fixed<double, xt::xshape<4>> u;
-        for (int j = 0; j < n; j++)
-        {
-            u(j) = x[j];
-        }
+    static_assert(N == 2 || N == 4, "hybrd solves the closest points between superellipsoids: 2 unknowns in 2D, 4 in 3D");
+    assert(n == static_cast<int>(N));
 
-        auto res = f(u, args);
-        // std::cout << "hybrd1 fcn = "<< res << std::endl;
-        for (int j = 0; j < n; j++)
-        {
-            fvec[j] = res(j);
-        }
+    xt::xtensor_fixed<double, xt::xshape<N>> u;
+    for (int j = 0; j < n; j++)
+    {
+        u(j) = x[j];
     }
 
-    if (n == 2)
-    { // n=2 dim=2
-        xt::xtensor_fixed<double, xt::xshape<2>> u;
-        for (int j = 0; j < n; j++)
-        {
-            u(j) = x[j];
-        }
-
-        auto res = f(u, args);
-        // std::cout << "hybrd1 fcn = "<< res << std::endl;
-        for (int j = 0; j < n; j++)
-        {
-            fvec[j] = res(j);
-        }
+    auto res = f(u, args);
+    for (int j = 0; j < n; j++)
+    {
+        fvec[j] = res(j);
     }
 }
 
@@ -74,6 +61,7 @@ void fcn(int n, double x[], double fvec[], int&, F f, A args)
  *
  * \todo Write documentation.
  *
+ * @tparam N Number of unknowns (2 or 4).
  * @tparam F
  * @tparam DF
  * @tparam A
@@ -84,46 +72,25 @@ void fcn(int n, double x[], double fvec[], int&, F f, A args)
  * @param fjac[]
  * @param ldfjac
  */
-template <typename F, typename DF, typename A>
+template <std::size_t N, typename F, typename DF, typename A>
 void fdjac_analytic(F, DF grad_f, A args, int n, double x[], double[], double fjac[], int ldfjac, int&, int, int, double, double[], double[])
 {
-    if (n == 4)
-    { // n=4 dim=3
-        xt::xtensor_fixed<double, xt::xshape<4>> u;
-        for (int j = 0; j < n; j++)
-        {
-            u(j) = x[j];
-        }
-        auto res = grad_f(u, args);
-        // std::cout << "hybrd1 fdjac_analytic = "<< res << std::endl;
-        for (int j = 0; j < n; j++)
-        {
-            for (int i = 0; i < n; i++)
-            {
-                fjac[i + j * ldfjac] = res(i, j); // res(j,i); // res(i,j);
-            }
-        }
-    }
+    static_assert(N == 2 || N == 4, "hybrd solves the closest points between superellipsoids: 2 unknowns in 2D, 4 in 3D");
+    assert(n == static_cast<int>(N));
 
-    if (n == 2)
-    { // n=2 dim=2
-        xt::xtensor_fixed<double, xt::xshape<2>> u;
-        for (int j = 0; j < n; j++)
+    xt::xtensor_fixed<double, xt::xshape<N>> u;
+    for (int j = 0; j < n; j++)
+    {
+        u(j) = x[j];
+    }
+    auto res = grad_f(u, args);
+    for (int j = 0; j < n; j++)
+    {
+        for (int i = 0; i < n; i++)
         {
-            u(j) = x[j];
-        }
-        auto res = grad_f(u, args);
-        // std::cout << "hybrd1 fdjac_analytic = "<< res << std::endl;
-        for (int j = 0; j < n; j++)
-        {
-            for (int i = 0; i < n; i++)
-            {
-                fjac[i + j * ldfjac] = res(i, j); // res(j,i); // res(i,j);
-            }
+            fjac[i + j * ldfjac] = res(i, j);
         }
     }
-
-    return;
 }
 
 /**
@@ -242,8 +209,9 @@ void dogleg(int n, double r[], int, double diag[], double qtb[], double delta, d
  * @param n
  * @param q[]
  * @param ldq
+ * @param wa[] Work array of size \c m.
  */
-void qform(int m, int n, double q[], int ldq);
+void qform(int m, int n, double q[], int ldq, double wa[]);
 
 //****************************************************************************80
 
@@ -293,8 +261,9 @@ bool r1updt(int m, int n, double s[], int, double u[], double v[], double w[]);
  * @param ipvt[]
  * @param rdiag[]
  * @param acnorm[]
+ * @param wa[] Work array of size \c n.
  */
-void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, double rdiag[], double acnorm[]);
+void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, double rdiag[], double acnorm[], double wa[]);
 
 //****************************************************************************80
 
@@ -303,6 +272,7 @@ void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, doubl
  *
  * \todo Write documentation.
  *
+ * @tparam N Number of unknowns (2 or 4).
  * @tparam F
  * @tparam DF
  * @tparam A
@@ -321,7 +291,7 @@ void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, doubl
  * @param mode
  * @param factor
  * @param nprint
- * @param nfev
+ * @param nfev [out] Number of evaluations of \c f.
  * @param fjac[]
  * @param ldfjac
  * @param r[]
@@ -331,10 +301,11 @@ void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, doubl
  * @param wa2[]
  * @param wa3[]
  * @param wa4[]
+ * @param iter [out] Number of iterations.
  *
  * @return
  */
-template <typename F, typename DF, typename A>
+template <std::size_t N, typename F, typename DF, typename A>
 int hybrd(F f,
           DF grad_f,
           A args,
@@ -350,7 +321,7 @@ int hybrd(F f,
           int mode,
           double factor,
           int nprint,
-          int nfev,
+          int& nfev,
           double fjac[],
           int ldfjac,
           double r[],
@@ -359,7 +330,8 @@ int hybrd(F f,
           double wa1[],
           double wa2[],
           double wa3[],
-          double wa4[])
+          double wa4[],
+          int& iter)
 {
     double actred;
     double delta = 0;
@@ -369,7 +341,6 @@ int hybrd(F f,
     int i;
     int iflag;
     int info;
-    int iter;
     int iwa[1];
     int j;
     bool jeval;
@@ -404,6 +375,7 @@ int hybrd(F f,
     info  = 0;
     iflag = 0;
     nfev  = 0;
+    iter  = 0;
     //
     //  Check the input parameters.
     //
@@ -462,7 +434,7 @@ int hybrd(F f,
     //  Evaluate the function at the starting point and calculate its norm.
     //
     iflag = 1;
-    fcn(n, x, fvec, iflag, f, args);
+    fcn<N>(n, x, fvec, iflag, f, args);
     nfev = 1;
     if (iflag < 0)
     {
@@ -494,7 +466,7 @@ int hybrd(F f,
         //
         iflag = 2;
         // fdjac1 ( f, grad_f, args, n, x, fvec, fjac, ldfjac, iflag, ml, mu, epsfcn, wa1, wa2 );
-        fdjac_analytic(f, grad_f, args, n, x, fvec, fjac, ldfjac, iflag, ml, mu, epsfcn, wa1, wa2);
+        fdjac_analytic<N>(f, grad_f, args, n, x, fvec, fjac, ldfjac, iflag, ml, mu, epsfcn, wa1, wa2);
 
         nfev = nfev + msum;
         if (iflag < 0)
@@ -505,7 +477,7 @@ int hybrd(F f,
         //
         //  Compute the QR factorization of the jacobian.
         //
-        qrfac(n, n, fjac, ldfjac, false, iwa, 1, wa1, wa2);
+        qrfac(n, n, fjac, ldfjac, false, iwa, 1, wa1, wa2, wa3);
         //
         //  On the first iteration and if MODE is 1, scale according
         //  to the norms of the columns of the initial jacobian.
@@ -590,7 +562,7 @@ int hybrd(F f,
         //
         //  Accumulate the orthogonal factor in FJAC.
         //
-        qform(n, n, fjac, ldfjac);
+        qform(n, n, fjac, ldfjac, wa4);
         //
         //  Rescale if necessary.
         //
@@ -614,7 +586,7 @@ int hybrd(F f,
                 if ((iter - 1) % nprint == 0)
                 {
                     iflag = 0;
-                    fcn(n, x, fvec, iflag, f, args);
+                    fcn<N>(n, x, fvec, iflag, f, args);
                     if (iflag < 0)
                     {
                         info = iflag;
@@ -647,7 +619,7 @@ int hybrd(F f,
             //  Evaluate the function at X + P and calculate its norm.
             //
             iflag = 1;
-            fcn(n, wa2, wa4, iflag, f, args);
+            fcn<N>(n, wa2, wa4, iflag, f, args);
             nfev = nfev + 1;
             if (iflag < 0)
             {
@@ -832,94 +804,116 @@ int hybrd(F f,
 
 //****************************************************************************80
 
-// int hybrd1 ( void fcn ( int n, double x[], double fvec[], int &iflag ), int n,
-//   double x[], double fvec[], double tol, double wa[], int lwa ) {
 /**
- * @brief
- *
- * @tparam F
- * @tparam DF
- * @tparam U
- * @tparam A
- * @param u0
- * @param f
- * @param grad_f
- * @param args
- *
- * @return
+ * @brief Report of hybrd.
  */
-template <typename F, typename DF, typename U, typename A>
-auto hybrd1(U u0, F f, DF grad_f, A args)
+struct hybrd_report
 {
-    int n = u0.size();
-    // std::cout << "minpack : u0 = " << u0 << " size n = " << n << std::endl;
-    double epsfcn = 0.0;
-    double factor = 100.0;
-    ;
+    /**
+     * @brief Termination status of hybrd.
+     *
+     * 1 if the relative error between two consecutive iterates is at most \c xtol,
+     * 2 if the number of evaluations of \c f reached its maximum,
+     * 3 if \c xtol is too small to improve the solution,
+     * 4 if the iteration is not making good progress.
+     */
     int info = 0;
-    int j;
-    int lr      = (n * (n + 1)) / 2;
-    int maxfev  = 200 * (n + 1);
-    int ml      = n - 1;
-    int mode    = 2;
-    int mu      = n - 1;
-    int nfev    = 0;
-    int index   = 6 * n + lr;
-    int nprint  = 0;
-    double xtol = 1.0e-10;
-    double* x   = new double[n];
-    for (j = 0; j < n; j++)
-    {
-        x[j] = u0(j);
-    }
-    int lwa = 2 * n * (3 * n + 13); // taille du tableau de travail wa
-    if (lwa < (n * (3 * n + 13)) / 2)
+    /**
+     * @brief Number of evaluations of \c f.
+     */
+    int nfev = 0;
+    /**
+     * @brief Number of iterations.
+     */
+    int iterations = 0;
+    /**
+     * @brief Norm of \c f at the solution.
+     */
+    double fnorm = 0.;
+
+    bool converged() const
     {
-        return std::make_tuple(x, info);
+        return info == 1;
     }
-    double* wa = new double[lwa];
-    for (j = 0; j < n; j++)
+};
+
+/**
+ * @brief Solve \f$ f(u) = 0 \f$ with the hybrid Powell method, for a fixed number of unknowns.
+ *
+ * The Jacobian is given by \c grad_f.
+ * All the work arrays are on the stack: there is no allocation.
+ *
+ * @tparam N Number of unknowns (2 or 4 for the closest points between superellipsoids).
+ * @param u0 [in] Initial guess.
+ * @param f [in] Function.
+ * @param grad_f [in] Jacobian of \c f.
+ * @param args [in] Parameters of \c f and \c grad_f.
+ * @param xtol [in] Relative tolerance between two consecutive iterates.
+ *
+ * @return The solution and the report.
+ */
+template <std::size_t N, typename F, typename DF, typename A>
+auto hybrd(const xt::xtensor_fixed<double, xt::xshape<N>>& u0, F f, DF grad_f, A args, double xtol = 1.0e-10)
+{
+    constexpr int n  = static_cast<int>(N);
+    constexpr int lr = (n * (n + 1)) / 2;
+
+    double x[N];
+    double fvec[N];
+    double diag[N];
+    double fjac[N * N];
+    double r[lr];
+    double qtf[N];
+    double wa1[N];
+    double wa2[N];
+    double wa3[N];
+    double wa4[N];
+    for (int j = 0; j < n; j++)
     {
-        wa[j] = 1.0;
+        x[j]    = u0(j);
+        fvec[j] = 0.;
+        diag[j] = 1.;
     }
-    double* fvec = new double[n];
-    for (j = 0; j < n; j++)
+
+    hybrd_report report;
+    report.info = hybrd<N>(f,
+                        grad_f,
+                        args,
+                        n,
+                        x,
+                        fvec,
+                        xtol,
+                        200 * (n + 1),
+                        n - 1,
+                        n - 1,
+                        0.,
+                        diag,
+                        2,
+                        100.,
+                        0,
+                        report.nfev,
+                        fjac,
+                        n,
+                        r,
+                        lr,
+                        qtf,
+                        wa1,
+                        wa2,
+                        wa3,
+                        wa4,
+                        report.iterations);
+    if (report.info == 5)
     {
-        fvec[j] = 0;
+        report.info = 4;
     }
+    report.fnorm = enorm(n, fvec);
 
-    info = hybrd(f,
-                 grad_f,
-                 args,
-                 n,
-                 x,
-                 fvec,
-                 xtol,
-                 maxfev,
-                 ml,
-                 mu,
-                 epsfcn,
-                 wa,
-                 mode,
-                 factor,
-                 nprint,
-                 nfev,
-                 wa + index,
-                 n,
-                 wa + 6 * n,
-                 lr,
-                 wa + n,
-                 wa + 2 * n,
-                 wa + 3 * n,
-                 wa + 4 * n,
-                 wa + 5 * n);
-    // std::cout << "hybrd : nfev = " << nfev << std::endl;
-    // std::cout << "hybrd : info = " << info << std::endl;
-    if (info == 5)
+    xt::xtensor_fixed<double, xt::xshape<N>> u;
+    for (int j = 0; j < n; j++)
     {
-        info = 4;
+        u(j) = x[j];
     }
-    return std::make_tuple(x, info);
+    return std::make_tuple(u, report);
 }
 
 //****************************************************************************80
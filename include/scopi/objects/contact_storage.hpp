@@ -0,0 +1,325 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include <xtensor/xfixed.hpp>
+
+#include "../contact/property.hpp"
+#include "../memory.hpp"
+#include "neighbor.hpp"
+
+namespace scopi
+{
+    namespace detail
+    {
+        struct empty_field
+        {
+        };
+    }
+
+    /**
+     * @brief Array of contacts stored by fields (structure of arrays).
+     *
+     * The indices of the particles are stored on 32 bits, each component of the normals and of the contact points
+     * in its own aligned array.
+     * The fields which are not used by the problem are not stored: \c sij only exists for the problems solved by
+     * fixed point iterations, and the properties are not stored when they are empty (NoFriction).
+     *
+     * The fields are read through the accessors (\c i(), \c nij(d), ...) which give the contiguous arrays, or one
+     * contact at a time through the functions contact_i, contact_nij, ... which also accept an array of neighbors.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam problem_t Problem to be solved.
+     */
+    template <std::size_t dim, class problem_t_>
+    class contact_storage
+    {
+      public:
+
+        using problem_t     = problem_t_;
+        using index_type    = std::uint32_t;
+        using property_type = contact_property<problem_t>;
+
+        static constexpr bool has_sij      = is_fixed_point_problem_v<problem_t>;
+        static constexpr bool has_property = !std::is_empty_v<property_type>;
+
+        contact_storage() = default;
+
+        explicit contact_storage(const std::vector<neighbor<dim, problem_t>>& contacts)
+        {
+            reserve(contacts.size());
+            for (auto& c : contacts)
+            {
+                push_back(c);
+            }
+        }
+
+        std::size_t size() const
+        {
+            return m_i.size();
+        }
+
+        bool empty() const
+        {
+            return m_i.empty();
+        }
+
+        void reserve(std::size_t size)
+        {
+            m_i.reserve(size);
+            m_j.reserve(size);
+            m_dij.reserve(size);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                m_nij[d].reserve(size);
+                m_pi[d].reserve(size);
+                m_pj[d].reserve(size);
+            }
+            if constexpr (has_sij)
+            {
+                m_sij.reserve(size);
+            }
+            if constexpr (has_property)
+            {
+                m_property.reserve(size);
+            }
+        }
+
+        /**
+         * @brief Append a contact.
+         *
+         * @param c [in] Contact.
+         * @param i [in] Index of the particle \c i (may differ from \c c.i, e.g. for a local numbering).
+         * @param j [in] Index of the particle \c j.
+         */
+        void push_back(const neighbor<dim, problem_t>& c, std::size_t i, std::size_t j)
+        {
+            assert(i <= std::numeric_limits<index_type>::max() && j <= std::numeric_limits<index_type>::max());
+            m_i.push_back(static_cast<index_type>(i));
+            m_j.push_back(static_cast<index_type>(j));
+            m_dij.push_back(c.dij);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                m_nij[d].push_back(c.nij(d));
+                m_pi[d].push_back(c.pi(d));
+                m_pj[d].push_back(c.pj(d));
+            }
+            if constexpr (has_sij)
+            {
+                m_sij.push_back(c.sij);
+            }
+            if constexpr (has_property)
+            {
+                m_property.push_back(c.property);
+            }
+        }
+
+        void push_back(const neighbor<dim, problem_t>& c)
+        {
+            push_back(c, c.i, c.j);
+        }
+
+        const aligned_vector<index_type>& i() const
+        {
+            return m_i;
+        }
+
+        const aligned_vector<index_type>& j() const
+        {
+            return m_j;
+        }
+
+        const aligned_vector<double>& dij() const
+        {
+            return m_dij;
+        }
+
+        /**
+         * @brief Component \c d of the normals.
+         */
+        const aligned_vector<double>& nij(std::size_t d) const
+        {
+            return m_nij[d];
+        }
+
+        /**
+         * @brief Component \c d of the contact points on the particles \c i.
+         */
+        const aligned_vector<double>& pi(std::size_t d) const
+        {
+            return m_pi[d];
+        }
+
+        /**
+         * @brief Component \c d of the contact points on the particles \c j.
+         */
+        const aligned_vector<double>& pj(std::size_t d) const
+        {
+            return m_pj[d];
+        }
+
+        double sij(std::size_t k) const
+        {
+            if constexpr (has_sij)
+            {
+                return m_sij[k];
+            }
+            else
+            {
+                return 0.;
+            }
+        }
+
+        void set_sij(std::size_t k, double value)
+        {
+            static_assert(has_sij, "the problem does not use sij");
+            m_sij[k] = value;
+        }
+
+        const property_type& property(std::size_t k) const
+        {
+            if constexpr (has_property)
+            {
+                return m_property[k];
+            }
+            else
+            {
+                static const property_type empty_property{};
+                return empty_property;
+            }
+        }
+
+      private:
+
+        aligned_vector<index_type> m_i;
+        aligned_vector<index_type> m_j;
+        aligned_vector<double> m_dij;
+        std::array<aligned_vector<double>, dim> m_nij;
+        std::array<aligned_vector<double>, dim> m_pi;
+        std::array<aligned_vector<double>, dim> m_pj;
+        std::conditional_t<has_sij, aligned_vector<double>, detail::empty_field> m_sij;
+        std::conditional_t<has_property, std::vector<property_type>, detail::empty_field> m_property;
+    };
+    /**
+     * @brief Fields of the contact \c k of an array of neighbors or of a contact_storage.
+     *
+     * The operators (AMatrix, ATMatrix, DMatrix, LagrangeMultiplier, ...) read the contacts through these functions,
+     * so that they accept both containers. For a contact_storage, only the requested field is read from its columns.
+     */
+    template <std::size_t dim, class problem_t>
+    std::size_t contact_i(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].i;
+    }
+
+    template <std::size_t dim, class problem_t>
+    std::size_t contact_i(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.i()[k];
+    }
+
+    template <std::size_t dim, class problem_t>
+    std::size_t contact_j(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].j;
+    }
+
+    template <std::size_t dim, class problem_t>
+    std::size_t contact_j(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.j()[k];
+    }
+
+    template <std::size_t dim, class problem_t>
+    double contact_dij(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].dij;
+    }
+
+    template <std::size_t dim, class problem_t>
+    double contact_dij(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.dij()[k];
+    }
+
+    template <std::size_t dim, class problem_t>
+    double contact_sij(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].sij;
+    }
+
+    template <std::size_t dim, class problem_t>
+    double contact_sij(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.sij(k);
+    }
+
+    template <std::size_t dim, class problem_t>
+    const contact_property<problem_t>& property_of(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].property;
+    }
+
+    template <std::size_t dim, class problem_t>
+    const contact_property<problem_t>& property_of(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.property(k);
+    }
+
+    template <std::size_t dim, class problem_t>
+    const xt::xtensor_fixed<double, xt::xshape<dim>>& contact_nij(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].nij;
+    }
+
+    template <std::size_t dim, class problem_t>
+    xt::xtensor_fixed<double, xt::xshape<dim>> contact_nij(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        xt::xtensor_fixed<double, xt::xshape<dim>> out;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            out(d) = contacts.nij(d)[k];
+        }
+        return out;
+    }
+
+    template <std::size_t dim, class problem_t>
+    const xt::xtensor_fixed<double, xt::xshape<dim>>& contact_pi(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].pi;
+    }
+
+    template <std::size_t dim, class problem_t>
+    xt::xtensor_fixed<double, xt::xshape<dim>> contact_pi(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        xt::xtensor_fixed<double, xt::xshape<dim>> out;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            out(d) = contacts.pi(d)[k];
+        }
+        return out;
+    }
+
+    template <std::size_t dim, class problem_t>
+    const xt::xtensor_fixed<double, xt::xshape<dim>>& contact_pj(const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t k)
+    {
+        return contacts[k].pj;
+    }
+
+    template <std::size_t dim, class problem_t>
+    xt::xtensor_fixed<double, xt::xshape<dim>> contact_pj(const contact_storage<dim, problem_t>& contacts, std::size_t k)
+    {
+        xt::xtensor_fixed<double, xt::xshape<dim>> out;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            out(d) = contacts.pj(d)[k];
+        }
+        return out;
+    }
+}
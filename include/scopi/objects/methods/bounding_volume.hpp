@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "../../small_math.hpp"
+#include "../dispatch.hpp"
+#include "../types/capsule.hpp"
+#include "../types/plane.hpp"
+#include "../types/sdf.hpp"
+#include "../types/segment.hpp"
+#include "../types/sphere.hpp"
+#include "../types/superellipsoid.hpp"
+
+namespace scopi
+{
+    /**
+     * @brief Bounding volume which proved that two objects are farther than the maximum distance of the contacts.
+     *
+     * The tests are conservative: a pair is rejected only if the distance between the bounding volumes is larger than
+     * the maximum distance, so that the contacts are the same as without them.
+     */
+    enum class rejection_tier
+    {
+        /**
+         * @brief The pair is not rejected: the closest points must be computed.
+         */
+        none,
+        /**
+         * @brief Rejected by the circumscribed spheres (or the distance between the center and the plane).
+         */
+        sphere,
+        /**
+         * @brief Rejected by the oriented bounding boxes (or the support function of the box for a plane).
+         */
+        oriented_box
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Oriented bounding box of an object.
+         */
+        template <std::size_t dim>
+        struct oriented_box
+        {
+            small::vec<dim> center;
+            /**
+             * @brief Axes of the box (columns).
+             */
+            small::mat<dim> axes;
+            small::vec<dim> half_extents;
+        };
+
+        /**
+         * @brief Oriented bounding box of a superellipsoid.
+         *
+         * Each coordinate of a point of the surface is at most the radius in this direction, whatever the squareness.
+         */
+        template <std::size_t dim, bool owner>
+        oriented_box<dim> bounding_box(const superellipsoid<dim, owner>& s)
+        {
+            return {small::to_vec<dim>(s.pos(0)), small::rotation_matrix<dim>(small::to_quat(s.q(0))), small::to_vec<dim>(s.radius())};
+        }
+
+        /**
+         * @brief Radius of the sphere centered at the center of a superellipsoid which contains it.
+         */
+        template <std::size_t dim, bool owner>
+        double bounding_radius(const superellipsoid<dim, owner>& s)
+        {
+            return small::norm(small::to_vec<dim>(s.radius()));
+        }
+
+        /**
+         * @brief Radius of the sphere centered at the center of a segment which contains it.
+         */
+        template <std::size_t dim, bool owner>
+        double bounding_radius(const segment<dim, owner>& seg)
+        {
+            return 0.5 * seg.length();
+        }
+
+        /**
+         * @brief Radius of the sphere centered at the position of a sdf which contains it.
+         */
+        template <std::size_t dim, bool owner>
+        double bounding_radius(const sdf<dim, owner>& f)
+        {
+            return f.bounding_radius();
+        }
+
+        /**
+         * @brief Radius of the sphere centered at the center of a capsule which contains it.
+         */
+        template <std::size_t dim, bool owner>
+        double bounding_radius(const capsule<dim, owner>& c)
+        {
+            return 0.5 * c.length() + c.radius();
+        }
+
+        /**
+         * @brief Whether the axis \c l separates two boxes, the first one being inflated by \c margin.
+         */
+        template <std::size_t dim>
+        bool is_separating_axis(const oriented_box<dim>& b1, const oriented_box<dim>& b2, const small::vec<dim>& l, double margin)
+        {
+            double r1 = 0.;
+            double r2 = 0.;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                r1 += (b1.half_extents[d] + margin) * std::abs(small::dot(b1.axes.column(d), l));
+                r2 += b2.half_extents[d] * std::abs(small::dot(b2.axes.column(d), l));
+            }
+            return std::abs(small::dot(b2.center - b1.center, l)) > r1 + r2;
+        }
+
+        /**
+         * @brief Whether two oriented boxes are farther than \c margin (separating axis theorem).
+         */
+        template <std::size_t dim>
+        bool are_separated(const oriented_box<dim>& b1, const oriented_box<dim>& b2, double margin)
+        {
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                if (is_separating_axis(b1, b2, b1.axes.column(d), margin) || is_separating_axis(b1, b2, b2.axes.column(d), margin))
+                {
+                    return true;
+                }
+            }
+            if constexpr (dim == 3)
+            {
+                for (std::size_t d1 = 0; d1 < dim; ++d1)
+                {
+                    for (std::size_t d2 = 0; d2 < dim; ++d2)
+                    {
+                        auto l = small::cross(b1.axes.column(d1), b2.axes.column(d2));
+                        // parallel axes: already tested
+                        if (small::squared_norm(l) > 1e-12 && is_separating_axis(b1, b2, l, margin))
+                        {
+                            return true;
+                        }
+                    }
+                }
+            }
+            return false;
+        }
+    }
+
+    /**
+     * @brief Early rejection between two objects, none by default.
+     */
+    template <class T1, class T2>
+    rejection_tier early_rejection(const T1&, const T2&, double)
+    {
+        return rejection_tier::none;
+    }
+
+    // SUPERELLIPSOID - SUPERELLIPSOID
+    /**
+     * @brief Early rejection between two superellipsoids.
+     *
+     * @param s1 [in] Superellipsoid \c i.
+     * @param s2 [in] Superellipsoid \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const superellipsoid<dim, owner>& s1, const superellipsoid<dim, owner>& s2, double dmax)
+    {
+        double center_distance = small::norm(small::to_vec<dim>(s2.pos(0)) - small::to_vec<dim>(s1.pos(0)));
+        if (center_distance - detail::bounding_radius(s1) - detail::bounding_radius(s2) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+        if (detail::are_separated(detail::bounding_box(s1), detail::bounding_box(s2), dmax))
+        {
+            return rejection_tier::oriented_box;
+        }
+        return rejection_tier::none;
+    }
+
+    // SPHERE - SUPERELLIPSOID
+    /**
+     * @brief Early rejection between a sphere and a superellipsoid.
+     *
+     * @param s1 [in] Sphere \c i.
+     * @param s2 [in] Superellipsoid \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const sphere<dim, owner>& s1, const superellipsoid<dim, owner>& s2, double dmax)
+    {
+        auto sphere_center     = small::to_vec<dim>(s1.pos(0));
+        double center_distance = small::norm(sphere_center - small::to_vec<dim>(s2.pos(0)));
+        if (center_distance - s1.radius() - detail::bounding_radius(s2) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+
+        // distance between the center of the sphere and the box, in the frame of the box
+        auto box = detail::bounding_box(s2);
+        small::vec<dim> outside{};
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            double coordinate = small::dot(sphere_center - box.center, box.axes.column(d));
+            outside[d]        = std::max(std::abs(coordinate) - box.half_extents[d], 0.);
+        }
+        if (small::norm(outside) - s1.radius() > dmax)
+        {
+            return rejection_tier::oriented_box;
+        }
+        return rejection_tier::none;
+    }
+
+    // SUPERELLIPSOID - PLANE
+    /**
+     * @brief Early rejection between a superellipsoid and a plane.
+     *
+     * @param s [in] Superellipsoid \c i.
+     * @param p [in] Plane \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const superellipsoid<dim, owner>& s, const plane<dim, owner>& p, double dmax)
+    {
+        auto normal            = small::rotation_matrix<dim>(small::to_quat(p.q(0))).column(0);
+        double center_distance = std::abs(small::dot(small::to_vec<dim>(s.pos(0)) - small::to_vec<dim>(p.pos(0)), normal));
+        if (center_distance - detail::bounding_radius(s) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+
+        // support function of the box in the direction of the normal
+        auto box       = detail::bounding_box(s);
+        double support = 0.;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            support += box.half_extents[d] * std::abs(small::dot(box.axes.column(d), normal));
+        }
+        if (center_distance - support > dmax)
+        {
+            return rejection_tier::oriented_box;
+        }
+        return rejection_tier::none;
+    }
+
+    // SPHERE - SDF
+    /**
+     * @brief Early rejection between a sphere and a sdf.
+     *
+     * @param s [in] Sphere \c i.
+     * @param f [in] Sdf \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const sphere<dim, owner>& s, const sdf<dim, owner>& f, double dmax)
+    {
+        double center_distance = small::norm(small::to_vec<dim>(f.pos(0)) - small::to_vec<dim>(s.pos(0)));
+        if (center_distance - s.radius() - detail::bounding_radius(f) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+        return rejection_tier::none;
+    }
+
+    // SUPERELLIPSOID - SDF
+    /**
+     * @brief Early rejection between a superellipsoid and a sdf.
+     *
+     * @param s [in] Superellipsoid \c i.
+     * @param f [in] Sdf \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const superellipsoid<dim, owner>& s, const sdf<dim, owner>& f, double dmax)
+    {
+        double center_distance = small::norm(small::to_vec<dim>(f.pos(0)) - small::to_vec<dim>(s.pos(0)));
+        if (center_distance - detail::bounding_radius(s) - detail::bounding_radius(f) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+        return rejection_tier::none;
+    }
+
+    // PLANE - SDF
+    /**
+     * @brief Early rejection between a plane and a sdf.
+     *
+     * @param p [in] Plane \c i.
+     * @param f [in] Sdf \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const plane<dim, owner>& p, const sdf<dim, owner>& f, double dmax)
+    {
+        auto normal            = small::rotation_matrix<dim>(small::to_quat(p.q(0))).column(0);
+        double center_distance = std::abs(small::dot(small::to_vec<dim>(f.pos(0)) - small::to_vec<dim>(p.pos(0)), normal));
+        if (center_distance - detail::bounding_radius(f) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+        return rejection_tier::none;
+    }
+
+    // SDF - SDF
+    /**
+     * @brief Early rejection between two sdf.
+     *
+     * @param f1 [in] Sdf \c i.
+     * @param f2 [in] Sdf \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     */
+    template <std::size_t dim, bool owner>
+    rejection_tier early_rejection(const sdf<dim, owner>& f1, const sdf<dim, owner>& f2, double dmax)
+    {
+        double center_distance = small::norm(small::to_vec<dim>(f2.pos(0)) - small::to_vec<dim>(f1.pos(0)));
+        if (center_distance - detail::bounding_radius(f1) - detail::bounding_radius(f2) > dmax)
+        {
+            return rejection_tier::sphere;
+        }
+        return rejection_tier::none;
+    }
+
+    /**
+     * @brief Functor for the early rejection dispatcher.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    struct early_rejection_functor
+    {
+        using return_type = rejection_tier;
+
+        template <class T1, class T2>
+        return_type run(const T1& obj1, const T2& obj2, double dmax) const
+        {
+            return early_rejection(obj1, obj2, dmax);
+        }
+
+        return_type on_error(const object<dim, false>&, const object<dim, false>&, double) const
+        {
+            return rejection_tier::none;
+        }
+    };
+
+    /**
+     * @brief Dispatcher of the early rejection between two objects.
+     *
+     * The dispatch is symmetric: the objects are given to early_rejection in the order of the list of types.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     */
+    template <std::size_t dim, bool owner = false>
+    using early_rejection_dispatcher = double_static_dispatcher<
+        early_rejection_functor<dim>,
+        const object<dim, owner>,
+        mpl::vector<const sphere<dim, owner>,
+                    const superellipsoid<dim, owner>,
+                    const plane<dim, owner>,
+                    const segment<dim, owner>,
+                    const sdf<dim, owner>>,
+        typename early_rejection_functor<dim>::return_type,
+        symmetric_dispatch>;
+}
@@ -1,6 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <xtensor-blas/xlinalg.hpp>
 #include <xtensor/xarray.hpp>
@@ -10,10 +16,15 @@
 #include <xtensor/xview.hpp>
 
 #include "../../minpack.hpp"
+#include "../../small_math.hpp"
 
 #include "../dispatch.hpp"
 #include "../neighbor.hpp"
+#include "bounding_volume.hpp"
+#include "gjk.hpp"
+#include "../types/capsule.hpp"
 #include "../types/plane.hpp"
+#include "../types/sdf.hpp"
 #include "../types/segment.hpp"
 #include "../types/sphere.hpp"
 #include "../types/superellipsoid.hpp"
@@ -37,18 +48,81 @@ namespace scopi
     auto closest_points(const sphere<dim, owner>& si, const sphere<dim, owner>& sj)
     {
         // std::cout << "closest_points : SPHERE - SPHERE" << std::endl;
-        auto si_pos   = xt::view(si.pos(), 0);
-        auto sj_pos   = xt::view(sj.pos(), 0);
-        auto si_to_sj = (sj_pos - si_pos) / xt::linalg::norm(sj_pos - si_pos);
+        auto si_pos   = small::to_vec<dim>(si.pos(0));
+        auto sj_pos   = small::to_vec<dim>(sj.pos(0));
+        auto si_to_sj = small::normalized(sj_pos - si_pos);
+
+        auto pi  = si_pos + si.radius() * si_to_sj;
+        auto pj  = sj_pos - sj.radius() * si_to_sj;
+        auto nij = small::normalized(pj - sj_pos);
 
         neighbor<dim, problem_t> neigh;
-        neigh.pi  = si_pos + si.radius() * si_to_sj;
-        neigh.pj  = sj_pos - sj.radius() * si_to_sj;
-        neigh.nij = (neigh.pj - sj_pos) / xt::linalg::norm(neigh.pj - sj_pos);
-        neigh.dij = xt::linalg::dot(neigh.pi - neigh.pj, neigh.nij)[0];
+        neigh.pi  = small::to_xtensor(pi);
+        neigh.pj  = small::to_xtensor(pj);
+        neigh.nij = small::to_xtensor(nij);
+        neigh.dij = small::dot(pi - pj, nij);
         return neigh;
     }
 
+    namespace detail
+    {
+        /**
+         * @brief Samples of two superellipsoids used as initial guess of the Newton method.
+         *
+         * Minimizes the distance between the samples of the two surfaces, penalized when their normals are not opposite.
+         * Distances and angles do not depend on the frame, so only the samples of \c s1 are moved, into the frame of \c s2:
+         * no temporary array is needed.
+         *
+         * @param s1 [in] Superellipsoid \c i.
+         * @param s2 [in] Superellipsoid \c j.
+         *
+         * @return Indices of the samples of \c s1 and of \c s2 (see superellipsoid::samples).
+         */
+        template <std::size_t dim, bool owner>
+        std::pair<std::size_t, std::size_t> closest_samples(const superellipsoid<dim, owner>& s1, const superellipsoid<dim, owner>& s2)
+        {
+            const auto& samples1 = s1.samples();
+            const auto& samples2 = s2.samples();
+            auto rotation1       = small::rotation_matrix<dim>(small::to_quat(s1.q(0)));
+            auto rotation2_t     = small::transpose(small::rotation_matrix<dim>(small::to_quat(s2.q(0))));
+            auto translation     = small::to_vec<dim>(s1.pos(0)) - small::to_vec<dim>(s2.pos(0));
+
+            std::size_t imin = 0;
+            std::size_t jmin = 0;
+            double dmin      = std::numeric_limits<double>::max();
+            for (std::size_t i = 0; i < samples1.points.size(); i++)
+            {
+                auto point1  = rotation2_t * (rotation1 * samples1.points[i] + translation);
+                auto normal1 = rotation2_t * (rotation1 * samples1.normals[i]);
+                for (std::size_t j = 0; j < samples2.points.size(); j++)
+                {
+                    double d = small::norm(point1 - samples2.points[j]) + 2 * (1 + small::dot(normal1, samples2.normals[j]));
+                    if (d < dmin)
+                    {
+                        dmin = d;
+                        imin = i;
+                        jmin = j;
+                    }
+                }
+            }
+            return {imin, jmin};
+        }
+
+        /**
+         * @brief Distance between the closest points of a neighbor, negative if they overlap along the normal.
+         *
+         * @param neigh [in] Neighbor whose \c pi, \c pj and \c nij are set.
+         */
+        template <std::size_t dim, class problem_t>
+        double signed_distance(const neighbor<dim, problem_t>& neigh)
+        {
+            auto pij    = small::to_vec<dim>(neigh.pi) - small::to_vec<dim>(neigh.pj);
+            double side = small::dot(pij, small::to_vec<dim>(neigh.nij));
+            double sign = (side > 0.) ? 1. : ((side < 0.) ? -1. : 0.);
+            return sign * small::norm(pij);
+        }
+    }
+
     // SUPERELLIPSOID 2D - SUPERELLIPSOID 2D
     /**
      * @brief Neighbor between two superellipsoids in 2D.
@@ -192,56 +266,15 @@ namespace scopi
             return res;
         };
 
-        int num        = 4;
-        auto binit1_xy = xt::unique(xt::adapt(s1.binit_xy(num)));
-        // std::cout << "binit1_xy = " << binit1_xy << std::endl;
-        auto binit2_xy = xt::unique(xt::adapt(s2.binit_xy(num)));
-        // std::cout << "binit2_xy = " << binit2_xy << std::endl;
-
-        xt::xtensor<double, 2> distances = xt::zeros<double>({binit1_xy.size(), binit2_xy.size()});
-        for (std::size_t i = 0; i < binit1_xy.size(); i++)
-        {
-            for (std::size_t j = 0; j < binit2_xy.size(); j++)
-            {
-                distances(i, j) = xt::linalg::norm(xt::flatten(s1.point(binit1_xy(i))) - xt::flatten(s2.point(binit2_xy(j))), 2)
-                                + 2 * (1 + xt::linalg::vdot(s1.normal(binit1_xy(i)), s2.normal(binit2_xy(j))));
-            }
-        }
-        // std::cout << "distances =" << distances << std::endl;
-        auto dmin = xt::amin(distances);
-        // std::cout << "distance min =" << dmin << std::endl;
-        auto indmin = xt::from_indices(xt::where(xt::equal(distances, dmin(0)))); // xt::argmin(distances);
-        // std::cout << "indmin =" << indmin << std::endl;
-        // std::cout << "indmin(0,0) =" << xt::row(indmin,0)(0) << std::endl;
-        // std::cout << "indmin(1,0) =" << xt::row(indmin,1)(0) << std::endl;
-
-        // std::cout << "pt s1 = " << s1.point(binit1_xy(xt::row(indmin,0)(0))) << std::endl;
-        // std::cout << "pt s2 = " << s2.point(binit2_xy(xt::row(indmin,1)(0))) << std::endl;
-        xt::xtensor_fixed<double, xt::xshape<2>> u0 = {binit1_xy(xt::row(indmin, 0)(0)), binit2_xy(xt::row(indmin, 1)(0))};
+        auto [imin, jmin] = detail::closest_samples(s1, s2);
+        xt::xtensor_fixed<double, xt::xshape<2>> u0 = {s1.samples().b[imin], s2.samples().b[jmin]};
         // std::cout << "u0 =" << u0 << std::endl;
-        auto [xx, info] = hybrd1(u0, newton_F, newton_GradF, args);
-        xt::xtensor_fixed<double, xt::xshape<2>> u;
-        for (int j = 0; j < 2; j++)
-        {
-            u(j) = xx[j];
-        }
+        auto [u, report] = hybrd<2>(u0, newton_F, newton_GradF, args);
         // auto [ u, info ] = newton_method(u0,newton_F,newton_GradF,args,2000,1.0e-10,1.0e-7);
-        if (info == -1)
-        {
-            std::cout << "\ns1 : " << std::endl;
-            s1.print();
-            std::cout << "s2 : " << std::endl;
-            s2.print();
-            std::cout << "s1.pos = " << s1.pos() << " s1.rotation = " << xt::flatten(s1.rotation()) << std::endl;
-            std::cout << "s2.pos = " << s2.pos() << " s2.rotation = " << xt::flatten(s2.rotation()) << std::endl;
-            exit(0);
-        }
         neigh.pi  = s1.point(u(0));
         neigh.pj  = s2.point(u(1));
         neigh.nij = s2.normal(u(1));
-        // neigh.dij = xt::linalg::dot(neigh.pi - neigh.pj, neigh.nij)[0];
-        auto xtsign = xt::sign(xt::eval(xt::linalg::dot(xt::flatten(neigh.pi) - xt::flatten(neigh.pj), xt::flatten(neigh.nij))));
-        neigh.dij   = xtsign(0) * xt::linalg::norm(xt::flatten(neigh.pi) - xt::flatten(neigh.pj), 2);
+        neigh.dij = detail::signed_distance<2>(neigh);
         // std::cout << "pi = " << neigh.pi << " pj = " << neigh.pj << std::endl;
         // std::cout << "nij = " << neigh.nij << " dij = " << neigh.dij << std::endl;
 
@@ -601,81 +634,11 @@ namespace scopi
                       + (M20 * A1 + M21 * A2 + M22 * A3) * (-N20 * B15 + N21 * B16);
             return res;
         };
-        const int num = 6;
-        auto binit1   = xt::unique(xt::adapt(s1.binit_xy(num)));
-        auto ainit1   = xt::unique(xt::adapt(s1.ainit_yz(num)));
-
-        // auto binit1_xy = xt::unique(xt::adapt(s1.binit_xy(num)));
-        // std::cout << " binit1_xy = " << binit1_xy << std::endl;
-        // auto ainit1_yz = xt::unique(xt::adapt(s1.ainit_yz(num)));
-        // std::cout << " ainit1_yz = " << ainit1_yz << std::endl;
-        // auto ainit1_xz = xt::unique(xt::adapt(s1.ainit_xz(num)));
-        // std::cout << " ainit1_xz = " << ainit1_xz << std::endl;
-        // // exit(0);
-        // // std::cout << " binit1_xy.size() = " << binit1_xy.size() << " ainit1_yz.size() = " << ainit1_yz.size() << " ainit1_xz.size() =
-        // " << ainit1_xz.size() << std::endl; auto binit1 = xt::concatenate(xt::xtuple(binit1_xy,binit1_xy)); auto ainit1 =
-        // xt::concatenate(xt::xtuple(ainit1_yz,ainit1_xz)); std::cout << " ainit1.size() = " << ainit1.size() << " binit1.size() = " <<
-        // binit1.size() << std::endl;
-        auto [agrid1, bgrid1] = xt::meshgrid(ainit1, binit1);
-        auto fl_agrid1        = xt::flatten(agrid1);
-        auto fl_bgrid1        = xt::flatten(bgrid1);
-        // std::cout << "agrid1 = " << agrid1 << "bgrid1 = " << bgrid1 << std::endl;
-        // std::cout << "flatten agrid1 =" << fl_agrid1 << std::endl;
-        // std::cout << "flatten bgrid1 =" << fl_bgrid1 << std::endl;
-
-        auto binit2 = xt::unique(xt::adapt(s2.binit_xy(num)));
-        auto ainit2 = xt::unique(xt::adapt(s2.ainit_yz(num)));
-        // auto binit2_xy = xt::unique(xt::adapt(s2.binit_xy(num)));
-        // std::cout << " binit2_xy = " << binit2_xy << std::endl;
-        // auto ainit2_yz = xt::unique(xt::adapt(s2.ainit_yz(num)));
-        // std::cout << " ainit2_yz = " << ainit2_yz << std::endl;
-        // auto ainit2_xz = xt::unique(xt::adapt(s2.ainit_xz(num)));
-        // std::cout << " ainit2_xz = " << ainit2_xz << std::endl;
-        // // std::cout << " binit2_xy.size() = " << binit2_xy.size() << " ainit2_yz.size() = " << ainit2_yz.size() << " ainit2_xz.size() =
-        // " << ainit2_xz.size() << std::endl; auto binit2 = xt::concatenate(xt::xtuple(binit2_xy,binit2_xy)); auto ainit2 =
-        // xt::concatenate(xt::xtuple(ainit2_yz,ainit2_xz)); std::cout << " ainit2.size() = " << ainit2.size() << " binit2.size() = " <<
-        // binit2.size() << std::endl;
-        auto [agrid2, bgrid2] = xt::meshgrid(ainit2, binit2);
-        // std::cout << "agrid2 = " << agrid2 << "bgrid2 = " << bgrid2 << std::endl;
-
-        auto fl_agrid2 = xt::flatten(agrid2);
-        auto fl_bgrid2 = xt::flatten(bgrid2);
-        // std::cout << "flatten agrid2 =" << fl_agrid2 << std::endl;
-        // std::cout << "flatten bgrid2 =" << fl_bgrid2 << std::endl;
-        //
-        // std::cout << " fl_agrid1.size() = " << fl_agrid1.size() << " fl_agrid2.size() = " << fl_agrid2.size() << std::endl;
-        xt::xtensor<double, 2> distances = xt::zeros<double>({fl_agrid1.size(), fl_agrid2.size()});
-        for (std::size_t i = 0; i < fl_agrid1.size(); i++)
-        {
-            for (std::size_t j = 0; j < fl_agrid2.size(); j++)
-            {
-                distances(i, j) = xt::linalg::norm(
-                                      xt::flatten(s1.point(fl_agrid1(i), fl_bgrid1(i))) - xt::flatten(s2.point(fl_agrid2(j), fl_bgrid2(j))),
-                                      2)
-                                + 2 * (1 + xt::linalg::vdot(s1.normal(fl_agrid1(i), fl_bgrid1(i)), s2.normal(fl_agrid2(j), fl_bgrid2(j))));
-            }
-        }
-        // std::cout << "distances =" << distances << std::endl;
-        auto dmin = xt::amin(distances);
-        // std::cout << "distance min =" << dmin << std::endl;
-        auto indmin = xt::from_indices(xt::where(xt::equal(distances, dmin(0)))); // xt::argmin(distances);
-        // std::cout << "indmin =" << indmin << std::endl;
-        // std::cout << "indmin(0,0) =" << xt::row(indmin,0)(0) << std::endl;
-        // std::cout << "indmin(1,0) =" << xt::row(indmin,1)(0) << std::endl;
-
-        // for (int l=0; xt::row(indmin,0).size(); ++l){
-        //     std::cout << "l =" << l << " pt s1 = " << s1.point(fl_agrid1(xt::row(indmin,0)(l)),fl_bgrid1(xt::row(indmin,0)(l))) <<
-        //     std::endl; std::cout << "l =" << l << " pt s2 = " <<
-        //     s2.point(fl_agrid1(xt::row(indmin,1)(l)),fl_bgrid1(xt::row(indmin,1)(l))) << std::endl;
-        // }
-        // std::cout << "pt s1 = " << s1.point(fl_agrid1(xt::row(indmin,0)(0)),fl_bgrid1(xt::row(indmin,0)(0))) << std::endl;
-        // std::cout << "pt s2 = " << s2.point(fl_agrid2(xt::row(indmin,1)(0)),fl_bgrid2(xt::row(indmin,1)(0))) << std::endl;
-        // xt::xtensor_fixed<double, xt::xshape<4>> u0 = {fl_agrid1(iindmin(0,0)),fl_bgrid1(indmin(0,1)),
-        //                                                fl_agrid2(indmin(1,0)),fl_bgrid2(indmin(1,1))};
-        xt::xtensor_fixed<double, xt::xshape<4>> u0 = {fl_agrid1(xt::row(indmin, 0)(0)),
-                                                       fl_bgrid1(xt::row(indmin, 0)(0)),
-                                                       fl_agrid2(xt::row(indmin, 1)(0)),
-                                                       fl_bgrid2(xt::row(indmin, 1)(0))};
+        auto [imin, jmin] = detail::closest_samples(s1, s2);
+
+        const auto& samples1                        = s1.samples();
+        const auto& samples2                        = s2.samples();
+        xt::xtensor_fixed<double, xt::xshape<4>> u0 = {samples1.a[imin], samples1.b[imin], samples2.a[jmin], samples2.b[jmin]};
         // std::cout << "u0 =" << u0 << std::endl;
 
         // exit(0);
@@ -696,12 +659,7 @@ namespace scopi
         // xt::xtensor_fixed<double, xt::xshape<4>> u0 = { ainit(indmin(0,0)), binit(indmin(0,0)), ainit(indmin(1,0)), binit(indmin(1,0)) };
         // std::cout << "u0 = "<< u0 << std::endl;
         // std::cout << "newton_GradF(u0,args) = " << newton_GradF(u0,args) << " newton_F(u0,args) = " << newton_F(u0,args) << std::endl;
-        auto [xx, info] = hybrd1(u0, newton_F, newton_GradF, args);
-        xt::xtensor_fixed<double, xt::xshape<4>> u;
-        for (int j = 0; j < 4; j++)
-        {
-            u(j) = xx[j];
-        }
+        auto [u, report] = hybrd<4>(u0, newton_F, newton_GradF, args);
         // std::cout << " u hybr = " << u << std::endl;
         // std::cout << " info hybr = " << info << std::endl;
         // auto [ ubis, infobis ] = newton_method(u0,newton_F,newton_GradF,args,4000,1.0e-8,1.0e-7); //itermax,  ftol,  xtol
@@ -717,15 +675,10 @@ namespace scopi
         // std::cout << "s2.pos = " << s2.pos() << " s2.rotation = " << xt::flatten(s2.rotation()) << std::endl;
         // exit(0);
         // }
-        if (info == -1)
-        {
-            exit(0);
-        }
-        neigh.pi    = s1.point(u(0), u(1));
-        neigh.pj    = s2.point(u(2), u(3));
-        neigh.nij   = s2.normal(u(2), u(3));
-        auto xtsign = xt::sign(xt::eval(xt::linalg::dot(xt::flatten(neigh.pi) - xt::flatten(neigh.pj), xt::flatten(neigh.nij))));
-        neigh.dij   = xtsign(0) * xt::linalg::norm(xt::flatten(neigh.pi) - xt::flatten(neigh.pj), 2);
+        neigh.pi  = s1.point(u(0), u(1));
+        neigh.pj  = s2.point(u(2), u(3));
+        neigh.nij = s2.normal(u(2), u(3));
+        neigh.dij = detail::signed_distance<3>(neigh);
         // std::cout << "pi = " << neigh.pi << " pj = " << neigh.pj << std::endl;
         // std::cout << "nij = " << neigh.nij << " dij = " << neigh.dij << std::endl;
         // std::cout << "dij = " << neigh.dij << std::endl;
@@ -769,20 +722,24 @@ namespace scopi
     auto closest_points(const sphere<dim, owner>& s, const plane<dim, owner>& p)
     {
         // std::cout << "closest_points : SPHERE - PLANE" << std::endl;
-        auto s_pos = s.pos(0);
-        auto p_pos = p.pos(0);
+        auto s_pos = small::to_vec<dim>(s.pos(0));
+        auto p_pos = small::to_vec<dim>(p.pos(0));
 
-        auto normal = p.normal();
+        auto normal = small::rotation_matrix<dim>(small::to_quat(p.q(0))).column(0);
 
         // plan2sphs.n
-        auto plane_to_sphere = xt::eval(xt::linalg::dot(s_pos - p_pos, normal));
-        auto xtsign          = xt::sign(plane_to_sphere);
+        double plane_to_sphere = small::dot(s_pos - p_pos, normal);
+        double sgn             = sign(plane_to_sphere);
+
+        auto pi  = s_pos - sgn * s.radius() * normal;
+        auto pj  = s_pos - plane_to_sphere * normal;
+        auto nij = sgn * normal;
 
         neighbor<dim, problem_t> neigh;
-        neigh.pi  = s_pos - xtsign * s.radius() * normal;
-        neigh.pj  = s_pos - plane_to_sphere * normal;
-        neigh.nij = xtsign * normal;
-        neigh.dij = xt::linalg::dot(neigh.pi - neigh.pj, neigh.nij)[0];
+        neigh.pi  = small::to_xtensor(pi);
+        neigh.pj  = small::to_xtensor(pj);
+        neigh.nij = small::to_xtensor(nij);
+        neigh.dij = small::dot(pi - pj, nij);
         return neigh;
     }
 
@@ -824,37 +781,49 @@ namespace scopi
     template <class problem_t, std::size_t dim, bool owner>
     auto closest_points(const sphere<dim, owner>& s, const segment<dim, owner>& seg)
     {
-        auto s_pos   = s.pos(0);
-        auto seg_pos = seg.extrema();
-
-        auto tangent = seg.tangent();
-
-        neighbor<dim, problem_t> neigh;
-        if (xt::linalg::dot(s_pos - seg_pos[0], tangent)[0] < 0)
+        auto s_pos    = small::to_vec<dim>(s.pos(0));
+        auto seg_pos  = small::to_vec<dim>(seg.pos(0));
+        auto rotation = small::rotation_matrix<dim>(small::to_quat(seg.q(0)));
+
+        // see segment::normal, segment::tangent and segment::extrema
+        auto normal  = rotation.column(0);
+        auto tangent = small::vec<dim>{
+            {-normal[1], normal[0]}
+        };
+        auto half_length = 0.5 * seg.length() * rotation.column(1);
+        auto seg_begin   = seg_pos - half_length;
+        auto seg_end     = seg_pos + half_length;
+
+        small::vec<dim> pi;
+        small::vec<dim> pj;
+        small::vec<dim> nij;
+        if (small::dot(s_pos - seg_begin, tangent) < 0)
         {
-            neigh.nij = xt::eval((s_pos - seg_pos[0]) / xt::linalg::norm(s_pos - seg_pos[0]));
-            neigh.pi  = s_pos - neigh.nij * s.radius();
-            neigh.pj  = seg_pos[0];
-            neigh.dij = xt::linalg::dot(neigh.pi - neigh.pj, neigh.nij)[0];
+            nij = small::normalized(s_pos - seg_begin);
+            pi  = s_pos - s.radius() * nij;
+            pj  = seg_begin;
         }
-        else if (xt::linalg::dot(s_pos - seg_pos[1], tangent)[0] > 0)
+        else if (small::dot(s_pos - seg_end, tangent) > 0)
         {
-            neigh.nij = xt::eval((s_pos - seg_pos[1]) / xt::linalg::norm(s_pos - seg_pos[1]));
-            neigh.pi  = s_pos - neigh.nij * s.radius();
-            neigh.pj  = seg_pos[1];
-            neigh.dij = xt::linalg::dot(neigh.pi - neigh.pj, neigh.nij)[0];
+            nij = small::normalized(s_pos - seg_end);
+            pi  = s_pos - s.radius() * nij;
+            pj  = seg_end;
         }
         else
         {
-            auto normal            = seg.normal();
-            auto segment_to_sphere = xt::eval(xt::linalg::dot(s_pos - seg.pos(0), normal));
-            auto xtsign            = xt::sign(segment_to_sphere);
-
-            neigh.pi  = s_pos - xtsign * s.radius() * normal;
-            neigh.pj  = s_pos - segment_to_sphere * normal;
-            neigh.nij = xtsign * normal;
-            neigh.dij = xt::linalg::dot(neigh.pi - neigh.pj, neigh.nij)[0];
+            double segment_to_sphere = small::dot(s_pos - seg_pos, normal);
+            double sgn               = sign(segment_to_sphere);
+
+            pi  = s_pos - sgn * s.radius() * normal;
+            pj  = s_pos - segment_to_sphere * normal;
+            nij = sgn * normal;
         }
+
+        neighbor<dim, problem_t> neigh;
+        neigh.pi  = small::to_xtensor(pi);
+        neigh.pj  = small::to_xtensor(pj);
+        neigh.nij = small::to_xtensor(nij);
+        neigh.dij = small::dot(pi - pj, nij);
         return neigh;
     }
 
@@ -882,51 +851,459 @@ namespace scopi
 
     // SEGMENT - SEGMENT
     /**
-     * @brief Neighbor between two segments.
+     * @brief Neighbor between two segments, computed by GJK/EPA.
      *
      * See neighbor.hpp.
      *
      * @tparam dim Dimension (2 or 3).
      * @tparam owner
-     * @param s1 [in] Plane \c i.
-     * @param s2 [in] Plane \c j.
+     * @param s1 [in] Segment \c i.
+     * @param s2 [in] Segment \c j.
      *
-     * @return
      * @return Neighbor struct for contact between segment \c i and segment \c j.
      */
     template <class problem_t, std::size_t dim, bool owner>
-    auto closest_points(const segment<dim, owner>&, const segment<dim, owner>&)
+    auto closest_points(const segment<dim, owner>& s1, const segment<dim, owner>& s2)
     {
-        std::cerr << "closest_points for segment/segment must be implemented" << std::endl;
-        return neighbor<dim, problem_t>();
+        return gjk_closest_points<problem_t>(s1, s2);
     }
 
+    // PLANE - SEGMENT
+    /**
+     * @brief Neighbor between a plane and a segment, computed with the support mapping of the segment.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param p [in] Plane \c i.
+     * @param seg [in] Segment \c j.
+     *
+     * @return Neighbor struct for contact between plane \c i and segment \c j.
+     */
     template <class problem_t, std::size_t dim, bool owner>
-    auto closest_points(const plane<dim, owner>&, const segment<dim, owner>&)
+    auto closest_points(const plane<dim, owner>& p, const segment<dim, owner>& seg)
     {
-        std::cerr << "closest_points for plane/segment must be implemented" << std::endl;
-        return neighbor<dim, problem_t>();
+        return gjk_closest_points<problem_t>(p, seg);
     }
 
+    // SEGMENT - PLANE
+    /**
+     * @brief Neighbor between a segment and a plane, computed with the support mapping of the segment.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param seg [in] Segment \c i.
+     * @param p [in] Plane \c j.
+     *
+     * @return Neighbor struct for contact between segment \c i and plane \c j.
+     */
     template <class problem_t, std::size_t dim, bool owner>
-    auto closest_points(const segment<dim, owner>&, const plane<dim, owner>&)
+    auto closest_points(const segment<dim, owner>& seg, const plane<dim, owner>& p)
     {
-        std::cerr << "closest_points for segment/plane must be implemented" << std::endl;
-        return neighbor<dim, problem_t>();
+        return gjk_closest_points<problem_t>(seg, p);
     }
 
+    // SUPERELLIPSOID - SEGMENT
+    /**
+     * @brief Neighbor between a superellipsoid and a segment, computed by GJK/EPA.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param s [in] Superellipsoid \c i.
+     * @param seg [in] Segment \c j.
+     *
+     * @return Neighbor struct for contact between superellipsoid \c i and segment \c j.
+     */
     template <class problem_t, std::size_t dim, bool owner>
-    auto closest_points(const superellipsoid<dim, owner>&, const segment<dim, owner>&)
+    auto closest_points(const superellipsoid<dim, owner>& s, const segment<dim, owner>& seg)
     {
-        std::cerr << "closest_points for superellipsoid/segment must be implemented" << std::endl;
-        return neighbor<dim, problem_t>();
+        return gjk_closest_points<problem_t>(s, seg);
     }
 
+    // SEGMENT - SUPERELLIPSOID
+    /**
+     * @brief Neighbor between a segment and a superellipsoid, computed by GJK/EPA.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param seg [in] Segment \c i.
+     * @param s [in] Superellipsoid \c j.
+     *
+     * @return Neighbor struct for contact between segment \c i and superellipsoid \c j.
+     */
     template <class problem_t, std::size_t dim, bool owner>
-    auto closest_points(const segment<dim, owner>&, const superellipsoid<dim, owner>&)
+    auto closest_points(const segment<dim, owner>& seg, const superellipsoid<dim, owner>& s)
     {
-        std::cerr << "closest_points for segment/superellipsoid must be implemented" << std::endl;
-        return neighbor<dim, problem_t>();
+        return gjk_closest_points<problem_t>(seg, s);
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Extremities of the axis of a capsule.
+         */
+        template <std::size_t dim, bool owner>
+        std::array<small::vec<dim>, 2> axis_extrema(const capsule<dim, owner>& c)
+        {
+            auto center    = small::to_vec<dim>(c.pos(0));
+            auto half_axis = 0.5 * c.length() * small::rotation_matrix<dim>(small::to_quat(c.q(0))).column(0);
+            return {center - half_axis, center + half_axis};
+        }
+
+        /**
+         * @brief Extremities of a segment (see segment::extrema).
+         */
+        template <std::size_t dim, bool owner>
+        std::array<small::vec<dim>, 2> axis_extrema(const segment<dim, owner>& seg)
+        {
+            auto center      = small::to_vec<dim>(seg.pos(0));
+            auto half_length = 0.5 * seg.length() * small::rotation_matrix<dim>(small::to_quat(seg.q(0))).column(1);
+            return {center - half_length, center + half_length};
+        }
+
+        /**
+         * @brief Closest points of the segments \c [p1, q1] and \c [p2, q2] (Ericson, Real-Time Collision Detection, 5.1.9).
+         *
+         * If the segments are parallel, the first extremity of the first segment is chosen.
+         *
+         * @return The point of the first segment and the point of the second segment.
+         */
+        template <std::size_t dim>
+        std::array<small::vec<dim>, 2>
+        closest_points_segments(const small::vec<dim>& p1, const small::vec<dim>& q1, const small::vec<dim>& p2, const small::vec<dim>& q2)
+        {
+            constexpr double eps = 1e-14;
+            auto d1              = q1 - p1;
+            auto d2              = q2 - p2;
+            auto r               = p1 - p2;
+            double a             = small::dot(d1, d1);
+            double e             = small::dot(d2, d2);
+            double f             = small::dot(d2, r);
+
+            double s = 0.;
+            double t = 0.;
+            if (a <= eps && e <= eps)
+            {
+                return {p1, p2};
+            }
+            if (a <= eps)
+            {
+                t = std::clamp(f / e, 0., 1.);
+            }
+            else
+            {
+                double c = small::dot(d1, r);
+                if (e <= eps)
+                {
+                    s = std::clamp(-c / a, 0., 1.);
+                }
+                else
+                {
+                    double b     = small::dot(d1, d2);
+                    double denom = a * e - b * b;
+                    s            = denom > 0. ? std::clamp((b * f - c * e) / denom, 0., 1.) : 0.;
+                    t            = (b * s + f) / e;
+                    if (t < 0.)
+                    {
+                        t = 0.;
+                        s = std::clamp(-c / a, 0., 1.);
+                    }
+                    else if (t > 1.)
+                    {
+                        t = 1.;
+                        s = std::clamp((b - c) / a, 0., 1.);
+                    }
+                }
+            }
+            return {p1 + s * d1, p2 + t * d2};
+        }
+
+        /**
+         * @brief Neighbor between two objects which are the points at distance \c ri of a core (point or segment).
+         *
+         * @param ci [in] Point of the core of \c i closest to the core of \c j.
+         * @param ri [in] Radius of \c i.
+         * @param cj [in] Point of the core of \c j closest to the core of \c i.
+         * @param rj [in] Radius of \c j.
+         * @param fallback [in] Normal used if the cores intersect.
+         */
+        template <class problem_t, std::size_t dim>
+        auto rounded_neighbor(const small::vec<dim>& ci, double ri, const small::vec<dim>& cj, double rj, const small::vec<dim>& fallback)
+        {
+            auto cj_to_ci   = ci - cj;
+            double distance = small::norm(cj_to_ci);
+            auto nij        = distance > 0. ? cj_to_ci / distance : fallback;
+
+            auto pi = ci - ri * nij;
+            auto pj = cj + rj * nij;
+
+            neighbor<dim, problem_t> neigh;
+            neigh.pi  = small::to_xtensor(pi);
+            neigh.pj  = small::to_xtensor(pj);
+            neigh.nij = small::to_xtensor(nij);
+            neigh.dij = small::dot(pi - pj, nij);
+            return neigh;
+        }
+
+        /**
+         * @brief Unit vector orthogonal to the axis of a capsule or of a segment, on the side of the point \c p.
+         */
+        template <std::size_t dim, class T>
+        small::vec<dim> normal_to_axis(const T& obj, const small::vec<dim>& p)
+        {
+            auto extrema = axis_extrema(obj);
+            auto axis    = extrema[1] - extrema[0];
+            auto center  = small::to_vec<dim>(obj.pos(0));
+            auto n       = p - center;
+            double axis2 = small::squared_norm(axis);
+            if (axis2 > 0.)
+            {
+                n -= (small::dot(n, axis) / axis2) * axis;
+            }
+            if (small::squared_norm(n) > 0.)
+            {
+                return small::normalized(n);
+            }
+            // p is on the axis: any direction orthogonal to it
+            if constexpr (dim == 2)
+            {
+                return small::normalized(small::vec<dim>{
+                    {-axis[1], axis[0]}
+                });
+            }
+            else
+            {
+                small::vec<dim> e{};
+                e[std::abs(axis[0]) < std::abs(axis[1]) ? 0 : 1] = 1.;
+                return small::normalized(small::cross(axis, e));
+            }
+        }
+    }
+
+    // CAPSULE - CAPSULE
+    /**
+     * @brief Neighbor between two capsules.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param c1 [in] Capsule \c i.
+     * @param c2 [in] Capsule \c j.
+     *
+     * @return Neighbor struct for contact between capsule \c i and capsule \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const capsule<dim, owner>& c1, const capsule<dim, owner>& c2)
+    {
+        auto e1     = detail::axis_extrema(c1);
+        auto e2     = detail::axis_extrema(c2);
+        auto points = detail::closest_points_segments(e1[0], e1[1], e2[0], e2[1]);
+        return detail::rounded_neighbor<problem_t>(points[0],
+                                                   c1.radius(),
+                                                   points[1],
+                                                   c2.radius(),
+                                                   detail::normal_to_axis(c2, small::to_vec<dim>(c1.pos(0))));
+    }
+
+    // SPHERE - CAPSULE
+    /**
+     * @brief Neighbor between a sphere and a capsule.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param s [in] Sphere \c i.
+     * @param c [in] Capsule \c j.
+     *
+     * @return Neighbor struct for contact between sphere \c i and capsule \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const sphere<dim, owner>& s, const capsule<dim, owner>& c)
+    {
+        auto center = small::to_vec<dim>(s.pos(0));
+        auto e      = detail::axis_extrema(c);
+        auto points = detail::closest_points_segments(center, center, e[0], e[1]);
+        return detail::rounded_neighbor<problem_t>(center, s.radius(), points[1], c.radius(), detail::normal_to_axis(c, center));
+    }
+
+    // CAPSULE - SPHERE
+    /**
+     * @brief Neighbor between a capsule and a sphere.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param c [in] Capsule \c i.
+     * @param s [in] Sphere \c j.
+     *
+     * @return Neighbor struct for contact between capsule \c i and sphere \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const capsule<dim, owner>& c, const sphere<dim, owner>& s)
+    {
+        auto neigh = closest_points<problem_t>(s, c);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+
+    // CAPSULE - SEGMENT
+    /**
+     * @brief Neighbor between a capsule and a segment.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param c [in] Capsule \c i.
+     * @param seg [in] Segment \c j.
+     *
+     * @return Neighbor struct for contact between capsule \c i and segment \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const capsule<dim, owner>& c, const segment<dim, owner>& seg)
+    {
+        auto e1     = detail::axis_extrema(c);
+        auto e2     = detail::axis_extrema(seg);
+        auto points = detail::closest_points_segments(e1[0], e1[1], e2[0], e2[1]);
+        return detail::rounded_neighbor<problem_t>(points[0],
+                                                   c.radius(),
+                                                   points[1],
+                                                   0.,
+                                                   detail::normal_to_axis(seg, small::to_vec<dim>(c.pos(0))));
+    }
+
+    // SEGMENT - CAPSULE
+    /**
+     * @brief Neighbor between a segment and a capsule.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param seg [in] Segment \c i.
+     * @param c [in] Capsule \c j.
+     *
+     * @return Neighbor struct for contact between segment \c i and capsule \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const segment<dim, owner>& seg, const capsule<dim, owner>& c)
+    {
+        auto neigh = closest_points<problem_t>(c, seg);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+
+    // CAPSULE - PLANE
+    /**
+     * @brief Neighbor between a capsule and a plane.
+     *
+     * The contact point is the extremity of the axis closest to the plane, or the center of the capsule if the axis is
+     * parallel to the plane.
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param c [in] Capsule \c i.
+     * @param p [in] Plane \c j.
+     *
+     * @return Neighbor struct for contact between capsule \c i and plane \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const capsule<dim, owner>& c, const plane<dim, owner>& p)
+    {
+        auto c_pos  = small::to_vec<dim>(c.pos(0));
+        auto p_pos  = small::to_vec<dim>(p.pos(0));
+        auto normal = small::rotation_matrix<dim>(small::to_quat(p.q(0))).column(0);
+        auto e      = detail::axis_extrema(c);
+
+        // side of the plane where the capsule is
+        double sgn = sign(small::dot(c_pos - p_pos, normal));
+        double d0  = sgn * small::dot(e[0] - p_pos, normal);
+        double d1  = sgn * small::dot(e[1] - p_pos, normal);
+        auto core  = d0 < d1 ? e[0] : (d1 < d0 ? e[1] : c_pos);
+
+        auto nij = sgn * normal;
+        auto pi  = core - c.radius() * nij;
+        auto pj  = core - small::dot(core - p_pos, normal) * normal;
+
+        neighbor<dim, problem_t> neigh;
+        neigh.pi  = small::to_xtensor(pi);
+        neigh.pj  = small::to_xtensor(pj);
+        neigh.nij = small::to_xtensor(nij);
+        neigh.dij = small::dot(pi - pj, nij);
+        return neigh;
+    }
+
+    // PLANE - CAPSULE
+    /**
+     * @brief Neighbor between a plane and a capsule.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param p [in] Plane \c i.
+     * @param c [in] Capsule \c j.
+     *
+     * @return Neighbor struct for contact between plane \c i and capsule \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const plane<dim, owner>& p, const capsule<dim, owner>& c)
+    {
+        auto neigh = closest_points<problem_t>(c, p);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+
+    // CAPSULE - SUPERELLIPSOID
+    /**
+     * @brief Neighbor between a capsule and a superellipsoid, computed by GJK/EPA.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param c [in] Capsule \c i.
+     * @param s [in] Superellipsoid \c j.
+     *
+     * @return Neighbor struct for contact between capsule \c i and superellipsoid \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const capsule<dim, owner>& c, const superellipsoid<dim, owner>& s)
+    {
+        return gjk_closest_points<problem_t>(c, s);
+    }
+
+    // SUPERELLIPSOID - CAPSULE
+    /**
+     * @brief Neighbor between a superellipsoid and a capsule, computed by GJK/EPA.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param s [in] Superellipsoid \c i.
+     * @param c [in] Capsule \c j.
+     *
+     * @return Neighbor struct for contact between superellipsoid \c i and capsule \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const superellipsoid<dim, owner>& s, const capsule<dim, owner>& c)
+    {
+        return gjk_closest_points<problem_t>(s, c);
     }
 
     // SUPERELLIPSOID 3D - SPHERE 3D
@@ -1957,6 +2334,282 @@ namespace scopi
         return neigh;
     }
 
+    namespace detail
+    {
+        /**
+         * @brief Deepest surface point of a sdf with respect to another object.
+         *
+         * The surface points farther than the best one from the bounding sphere of the other object are skipped.
+         *
+         * @tparam dim Dimension (2 or 3).
+         * @tparam owner
+         * @param f [in] Sdf \c i.
+         * @param center [in] Center of the bounding sphere of the object \c j.
+         * @param radius [in] Radius of the bounding sphere of the object \c j.
+         * @param distance [in] Signed distance to the object \c j and its outer normal at a point.
+         *
+         * @return Neighbor struct for contact between sdf \c i and object \c j, with an infinite distance if the sdf has
+         * no surface point.
+         */
+        template <class problem_t, std::size_t dim, bool owner, class D>
+        neighbor<dim, problem_t> deepest_surface_point(const sdf<dim, owner>& f, const small::vec<dim>& center, double radius, D&& distance)
+        {
+            auto r     = small::rotation_matrix<dim>(small::to_quat(f.q(0)));
+            auto f_pos = small::to_vec<dim>(f.pos(0));
+
+            neighbor<dim, problem_t> neigh{};
+            neigh.dij = std::numeric_limits<double>::max();
+            for (const auto& sample : f.grid().surface_points())
+            {
+                auto x = f_pos + r * sample;
+                if (small::norm(x - center) - radius >= neigh.dij)
+                {
+                    continue;
+                }
+
+                small::vec<dim> n;
+                double d = distance(x, n);
+                if (d < neigh.dij)
+                {
+                    neigh.pi  = small::to_xtensor(x);
+                    neigh.pj  = small::to_xtensor(x - d * n);
+                    neigh.nij = small::to_xtensor(n);
+                    neigh.dij = d;
+                }
+            }
+            return neigh;
+        }
+    }
+
+    // SPHERE - SDF
+    /**
+     * @brief Neighbor between a sphere and a sdf.
+     *
+     * The closest point of the sdf is given by the signed distance and its gradient at the center of the sphere.
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param s [in] Sphere \c i.
+     * @param f [in] Sdf \c j.
+     *
+     * @return Neighbor struct for contact between sphere \c i and sdf \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const sphere<dim, owner>& s, const sdf<dim, owner>& f)
+    {
+        auto s_pos = small::to_vec<dim>(s.pos(0));
+        small::vec<dim> n;
+        double phi = f.signed_distance(s_pos, n);
+
+        neighbor<dim, problem_t> neigh;
+        neigh.pi  = small::to_xtensor(s_pos - s.radius() * n);
+        neigh.pj  = small::to_xtensor(s_pos - phi * n);
+        neigh.nij = small::to_xtensor(n);
+        neigh.dij = phi - s.radius();
+        return neigh;
+    }
+
+    // SDF - SPHERE
+    /**
+     * @brief Neighbor between a sdf and a sphere.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param f [in] Sdf \c i.
+     * @param s [in] Sphere \c j.
+     *
+     * @return Neighbor struct for contact between sdf \c i and sphere \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const sdf<dim, owner>& f, const sphere<dim, owner>& s)
+    {
+        auto neigh = closest_points<problem_t>(s, f);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+
+    // SDF - PLANE
+    /**
+     * @brief Neighbor between a sdf and a plane.
+     *
+     * The contact point is the surface point of the sdf closest to the plane.
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param f [in] Sdf \c i.
+     * @param p [in] Plane \c j.
+     *
+     * @return Neighbor struct for contact between sdf \c i and plane \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const sdf<dim, owner>& f, const plane<dim, owner>& p)
+    {
+        auto p_pos  = small::to_vec<dim>(p.pos(0));
+        auto normal = small::rotation_matrix<dim>(small::to_quat(p.q(0))).column(0);
+        // side of the plane where the sdf is
+        auto nij = static_cast<double>(sign(small::dot(small::to_vec<dim>(f.pos(0)) - p_pos, normal))) * normal;
+
+        return detail::deepest_surface_point<problem_t>(f,
+                                                        p_pos,
+                                                        std::numeric_limits<double>::infinity(),
+                                                        [&](const small::vec<dim>& x, small::vec<dim>& n)
+                                                        {
+                                                            n = nij;
+                                                            return small::dot(x - p_pos, nij);
+                                                        });
+    }
+
+    // PLANE - SDF
+    /**
+     * @brief Neighbor between a plane and a sdf.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param p [in] Plane \c i.
+     * @param f [in] Sdf \c j.
+     *
+     * @return Neighbor struct for contact between plane \c i and sdf \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const plane<dim, owner>& p, const sdf<dim, owner>& f)
+    {
+        auto neigh = closest_points<problem_t>(f, p);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+
+    // SDF - SDF
+    /**
+     * @brief Neighbor between two sdf.
+     *
+     * The surface points of each sdf are tested against the signed distance of the other one, the deepest point is
+     * kept.
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param f1 [in] Sdf \c i.
+     * @param f2 [in] Sdf \c j.
+     *
+     * @return Neighbor struct for contact between sdf \c i and sdf \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    auto closest_points(const sdf<dim, owner>& f1, const sdf<dim, owner>& f2)
+    {
+        auto neigh12 = detail::deepest_surface_point<problem_t>(f1,
+                                                                small::to_vec<dim>(f2.pos(0)),
+                                                                f2.bounding_radius(),
+                                                                [&](const small::vec<dim>& x, small::vec<dim>& n)
+                                                                {
+                                                                    return f2.signed_distance(x, n);
+                                                                });
+        auto neigh21 = detail::deepest_surface_point<problem_t>(f2,
+                                                                small::to_vec<dim>(f1.pos(0)),
+                                                                f1.bounding_radius(),
+                                                                [&](const small::vec<dim>& x, small::vec<dim>& n)
+                                                                {
+                                                                    return f1.signed_distance(x, n);
+                                                                });
+        if (neigh21.dij < neigh12.dij)
+        {
+            neigh21.nij *= -1.;
+            std::swap(neigh21.pi, neigh21.pj);
+            return neigh21;
+        }
+        return neigh12;
+    }
+
+    // SDF - CONVEX OBJECT
+    /**
+     * @brief Neighbor between a sdf and a convex object (superellipsoid, segment, capsule).
+     *
+     * The distance between a surface point of the sdf and the object is computed by GJK/EPA.
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param f [in] Sdf \c i.
+     * @param obj [in] Object \c j.
+     *
+     * @return Neighbor struct for contact between sdf \c i and object \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner, template <std::size_t, bool> class T>
+    auto closest_points(const sdf<dim, owner>& f, const T<dim, owner>& obj)
+    {
+        auto center = small::to_vec<dim>(obj.pos(0));
+        return detail::deepest_surface_point<problem_t>(f,
+                                                        center,
+                                                        detail::bounding_radius(obj),
+                                                        [&](const small::vec<dim>& x, small::vec<dim>& n)
+                                                        {
+                                                            auto result = gjk_epa<dim>(
+                                                                [&](const small::vec<dim>&)
+                                                                {
+                                                                    return x;
+                                                                },
+                                                                [&](const small::vec<dim>& d)
+                                                                {
+                                                                    return support(obj, d);
+                                                                },
+                                                                x,
+                                                                center);
+                                                            n = result.normal;
+                                                            return small::dot(result.pa - result.pb, n);
+                                                        });
+    }
+
+    // CONVEX OBJECT - SDF
+    /**
+     * @brief Neighbor between a convex object (superellipsoid, segment, capsule) and a sdf.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param obj [in] Object \c i.
+     * @param f [in] Sdf \c j.
+     *
+     * @return Neighbor struct for contact between object \c i and sdf \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner, template <std::size_t, bool> class T>
+    auto closest_points(const T<dim, owner>& obj, const sdf<dim, owner>& f)
+    {
+        auto neigh = closest_points<problem_t>(f, obj);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+
+    /**
+     * @brief Whether the closest points between two types of objects are computed by GJK/EPA instead of closest_points.
+     *
+     * The pairs without a dedicated method already use GJK/EPA (see gjk_closest_points).
+     * Specialize this trait to use it for a pair with a dedicated method, for example to compare it with the Newton
+     * method of the superellipsoids; as the dispatch is antisymmetric, both orders of the pair must be specialized:
+     *
+     * @code
+     * template <std::size_t dim, bool owner>
+     * struct use_gjk<superellipsoid<dim, owner>, superellipsoid<dim, owner>> : std::true_type
+     * {
+     * };
+     * @endcode
+     *
+     * @tparam T1 Type of the object \c i.
+     * @tparam T2 Type of the object \c j.
+     */
+    template <class T1, class T2>
+    struct use_gjk : std::false_type
+    {
+    };
+
     /**
      * @brief
      *
@@ -1987,7 +2640,14 @@ namespace scopi
         template <class T1, class T2>
         return_type run(const T1& obj1, const T2& obj2) const
         {
-            return closest_points<problem_t>(obj1, obj2);
+            if constexpr (use_gjk<T1, T2>::value)
+            {
+                return gjk_closest_points<problem_t>(obj1, obj2);
+            }
+            else
+            {
+                return closest_points<problem_t>(obj1, obj2);
+            }
         }
 
         /**
@@ -2038,7 +2698,12 @@ namespace scopi
     using closest_points_dispatcher = double_static_dispatcher<
         closest_points_functor<problem_t, dim>,
         const object<dim, owner>,
-        mpl::vector<const sphere<dim, owner>, const superellipsoid<dim, owner>, const plane<dim, owner>, const segment<dim, owner>>,
+        mpl::vector<const sphere<dim, owner>,
+                    const superellipsoid<dim, owner>,
+                    const plane<dim, owner>,
+                    const segment<dim, owner>,
+                    const capsule<dim, owner>,
+                    const sdf<dim, owner>>,
         typename closest_points_functor<problem_t, dim>::return_type,
         antisymmetric_dispatch>;
 }
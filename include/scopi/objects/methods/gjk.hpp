@@ -0,0 +1,949 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "../../small_math.hpp"
+#include "../../utils.hpp"
+#include "../neighbor.hpp"
+#include "../types/capsule.hpp"
+#include "../types/plane.hpp"
+#include "../types/segment.hpp"
+#include "../types/sphere.hpp"
+#include "../types/superellipsoid.hpp"
+
+namespace scopi
+{
+    /**
+     * @brief Maximal number of iterations of GJK.
+     */
+    constexpr std::size_t gjk_max_iterations = 128;
+    /**
+     * @brief Maximal number of iterations of EPA.
+     */
+    constexpr std::size_t epa_max_iterations = 256;
+    /**
+     * @brief Relative tolerance of GJK on the distance and absolute tolerance of EPA on the penetration depth.
+     */
+    constexpr double gjk_tolerance = 1e-10;
+
+    //////////////////////
+    // support mappings //
+    //////////////////////
+
+    /**
+     * @brief Point of the sphere which maximizes the scalar product with the direction \c d.
+     *
+     * @param s [in] Sphere.
+     * @param d [in] Direction (not necessarily unit).
+     */
+    template <std::size_t dim, bool owner>
+    small::vec<dim> support(const sphere<dim, owner>& s, const small::vec<dim>& d)
+    {
+        auto center = small::to_vec<dim>(s.pos(0));
+        double n    = small::norm(d);
+        return n > 0. ? center + (s.radius() / n) * d : center;
+    }
+
+    /**
+     * @brief Point of the segment which maximizes the scalar product with the direction \c d.
+     *
+     * @param seg [in] Segment.
+     * @param d [in] Direction (not necessarily unit).
+     */
+    template <std::size_t dim, bool owner>
+    small::vec<dim> support(const segment<dim, owner>& seg, const small::vec<dim>& d)
+    {
+        // see segment::extrema
+        auto half_length = 0.5 * seg.length() * small::rotation_matrix<dim>(small::to_quat(seg.q(0))).column(1);
+        return small::to_vec<dim>(seg.pos(0)) + sign(small::dot(d, half_length)) * half_length;
+    }
+
+    /**
+     * @brief Point of the capsule which maximizes the scalar product with the direction \c d.
+     *
+     * @param c [in] Capsule.
+     * @param d [in] Direction (not necessarily unit).
+     */
+    template <std::size_t dim, bool owner>
+    small::vec<dim> support(const capsule<dim, owner>& c, const small::vec<dim>& d)
+    {
+        auto half_axis = 0.5 * c.length() * small::rotation_matrix<dim>(small::to_quat(c.q(0))).column(0);
+        auto core      = small::to_vec<dim>(c.pos(0)) + sign(small::dot(d, half_axis)) * half_axis;
+        double n       = small::norm(d);
+        return n > 0. ? core + (c.radius() / n) * d : core;
+    }
+
+    namespace detail
+    {
+        /**
+         * @brief Unit vector of the \f$ p \f$-norm, \f$ p = 2/e \f$, which maximizes the scalar product with \c c.
+         *
+         * It is given by the dual norm: \f$ y_i \propto \mathrm{sign}(c_i) |c_i|^{e/(2-e)} \f$.
+         * For \f$ e \ge 2 \f$, the unit ball is (the convex hull of) a diamond whose vertex in the direction of the largest
+         * component of \c c is returned.
+         *
+         * @param c [in] Direction.
+         * @param e [in] Squareness.
+         */
+        template <std::size_t N>
+        small::vec<N> dual_unit(const small::vec<N>& c, double e)
+        {
+            std::size_t k = 0;
+            double cmax   = 0.;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                if (std::abs(c[i]) > cmax)
+                {
+                    cmax = std::abs(c[i]);
+                    k    = i;
+                }
+            }
+
+            small::vec<N> y{};
+            if (cmax == 0.)
+            {
+                y[0] = 1.;
+                return y;
+            }
+            if (e >= 2.)
+            {
+                y[k] = sign(c[k]);
+                return y;
+            }
+
+            // scaled by the largest component to avoid overflows of the power
+            double exponent = e / (2. - e);
+            double norm_p   = 0.;
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                y[i] = sign(c[i]) * std::pow(std::abs(c[i]) / cmax, exponent);
+                norm_p += std::pow(std::abs(y[i]), 2. / e);
+            }
+            return y / std::pow(norm_p, e / 2.);
+        }
+    }
+
+    /**
+     * @brief Point of the superellipsoid which maximizes the scalar product with the direction \c d.
+     *
+     * The implicit surface is \f$ |x/r_0|^{2/e} + |y/r_1|^{2/e} = 1 \f$ in 2D and
+     * \f$ \left( |x/r_0|^{2/e} + |y/r_1|^{2/e} \right)^{e/n} + |z/r_2|^{2/n} = 1 \f$ in 3D, so that the support point
+     * is given by the dual norm of the (nested) \f$ p \f$-norms, without iterations.
+     * For a squareness larger than 2 (non convex superellipsoid), it is the support point of its convex hull.
+     *
+     * @param s [in] Superellipsoid.
+     * @param d [in] Direction (not necessarily unit).
+     */
+    template <std::size_t dim, bool owner>
+    small::vec<dim> support(const superellipsoid<dim, owner>& s, const small::vec<dim>& d)
+    {
+        auto rotation = small::rotation_matrix<dim>(small::to_quat(s.q(0)));
+        auto radius   = small::to_vec<dim>(s.radius());
+
+        // direction in the frame of the superellipsoid, scaled by the radiuses
+        auto c = small::transpose(rotation) * d;
+        for (std::size_t k = 0; k < dim; ++k)
+        {
+            c[k] *= radius[k];
+        }
+
+        small::vec<dim> y;
+        if constexpr (dim == 2)
+        {
+            y = detail::dual_unit(c, s.squareness()(0));
+        }
+        else
+        {
+            small::vec<2> c_xy{
+                {c[0], c[1]}
+            };
+            auto y_xy = detail::dual_unit(c_xy, s.squareness()(0));
+            small::vec<2> c_z{
+                {small::dot(c_xy, y_xy), c[2]}
+            };
+            auto y_z = detail::dual_unit(c_z, s.squareness()(1));
+            y        = {
+                {y_z[0] * y_xy[0], y_z[0] * y_xy[1], y_z[1]}
+            };
+        }
+
+        for (std::size_t k = 0; k < dim; ++k)
+        {
+            y[k] *= radius[k];
+        }
+        return rotation * y + small::to_vec<dim>(s.pos(0));
+    }
+
+    /**
+     * @brief Result of GJK/EPA between two convex objects \c A and \c B.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    struct gjk_result
+    {
+        /**
+         * @brief Point of \c A which realizes the distance (the deepest point if the objects overlap).
+         */
+        small::vec<dim> pa;
+        /**
+         * @brief Point of \c B which realizes the distance (the deepest point if the objects overlap).
+         */
+        small::vec<dim> pb;
+        /**
+         * @brief Unit normal from \c B to \c A.
+         */
+        small::vec<dim> normal;
+        /**
+         * @brief Signed distance, negative if the objects overlap.
+         */
+        double distance;
+        /**
+         * @brief Number of iterations of GJK and of EPA.
+         */
+        std::size_t iterations = 0;
+        /**
+         * @brief Whether the objects overlap (the result is given by EPA).
+         */
+        bool penetration = false;
+        /**
+         * @brief Whether the tolerance has been reached before the maximal number of iterations.
+         */
+        bool converged = false;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Vertex of the simplex of GJK: point of the Minkowski difference \f$ A - B \f$ and its two support points.
+         */
+        template <std::size_t dim>
+        struct simplex_vertex
+        {
+            small::vec<dim> w;
+            small::vec<dim> a;
+            small::vec<dim> b;
+        };
+
+        /**
+         * @brief Point of a subset of the simplex, as barycentric coordinates of its vertices.
+         */
+        struct barycentric
+        {
+            std::size_t size;
+            std::array<std::size_t, 4> index;
+            std::array<double, 4> lambda;
+        };
+
+        template <std::size_t dim>
+        small::vec<dim> barycentric_point(const simplex_vertex<dim>* s, const barycentric& bc)
+        {
+            small::vec<dim> v{};
+            for (std::size_t k = 0; k < bc.size; ++k)
+            {
+                v += bc.lambda[k] * s[bc.index[k]].w;
+            }
+            return v;
+        }
+
+        /**
+         * @brief Point of the segment \c [s[i0], s[i1]] closest to the origin.
+         */
+        template <std::size_t dim>
+        barycentric closest_on_segment(const simplex_vertex<dim>* s, std::size_t i0, std::size_t i1)
+        {
+            auto e    = s[i1].w - s[i0].w;
+            double ee = small::squared_norm(e);
+            if (ee <= 0.)
+            {
+                return {1, {i1}, {1.}};
+            }
+            double t = -small::dot(s[i0].w, e) / ee;
+            if (t <= 0.)
+            {
+                return {1, {i0}, {1.}};
+            }
+            if (t >= 1.)
+            {
+                return {1, {i1}, {1.}};
+            }
+            return {
+                2,
+                {i0, i1},
+                {1. - t, t}
+            };
+        }
+
+        /**
+         * @brief Point of the triangle \c [s[i0], s[i1], s[i2]] closest to the origin (Ericson, Real-Time Collision Detection, 5.1.5).
+         *
+         * @param interior [out] Whether the point is inside the triangle (in 2D, the triangle contains the origin).
+         */
+        template <std::size_t dim>
+        barycentric closest_on_triangle(const simplex_vertex<dim>* s, std::size_t i0, std::size_t i1, std::size_t i2, bool& interior)
+        {
+            interior = false;
+            auto a   = s[i0].w;
+            auto b   = s[i1].w;
+            auto c   = s[i2].w;
+            auto ab  = b - a;
+            auto ac  = c - a;
+
+            double d1 = -small::dot(ab, a);
+            double d2 = -small::dot(ac, a);
+            if (d1 <= 0. && d2 <= 0.)
+            {
+                return {1, {i0}, {1.}};
+            }
+            double d3 = -small::dot(ab, b);
+            double d4 = -small::dot(ac, b);
+            if (d3 >= 0. && d4 <= d3)
+            {
+                return {1, {i1}, {1.}};
+            }
+            double vc = d1 * d4 - d3 * d2;
+            if (vc <= 0. && d1 >= 0. && d3 <= 0.)
+            {
+                double t = d1 / (d1 - d3);
+                return {
+                    2,
+                    {i0, i1},
+                    {1. - t, t}
+                };
+            }
+            double d5 = -small::dot(ab, c);
+            double d6 = -small::dot(ac, c);
+            if (d6 >= 0. && d5 <= d6)
+            {
+                return {1, {i2}, {1.}};
+            }
+            double vb = d5 * d2 - d1 * d6;
+            if (vb <= 0. && d2 >= 0. && d6 <= 0.)
+            {
+                double t = d2 / (d2 - d6);
+                return {
+                    2,
+                    {i0, i2},
+                    {1. - t, t}
+                };
+            }
+            double va = d3 * d6 - d5 * d4;
+            if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+            {
+                double t = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+                return {
+                    2,
+                    {i1, i2},
+                    {1. - t, t}
+                };
+            }
+
+            double denom = va + vb + vc;
+            if (denom <= std::numeric_limits<double>::min())
+            {
+                // flat triangle: closest edge
+                barycentric best = closest_on_segment(s, i0, i1);
+                for (auto bc : {closest_on_segment(s, i0, i2), closest_on_segment(s, i1, i2)})
+                {
+                    if (small::squared_norm(barycentric_point(s, bc)) < small::squared_norm(barycentric_point(s, best)))
+                    {
+                        best = bc;
+                    }
+                }
+                return best;
+            }
+            interior = true;
+            return {
+                3,
+                {i0, i1, i2},
+                {va / denom, vb / denom, vc / denom}
+            };
+        }
+
+        /**
+         * @brief Point of the tetrahedron \c s closest to the origin (3D).
+         *
+         * @param contained [out] Whether the tetrahedron contains the origin.
+         */
+        inline barycentric closest_on_tetrahedron(const simplex_vertex<3>* s, bool& contained)
+        {
+            static constexpr std::size_t faces[4][4] = {
+                {0, 1, 2, 3},
+                {0, 2, 3, 1},
+                {0, 3, 1, 2},
+                {1, 3, 2, 0}
+            };
+
+            double scale = 0.;
+            for (std::size_t k = 1; k < 4; ++k)
+            {
+                scale = std::max(scale, small::norm(s[k].w - s[0].w));
+            }
+            double volume = small::dot(s[3].w - s[0].w, small::cross(s[1].w - s[0].w, s[2].w - s[0].w));
+            bool flat     = std::abs(volume) <= 1e-12 * scale * scale * scale;
+
+            contained = !flat;
+            barycentric best{0, {}, {}};
+            double best_distance = std::numeric_limits<double>::max();
+            for (auto& f : faces)
+            {
+                auto normal          = small::cross(s[f[1]].w - s[f[0]].w, s[f[2]].w - s[f[0]].w);
+                double origin_side   = -small::dot(s[f[0]].w, normal);
+                double opposite_side = small::dot(s[f[3]].w - s[f[0]].w, normal);
+                if (flat || origin_side * opposite_side < 0.)
+                {
+                    contained = false;
+                    bool interior;
+                    auto bc         = closest_on_triangle(s, f[0], f[1], f[2], interior);
+                    double distance = small::squared_norm(barycentric_point(s, bc));
+                    if (distance < best_distance)
+                    {
+                        best_distance = distance;
+                        best          = bc;
+                    }
+                }
+            }
+            return best;
+        }
+
+        /**
+         * @brief Replace the simplex by its subset closest to the origin.
+         *
+         * @param s [inout] Vertices of the simplex.
+         * @param n [inout] Number of vertices.
+         * @param lambda [out] Barycentric coordinates of \c v in the reduced simplex.
+         * @param v [out] Point of the simplex closest to the origin.
+         *
+         * @return false if the simplex is full and contains the origin.
+         */
+        template <std::size_t dim>
+        bool reduce_simplex(std::array<simplex_vertex<dim>, dim + 1>& s,
+                            std::size_t& n,
+                            std::array<double, dim + 1>& lambda,
+                            small::vec<dim>& v)
+        {
+            barycentric bc{
+                1,
+                {0},
+                {1.}
+            };
+            bool interior = false;
+            if (n == 2)
+            {
+                bc = closest_on_segment(s.data(), 0, 1);
+            }
+            else if (n == 3)
+            {
+                bc = closest_on_triangle(s.data(), 0, 1, 2, interior);
+                if constexpr (dim == 2)
+                {
+                    if (interior)
+                    {
+                        return false;
+                    }
+                }
+            }
+            else if (n == 4)
+            {
+                if constexpr (dim == 3)
+                {
+                    bool contained;
+                    bc = closest_on_tetrahedron(s.data(), contained);
+                    if (contained)
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            v = barycentric_point(s.data(), bc);
+            std::array<simplex_vertex<dim>, dim + 1> reduced;
+            for (std::size_t k = 0; k < bc.size; ++k)
+            {
+                reduced[k] = s[bc.index[k]];
+                lambda[k]  = bc.lambda[k];
+            }
+            s = reduced;
+            n = bc.size;
+            return true;
+        }
+
+        /**
+         * @brief Whether the vertex \c x is affinely independent of the \c n vertices of the simplex.
+         */
+        template <std::size_t dim>
+        bool is_independent(const std::array<simplex_vertex<dim>, dim + 1>& s, std::size_t n, const small::vec<dim>& x)
+        {
+            constexpr double eps = 1e-12;
+            if (n == 0)
+            {
+                return true;
+            }
+            auto f = x - s[0].w;
+            if (n == 1)
+            {
+                return small::norm(f) > eps;
+            }
+            auto e = s[1].w - s[0].w;
+            if (n == 2)
+            {
+                if constexpr (dim == 2)
+                {
+                    return std::abs(small::cross(e, f)) > eps * small::norm(e);
+                }
+                else
+                {
+                    return small::norm(small::cross(e, f)) > eps * small::norm(e);
+                }
+            }
+            if constexpr (dim == 3)
+            {
+                auto normal = small::cross(e, s[2].w - s[0].w);
+                return std::abs(small::dot(normal, f)) > eps * small::norm(normal);
+            }
+            return false;
+        }
+
+        /**
+         * @brief Point of the Minkowski difference \f$ A - B \f$ which maximizes the scalar product with \c d.
+         */
+        template <std::size_t dim, class SA, class SB>
+        simplex_vertex<dim> minkowski_support(SA& support_a, SB& support_b, const small::vec<dim>& d)
+        {
+            simplex_vertex<dim> x;
+            x.a = support_a(d);
+            x.b = support_b(-d);
+            x.w = x.a - x.b;
+            return x;
+        }
+
+        /**
+         * @brief Add vertices to the simplex until it is full (a triangle in 2D, a tetrahedron in 3D).
+         *
+         * Used when GJK stops with a simplex of lower dimension because the objects touch.
+         *
+         * @return false if the Minkowski difference is flat.
+         */
+        template <std::size_t dim, class SA, class SB>
+        bool blow_up_simplex(std::array<simplex_vertex<dim>, dim + 1>& s, std::size_t& n, SA& support_a, SB& support_b)
+        {
+            while (n < dim + 1)
+            {
+                std::vector<small::vec<dim>> directions;
+                if (n >= 2)
+                {
+                    auto e = s[1].w - s[0].w;
+                    if constexpr (dim == 2)
+                    {
+                        directions.push_back({
+                            {-e[1], e[0]}
+                        });
+                    }
+                    else
+                    {
+                        if (n == 3)
+                        {
+                            directions.push_back(small::cross(e, s[2].w - s[0].w));
+                        }
+                        else
+                        {
+                            for (std::size_t k = 0; k < dim; ++k)
+                            {
+                                small::vec<dim> axis{};
+                                axis[k] = 1.;
+                                directions.push_back(small::cross(e, axis));
+                            }
+                        }
+                    }
+                }
+                for (std::size_t k = 0; k < dim; ++k)
+                {
+                    small::vec<dim> axis{};
+                    axis[k] = 1.;
+                    directions.push_back(axis);
+                }
+
+                bool added = false;
+                for (auto& d : directions)
+                {
+                    for (double sgn : {1., -1.})
+                    {
+                        auto x = minkowski_support<dim>(support_a, support_b, sgn * d);
+                        if (is_independent(s, n, x.w))
+                        {
+                            s[n++] = x;
+                            added  = true;
+                            break;
+                        }
+                    }
+                    if (added)
+                    {
+                        break;
+                    }
+                }
+                if (!added)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief EPA in 2D: expands the polygon from the simplex which contains the origin.
+         */
+        template <class SA, class SB>
+        void epa(std::array<simplex_vertex<2>, 3>& s, SA& support_a, SB& support_b, gjk_result<2>& result)
+        {
+            std::vector<simplex_vertex<2>> polygon(s.begin(), s.end());
+            // counterclockwise
+            if (small::cross(polygon[1].w - polygon[0].w, polygon[2].w - polygon[0].w) < 0.)
+            {
+                std::swap(polygon[1], polygon[2]);
+            }
+
+            std::size_t edge = 0;
+            small::vec<2> normal{};
+            double distance = 0.;
+            for (std::size_t it = 0; it < epa_max_iterations; ++it)
+            {
+                ++result.iterations;
+                distance = std::numeric_limits<double>::max();
+                for (std::size_t i = 0; i < polygon.size(); ++i)
+                {
+                    auto e = polygon[(i + 1) % polygon.size()].w - polygon[i].w;
+                    small::vec<2> n{
+                        {e[1], -e[0]}
+                    };
+                    double length = small::norm(n);
+                    if (length == 0.)
+                    {
+                        continue;
+                    }
+                    n /= length;
+                    double d = small::dot(n, polygon[i].w);
+                    if (d < distance)
+                    {
+                        distance = d;
+                        normal   = n;
+                        edge     = i;
+                    }
+                }
+
+                auto x = minkowski_support<2>(support_a, support_b, normal);
+                if (small::dot(x.w, normal) - distance <= gjk_tolerance)
+                {
+                    result.converged = true;
+                    break;
+                }
+                polygon.insert(polygon.begin() + static_cast<std::ptrdiff_t>(edge + 1), x);
+            }
+
+            const auto& v0 = polygon[edge];
+            const auto& v1 = polygon[(edge + 1) % polygon.size()];
+            auto e          = v1.w - v0.w;
+            double t        = std::clamp(small::dot(distance * normal - v0.w, e) / small::squared_norm(e), 0., 1.);
+            result.pa       = (1. - t) * v0.a + t * v1.a;
+            result.pb       = (1. - t) * v0.b + t * v1.b;
+            result.normal   = -normal;
+            result.distance = -distance;
+        }
+
+        /**
+         * @brief EPA in 3D: expands the polytope from the simplex which contains the origin.
+         */
+        template <class SA, class SB>
+        void epa(std::array<simplex_vertex<3>, 4>& s, SA& support_a, SB& support_b, gjk_result<3>& result)
+        {
+            struct face
+            {
+                std::array<std::size_t, 3> index;
+                small::vec<3> normal;
+                double distance;
+            };
+
+            std::vector<simplex_vertex<3>> vertices(s.begin(), s.end());
+            auto make_face = [&](std::size_t i0, std::size_t i1, std::size_t i2)
+            {
+                face f{
+                    {i0, i1, i2},
+                    small::cross(vertices[i1].w - vertices[i0].w, vertices[i2].w - vertices[i0].w),
+                    std::numeric_limits<double>::max()
+                };
+                double length = small::norm(f.normal);
+                if (length > 0.)
+                {
+                    f.normal /= length;
+                    f.distance = small::dot(f.normal, vertices[i0].w);
+                }
+                return f;
+            };
+
+            // outer normals: the face (0, 1, 2) is opposite to the vertex 3
+            if (small::dot(small::cross(vertices[1].w - vertices[0].w, vertices[2].w - vertices[0].w), vertices[3].w - vertices[0].w) > 0.)
+            {
+                std::swap(vertices[1], vertices[2]);
+            }
+            std::vector<face> faces = {make_face(0, 1, 2), make_face(0, 2, 3), make_face(0, 3, 1), make_face(1, 3, 2)};
+
+            std::size_t closest = 0;
+            for (std::size_t it = 0; it < epa_max_iterations; ++it)
+            {
+                ++result.iterations;
+                closest = 0;
+                for (std::size_t k = 1; k < faces.size(); ++k)
+                {
+                    if (faces[k].distance < faces[closest].distance)
+                    {
+                        closest = k;
+                    }
+                }
+
+                auto x = minkowski_support<3>(support_a, support_b, faces[closest].normal);
+                if (small::dot(x.w, faces[closest].normal) - faces[closest].distance <= gjk_tolerance)
+                {
+                    result.converged = true;
+                    break;
+                }
+
+                // remove the faces seen from the new vertex and keep their boundary (horizon)
+                std::size_t new_index = vertices.size();
+                vertices.push_back(x);
+                std::vector<std::pair<std::size_t, std::size_t>> horizon;
+                std::vector<face> kept;
+                for (auto& f : faces)
+                {
+                    if (small::dot(f.normal, x.w - vertices[f.index[0]].w) > 0.)
+                    {
+                        for (std::size_t k = 0; k < 3; ++k)
+                        {
+                            std::pair<std::size_t, std::size_t> e{f.index[k], f.index[(k + 1) % 3]};
+                            auto reverse = std::find(horizon.begin(), horizon.end(), std::make_pair(e.second, e.first));
+                            if (reverse != horizon.end())
+                            {
+                                horizon.erase(reverse);
+                            }
+                            else
+                            {
+                                horizon.push_back(e);
+                            }
+                        }
+                    }
+                    else
+                    {
+                        kept.push_back(f);
+                    }
+                }
+                if (horizon.empty())
+                {
+                    break;
+                }
+                for (auto& e : horizon)
+                {
+                    kept.push_back(make_face(e.first, e.second, new_index));
+                }
+                faces = std::move(kept);
+            }
+
+            // barycentric coordinates of the projection of the origin on the closest face
+            const auto& f  = faces[closest];
+            const auto& v0 = vertices[f.index[0]];
+            const auto& v1 = vertices[f.index[1]];
+            const auto& v2 = vertices[f.index[2]];
+            auto e0        = v1.w - v0.w;
+            auto e1        = v2.w - v0.w;
+            auto e2        = f.distance * f.normal - v0.w;
+            double d00     = small::dot(e0, e0);
+            double d01     = small::dot(e0, e1);
+            double d11     = small::dot(e1, e1);
+            double d20     = small::dot(e2, e0);
+            double d21     = small::dot(e2, e1);
+            double denom   = d00 * d11 - d01 * d01;
+            double l1      = denom > 0. ? (d11 * d20 - d01 * d21) / denom : 0.;
+            double l2      = denom > 0. ? (d00 * d21 - d01 * d20) / denom : 0.;
+            double l0      = 1. - l1 - l2;
+
+            result.pa       = l0 * v0.a + l1 * v1.a + l2 * v2.a;
+            result.pb       = l0 * v0.b + l1 * v1.b + l2 * v2.b;
+            result.normal   = -f.normal;
+            result.distance = -f.distance;
+        }
+    }
+
+    /**
+     * @brief Distance (GJK) or penetration (EPA) between two convex objects given by their support mappings.
+     *
+     * GJK iterates on a simplex of the Minkowski difference \f$ A - B \f$ until its closest point to the origin is
+     * within gjk_tolerance of the distance. If the simplex contains the origin, the objects overlap and EPA expands it
+     * into a polytope until its closest face to the origin gives the penetration depth.
+     * Both are bounded by a maximal number of iterations.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param support_a [in] Support mapping of \c A: direction -> point of \c A.
+     * @param support_b [in] Support mapping of \c B: direction -> point of \c B.
+     * @param center_a [in] Point inside \c A.
+     * @param center_b [in] Point inside \c B.
+     */
+    template <std::size_t dim, class SA, class SB>
+    gjk_result<dim> gjk_epa(SA support_a, SB support_b, const small::vec<dim>& center_a, const small::vec<dim>& center_b)
+    {
+        gjk_result<dim> result;
+
+        small::vec<dim> v = center_a - center_b;
+        if (small::squared_norm(v) == 0.)
+        {
+            v[0] = 1.;
+        }
+
+        std::array<detail::simplex_vertex<dim>, dim + 1> s;
+        std::array<double, dim + 1> lambda = {1.};
+        std::size_t n                      = 1;
+        s[0]                               = detail::minkowski_support<dim>(support_a, support_b, -v);
+        v                                  = s[0].w;
+
+        bool overlap = false;
+        for (; result.iterations < gjk_max_iterations; ++result.iterations)
+        {
+            double vv = small::squared_norm(v);
+            // the objects touch
+            if (vv <= 1e-24)
+            {
+                overlap = true;
+                break;
+            }
+
+            auto x = detail::minkowski_support<dim>(support_a, support_b, -v);
+            if (vv - small::dot(v, x.w) <= gjk_tolerance * vv || !detail::is_independent(s, n, x.w))
+            {
+                result.converged = true;
+                break;
+            }
+
+            s[n++] = x;
+            if (!detail::reduce_simplex(s, n, lambda, v))
+            {
+                overlap = true;
+                break;
+            }
+        }
+
+        // closest points of the simplex (meaningful if it is not full)
+        result.pa = {};
+        result.pb = {};
+        for (std::size_t k = 0; k < n; ++k)
+        {
+            result.pa += lambda[k] * s[k].a;
+            result.pb += lambda[k] * s[k].b;
+        }
+        if (!overlap)
+        {
+            result.distance = small::norm(v);
+            result.normal   = v / result.distance;
+            return result;
+        }
+
+        result.penetration = true;
+        if (!detail::blow_up_simplex(s, n, support_a, support_b))
+        {
+            // flat Minkowski difference: the objects touch
+            auto direction   = center_a - center_b;
+            result.distance  = 0.;
+            result.normal    = small::squared_norm(direction) > 0. ? small::normalized(direction) : small::vec<dim>{{1.}};
+            result.converged = true;
+            return result;
+        }
+        detail::epa(s, support_a, support_b, result);
+        return result;
+    }
+
+    /**
+     * @brief Neighbor between two convex objects with bounded support mappings, computed by GJK/EPA.
+     *
+     * It can be used for any pair of sphere, superellipsoid and segment (see use_gjk in closest_points.hpp).
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param obj1 [in] Object \c i.
+     * @param obj2 [in] Object \c j.
+     *
+     * @return Neighbor struct for contact between object \c i and object \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner, template <std::size_t, bool> class T1, template <std::size_t, bool> class T2>
+    auto gjk_closest_points(const T1<dim, owner>& obj1, const T2<dim, owner>& obj2)
+    {
+        auto result = gjk_epa<dim>(
+            [&](const small::vec<dim>& d)
+            {
+                return support(obj1, d);
+            },
+            [&](const small::vec<dim>& d)
+            {
+                return support(obj2, d);
+            },
+            small::to_vec<dim>(obj1.pos(0)),
+            small::to_vec<dim>(obj2.pos(0)));
+
+        neighbor<dim, problem_t> neigh;
+        neigh.pi  = small::to_xtensor(result.pa);
+        neigh.pj  = small::to_xtensor(result.pb);
+        neigh.nij = small::to_xtensor(result.normal);
+        neigh.dij = small::dot(result.pa - result.pb, result.normal);
+        return neigh;
+    }
+
+    /**
+     * @brief Neighbor between a convex object and a plane, computed with the support mapping of the object.
+     *
+     * The contact point of the object is its support point in the direction of the plane.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param obj [in] Object \c i.
+     * @param p [in] Plane \c j.
+     *
+     * @return Neighbor struct for contact between object \c i and plane \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner, template <std::size_t, bool> class T>
+    auto gjk_closest_points(const T<dim, owner>& obj, const plane<dim, owner>& p)
+    {
+        auto p_pos  = small::to_vec<dim>(p.pos(0));
+        auto normal = small::rotation_matrix<dim>(small::to_quat(p.q(0))).column(0);
+
+        // side of the plane where the object is
+        auto nij = static_cast<double>(sign(small::dot(small::to_vec<dim>(obj.pos(0)) - p_pos, normal))) * normal;
+        auto pi  = support(obj, -nij);
+        auto pj  = pi - small::dot(pi - p_pos, normal) * normal;
+
+        neighbor<dim, problem_t> neigh;
+        neigh.pi  = small::to_xtensor(pi);
+        neigh.pj  = small::to_xtensor(pj);
+        neigh.nij = small::to_xtensor(nij);
+        neigh.dij = small::dot(pi - pj, nij);
+        return neigh;
+    }
+
+    /**
+     * @brief Neighbor between a plane and a convex object, computed with the support mapping of the object.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param p [in] Plane \c i.
+     * @param obj [in] Object \c j.
+     *
+     * @return Neighbor struct for contact between plane \c i and object \c j.
+     */
+    template <class problem_t, std::size_t dim, bool owner, template <std::size_t, bool> class T>
+    auto gjk_closest_points(const plane<dim, owner>& p, const T<dim, owner>& obj)
+    {
+        auto neigh = gjk_closest_points<problem_t>(obj, p);
+        neigh.nij *= -1.;
+        std::swap(neigh.pi, neigh.pj);
+        return neigh;
+    }
+}
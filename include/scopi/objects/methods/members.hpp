@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../dispatch.hpp"
+#include "../types/clump.hpp"
+#include "../types/mesh.hpp"
+
+namespace scopi
+{
+    // CLUMP
+    /**
+     * @brief Spheres of a clump at its current position.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param c [in] Clump.
+     */
+    template <std::size_t dim>
+    clump_members<dim> members(const clump<dim, false>& c)
+    {
+        return c.members();
+    }
+
+    /**
+     * @brief Functor for the dispatcher of the spheres of a composite rigid object.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    struct members_functor
+    {
+        using return_type = clump_members<dim>;
+
+        template <class T>
+        return_type run(const T& obj) const
+        {
+            return members(obj);
+        }
+
+        /**
+         * @brief The object is not made of rigidly attached spheres: empty set.
+         */
+        return_type on_error(const object<dim, false>&) const
+        {
+            return {};
+        }
+    };
+
+    /**
+     * @brief Dispatcher of the spheres of a composite rigid object (see clump).
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    using members_dispatcher = unit_static_dispatcher<members_functor<dim>,
+                                                      const object<dim, false>,
+                                                      mpl::vector<const clump<dim, false>>,
+                                                      typename members_functor<dim>::return_type>;
+
+    /**
+     * @brief How the contacts of an object are computed (see compute_exact_distance).
+     */
+    enum class object_kind
+    {
+        /// One contact with another object, given by closest_points_dispatcher.
+        simple,
+        /// One contact for each sphere of the clump (see members).
+        clump,
+        /// One contact for each close primitive of the mesh (see mesh_closest_points_dispatcher).
+        mesh
+    };
+
+    /**
+     * @brief Functor for the dispatcher of the kind of an object.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    struct object_kind_functor
+    {
+        using return_type = object_kind;
+
+        return_type run(const clump<dim, false>&) const
+        {
+            return object_kind::clump;
+        }
+
+        return_type run(const mesh<dim, false>&) const
+        {
+            return object_kind::mesh;
+        }
+
+        return_type on_error(const object<dim, false>&) const
+        {
+            return object_kind::simple;
+        }
+    };
+
+    /**
+     * @brief Dispatcher of the kind of an object, so that the contact detection casts the object to its type once.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    using object_kind_dispatcher = unit_static_dispatcher<object_kind_functor<dim>,
+                                                          const object<dim, false>,
+                                                          mpl::vector<const clump<dim, false>, const mesh<dim, false>>,
+                                                          typename object_kind_functor<dim>::return_type>;
+}
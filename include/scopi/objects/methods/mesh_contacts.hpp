@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "../../small_math.hpp"
+#include "../dispatch.hpp"
+#include "../neighbor.hpp"
+#include "../types/capsule.hpp"
+#include "../types/mesh.hpp"
+#include "../types/sphere.hpp"
+#include "../types/superellipsoid.hpp"
+#include "bounding_volume.hpp"
+#include "gjk.hpp"
+
+namespace scopi
+{
+    namespace detail
+    {
+        /**
+         * @brief Closest point of a primitive of a mesh (segment in 2D, triangle in 3D) to the point \c p.
+         *
+         * For the triangle, see Ericson, Real-Time Collision Detection, 5.1.5.
+         */
+        inline small::vec<2> closest_point_on_primitive(const std::array<small::vec<2>, 2>& v, const small::vec<2>& p)
+        {
+            auto ab   = v[1] - v[0];
+            double ab2 = small::squared_norm(ab);
+            double t  = ab2 > 0. ? std::clamp(small::dot(p - v[0], ab) / ab2, 0., 1.) : 0.;
+            return v[0] + t * ab;
+        }
+
+        inline small::vec<3> closest_point_on_primitive(const std::array<small::vec<3>, 3>& v, const small::vec<3>& p)
+        {
+            const auto& a = v[0];
+            const auto& b = v[1];
+            const auto& c = v[2];
+            auto ab       = b - a;
+            auto ac       = c - a;
+
+            auto ap   = p - a;
+            double d1 = small::dot(ab, ap);
+            double d2 = small::dot(ac, ap);
+            if (d1 <= 0. && d2 <= 0.)
+            {
+                return a;
+            }
+
+            auto bp   = p - b;
+            double d3 = small::dot(ab, bp);
+            double d4 = small::dot(ac, bp);
+            if (d3 >= 0. && d4 <= d3)
+            {
+                return b;
+            }
+
+            double vc = d1 * d4 - d3 * d2;
+            if (vc <= 0. && d1 >= 0. && d3 <= 0.)
+            {
+                return a + (d1 / (d1 - d3)) * ab;
+            }
+
+            auto cp   = p - c;
+            double d5 = small::dot(ab, cp);
+            double d6 = small::dot(ac, cp);
+            if (d6 >= 0. && d5 <= d6)
+            {
+                return c;
+            }
+
+            double vb = d5 * d2 - d1 * d6;
+            if (vb <= 0. && d2 >= 0. && d6 <= 0.)
+            {
+                return a + (d2 / (d2 - d6)) * ac;
+            }
+
+            double va = d3 * d6 - d5 * d4;
+            if (va <= 0. && (d4 - d3) >= 0. && (d5 - d6) >= 0.)
+            {
+                return b + ((d4 - d3) / ((d4 - d3) + (d5 - d6))) * (c - b);
+            }
+
+            double denom = 1. / (va + vb + vc);
+            return a + (vb * denom) * ab + (vc * denom) * ac;
+        }
+
+        /**
+         * @brief Unit normal of a primitive of a mesh, used if a point lies on it.
+         */
+        inline small::vec<2> primitive_normal(const std::array<small::vec<2>, 2>& v)
+        {
+            auto t = v[1] - v[0];
+            small::vec<2> n{
+                {-t[1], t[0]}
+            };
+            return small::squared_norm(n) > 0. ? small::normalized(n) : small::vec<2>{{0., 1.}};
+        }
+
+        inline small::vec<3> primitive_normal(const std::array<small::vec<3>, 3>& v)
+        {
+            auto n = small::cross(v[1] - v[0], v[2] - v[0]);
+            return small::squared_norm(n) > 0. ? small::normalized(n) : small::vec<3>{{0., 0., 1.}};
+        }
+
+        /**
+         * @brief Keep one contact per contact point of the mesh.
+         *
+         * The primitives which share an edge or a vertex give the same contact if it is the closest point.
+         */
+        template <std::size_t dim, class problem_t>
+        void remove_duplicated_contacts(std::vector<neighbor<dim, problem_t>>& contacts)
+        {
+            std::sort(contacts.begin(),
+                      contacts.end(),
+                      [](const auto& a, const auto& b)
+                      {
+                          return a.dij < b.dij;
+                      });
+
+            std::vector<neighbor<dim, problem_t>> distinct;
+            for (auto& c : contacts)
+            {
+                auto pj       = small::to_vec<dim>(c.pj);
+                bool is_known = std::any_of(distinct.begin(),
+                                            distinct.end(),
+                                            [&](const auto& d)
+                                            {
+                                                return small::squared_norm(small::to_vec<dim>(d.pj) - pj)
+                                                    <= 1e-20 * (1. + small::squared_norm(pj));
+                                            });
+                if (!is_known)
+                {
+                    distinct.push_back(std::move(c));
+                }
+            }
+            std::swap(contacts, distinct);
+        }
+    }
+
+    // SPHERE - MESH
+    /**
+     * @brief Neighbors between a sphere and the close primitives of a mesh.
+     *
+     * See neighbor.hpp.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param s [in] Sphere \c i.
+     * @param m [in] Mesh \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     *
+     * @return Neighbors for contact between sphere \c i and the primitives of mesh \c j closer than \c dmax.
+     */
+    template <class problem_t, std::size_t dim, bool owner>
+    std::vector<neighbor<dim, problem_t>> mesh_closest_points(const sphere<dim, owner>& s, const mesh<dim, owner>& m, double dmax)
+    {
+        auto m_pos    = small::to_vec<dim>(m.pos(0));
+        auto rotation = small::rotation_matrix<dim>(small::to_quat(m.q(0)));
+        auto center   = small::to_vec<dim>(s.pos(0));
+        // center of the sphere in the frame of the mesh
+        auto local = small::transpose(rotation) * (center - m_pos);
+
+        std::vector<neighbor<dim, problem_t>> contacts;
+        m.data().for_each_close_primitive(local,
+                                          s.radius() + dmax,
+                                          [&](std::size_t p)
+                                          {
+                                              auto vertices  = m.data().primitive(p);
+                                              auto closest   = detail::closest_point_on_primitive(vertices, local);
+                                              auto to_center = local - closest;
+                                              double d       = small::norm(to_center);
+                                              if (d - s.radius() >= dmax)
+                                              {
+                                                  return;
+                                              }
+                                              auto n = rotation * (d > 0. ? to_center / d : detail::primitive_normal(vertices));
+
+                                              neighbor<dim, problem_t> neigh;
+                                              neigh.pi  = small::to_xtensor(center - s.radius() * n);
+                                              neigh.pj  = small::to_xtensor(m_pos + rotation * closest);
+                                              neigh.nij = small::to_xtensor(n);
+                                              neigh.dij = d - s.radius();
+                                              contacts.push_back(std::move(neigh));
+                                          });
+        detail::remove_duplicated_contacts(contacts);
+        return contacts;
+    }
+
+    // CONVEX OBJECT - MESH
+    /**
+     * @brief Neighbors between a convex object and the close primitives of a mesh, computed by GJK/EPA.
+     *
+     * It is used for the superellipsoids and the capsules: the object needs a support mapping (see gjk.hpp) and a
+     * bounding radius (see bounding_volume.hpp).
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     * @param obj [in] Object \c i.
+     * @param m [in] Mesh \c j.
+     * @param dmax [in] Maximum distance of the contacts.
+     *
+     * @return Neighbors for contact between object \c i and the primitives of mesh \c j closer than \c dmax.
+     */
+    template <class problem_t, std::size_t dim, bool owner, template <std::size_t, bool> class T>
+    std::vector<neighbor<dim, problem_t>> mesh_closest_points(const T<dim, owner>& obj, const mesh<dim, owner>& m, double dmax)
+    {
+        auto m_pos    = small::to_vec<dim>(m.pos(0));
+        auto rotation = small::rotation_matrix<dim>(small::to_quat(m.q(0)));
+        auto center   = small::to_vec<dim>(obj.pos(0));
+        auto local    = small::transpose(rotation) * (center - m_pos);
+
+        std::vector<neighbor<dim, problem_t>> contacts;
+        m.data().for_each_close_primitive(local,
+                                          detail::bounding_radius(obj) + dmax,
+                                          [&](std::size_t p)
+                                          {
+                                              auto vertices = m.data().primitive(p);
+                                              small::vec<dim> centroid{};
+                                              for (auto& v : vertices)
+                                              {
+                                                  v = m_pos + rotation * v;
+                                                  centroid += v;
+                                              }
+                                              centroid /= static_cast<double>(dim);
+
+                                              auto result = gjk_epa<dim>(
+                                                  [&](const small::vec<dim>& d)
+                                                  {
+                                                      return support(obj, d);
+                                                  },
+                                                  [&](const small::vec<dim>& d)
+                                                  {
+                                                      return *std::max_element(vertices.begin(),
+                                                                               vertices.end(),
+                                                                               [&](const auto& a, const auto& b)
+                                                                               {
+                                                                                   return small::dot(a, d) < small::dot(b, d);
+                                                                               });
+                                                  },
+                                                  center,
+                                                  centroid);
+                                              double dij = small::dot(result.pa - result.pb, result.normal);
+                                              if (dij >= dmax)
+                                              {
+                                                  return;
+                                              }
+
+                                              neighbor<dim, problem_t> neigh;
+                                              neigh.pi  = small::to_xtensor(result.pa);
+                                              neigh.pj  = small::to_xtensor(result.pb);
+                                              neigh.nij = small::to_xtensor(result.normal);
+                                              neigh.dij = dij;
+                                              contacts.push_back(std::move(neigh));
+                                          });
+        detail::remove_duplicated_contacts(contacts);
+        return contacts;
+    }
+
+    /**
+     * @brief Functor for the dispatcher of the contacts with a mesh.
+     *
+     * @tparam problem_t Problem to be solved.
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <class problem_t, std::size_t dim>
+    struct mesh_closest_points_functor
+    {
+        using return_type = std::vector<neighbor<dim, problem_t>>;
+
+        template <class T>
+        return_type run(const T& obj, const mesh<dim, false>& m, double dmax) const
+        {
+            return mesh_closest_points<problem_t>(obj, m, dmax);
+        }
+
+        /**
+         * @brief No contact between a mesh and an object which is not in the list (planes, other meshes, ...).
+         */
+        return_type on_error(const object<dim, false>&, const mesh<dim, false>&, double) const
+        {
+            return {};
+        }
+    };
+
+    /**
+     * @brief Dispatcher of the contacts between an object \c i and a mesh \c j.
+     *
+     * @tparam problem_t Problem to be solved.
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <class problem_t, std::size_t dim>
+    using mesh_closest_points_dispatcher = unit_static_dispatcher<
+        mesh_closest_points_functor<problem_t, dim>,
+        const object<dim, false>,
+        mpl::vector<const sphere<dim, false>, const superellipsoid<dim, false>, const capsule<dim, false>>,
+        typename mesh_closest_points_functor<problem_t, dim>::return_type>;
+}
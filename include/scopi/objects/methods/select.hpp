@@ -13,7 +13,11 @@
 
 #include "../dispatch.hpp"
 #include "../neighbor.hpp"
+#include "../types/capsule.hpp"
+#include "../types/clump.hpp"
+#include "../types/mesh.hpp"
 #include "../types/plane.hpp"
+#include "../types/sdf.hpp"
 #include "../types/segment.hpp"
 #include "../types/sphere.hpp"
 #include "../types/superellipsoid.hpp"
@@ -64,6 +68,34 @@ namespace scopi
         return std::make_unique<segment<dim, false>>(s);
     }
 
+    // CAPSULE
+    template <std::size_t dim>
+    std::unique_ptr<object<dim, false>> select_object(const capsule<dim, false>& s, const std::size_t)
+    {
+        return std::make_unique<capsule<dim, false>>(s);
+    }
+
+    // CLUMP
+    template <std::size_t dim>
+    std::unique_ptr<object<dim, false>> select_object(const clump<dim, false>& s, const std::size_t)
+    {
+        return std::make_unique<clump<dim, false>>(s);
+    }
+
+    // MESH
+    template <std::size_t dim>
+    std::unique_ptr<object<dim, false>> select_object(const mesh<dim, false>& s, const std::size_t)
+    {
+        return std::make_unique<mesh<dim, false>>(s);
+    }
+
+    // SDF
+    template <std::size_t dim>
+    std::unique_ptr<object<dim, false>> select_object(const sdf<dim, false>& s, const std::size_t)
+    {
+        return std::make_unique<sdf<dim, false>>(s);
+    }
+
     // WORM
     template <std::size_t dim>
     std::unique_ptr<object<dim, false>> select_object(const worm<dim, false>& s, const std::size_t i)
@@ -92,7 +124,15 @@ namespace scopi
     using select_object_dispatcher = double_static_dispatcher<
         select_object_functor<dim>,
         const object<dim, false>,
-        mpl::vector<const sphere<dim, false>, const superellipsoid<dim, false>, const worm<dim, false>, const plane<dim, false>, const segment<dim, false>>,
+        mpl::vector<const sphere<dim, false>,
+                    const superellipsoid<dim, false>,
+                    const worm<dim, false>,
+                    const plane<dim, false>,
+                    const segment<dim, false>,
+                    const capsule<dim, false>,
+                    const clump<dim, false>,
+                    const mesh<dim, false>,
+                    const sdf<dim, false>>,
         typename select_object_functor<dim>::return_type,
         antisymmetric_dispatch,
         const index,
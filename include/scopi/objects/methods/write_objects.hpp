@@ -13,7 +13,11 @@
 
 #include "../dispatch.hpp"
 #include "../neighbor.hpp"
+#include "../types/capsule.hpp"
+#include "../types/clump.hpp"
+#include "../types/mesh.hpp"
 #include "../types/plane.hpp"
+#include "../types/sdf.hpp"
 #include "../types/segment.hpp"
 #include "../types/sphere.hpp"
 #include "../types/superellipsoid.hpp"
@@ -171,6 +175,156 @@ namespace scopi
         return object;
     }
 
+    // CAPSULE
+    /**
+     * @brief Write the elements of a capsule in json format.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param c [in] Capsule.
+     *
+     * @return nlohmann json object.
+     */
+    template <std::size_t dim>
+    nl::json write_objects(const capsule<dim, false>& c, std::size_t id)
+    {
+        nl::json object;
+
+        object["type"]       = "capsule";
+        object["id"]         = id;
+        object["position"]   = xt::flatten(c.pos());
+        object["radius"]     = c.radius();
+        object["length"]     = c.length();
+        auto extrema         = c.extrema();
+        object["p1"]         = extrema[0];
+        object["p2"]         = extrema[1];
+        object["rotation"]   = xt::flatten(c.rotation());
+        object["quaternion"] = xt::flatten(c.q());
+
+        return object;
+    }
+
+    // CLUMP
+    /**
+     * @brief Write the elements of a clump in json format.
+     *
+     * The offsets and the radii describe the clump in its frame (used for restart), the spheres give the centers
+     * of the spheres at the current position (used for visualization).
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param c [in] Clump.
+     *
+     * @return nlohmann json object.
+     */
+    template <std::size_t dim>
+    nl::json write_objects(const clump<dim, false>& c, std::size_t id)
+    {
+        nl::json object;
+
+        object["type"]       = "clump";
+        object["id"]         = id;
+        object["position"]   = xt::flatten(c.pos());
+        object["rotation"]   = xt::flatten(c.rotation());
+        object["quaternion"] = xt::flatten(c.q());
+        object["offsets"]    = c.offsets();
+        object["radii"]      = c.radii();
+        for (std::size_t k = 0; k < c.nb_spheres(); ++k)
+        {
+            object["spheres"].push_back(c.sphere_position(k));
+        }
+
+        return object;
+    }
+
+    // MESH
+    /**
+     * @brief Write the elements of a mesh in json format.
+     *
+     * A mesh read from a file is written by the name of the file, otherwise by its vertices and its primitives in
+     * the frame of the mesh.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param m [in] Mesh.
+     *
+     * @return nlohmann json object.
+     */
+    template <std::size_t dim>
+    nl::json write_objects(const mesh<dim, false>& m, std::size_t id)
+    {
+        nl::json object;
+
+        object["type"]       = "mesh";
+        object["id"]         = id;
+        object["position"]   = xt::flatten(m.pos());
+        object["rotation"]   = xt::flatten(m.rotation());
+        object["quaternion"] = xt::flatten(m.q());
+        if (!m.data().source().empty())
+        {
+            object["file"] = m.data().source();
+        }
+        else
+        {
+            object["vertices"] = nl::json::array();
+            for (const auto& v : m.data().vertices())
+            {
+                object["vertices"].push_back(small::to_xtensor(v));
+            }
+            object["primitives"] = m.data().primitives();
+        }
+
+        return object;
+    }
+
+    // SDF
+    /**
+     * @brief Write the elements of a sdf in json format.
+     *
+     * The grid is not written: the particles with the same grid have the same shape identifier.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param f [in] Sdf.
+     *
+     * @return nlohmann json object.
+     */
+    template <std::size_t dim>
+    nl::json write_objects(const sdf<dim, false>& f, std::size_t id)
+    {
+        nl::json object;
+
+        object["type"]            = "sdf";
+        object["id"]              = id;
+        object["position"]        = xt::flatten(f.pos());
+        object["rotation"]        = xt::flatten(f.rotation());
+        object["quaternion"]      = xt::flatten(f.q());
+        object["shape"]           = f.hash();
+        object["bounding_radius"] = f.bounding_radius();
+
+        return object;
+    }
+
+    /**
+     * @brief Write a signed distance grid in json format, so that make_sdf_grid_from_json rebuilds it bit for bit.
+     *
+     * The grid is only written in the shape table of the checkpoints (see write_checkpoint).
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param grid [in] Signed distance grid.
+     *
+     * @return nlohmann json object.
+     */
+    template <std::size_t dim>
+    nl::json write_sdf_grid(const sdf_grid<dim>& grid)
+    {
+        nl::json object;
+
+        object["origin"]        = small::to_xtensor(grid.origin());
+        object["spacing"]       = grid.spacing();
+        object["shape"]         = grid.shape();
+        object["interpolation"] = static_cast<int>(grid.interpolation());
+        object["values"]        = grid.values();
+
+        return object;
+    }
+
     // WORM
     /**
      * @brief Write the elements of a worm in json format.
@@ -258,6 +412,14 @@ namespace scopi
     using write_objects_dispatcher = unit_static_dispatcher<
         write_objects_functor<dim>,
         const object<dim, false>,
-        mpl::vector<const sphere<dim, false>, const superellipsoid<dim, false>, const worm<dim, false>, const plane<dim, false>, const segment<dim, false>>,
+        mpl::vector<const sphere<dim, false>,
+                    const superellipsoid<dim, false>,
+                    const worm<dim, false>,
+                    const plane<dim, false>,
+                    const segment<dim, false>,
+                    const capsule<dim, false>,
+                    const clump<dim, false>,
+                    const mesh<dim, false>,
+                    const sdf<dim, false>>,
         typename write_objects_functor<dim>::return_type>;
 }
@@ -42,30 +42,45 @@ namespace scopi
 
     namespace detail
     {
+        /**
+         * @brief View of \c size contiguous fixed-size vectors as a (size, n) array.
+         *
+         * The stride is computed from the size of the vector type, which can hold more than its \c n values
+         * depending on the version of xtensor.
+         */
+        template <std::size_t n, class value_t, class T>
+        auto fixed_array_view(T* t, std::size_t size)
+        {
+            constexpr std::size_t stride       = sizeof(T) / sizeof(double);
+            std::array<std::size_t, 2> shape   = {size, n};
+            std::array<std::size_t, 2> strides = {stride, 1};
+            return xt::adapt(reinterpret_cast<value_t*>(t->data()), size * stride, xt::no_ownership(), shape, strides);
+        }
+
         // position type
         template <std::size_t dim>
         auto get_value_impl(const std::vector<type::position_t<dim>>& t, std::size_t size)
         {
-            return xt::view((xt::adapt(reinterpret_cast<const double*>(t.data()->data()), {size, dim + 2})), xt::all(), xt::range(0, dim));
+            return fixed_array_view<dim, const double>(t.data(), size);
         }
 
         template <std::size_t dim>
         auto get_value_impl(const type::position_t<dim>* t, std::size_t size)
         {
             std::cout << "get_value_impl position 2" << std::endl;
-            return xt::adapt(reinterpret_cast<const double*>(t->data()), {size, dim});
+            return fixed_array_view<dim, const double>(t, size);
         }
 
         template <std::size_t dim>
         auto get_value_impl(std::vector<type::position_t<dim>>& t, std::size_t size)
         {
-            return xt::view((xt::adapt(reinterpret_cast<double*>(t.data()->data()), {size, dim + 2})), xt::all(), xt::range(0, dim));
+            return fixed_array_view<dim, double>(t.data(), size);
         }
 
         template <std::size_t dim>
         auto get_value_impl(type::position_t<dim>* t, std::size_t size)
         {
-            return xt::view((xt::adapt(reinterpret_cast<double*>(t->data()), {size, dim + 2})), xt::all(), xt::range(0, dim));
+            return fixed_array_view<dim, double>(t, size);
         }
 
         // quaternion type
@@ -80,7 +95,7 @@ namespace scopi
         auto get_value_impl(const object_t* t, std::size_t size)
         {
             std::cout << "get_value_impl quaternion 2" << std::endl;
-            return xt::adapt(reinterpret_cast<const double*>(t->data()), {size, 4UL});
+            return fixed_array_view<4, const double>(t, size);
         }
 
         template <class object_t = type::quaternion_t>
@@ -94,7 +109,7 @@ namespace scopi
         auto get_value_impl(object_t* t, std::size_t size)
         {
             std::cout << "get_value_impl quaternion 4" << std::endl;
-            return xt::adapt(reinterpret_cast<double*>(t->data()), {size, 4UL});
+            return fixed_array_view<4, double>(t, size);
         }
 
         template <class T>
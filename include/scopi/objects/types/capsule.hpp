@@ -0,0 +1,203 @@
+#pragma once
+
+#include <array>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include "../../quaternion.hpp"
+#include "base.hpp"
+
+namespace scopi
+{
+    ////////////////////////
+    // capsule definition //
+    ////////////////////////
+    /**
+     * @class capsule
+     * @brief Capsule (spherocylinder): set of the points at distance at most \c radius of a segment.
+     *
+     * The segment (the axis of the capsule) is centered at the position of the capsule and is along the first
+     * axis of its frame. Its closest points with the spheres, the planes, the segments and the other capsules are
+     * computed in closed form from the closest points of the axes.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     */
+    template <std::size_t dim, bool owner = true>
+    class capsule : public object<dim, owner>
+    {
+      public:
+
+        /**
+         * @brief Alias for the base class object.
+         */
+        using base_type = object<dim, owner>;
+        /**
+         * @brief Alias for position type.
+         */
+        using position_type = typename base_type::position_type;
+        /**
+         * @brief Alias for quaternion type.
+         */
+        using quaternion_type = typename base_type::quaternion_type;
+
+        /**
+         * @brief Constructor with default rotation (the axis is along \f$ x \f$).
+         *
+         * @param pos [in] Position of the center of the capsule.
+         * @param radius [in] Radius of the capsule.
+         * @param length [in] Length of the axis (distance between the centers of the two caps).
+         */
+        capsule(position_type pos, double radius, double length);
+        /**
+         * @brief Constructor with given rotation.
+         *
+         * @param pos [in] Position of the center of the capsule.
+         * @param q [in] Quaternion describing the rotation of the capsule.
+         * @param radius [in] Radius of the capsule.
+         * @param length [in] Length of the axis (distance between the centers of the two caps).
+         */
+        capsule(position_type pos, quaternion_type q, double radius, double length);
+
+        /**
+         * @brief Get the radius of the capsule.
+         */
+        double radius() const;
+        /**
+         * @brief Get the length of the axis of the capsule.
+         */
+        double length() const;
+        /**
+         * @brief Get the rotation matrix of the capsule.
+         */
+        auto rotation() const;
+        /**
+         * @brief Get the unit vector along the axis of the capsule.
+         */
+        auto axis() const;
+        /**
+         * @brief Get the extremities of the axis of the capsule (the centers of the two caps).
+         */
+        auto extrema() const;
+
+        /**
+         * @brief
+         *
+         * \todo Write documentation.
+         *
+         * @return
+         */
+        std::unique_ptr<base_constructor<dim>> construct() const override;
+        /**
+         * @brief Print the elements of the capsule on standard output.
+         */
+        void print() const override;
+        /**
+         * @brief Get the hash of the capsule.
+         */
+        std::size_t hash() const override;
+
+      private:
+
+        /**
+         * @brief Create the hash of the capsule.
+         *
+         * Two capsules with the same dimension, same radius and same length have the same hash.
+         */
+        void create_hash();
+
+        /**
+         * @brief Radius of the capsule.
+         */
+        double m_radius;
+        /**
+         * @brief Length of the axis of the capsule.
+         */
+        double m_length;
+        /**
+         * @brief Hash of the capsule.
+         */
+        std::size_t m_hash{std::numeric_limits<std::size_t>::min()};
+    };
+
+    ////////////////////////////
+    // capsule implementation //
+    ////////////////////////////
+    template <std::size_t dim, bool owner>
+    capsule<dim, owner>::capsule(position_type pos, double radius, double length)
+        : base_type(pos, {quaternion()}, 1)
+        , m_radius(radius)
+        , m_length(length)
+    {
+        create_hash();
+    }
+
+    template <std::size_t dim, bool owner>
+    capsule<dim, owner>::capsule(position_type pos, quaternion_type q, double radius, double length)
+        : base_type(pos, q, 1)
+        , m_radius(radius)
+        , m_length(length)
+    {
+        create_hash();
+    }
+
+    template <std::size_t dim, bool owner>
+    double capsule<dim, owner>::radius() const
+    {
+        return m_radius;
+    }
+
+    template <std::size_t dim, bool owner>
+    double capsule<dim, owner>::length() const
+    {
+        return m_length;
+    }
+
+    template <std::size_t dim, bool owner>
+    auto capsule<dim, owner>::rotation() const
+    {
+        return rotation_matrix<dim>(this->q());
+    }
+
+    template <std::size_t dim, bool owner>
+    auto capsule<dim, owner>::axis() const
+    {
+        auto matrix = rotation_matrix<dim>(this->q(0));
+        return xt::eval(xt::view(matrix, xt::all(), 0));
+    }
+
+    template <std::size_t dim, bool owner>
+    auto capsule<dim, owner>::extrema() const
+    {
+        std::array<xt::xtensor_fixed<double, xt::xshape<dim>>, 2> pts;
+        xt::xtensor_fixed<double, xt::xshape<dim>> half_axis = 0.5 * m_length * axis();
+        pts[0]                                                = this->pos(0) - half_axis;
+        pts[1]                                                = this->pos(0) + half_axis;
+        return pts;
+    }
+
+    template <std::size_t dim, bool owner>
+    std::unique_ptr<base_constructor<dim>> capsule<dim, owner>::construct() const
+    {
+        return make_object_constructor<capsule<dim, false>>(m_radius, m_length);
+    }
+
+    template <std::size_t dim, bool owner>
+    void capsule<dim, owner>::print() const
+    {
+        std::cout << fmt::format("capsule<{}>({}, {})", dim, m_radius, m_length) << std::endl;
+    }
+
+    template <std::size_t dim, bool owner>
+    std::size_t capsule<dim, owner>::hash() const
+    {
+        return m_hash;
+    }
+
+    template <std::size_t dim, bool owner>
+    void capsule<dim, owner>::create_hash()
+    {
+        m_hash = std::hash<std::string>{}(fmt::format("capsule<{}>({}, {})", dim, m_radius, m_length));
+    }
+}
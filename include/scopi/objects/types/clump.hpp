@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+#include <xtensor/xio.hpp>
+
+#include "../../quaternion.hpp"
+#include "../../small_math.hpp"
+#include "base.hpp"
+#include "sphere.hpp"
+
+namespace scopi
+{
+    //////////////////////////////
+    // clump_members definition //
+    //////////////////////////////
+    /**
+     * @class clump_members
+     * @brief Spheres of a clump at its current position.
+     *
+     * The spheres do not own their positions: they point to the storage of this object, which must outlive them.
+     * An empty set means that the object is not a clump.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    class clump_members
+    {
+      public:
+
+        clump_members() = default;
+        /**
+         * @brief Constructor.
+         *
+         * @param positions [in] Positions of the centers of the spheres.
+         * @param q [in] Quaternion of the clump, shared by the spheres.
+         * @param radii [in] Radii of the spheres.
+         */
+        clump_members(std::vector<type::position_t<dim>> positions, const type::quaternion_t& q, std::vector<double> radii);
+
+        /**
+         * @brief Number of spheres.
+         */
+        std::size_t size() const;
+        /**
+         * @brief Whether the set of spheres is empty.
+         */
+        bool empty() const;
+        /**
+         * @brief Get a sphere of the clump.
+         *
+         * @param k [in] Index of the sphere in the clump. 0 <= \c k < <tt> this->size() </tt>.
+         *
+         * The sphere is a view on the storage of this object: no memory is allocated.
+         *
+         * @return The k-th sphere of the clump.
+         */
+        sphere<dim, false> get_sphere(std::size_t k);
+
+      private:
+
+        std::vector<type::position_t<dim>> m_positions;
+        std::vector<type::quaternion_t> m_quaternions;
+        std::vector<double> m_radii;
+    };
+
+    //////////////////////
+    // clump definition //
+    //////////////////////
+    /**
+     * @class clump
+     * @brief Rigid clump of spheres.
+     *
+     * The spheres are at fixed offsets in the frame of the clump and move with it: the clump is one particle in the
+     * container, with one velocity and one rotation. A contact with a sphere of the clump is a contact with the clump,
+     * at a point away from its center, so that the lever arm of AMatrix and ATMatrix gives its contribution to the
+     * rotation. Unlike the worm, no contact is needed to hold the spheres together.
+     *
+     * The position of the clump is the origin of the offsets; it should be the center of mass for the rotation to be
+     * physical. The mass and the moment of inertia are given by the properties of the particle.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     */
+    template <std::size_t dim, bool owner = true>
+    class clump : public object<dim, owner>
+    {
+      public:
+
+        /**
+         * @brief Alias for the base class object.
+         */
+        using base_type = object<dim, owner>;
+        /**
+         * @brief Alias for position type.
+         */
+        using position_type = typename base_type::position_type;
+        /**
+         * @brief Alias for quaternion type.
+         */
+        using quaternion_type = typename base_type::quaternion_type;
+
+        /**
+         * @brief Constructor with default rotation.
+         *
+         * @param pos [in] Position of the clump.
+         * @param offsets [in] Positions of the centers of the spheres in the frame of the clump.
+         * @param radii [in] Radii of the spheres.
+         */
+        clump(position_type pos, const std::vector<type::position_t<dim>>& offsets, const std::vector<double>& radii);
+        /**
+         * @brief Constructor with given rotation.
+         *
+         * @param pos [in] Position of the clump.
+         * @param q [in] Quaternion describing the rotation of the clump.
+         * @param offsets [in] Positions of the centers of the spheres in the frame of the clump.
+         * @param radii [in] Radii of the spheres.
+         */
+        clump(position_type pos, quaternion_type q, const std::vector<type::position_t<dim>>& offsets, const std::vector<double>& radii);
+
+        /**
+         * @brief Number of spheres in the clump.
+         */
+        std::size_t nb_spheres() const;
+        /**
+         * @brief Positions of the centers of the spheres in the frame of the clump.
+         */
+        const std::vector<type::position_t<dim>>& offsets() const;
+        /**
+         * @brief Radii of the spheres.
+         */
+        const std::vector<double>& radii() const;
+        /**
+         * @brief Get the position of the center of a sphere.
+         *
+         * @param k [in] Index of the sphere in the clump.
+         */
+        type::position_t<dim> sphere_position(std::size_t k) const;
+        /**
+         * @brief Radius of the sphere centered at the position of the clump which contains it.
+         */
+        double bounding_radius() const;
+        /**
+         * @brief Get the spheres of the clump at its current position.
+         */
+        clump_members<dim> members() const;
+        /**
+         * @brief Get the rotation matrix of the clump.
+         */
+        auto rotation() const;
+
+        /**
+         * @brief
+         *
+         * \todo Write documentation.
+         *
+         * @return
+         */
+        std::unique_ptr<base_constructor<dim>> construct() const override;
+        /**
+         * @brief Print the elements of the clump on standard output.
+         */
+        void print() const override;
+        /**
+         * @brief Get the hash of the clump.
+         */
+        std::size_t hash() const override;
+
+      private:
+
+        /**
+         * @brief Create the hash of the clump.
+         *
+         * Two clumps with the same dimension, same offsets and same radii have the same hash.
+         */
+        void create_hash();
+
+        /**
+         * @brief Positions of the centers of the spheres in the frame of the clump.
+         */
+        std::vector<type::position_t<dim>> m_offsets;
+        /**
+         * @brief Radii of the spheres.
+         */
+        std::vector<double> m_radii;
+        /**
+         * @brief Hash of the clump.
+         */
+        std::size_t m_hash{std::numeric_limits<std::size_t>::min()};
+    };
+
+    //////////////////////////////////
+    // clump_members implementation //
+    //////////////////////////////////
+    template <std::size_t dim>
+    clump_members<dim>::clump_members(std::vector<type::position_t<dim>> positions,
+                                      const type::quaternion_t& q,
+                                      std::vector<double> radii)
+        : m_positions(std::move(positions))
+        , m_quaternions(m_positions.size(), q)
+        , m_radii(std::move(radii))
+    {
+    }
+
+    template <std::size_t dim>
+    std::size_t clump_members<dim>::size() const
+    {
+        return m_positions.size();
+    }
+
+    template <std::size_t dim>
+    bool clump_members<dim>::empty() const
+    {
+        return m_positions.empty();
+    }
+
+    template <std::size_t dim>
+    sphere<dim, false> clump_members<dim>::get_sphere(std::size_t k)
+    {
+        return sphere<dim, false>(&m_positions[k], &m_quaternions[k], m_radii[k]);
+    }
+
+    //////////////////////////
+    // clump implementation //
+    //////////////////////////
+    template <std::size_t dim, bool owner>
+    clump<dim, owner>::clump(position_type pos, const std::vector<type::position_t<dim>>& offsets, const std::vector<double>& radii)
+        : base_type(pos, {quaternion()}, 1)
+        , m_offsets(offsets)
+        , m_radii(radii)
+    {
+        create_hash();
+    }
+
+    template <std::size_t dim, bool owner>
+    clump<dim, owner>::clump(position_type pos,
+                             quaternion_type q,
+                             const std::vector<type::position_t<dim>>& offsets,
+                             const std::vector<double>& radii)
+        : base_type(pos, q, 1)
+        , m_offsets(offsets)
+        , m_radii(radii)
+    {
+        create_hash();
+    }
+
+    template <std::size_t dim, bool owner>
+    std::size_t clump<dim, owner>::nb_spheres() const
+    {
+        return m_offsets.size();
+    }
+
+    template <std::size_t dim, bool owner>
+    const std::vector<type::position_t<dim>>& clump<dim, owner>::offsets() const
+    {
+        return m_offsets;
+    }
+
+    template <std::size_t dim, bool owner>
+    const std::vector<double>& clump<dim, owner>::radii() const
+    {
+        return m_radii;
+    }
+
+    template <std::size_t dim, bool owner>
+    type::position_t<dim> clump<dim, owner>::sphere_position(std::size_t k) const
+    {
+        auto r = small::rotation_matrix<dim>(small::to_quat(this->q(0)));
+        return small::to_xtensor(small::to_vec<dim>(this->pos(0)) + r * small::to_vec<dim>(m_offsets[k]));
+    }
+
+    template <std::size_t dim, bool owner>
+    double clump<dim, owner>::bounding_radius() const
+    {
+        double radius = 0.;
+        for (std::size_t k = 0; k < m_offsets.size(); ++k)
+        {
+            radius = std::max(radius, small::norm(small::to_vec<dim>(m_offsets[k])) + m_radii[k]);
+        }
+        return radius;
+    }
+
+    template <std::size_t dim, bool owner>
+    clump_members<dim> clump<dim, owner>::members() const
+    {
+        type::quaternion_t q = this->q(0);
+        auto r               = small::rotation_matrix<dim>(small::to_quat(q));
+        auto center          = small::to_vec<dim>(this->pos(0));
+        std::vector<type::position_t<dim>> positions(m_offsets.size());
+        for (std::size_t k = 0; k < m_offsets.size(); ++k)
+        {
+            positions[k] = small::to_xtensor(center + r * small::to_vec<dim>(m_offsets[k]));
+        }
+        return {std::move(positions), q, m_radii};
+    }
+
+    template <std::size_t dim, bool owner>
+    auto clump<dim, owner>::rotation() const
+    {
+        return rotation_matrix<dim>(this->q());
+    }
+
+    template <std::size_t dim, bool owner>
+    std::unique_ptr<base_constructor<dim>> clump<dim, owner>::construct() const
+    {
+        return make_object_constructor<clump<dim, false>>(m_offsets, m_radii);
+    }
+
+    template <std::size_t dim, bool owner>
+    void clump<dim, owner>::print() const
+    {
+        std::cout << "clump<" << dim << ">(" << m_offsets.size() << " spheres)\n";
+    }
+
+    template <std::size_t dim, bool owner>
+    std::size_t clump<dim, owner>::hash() const
+    {
+        return m_hash;
+    }
+
+    template <std::size_t dim, bool owner>
+    void clump<dim, owner>::create_hash()
+    {
+        std::stringstream ss;
+        ss << "clump<" << dim << ">(";
+        for (std::size_t k = 0; k < m_offsets.size(); ++k)
+        {
+            ss << "[" << m_offsets[k] << ", " << m_radii[k] << "]";
+        }
+        ss << ")";
+        m_hash = std::hash<std::string>{}(ss.str());
+    }
+}
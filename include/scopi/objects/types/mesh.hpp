@@ -0,0 +1,619 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "../../quaternion.hpp"
+#include "../../small_math.hpp"
+#include "base.hpp"
+
+namespace scopi
+{
+    //////////////////////////
+    // mesh_data definition //
+    //////////////////////////
+    /**
+     * @class mesh_data
+     * @brief Geometry of a static mesh and its bounding volume hierarchy.
+     *
+     * The primitives are triangles in 3D and segments in 2D. The vertices are given in the frame of the mesh.
+     * The hierarchy of axis-aligned boxes is built once: a query returns the primitives close to a point in a time
+     * which depends on the number of primitives around it, not on the size of the mesh.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    class mesh_data
+    {
+      public:
+
+        /**
+         * @brief Indices of the vertices of a primitive (triangle in 3D, segment in 2D).
+         */
+        using primitive_type = std::array<std::size_t, dim>;
+
+        /**
+         * @brief Maximum number of primitives in a leaf of the hierarchy.
+         */
+        static constexpr std::size_t leaf_size = 4;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param vertices [in] Vertices in the frame of the mesh.
+         * @param primitives [in] Indices of the vertices of each primitive.
+         * @param source [in] File the mesh was read from, empty if none.
+         */
+        mesh_data(std::vector<small::vec<dim>> vertices, std::vector<primitive_type> primitives, std::string source = "");
+
+        /**
+         * @brief Number of primitives.
+         */
+        std::size_t size() const;
+        /**
+         * @brief Vertices in the frame of the mesh.
+         */
+        const std::vector<small::vec<dim>>& vertices() const;
+        /**
+         * @brief Indices of the vertices of the primitives.
+         */
+        const std::vector<primitive_type>& primitives() const;
+        /**
+         * @brief File the mesh was read from, empty if none.
+         */
+        const std::string& source() const;
+        /**
+         * @brief Get the vertices of a primitive.
+         *
+         * @param p [in] Index of the primitive.
+         */
+        std::array<small::vec<dim>, dim> primitive(std::size_t p) const;
+
+        /**
+         * @brief Call \c f on each primitive whose bounding box is closer than \c distance to \c point.
+         *
+         * @param point [in] Point in the frame of the mesh.
+         * @param distance [in] Distance of the query.
+         * @param f [in] Function called with the index of the primitive.
+         */
+        template <class F>
+        void for_each_close_primitive(const small::vec<dim>& point, double distance, F&& f) const;
+
+      private:
+
+        /**
+         * @brief Node of the hierarchy.
+         *
+         * A leaf holds the primitives <tt> m_order[first, first + count) </tt>, an internal node has its children at
+         * \c first and <tt> first + 1 </tt> and \c count = 0.
+         */
+        struct node
+        {
+            small::vec<dim> lower;
+            small::vec<dim> upper;
+            std::size_t first;
+            std::size_t count;
+        };
+
+        void build();
+        void build(std::size_t n, std::size_t begin, std::size_t end);
+
+        std::vector<small::vec<dim>> m_vertices;
+        std::vector<primitive_type> m_primitives;
+        std::string m_source;
+        /**
+         * @brief Nodes of the hierarchy, the root is the first one.
+         */
+        std::vector<node> m_nodes;
+        /**
+         * @brief Indices of the primitives sorted by leaf.
+         */
+        std::vector<std::size_t> m_order;
+        std::vector<small::vec<dim>> m_centroids;
+    };
+
+    /////////////////////
+    // mesh definition //
+    /////////////////////
+    /**
+     * @class mesh
+     * @brief Static mesh, used as an obstacle (walls of silos, hoppers, mixers, ...).
+     *
+     * The geometry is shared between the copies of the mesh, only its position and its rotation are stored in the
+     * container. The closest points with the other objects are computed primitive by primitive, on the primitives
+     * given by the hierarchy of the mesh, and there is one contact per close primitive (see mesh_contacts.hpp).
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     */
+    template <std::size_t dim, bool owner = true>
+    class mesh : public object<dim, owner>
+    {
+      public:
+
+        /**
+         * @brief Alias for the base class object.
+         */
+        using base_type = object<dim, owner>;
+        /**
+         * @brief Alias for position type.
+         */
+        using position_type = typename base_type::position_type;
+        /**
+         * @brief Alias for quaternion type.
+         */
+        using quaternion_type = typename base_type::quaternion_type;
+
+        /**
+         * @brief Constructor with default rotation.
+         *
+         * @param pos [in] Position of the origin of the frame of the mesh.
+         * @param data [in] Geometry of the mesh.
+         */
+        mesh(position_type pos, std::shared_ptr<const mesh_data<dim>> data);
+        /**
+         * @brief Constructor with given rotation.
+         *
+         * @param pos [in] Position of the origin of the frame of the mesh.
+         * @param q [in] Quaternion describing the rotation of the mesh.
+         * @param data [in] Geometry of the mesh.
+         */
+        mesh(position_type pos, quaternion_type q, std::shared_ptr<const mesh_data<dim>> data);
+
+        /**
+         * @brief Geometry of the mesh.
+         */
+        const mesh_data<dim>& data() const;
+        /**
+         * @brief Get the rotation matrix of the mesh.
+         */
+        auto rotation() const;
+
+        /**
+         * @brief
+         *
+         * \todo Write documentation.
+         *
+         * @return
+         */
+        std::unique_ptr<base_constructor<dim>> construct() const override;
+        /**
+         * @brief Print the elements of the mesh on standard output.
+         */
+        void print() const override;
+        /**
+         * @brief Get the hash of the mesh.
+         */
+        std::size_t hash() const override;
+
+      private:
+
+        /**
+         * @brief Create the hash of the mesh.
+         *
+         * Two meshes share the same hash if they share the same geometry.
+         */
+        void create_hash();
+
+        std::shared_ptr<const mesh_data<dim>> m_data;
+        /**
+         * @brief Hash of the mesh.
+         */
+        std::size_t m_hash{std::numeric_limits<std::size_t>::min()};
+    };
+
+    //////////////////////////////
+    // mesh_data implementation //
+    //////////////////////////////
+    template <std::size_t dim>
+    mesh_data<dim>::mesh_data(std::vector<small::vec<dim>> vertices, std::vector<primitive_type> primitives, std::string source)
+        : m_vertices(std::move(vertices))
+        , m_primitives(std::move(primitives))
+        , m_source(std::move(source))
+    {
+        for (const auto& p : m_primitives)
+        {
+            for (auto v : p)
+            {
+                if (v >= m_vertices.size())
+                {
+                    throw std::runtime_error(fmt::format("mesh: vertex {} of a primitive does not exist", v));
+                }
+            }
+        }
+        build();
+    }
+
+    template <std::size_t dim>
+    std::size_t mesh_data<dim>::size() const
+    {
+        return m_primitives.size();
+    }
+
+    template <std::size_t dim>
+    const std::vector<small::vec<dim>>& mesh_data<dim>::vertices() const
+    {
+        return m_vertices;
+    }
+
+    template <std::size_t dim>
+    auto mesh_data<dim>::primitives() const -> const std::vector<primitive_type>&
+    {
+        return m_primitives;
+    }
+
+    template <std::size_t dim>
+    const std::string& mesh_data<dim>::source() const
+    {
+        return m_source;
+    }
+
+    template <std::size_t dim>
+    std::array<small::vec<dim>, dim> mesh_data<dim>::primitive(std::size_t p) const
+    {
+        std::array<small::vec<dim>, dim> out;
+        for (std::size_t k = 0; k < dim; ++k)
+        {
+            out[k] = m_vertices[m_primitives[p][k]];
+        }
+        return out;
+    }
+
+    template <std::size_t dim>
+    void mesh_data<dim>::build()
+    {
+        m_centroids.resize(m_primitives.size());
+        for (std::size_t p = 0; p < m_primitives.size(); ++p)
+        {
+            small::vec<dim> c{};
+            for (auto v : m_primitives[p])
+            {
+                c += m_vertices[v];
+            }
+            m_centroids[p] = c / static_cast<double>(dim);
+        }
+        m_order.resize(m_primitives.size());
+        std::iota(m_order.begin(), m_order.end(), std::size_t(0));
+
+        m_nodes.clear();
+        m_nodes.reserve(2 * (m_primitives.size() / leaf_size + 1));
+        m_nodes.push_back({});
+        build(0, 0, m_primitives.size());
+    }
+
+    template <std::size_t dim>
+    void mesh_data<dim>::build(std::size_t n, std::size_t begin, std::size_t end)
+    {
+        small::vec<dim> lower;
+        small::vec<dim> upper;
+        small::vec<dim> centroid_lower;
+        small::vec<dim> centroid_upper;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            lower[d]          = std::numeric_limits<double>::max();
+            upper[d]          = std::numeric_limits<double>::lowest();
+            centroid_lower[d] = std::numeric_limits<double>::max();
+            centroid_upper[d] = std::numeric_limits<double>::lowest();
+        }
+        for (std::size_t k = begin; k < end; ++k)
+        {
+            for (auto v : m_primitives[m_order[k]])
+            {
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    lower[d] = std::min(lower[d], m_vertices[v][d]);
+                    upper[d] = std::max(upper[d], m_vertices[v][d]);
+                }
+            }
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                centroid_lower[d] = std::min(centroid_lower[d], m_centroids[m_order[k]][d]);
+                centroid_upper[d] = std::max(centroid_upper[d], m_centroids[m_order[k]][d]);
+            }
+        }
+        m_nodes[n].lower = lower;
+        m_nodes[n].upper = upper;
+
+        if (end - begin <= leaf_size)
+        {
+            m_nodes[n].first = begin;
+            m_nodes[n].count = end - begin;
+            return;
+        }
+
+        // median split along the largest extent of the centroids
+        std::size_t axis = 0;
+        for (std::size_t d = 1; d < dim; ++d)
+        {
+            if (centroid_upper[d] - centroid_lower[d] > centroid_upper[axis] - centroid_lower[axis])
+            {
+                axis = d;
+            }
+        }
+        std::size_t middle = begin + (end - begin) / 2;
+        std::nth_element(m_order.begin() + static_cast<std::ptrdiff_t>(begin),
+                         m_order.begin() + static_cast<std::ptrdiff_t>(middle),
+                         m_order.begin() + static_cast<std::ptrdiff_t>(end),
+                         [&](std::size_t a, std::size_t b)
+                         {
+                             return m_centroids[a][axis] < m_centroids[b][axis];
+                         });
+
+        std::size_t left = m_nodes.size();
+        m_nodes[n].first = left;
+        m_nodes[n].count = 0;
+        m_nodes.push_back({});
+        m_nodes.push_back({});
+        build(left, begin, middle);
+        build(left + 1, middle, end);
+    }
+
+    template <std::size_t dim>
+    template <class F>
+    void mesh_data<dim>::for_each_close_primitive(const small::vec<dim>& point, double distance, F&& f) const
+    {
+        if (m_primitives.empty())
+        {
+            return;
+        }
+
+        std::array<std::size_t, 64> stack;
+        std::size_t top = 0;
+        stack[top++]    = 0;
+        while (top > 0)
+        {
+            const auto& n = m_nodes[stack[--top]];
+
+            bool overlap = true;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                overlap = overlap && point[d] + distance >= n.lower[d] && point[d] - distance <= n.upper[d];
+            }
+            if (!overlap)
+            {
+                continue;
+            }
+
+            if (n.count > 0)
+            {
+                for (std::size_t k = n.first; k < n.first + n.count; ++k)
+                {
+                    f(m_order[k]);
+                }
+            }
+            else
+            {
+                stack[top++] = n.first;
+                stack[top++] = n.first + 1;
+            }
+        }
+    }
+
+    /////////////////////////
+    // mesh implementation //
+    /////////////////////////
+    template <std::size_t dim, bool owner>
+    mesh<dim, owner>::mesh(position_type pos, std::shared_ptr<const mesh_data<dim>> data)
+        : base_type(pos, {quaternion()}, 1)
+        , m_data(std::move(data))
+    {
+        create_hash();
+    }
+
+    template <std::size_t dim, bool owner>
+    mesh<dim, owner>::mesh(position_type pos, quaternion_type q, std::shared_ptr<const mesh_data<dim>> data)
+        : base_type(pos, q, 1)
+        , m_data(std::move(data))
+    {
+        create_hash();
+    }
+
+    template <std::size_t dim, bool owner>
+    const mesh_data<dim>& mesh<dim, owner>::data() const
+    {
+        return *m_data;
+    }
+
+    template <std::size_t dim, bool owner>
+    auto mesh<dim, owner>::rotation() const
+    {
+        return rotation_matrix<dim>(this->q());
+    }
+
+    template <std::size_t dim, bool owner>
+    std::unique_ptr<base_constructor<dim>> mesh<dim, owner>::construct() const
+    {
+        return make_object_constructor<mesh<dim, false>>(m_data);
+    }
+
+    template <std::size_t dim, bool owner>
+    void mesh<dim, owner>::print() const
+    {
+        std::cout << "mesh<" << dim << ">(" << m_data->size() << " primitives)\n";
+    }
+
+    template <std::size_t dim, bool owner>
+    std::size_t mesh<dim, owner>::hash() const
+    {
+        return m_hash;
+    }
+
+    template <std::size_t dim, bool owner>
+    void mesh<dim, owner>::create_hash()
+    {
+        std::stringstream ss;
+        ss << "mesh<" << dim << ">(" << static_cast<const void*>(m_data.get()) << ")";
+        m_hash = std::hash<std::string>{}(ss.str());
+    }
+
+    /////////////
+    // loaders //
+    /////////////
+    namespace detail
+    {
+        inline small::vec<3> read_stl_vertex(std::istream& in)
+        {
+            small::vec<3> v;
+            in >> v[0] >> v[1] >> v[2];
+            return v;
+        }
+    }
+
+    /**
+     * @brief Read a mesh from a STL file (ascii or binary).
+     *
+     * The vertices of neighboring triangles are not merged.
+     *
+     * @param filename [in] Name of the file.
+     */
+    inline std::shared_ptr<const mesh_data<3>> load_stl(const std::string& filename)
+    {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("load_stl: cannot open {}", filename));
+        }
+        std::vector<char> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        std::vector<small::vec<3>> vertices;
+        std::vector<mesh_data<3>::primitive_type> triangles;
+
+        // a binary file has a header of 80 bytes, the number of triangles and 50 bytes per triangle
+        bool binary = false;
+        if (content.size() >= 84)
+        {
+            std::uint32_t nb_triangles;
+            std::memcpy(&nb_triangles, content.data() + 80, sizeof(nb_triangles));
+            binary = content.size() == 84 + 50 * static_cast<std::size_t>(nb_triangles);
+        }
+
+        if (binary)
+        {
+            std::uint32_t nb_triangles;
+            std::memcpy(&nb_triangles, content.data() + 80, sizeof(nb_triangles));
+            vertices.reserve(3 * nb_triangles);
+            triangles.reserve(nb_triangles);
+            for (std::size_t t = 0; t < nb_triangles; ++t)
+            {
+                // normal (3 floats), vertices (9 floats), attribute (2 bytes)
+                const char* record = content.data() + 84 + 50 * t;
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    float xyz[3];
+                    std::memcpy(xyz, record + 12 * (k + 1), sizeof(xyz));
+                    vertices.push_back({
+                        {xyz[0], xyz[1], xyz[2]}
+                    });
+                }
+                triangles.push_back({3 * t, 3 * t + 1, 3 * t + 2});
+            }
+        }
+        else
+        {
+            std::istringstream in(std::string(content.begin(), content.end()));
+            std::string word;
+            while (in >> word)
+            {
+                if (word == "vertex")
+                {
+                    vertices.push_back(detail::read_stl_vertex(in));
+                    if (vertices.size() % 3 == 0)
+                    {
+                        std::size_t t = vertices.size() / 3 - 1;
+                        triangles.push_back({3 * t, 3 * t + 1, 3 * t + 2});
+                    }
+                }
+            }
+            if (vertices.size() % 3 != 0)
+            {
+                throw std::runtime_error(fmt::format("load_stl: incomplete triangle in {}", filename));
+            }
+        }
+        return std::make_shared<const mesh_data<3>>(std::move(vertices), std::move(triangles), filename);
+    }
+
+    /**
+     * @brief Read a mesh from an OBJ file.
+     *
+     * In 3D, the faces (\c f) are split into triangles. In 2D, the lines (\c l) are split into segments and the
+     * third coordinate of the vertices is ignored. The other elements are ignored.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param filename [in] Name of the file.
+     */
+    template <std::size_t dim>
+    std::shared_ptr<const mesh_data<dim>> load_obj(const std::string& filename)
+    {
+        std::ifstream file(filename);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("load_obj: cannot open {}", filename));
+        }
+
+        std::vector<small::vec<dim>> vertices;
+        std::vector<typename mesh_data<dim>::primitive_type> primitives;
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream in(line);
+            std::string keyword;
+            in >> keyword;
+            if (keyword == "v")
+            {
+                small::vec<dim> v;
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    in >> v[d];
+                }
+                vertices.push_back(v);
+            }
+            else if ((dim == 3 && keyword == "f") || (dim == 2 && keyword == "l"))
+            {
+                // "i", "i/j", "i//k" or "i/j/k", the indices start at 1 and can be relative to the end
+                std::vector<std::size_t> indices;
+                std::string element;
+                while (in >> element)
+                {
+                    long index = std::stol(element.substr(0, element.find('/')));
+                    index      = index < 0 ? static_cast<long>(vertices.size()) + index : index - 1;
+                    if (index < 0)
+                    {
+                        throw std::runtime_error(fmt::format("load_obj: invalid index {} in {}", element, filename));
+                    }
+                    indices.push_back(static_cast<std::size_t>(index));
+                }
+                if constexpr (dim == 3)
+                {
+                    for (std::size_t k = 1; k + 1 < indices.size(); ++k)
+                    {
+                        primitives.push_back({indices[0], indices[k], indices[k + 1]});
+                    }
+                }
+                else
+                {
+                    for (std::size_t k = 0; k + 1 < indices.size(); ++k)
+                    {
+                        primitives.push_back({indices[k], indices[k + 1]});
+                    }
+                }
+            }
+        }
+        return std::make_shared<const mesh_data<dim>>(std::move(vertices), std::move(primitives), filename);
+    }
+}
@@ -0,0 +1,640 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "../../quaternion.hpp"
+#include "../../small_math.hpp"
+#include "base.hpp"
+
+namespace scopi
+{
+    /**
+     * @brief Interpolation of the values of a signed distance grid.
+     */
+    enum class sdf_interpolation
+    {
+        /**
+         * @brief Bilinear (2D) or trilinear (3D) interpolation, continuous.
+         */
+        linear,
+        /**
+         * @brief Bicubic (2D) or tricubic (3D) Catmull-Rom interpolation, with a continuous gradient.
+         */
+        cubic
+    };
+
+    /////////////////////////
+    // sdf_grid definition //
+    /////////////////////////
+    /**
+     * @class sdf_grid
+     * @brief Signed distance to a shape sampled on a regular grid, in the frame of the shape.
+     *
+     * The distance is negative inside the shape. The values are stored with the first index varying the fastest.
+     * Outside the grid, the distance to the grid is added to the value at the closest point of the grid.
+     *
+     * The surface is also sampled once: one point of the zero level set for each cell crossed by the surface. These
+     * points are used for the contacts between two such shapes, or between such a shape and a plane.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    class sdf_grid
+    {
+      public:
+
+        /**
+         * @brief Number of points of the grid in each direction.
+         */
+        using shape_type = std::array<std::size_t, dim>;
+
+        /**
+         * @brief Constructor.
+         *
+         * @param origin [in] Position of the first point of the grid in the frame of the shape.
+         * @param spacing [in] Distance between two points of the grid.
+         * @param shape [in] Number of points of the grid in each direction, at least 2.
+         * @param values [in] Signed distance at the points of the grid.
+         * @param interpolation [in] Interpolation of the values.
+         */
+        sdf_grid(const small::vec<dim>& origin,
+                 double spacing,
+                 const shape_type& shape,
+                 std::vector<double> values,
+                 sdf_interpolation interpolation = sdf_interpolation::linear);
+
+        /**
+         * @brief Position of the first point of the grid.
+         */
+        const small::vec<dim>& origin() const;
+        /**
+         * @brief Distance between two points of the grid.
+         */
+        double spacing() const;
+        /**
+         * @brief Number of points of the grid in each direction.
+         */
+        const shape_type& shape() const;
+        /**
+         * @brief Signed distance at the points of the grid.
+         */
+        const std::vector<double>& values() const;
+        /**
+         * @brief Interpolation of the values.
+         */
+        sdf_interpolation interpolation() const;
+
+        /**
+         * @brief Signed distance at a point of the frame of the shape.
+         *
+         * @param p [in] Point.
+         */
+        double value(const small::vec<dim>& p) const;
+        /**
+         * @brief Signed distance and its gradient at a point of the frame of the shape.
+         *
+         * @param p [in] Point.
+         * @param gradient [out] Gradient of the signed distance at \c p.
+         */
+        double value(const small::vec<dim>& p, small::vec<dim>& gradient) const;
+        /**
+         * @brief Gradient of the signed distance at a point of the frame of the shape.
+         *
+         * @param p [in] Point.
+         */
+        small::vec<dim> gradient(const small::vec<dim>& p) const;
+
+        /**
+         * @brief Points of the surface of the shape.
+         */
+        const std::vector<small::vec<dim>>& surface_points() const;
+        /**
+         * @brief Radius of the sphere centered at the origin of the frame which contains the zero level set.
+         *
+         * It bounds the cells crossed by the zero level set, with a margin of one spacing, so it is larger than the
+         * distance of the farthest surface point.
+         */
+        double bounding_radius() const;
+        /**
+         * @brief Hash of the grid.
+         *
+         * Two grids with the same values have the same hash.
+         */
+        std::size_t hash() const;
+
+      private:
+
+        double interpolate(const small::vec<dim>& p, small::vec<dim>& gradient) const;
+        void sample_surface();
+        void create_hash();
+
+        small::vec<dim> m_origin;
+        double m_spacing;
+        shape_type m_shape;
+        std::vector<double> m_values;
+        sdf_interpolation m_interpolation;
+        /**
+         * @brief Last point of the grid.
+         */
+        small::vec<dim> m_upper;
+        std::vector<small::vec<dim>> m_surface_points;
+        double m_bounding_radius{0.};
+        std::size_t m_hash{std::numeric_limits<std::size_t>::min()};
+    };
+
+    ////////////////////
+    // sdf definition //
+    ////////////////////
+    /**
+     * @class sdf
+     * @brief Rigid shape given by a signed distance grid.
+     *
+     * Used for shapes which are neither spheres nor superellipsoids. The grid is shared between all the particles
+     * with this shape: the container keeps one copy of the shape for each hash (see scopi_container), and the hash
+     * only depends on the grid, so that the memory does not depend on the number of particles.
+     *
+     * The contact with a sphere uses the value of the grid at its center, the contacts with a plane, another
+     * sdf or a convex object use the surface points of the grid.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam owner
+     */
+    template <std::size_t dim, bool owner = true>
+    class sdf : public object<dim, owner>
+    {
+      public:
+
+        /**
+         * @brief Alias for the base class object.
+         */
+        using base_type = object<dim, owner>;
+        /**
+         * @brief Alias for position type.
+         */
+        using position_type = typename base_type::position_type;
+        /**
+         * @brief Alias for quaternion type.
+         */
+        using quaternion_type = typename base_type::quaternion_type;
+
+        /**
+         * @brief Constructor with default rotation.
+         *
+         * @param pos [in] Position of the origin of the frame of the shape.
+         * @param grid [in] Signed distance grid of the shape.
+         */
+        sdf(position_type pos, std::shared_ptr<const sdf_grid<dim>> grid);
+        /**
+         * @brief Constructor with given rotation.
+         *
+         * @param pos [in] Position of the origin of the frame of the shape.
+         * @param q [in] Quaternion describing the rotation of the shape.
+         * @param grid [in] Signed distance grid of the shape.
+         */
+        sdf(position_type pos, quaternion_type q, std::shared_ptr<const sdf_grid<dim>> grid);
+
+        /**
+         * @brief Signed distance grid of the shape.
+         */
+        const sdf_grid<dim>& grid() const;
+        /**
+         * @brief Get the rotation matrix of the shape.
+         */
+        auto rotation() const;
+        /**
+         * @brief Radius of the sphere centered at the position of the shape which contains it.
+         */
+        double bounding_radius() const;
+        /**
+         * @brief Signed distance to the shape and outer normal at a point.
+         *
+         * @param p [in] Point.
+         * @param normal [out] Unit gradient of the signed distance at \c p.
+         */
+        double signed_distance(const small::vec<dim>& p, small::vec<dim>& normal) const;
+
+        /**
+         * @brief
+         *
+         * \todo Write documentation.
+         *
+         * @return
+         */
+        std::unique_ptr<base_constructor<dim>> construct() const override;
+        /**
+         * @brief Print the elements of the shape on standard output.
+         */
+        void print() const override;
+        /**
+         * @brief Get the hash of the shape.
+         */
+        std::size_t hash() const override;
+
+      private:
+
+        std::shared_ptr<const sdf_grid<dim>> m_grid;
+    };
+
+    /**
+     * @brief Sample a signed distance function on a grid.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param f [in] Signed distance function, called with a point of the frame of the shape.
+     * @param lower [in] Lower corner of the grid.
+     * @param upper [in] Upper corner of the grid.
+     * @param spacing [in] Distance between two points of the grid.
+     * @param interpolation [in] Interpolation of the values.
+     */
+    template <std::size_t dim, class F>
+    std::shared_ptr<const sdf_grid<dim>> make_sdf_grid(F&& f,
+                                                       const small::vec<dim>& lower,
+                                                       const small::vec<dim>& upper,
+                                                       double spacing,
+                                                       sdf_interpolation interpolation = sdf_interpolation::linear)
+    {
+        typename sdf_grid<dim>::shape_type shape;
+        std::size_t size = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            shape[d] = std::max(static_cast<std::size_t>(std::ceil((upper[d] - lower[d]) / spacing)) + 1, std::size_t(2));
+            size *= shape[d];
+        }
+
+        std::vector<double> values(size);
+        for (std::size_t n = 0; n < size; ++n)
+        {
+            small::vec<dim> p;
+            std::size_t rest = n;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                p[d] = lower[d] + static_cast<double>(rest % shape[d]) * spacing;
+                rest /= shape[d];
+            }
+            values[n] = f(p);
+        }
+        return std::make_shared<const sdf_grid<dim>>(lower, spacing, shape, std::move(values), interpolation);
+    }
+
+    /////////////////////////////
+    // sdf_grid implementation //
+    /////////////////////////////
+    template <std::size_t dim>
+    sdf_grid<dim>::sdf_grid(const small::vec<dim>& origin,
+                            double spacing,
+                            const shape_type& shape,
+                            std::vector<double> values,
+                            sdf_interpolation interpolation)
+        : m_origin(origin)
+        , m_spacing(spacing)
+        , m_shape(shape)
+        , m_values(std::move(values))
+        , m_interpolation(interpolation)
+    {
+        if (!(m_spacing > 0.))
+        {
+            throw std::runtime_error(fmt::format("sdf_grid: the spacing must be positive, got {}", m_spacing));
+        }
+        std::size_t size = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            if (m_shape[d] < 2)
+            {
+                throw std::runtime_error(fmt::format("sdf_grid: at least 2 points are needed in direction {}", d));
+            }
+            size *= m_shape[d];
+            m_upper[d] = m_origin[d] + static_cast<double>(m_shape[d] - 1) * m_spacing;
+        }
+        if (m_values.size() != size)
+        {
+            throw std::runtime_error(fmt::format("sdf_grid: {} values given for a grid of {} points", m_values.size(), size));
+        }
+        sample_surface();
+        create_hash();
+    }
+
+    template <std::size_t dim>
+    const small::vec<dim>& sdf_grid<dim>::origin() const
+    {
+        return m_origin;
+    }
+
+    template <std::size_t dim>
+    double sdf_grid<dim>::spacing() const
+    {
+        return m_spacing;
+    }
+
+    template <std::size_t dim>
+    auto sdf_grid<dim>::shape() const -> const shape_type&
+    {
+        return m_shape;
+    }
+
+    template <std::size_t dim>
+    const std::vector<double>& sdf_grid<dim>::values() const
+    {
+        return m_values;
+    }
+
+    template <std::size_t dim>
+    sdf_interpolation sdf_grid<dim>::interpolation() const
+    {
+        return m_interpolation;
+    }
+
+    template <std::size_t dim>
+    double sdf_grid<dim>::value(const small::vec<dim>& p) const
+    {
+        small::vec<dim> gradient;
+        return value(p, gradient);
+    }
+
+    template <std::size_t dim>
+    double sdf_grid<dim>::value(const small::vec<dim>& p, small::vec<dim>& gradient) const
+    {
+        small::vec<dim> inside;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            inside[d] = std::clamp(p[d], m_origin[d], m_upper[d]);
+        }
+        double phi     = interpolate(inside, gradient);
+        double outside = small::norm(p - inside);
+        if (outside > 0.)
+        {
+            gradient = (p - inside) / outside;
+        }
+        return phi + outside;
+    }
+
+    template <std::size_t dim>
+    small::vec<dim> sdf_grid<dim>::gradient(const small::vec<dim>& p) const
+    {
+        small::vec<dim> gradient;
+        value(p, gradient);
+        return gradient;
+    }
+
+    template <std::size_t dim>
+    const std::vector<small::vec<dim>>& sdf_grid<dim>::surface_points() const
+    {
+        return m_surface_points;
+    }
+
+    template <std::size_t dim>
+    double sdf_grid<dim>::bounding_radius() const
+    {
+        return m_bounding_radius;
+    }
+
+    template <std::size_t dim>
+    std::size_t sdf_grid<dim>::hash() const
+    {
+        return m_hash;
+    }
+
+    template <std::size_t dim>
+    double sdf_grid<dim>::interpolate(const small::vec<dim>& p, small::vec<dim>& gradient) const
+    {
+        constexpr std::size_t max_points = 4;
+        std::size_t points               = m_interpolation == sdf_interpolation::cubic ? 4 : 2;
+
+        // indices, weights and derivatives of the weights of the points in each direction
+        std::array<std::array<std::size_t, max_points>, dim> index;
+        std::array<std::array<double, max_points>, dim> w;
+        std::array<std::array<double, max_points>, dim> dw;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            double x  = (p[d] - m_origin[d]) / m_spacing;
+            long last = static_cast<long>(m_shape[d]) - 1;
+            long cell = std::clamp(static_cast<long>(std::floor(x)), 0L, last - 1);
+            double t  = std::clamp(x - static_cast<double>(cell), 0., 1.);
+            double h  = 1. / m_spacing;
+            if (m_interpolation == sdf_interpolation::cubic)
+            {
+                double t2 = t * t;
+                double t3 = t2 * t;
+                w[d]      = {0.5 * (-t3 + 2. * t2 - t), 0.5 * (3. * t3 - 5. * t2 + 2.), 0.5 * (-3. * t3 + 4. * t2 + t), 0.5 * (t3 - t2)};
+                dw[d]     = {0.5 * h * (-3. * t2 + 4. * t - 1.),
+                             0.5 * h * (9. * t2 - 10. * t),
+                             0.5 * h * (-9. * t2 + 8. * t + 1.),
+                             0.5 * h * (3. * t2 - 2. * t)};
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    index[d][k] = static_cast<std::size_t>(std::clamp(cell - 1 + static_cast<long>(k), 0L, last));
+                }
+            }
+            else
+            {
+                w[d]     = {1. - t, t, 0., 0.};
+                dw[d]    = {-h, h, 0., 0.};
+                index[d] = {static_cast<std::size_t>(cell), static_cast<std::size_t>(cell + 1), 0, 0};
+            }
+        }
+
+        std::size_t nb_points = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            nb_points *= points;
+        }
+
+        double value = 0.;
+        gradient     = {};
+        for (std::size_t c = 0; c < nb_points; ++c)
+        {
+            std::array<std::size_t, dim> k;
+            std::size_t rest   = c;
+            std::size_t flat   = 0;
+            std::size_t stride = 1;
+            double weight      = 1.;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                k[d] = rest % points;
+                rest /= points;
+                flat += index[d][k[d]] * stride;
+                stride *= m_shape[d];
+                weight *= w[d][k[d]];
+            }
+
+            double v = m_values[flat];
+            value += weight * v;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                double dweight = dw[d][k[d]];
+                for (std::size_t e = 0; e < dim; ++e)
+                {
+                    if (e != d)
+                    {
+                        dweight *= w[e][k[e]];
+                    }
+                }
+                gradient[d] += dweight * v;
+            }
+        }
+        return value;
+    }
+
+    template <std::size_t dim>
+    void sdf_grid<dim>::sample_surface()
+    {
+        // the zero level set crosses a cell whose corners change sign: it is at most half a diagonal away from the
+        // center of the cell, plus one spacing since the cubic interpolation can overshoot into the neighbor cells
+        double margin        = (0.5 * std::sqrt(static_cast<double>(dim)) + 1.) * m_spacing;
+        std::size_t nb_cells = 1;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            nb_cells *= m_shape[d] - 1;
+        }
+
+        for (std::size_t c = 0; c < nb_cells; ++c)
+        {
+            // first point of the cell
+            std::array<std::size_t, dim> cell;
+            std::size_t rest = c;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                cell[d] = rest % (m_shape[d] - 1);
+                rest /= m_shape[d] - 1;
+            }
+
+            double min = std::numeric_limits<double>::max();
+            double max = std::numeric_limits<double>::lowest();
+            for (std::size_t corner = 0; corner < (std::size_t(1) << dim); ++corner)
+            {
+                std::size_t flat   = 0;
+                std::size_t stride = 1;
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    flat += (cell[d] + ((corner >> d) & 1)) * stride;
+                    stride *= m_shape[d];
+                }
+                min = std::min(min, m_values[flat]);
+                max = std::max(max, m_values[flat]);
+            }
+            if (min > 0. || max < 0.)
+            {
+                continue;
+            }
+
+            small::vec<dim> p;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                p[d] = m_origin[d] + (static_cast<double>(cell[d]) + 0.5) * m_spacing;
+            }
+            m_bounding_radius = std::max(m_bounding_radius, small::norm(p) + margin);
+
+            // projection of the center of the cell on the zero level set
+            small::vec<dim> gradient;
+            double phi = 0.;
+            for (std::size_t it = 0; it < 4; ++it)
+            {
+                phi              = value(p, gradient);
+                double gradient2 = small::squared_norm(gradient);
+                if (gradient2 == 0.)
+                {
+                    break;
+                }
+                p -= (phi / gradient2) * gradient;
+            }
+            phi = value(p);
+            if (std::abs(phi) <= 0.5 * m_spacing)
+            {
+                m_surface_points.push_back(p);
+            }
+        }
+    }
+
+    template <std::size_t dim>
+    void sdf_grid<dim>::create_hash()
+    {
+        std::stringstream ss;
+        ss << "sdf_grid<" << dim << ">(" << static_cast<int>(m_interpolation) << ", " << m_spacing;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            ss << ", " << m_origin[d] << ", " << m_shape[d];
+        }
+        ss << ")";
+        std::string_view values(reinterpret_cast<const char*>(m_values.data()), m_values.size() * sizeof(double));
+        m_hash = std::hash<std::string>{}(ss.str()) ^ (std::hash<std::string_view>{}(values) << 1);
+    }
+
+    ////////////////////////
+    // sdf implementation //
+    ////////////////////////
+    template <std::size_t dim, bool owner>
+    sdf<dim, owner>::sdf(position_type pos, std::shared_ptr<const sdf_grid<dim>> grid)
+        : base_type(pos, {quaternion()}, 1)
+        , m_grid(std::move(grid))
+    {
+    }
+
+    template <std::size_t dim, bool owner>
+    sdf<dim, owner>::sdf(position_type pos, quaternion_type q, std::shared_ptr<const sdf_grid<dim>> grid)
+        : base_type(pos, q, 1)
+        , m_grid(std::move(grid))
+    {
+    }
+
+    template <std::size_t dim, bool owner>
+    const sdf_grid<dim>& sdf<dim, owner>::grid() const
+    {
+        return *m_grid;
+    }
+
+    template <std::size_t dim, bool owner>
+    auto sdf<dim, owner>::rotation() const
+    {
+        return rotation_matrix<dim>(this->q());
+    }
+
+    template <std::size_t dim, bool owner>
+    double sdf<dim, owner>::bounding_radius() const
+    {
+        return m_grid->bounding_radius();
+    }
+
+    template <std::size_t dim, bool owner>
+    double sdf<dim, owner>::signed_distance(const small::vec<dim>& p, small::vec<dim>& normal) const
+    {
+        auto r     = small::rotation_matrix<dim>(small::to_quat(this->q(0)));
+        auto local = small::transpose(r) * (p - small::to_vec<dim>(this->pos(0)));
+        double phi = m_grid->value(local, normal);
+        normal     = r * normal;
+        if (small::squared_norm(normal) > 0.)
+        {
+            normal = small::normalized(normal);
+        }
+        return phi;
+    }
+
+    template <std::size_t dim, bool owner>
+    std::unique_ptr<base_constructor<dim>> sdf<dim, owner>::construct() const
+    {
+        return make_object_constructor<sdf<dim, false>>(m_grid);
+    }
+
+    template <std::size_t dim, bool owner>
+    void sdf<dim, owner>::print() const
+    {
+        std::cout << "sdf<" << dim << ">(" << m_grid->values().size() << " values, " << m_grid->surface_points().size()
+                  << " surface points)\n";
+    }
+
+    template <std::size_t dim, bool owner>
+    std::size_t sdf<dim, owner>::hash() const
+    {
+        return m_grid->hash();
+    }
+}
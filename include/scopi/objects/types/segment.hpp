@@ -90,6 +90,11 @@ namespace scopi
 
         auto extrema() const;
 
+        /**
+         * @brief Get the length of the segment.
+         */
+        double length() const;
+
         /**
          * @brief
          *
@@ -165,6 +170,12 @@ namespace scopi
         return xt::xtensor_fixed<double, xt::xshape<dim>>{-n[1], n[0]};
     }
 
+    template <std::size_t dim, bool owner>
+    double segment<dim, owner>::length() const
+    {
+        return m_length;
+    }
+
     template <std::size_t dim, bool owner>
     auto segment<dim, owner>::extrema() const
     {
@@ -1,14 +1,51 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 #include "../../quaternion.hpp"
+#include "../../small_math.hpp"
 #include "../../types.hpp"
 #include "base.hpp"
 
 namespace scopi
 {
+    /**
+     * @brief Samples of the surface of a superellipsoid, in the frame of the superellipsoid.
+     *
+     * They are the starting points of the Newton method for the closest points between two superellipsoids.
+     * As they only depend on the radiuses and on the squareness, they are computed once per shape and shared by all
+     * the superellipsoids of this shape (see superellipsoid::samples).
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    struct superellipsoid_samples
+    {
+        /**
+         * @brief Angle \c a of each sample (3D only).
+         */
+        std::vector<double> a;
+        /**
+         * @brief Angle \c b of each sample.
+         */
+        std::vector<double> b;
+        /**
+         * @brief Point of each sample.
+         */
+        std::vector<small::vec<dim>> points;
+        /**
+         * @brief Unit outer normal of each sample.
+         */
+        std::vector<small::vec<dim>> normals;
+    };
+
     ///////////////////////
     // superellipsoid definition //
     ///////////////////////
@@ -64,6 +101,22 @@ namespace scopi
          * @param squareness [in] Squareness (1 element in 2D, 2 elements in 3D).
          */
         superellipsoid(position_type pos, quaternion_type q, type::position_t<dim> radius, type::position_t<dim - 1> squareness);
+        /**
+         * @brief Constructor with given rotation and samples of the surface.
+         *
+         * Used by the container, which shares the samples between the superellipsoids of the same shape.
+         *
+         * @param pos [in] Position of the center of the superellipsoid.
+         * @param q [in] Quaternion describing the rotation of the sphere.
+         * @param radius [in] Radiuses in all the direction (2 elements in 2D, 3 elements in 3D).
+         * @param squareness [in] Squareness (1 element in 2D, 2 elements in 3D).
+         * @param samples [in] Samples of the surface of the superellipsoid.
+         */
+        superellipsoid(position_type pos,
+                       quaternion_type q,
+                       type::position_t<dim> radius,
+                       type::position_t<dim - 1> squareness,
+                       std::shared_ptr<const superellipsoid_samples<dim>> samples);
 
         // superellipsoid(const superellipsoid&) = default;
         // superellipsoid& operator=(const superellipsoid&) = default;
@@ -177,9 +230,43 @@ namespace scopi
          * @return
          */
         std::vector<double> ainit_xz(int n) const; // dim  3
+        /**
+         * @brief Get the samples of the surface, in the frame of the superellipsoid.
+         *
+         * They are the combinations of the angles given by binit_xy (and ainit_yz in 3D).
+         */
+        const superellipsoid_samples<dim>& samples() const;
+
+        /**
+         * @brief Number of angles given to binit_xy and ainit_yz to build the samples.
+         */
+        static constexpr int nb_sample_angles = dim == 2 ? 4 : 6;
 
       private:
 
+        /**
+         * @brief Point of angle \c b in the frame of the superellipsoid (2D).
+         */
+        small::vec<dim> local_point(double b) const;
+        /**
+         * @brief Point of angles \c a and \c b in the frame of the superellipsoid (3D).
+         */
+        small::vec<dim> local_point(double a, double b) const;
+        /**
+         * @brief Unit outer normal at angle \c b in the frame of the superellipsoid (2D).
+         */
+        small::vec<dim> local_normal(double b) const;
+        /**
+         * @brief Unit outer normal at angles \c a and \c b in the frame of the superellipsoid (3D).
+         */
+        small::vec<dim> local_normal(double a, double b) const;
+        /**
+         * @brief Get the samples of the shape from the cache, or compute them.
+         *
+         * The cache is indexed by the values of the radiuses and of the squareness.
+         */
+        void create_samples();
+
         /**
          * @brief Create the hash of the spheres.
          *
@@ -199,6 +286,10 @@ namespace scopi
          * @brief Hash of the superellipsoid.
          */
         std::size_t m_hash{std::numeric_limits<std::size_t>::min()};
+        /**
+         * @brief Samples of the surface, shared by the superellipsoids of the same shape.
+         */
+        std::shared_ptr<const superellipsoid_samples<dim>> m_samples;
     };
 
     ///////////////////////////////////
@@ -211,6 +302,7 @@ namespace scopi
         , m_squareness(squareness)
     {
         create_hash();
+        create_samples();
     }
 
     template <std::size_t dim, bool owner>
@@ -221,6 +313,21 @@ namespace scopi
         : base_type(pos, q, 1)
         , m_radius(radius)
         , m_squareness(squareness)
+    {
+        create_hash();
+        create_samples();
+    }
+
+    template <std::size_t dim, bool owner>
+    superellipsoid<dim, owner>::superellipsoid(position_type pos,
+                                               quaternion_type q,
+                                               type::position_t<dim> radius,
+                                               type::position_t<dim - 1> squareness,
+                                               std::shared_ptr<const superellipsoid_samples<dim>> samples)
+        : base_type(pos, q, 1)
+        , m_radius(radius)
+        , m_squareness(squareness)
+        , m_samples(std::move(samples))
     {
         create_hash();
     }
@@ -228,7 +335,7 @@ namespace scopi
     template <std::size_t dim, bool owner>
     std::unique_ptr<base_constructor<dim>> superellipsoid<dim, owner>::construct() const
     {
-        return make_object_constructor<superellipsoid<dim, false>>(m_radius, m_squareness);
+        return make_object_constructor<superellipsoid<dim, false>>(m_radius, m_squareness, m_samples);
     }
 
     template <std::size_t dim, bool owner>
@@ -279,49 +386,135 @@ namespace scopi
     }
 
     template <std::size_t dim, bool owner>
-    auto superellipsoid<dim, owner>::point(double b) const
+    small::vec<dim> superellipsoid<dim, owner>::local_point(double b) const
     {
-        xt::xtensor_fixed<double, xt::xshape<dim>> pt;
-        pt(0) = m_radius(0) * sign(std::cos(b)) * std::pow(std::abs(std::cos(b)), m_squareness(0));
-        pt(1) = m_radius(1) * sign(std::sin(b)) * std::pow(std::abs(std::sin(b)), m_squareness(0));
-        return xt::flatten(xt::eval(xt::linalg::dot(rotation_matrix<dim>(this->q()), pt) + this->pos()));
+        small::vec<dim> pt{};
+        pt[0] = m_radius(0) * sign(std::cos(b)) * std::pow(std::abs(std::cos(b)), m_squareness(0));
+        pt[1] = m_radius(1) * sign(std::sin(b)) * std::pow(std::abs(std::sin(b)), m_squareness(0));
+        return pt;
     }
 
     template <std::size_t dim, bool owner>
-    auto superellipsoid<dim, owner>::point(double a, double b) const
+    small::vec<dim> superellipsoid<dim, owner>::local_point(double a, double b) const
     {
-        xt::xtensor_fixed<double, xt::xshape<dim>> pt;
-        pt(0) = m_radius(0) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), m_squareness(1)) * sign(std::cos(b))
+        small::vec<dim> pt{};
+        pt[0] = m_radius(0) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), m_squareness(1)) * sign(std::cos(b))
               * std::pow(std::abs(std::cos(b)), m_squareness(0));
-        pt(1) = m_radius(1) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), m_squareness(1)) * sign(std::sin(b))
+        pt[1] = m_radius(1) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), m_squareness(1)) * sign(std::sin(b))
               * std::pow(std::abs(std::sin(b)), m_squareness(0));
-        pt(2) = m_radius(2) * sign(std::sin(a)) * std::pow(std::abs(std::sin(a)), m_squareness(1));
-        return xt::flatten(xt::eval(xt::linalg::dot(rotation_matrix<dim>(this->q()), pt) + this->pos()));
+        pt[2] = m_radius(2) * sign(std::sin(a)) * std::pow(std::abs(std::sin(a)), m_squareness(1));
+        return pt;
     }
 
     template <std::size_t dim, bool owner>
-    auto superellipsoid<dim, owner>::normal(double b) const
+    small::vec<dim> superellipsoid<dim, owner>::local_normal(double b) const
     {
-        xt::xtensor_fixed<double, xt::xshape<dim>> n;
-        n(0) = m_radius(1) * sign(std::cos(b)) * std::pow(std::abs(std::cos(b)), 2 - m_squareness(0));
-        n(1) = m_radius(0) * sign(std::sin(b)) * std::pow(std::abs(std::sin(b)), 2 - m_squareness(0));
-        n    = xt::flatten(xt::linalg::dot(rotation_matrix<dim>(this->q()), n));
-        n /= xt::linalg::norm(n, 2);
-        return n;
+        small::vec<dim> n{};
+        n[0] = m_radius(1) * sign(std::cos(b)) * std::pow(std::abs(std::cos(b)), 2 - m_squareness(0));
+        n[1] = m_radius(0) * sign(std::sin(b)) * std::pow(std::abs(std::sin(b)), 2 - m_squareness(0));
+        return small::normalized(n);
     }
 
     template <std::size_t dim, bool owner>
-    auto superellipsoid<dim, owner>::normal(double a, double b) const
+    small::vec<dim> superellipsoid<dim, owner>::local_normal(double a, double b) const
     {
-        xt::xtensor_fixed<double, xt::xshape<dim>> n;
-        n(0) = m_radius(1) * m_radius(2) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), 2 - m_squareness(1)) * sign(std::cos(b))
+        small::vec<dim> n{};
+        n[0] = m_radius(1) * m_radius(2) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), 2 - m_squareness(1)) * sign(std::cos(b))
              * std::pow(std::abs(std::cos(b)), 2 - m_squareness(0));
-        n(1) = m_radius(0) * m_radius(2) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), 2 - m_squareness(1)) * sign(std::sin(b))
+        n[1] = m_radius(0) * m_radius(2) * sign(std::cos(a)) * std::pow(std::abs(std::cos(a)), 2 - m_squareness(1)) * sign(std::sin(b))
              * std::pow(std::abs(std::sin(b)), 2 - m_squareness(0));
-        n(2) = m_radius(0) * m_radius(1) * sign(std::sin(a)) * std::pow(std::abs(std::sin(a)), 2 - m_squareness(1));
-        n    = xt::flatten(xt::linalg::dot(rotation_matrix<dim>(this->q()), n));
-        n /= xt::linalg::norm(n, 2);
-        return n;
+        n[2] = m_radius(0) * m_radius(1) * sign(std::sin(a)) * std::pow(std::abs(std::sin(a)), 2 - m_squareness(1));
+        return small::normalized(n);
+    }
+
+    template <std::size_t dim, bool owner>
+    auto superellipsoid<dim, owner>::point(double b) const
+    {
+        return small::to_xtensor(small::rotation_matrix<dim>(small::to_quat(this->q(0))) * local_point(b) + small::to_vec<dim>(this->pos(0)));
+    }
+
+    template <std::size_t dim, bool owner>
+    auto superellipsoid<dim, owner>::point(double a, double b) const
+    {
+        return small::to_xtensor(small::rotation_matrix<dim>(small::to_quat(this->q(0))) * local_point(a, b)
+                                 + small::to_vec<dim>(this->pos(0)));
+    }
+
+    template <std::size_t dim, bool owner>
+    auto superellipsoid<dim, owner>::normal(double b) const
+    {
+        return small::to_xtensor(small::rotation_matrix<dim>(small::to_quat(this->q(0))) * local_normal(b));
+    }
+
+    template <std::size_t dim, bool owner>
+    auto superellipsoid<dim, owner>::normal(double a, double b) const
+    {
+        return small::to_xtensor(small::rotation_matrix<dim>(small::to_quat(this->q(0))) * local_normal(a, b));
+    }
+
+    template <std::size_t dim, bool owner>
+    const superellipsoid_samples<dim>& superellipsoid<dim, owner>::samples() const
+    {
+        return *m_samples;
+    }
+
+    template <std::size_t dim, bool owner>
+    void superellipsoid<dim, owner>::create_samples()
+    {
+        static std::mutex mutex;
+        static std::map<std::array<double, 2 * dim - 1>, std::weak_ptr<const superellipsoid_samples<dim>>> cache;
+
+        // the exact shape parameters, two shapes never share an entry
+        std::array<double, 2 * dim - 1> key;
+        std::copy(m_radius.cbegin(), m_radius.cend(), key.begin());
+        std::copy(m_squareness.cbegin(), m_squareness.cend(), key.begin() + dim);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        m_samples = cache[key].lock();
+        if (m_samples)
+        {
+            return;
+        }
+        // drop the shapes which are no longer used by any superellipsoid
+        for (auto it = cache.begin(); it != cache.end();)
+        {
+            it = it->second.expired() ? cache.erase(it) : std::next(it);
+        }
+
+        auto unique_angles = [](std::vector<double> angles)
+        {
+            std::sort(angles.begin(), angles.end());
+            angles.erase(std::unique(angles.begin(), angles.end()), angles.end());
+            return angles;
+        };
+
+        auto samples = std::make_shared<superellipsoid_samples<dim>>();
+        auto bs      = unique_angles(binit_xy(nb_sample_angles));
+        if constexpr (dim == 2)
+        {
+            for (double b : bs)
+            {
+                samples->b.push_back(b);
+                samples->points.push_back(local_point(b));
+                samples->normals.push_back(local_normal(b));
+            }
+        }
+        else
+        {
+            // same ordering as the flattened xt::meshgrid(as, bs)
+            for (double a : unique_angles(ainit_yz(nb_sample_angles)))
+            {
+                for (double b : bs)
+                {
+                    samples->a.push_back(a);
+                    samples->b.push_back(b);
+                    samples->points.push_back(local_point(a, b));
+                    samples->normals.push_back(local_normal(a, b));
+                }
+            }
+        }
+        m_samples  = samples;
+        cache[key] = m_samples;
     }
 
     template <std::size_t dim, bool owner>
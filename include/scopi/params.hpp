@@ -104,6 +104,24 @@ namespace scopi
          * \note \c output_frequency > 0
          */
         std::size_t output_frequency;
+        /**
+         * @brief Frequency to write the checkpoints (see ScopiSolver::restart).
+         *
+         * If \c checkpoint_frequency is <tt> std::size_t(-1) </tt>, then no checkpoint is written.
+         * Default value is <tt> std::size_t(-1) </tt>.
+         */
+        std::size_t checkpoint_frequency;
+        /**
+         * @brief Frequency to compute the observables of ScopiSolver::analysis (see analysis_pipeline).
+         *
+         * As for the output files, the observables of the time steps which reach an iteration multiple of
+         * \c analysis_frequency are appended to the file <tt>path/filename_analysis.csv</tt>: the row of an iteration is
+         * written once, even if the simulation is restarted from a checkpoint of this iteration. They are computed with
+         * the new velocities and the positions before the move, at which the contacts were detected.
+         * If \c analysis_frequency is <tt> std::size_t(-1) </tt>, then no observable is computed.
+         * Default value is <tt> std::size_t(-1) </tt>.
+         */
+        std::size_t analysis_frequency;
 
         std::filesystem::path path;
         /**
@@ -124,6 +142,57 @@ namespace scopi
          * Default value is false.
          */
         bool binary_output;
+        /**
+         * @brief Whether to write columnar binary snapshots (see snapshot.hpp) instead of json or bson files.
+         *
+         * Default value is false.
+         */
+        bool snapshot_output;
+        /**
+         * @brief Whether the json or bson files are streamed one object at a time instead of built as a whole document.
+         *
+         * The json files are then written without indentation (see write_json_stream).
+         * Default value is false.
+         */
+        bool streaming_output;
+        /**
+         * @brief Whether the output files are written by a background thread (see async_writer).
+         *
+         * Default value is false.
+         */
+        bool async_output;
+        /**
+         * @brief Number of output frames of the background thread: the solver waits if they are all queued.
+         *
+         * Default value is 2.
+         */
+        std::size_t output_buffers;
+        /**
+         * @brief Whether the resting particles are put to sleep.
+         *
+         * A sleeping particle is excluded from the optimization problem and from the integration,
+         * and behaves as an obstacle for the other particles.
+         * Default value is false.
+         */
+        bool sleep;
+        /**
+         * @brief Velocity under which a particle is considered at rest.
+         *
+         * Default value is 1e-4.
+         */
+        double sleep_velocity;
+        /**
+         * @brief Rotation velocity under which a particle is considered at rest.
+         *
+         * Default value is 1e-4.
+         */
+        double sleep_omega;
+        /**
+         * @brief Number of consecutive iterations at rest before the particles of an island fall asleep.
+         *
+         * Default value is 50.
+         */
+        std::size_t sleep_steps;
     };
 
     /**
@@ -5,7 +5,11 @@
 
 #include "container.hpp"
 #include "json.hpp"
+#include "objects/types/capsule.hpp"
+#include "objects/types/clump.hpp"
+#include "objects/types/mesh.hpp"
 #include "objects/types/plane.hpp"
+#include "objects/types/sdf.hpp"
 #include "objects/types/segment.hpp"
 #include "objects/types/sphere.hpp"
 #include "objects/types/superellipsoid.hpp"
@@ -17,51 +21,142 @@ namespace nl = nlohmann;
 namespace scopi
 {
 
+    /**
+     * @brief Build the signed distance grid described by \c o (see write_sdf_grid).
+     */
     template <std::size_t dim>
-    auto from_json(const nl::json& j)
+    std::shared_ptr<const sdf_grid<dim>> make_sdf_grid_from_json(const nl::json& o)
+    {
+        return std::make_shared<const sdf_grid<dim>>(small::to_vec<dim>(o["origin"].get<xt::xtensor<double, 1>>()),
+                                                     o["spacing"].get<double>(),
+                                                     o["shape"].get<typename sdf_grid<dim>::shape_type>(),
+                                                     o["values"].get<std::vector<double>>(),
+                                                     static_cast<sdf_interpolation>(o["interpolation"].get<int>()));
+    }
+
+    /**
+     * @brief Build the object described by \c o (see write_objects) and pass it to \c f.
+     *
+     * An sdf is only rebuilt if its grid is given (see write_sdf_grid), as in the shape table of the checkpoints.
+     *
+     * @return false if the type of the object is unknown.
+     */
+    template <std::size_t dim, class Function>
+    bool make_object_from_json(const nl::json& o, Function&& f)
     {
         using xt_t = xt::xtensor<double, 1>;
-        scopi_container<dim> container;
 
-        for (const auto& o : j["objects"])
-        {
-            std::string type = o["type"];
+        std::string type = o["type"];
 
-            if (type == "sphere")
-            {
-                sphere<dim> s({o["position"].get<xt_t>()}, {o["quaternion"].get<xt_t>()}, o["radius"].get<double>());
-                container.push_back(s, o["properties"]);
-            }
-            else if (type == "superellipsoid")
-            {
-                superellipsoid<dim> s({o["position"].get<xt_t>()},
-                                      {o["quaternion"].get<xt_t>()},
-                                      o["radius"].get<xt_t>(),
-                                      o["squareness"].get<xt_t>());
-                container.push_back(s, o["properties"]);
-            }
-            else if (type == "segment")
+        if (type == "sphere")
+        {
+            sphere<dim> s({o["position"].get<xt_t>()}, {o["quaternion"].get<xt_t>()}, o["radius"].get<double>());
+            f(s);
+        }
+        else if (type == "superellipsoid")
+        {
+            superellipsoid<dim> s({o["position"].get<xt_t>()},
+                                  {o["quaternion"].get<xt_t>()},
+                                  o["radius"].get<xt_t>(),
+                                  o["squareness"].get<xt_t>());
+            f(s);
+        }
+        else if (type == "segment")
+        {
+            segment<dim> s(o["p1"].get<xt_t>(), o["p2"].get<xt_t>());
+            f(s);
+        }
+        else if (type == "plane")
+        {
+            plane<dim> s({o["position"].get<xt_t>()}, {o["quaternion"].get<xt_t>()});
+            f(s);
+        }
+        else if (type == "capsule")
+        {
+            capsule<dim> s({o["position"].get<xt_t>()},
+                           {o["quaternion"].get<xt_t>()},
+                           o["radius"].get<double>(),
+                           o["length"].get<double>());
+            f(s);
+        }
+        else if (type == "clump")
+        {
+            std::vector<type::position_t<dim>> offsets;
+            for (auto& offset : o["offsets"])
             {
-                segment<dim> s(o["p1"].get<xt_t>(), o["p2"].get<xt_t>());
-                container.push_back(s, o["properties"]);
+                offsets.push_back(offset.get<xt_t>());
             }
-            else if (type == "plane")
+            clump<dim> c({o["position"].get<xt_t>()},
+                         {o["quaternion"].get<xt_t>()},
+                         offsets,
+                         o["radii"].get<std::vector<double>>());
+            f(c);
+        }
+        else if (type == "mesh")
+        {
+            std::shared_ptr<const mesh_data<dim>> data;
+            if (o.contains("file"))
             {
-                plane<dim> s({o["position"].get<xt_t>()}, {o["quaternion"].get<xt_t>()});
-                container.push_back(s, o["properties"]);
+                std::string file = o["file"];
+                if constexpr (dim == 3)
+                {
+                    bool is_stl = file.size() >= 4 && (file.substr(file.size() - 4) == ".stl" || file.substr(file.size() - 4) == ".STL");
+                    data        = is_stl ? load_stl(file) : load_obj<dim>(file);
+                }
+                else
+                {
+                    data = load_obj<dim>(file);
+                }
             }
-            else if (type == "worm")
+            else
             {
-                std::vector<type::position_t<dim>> pos;
-                std::vector<type::quaternion_t> q;
-                for (auto& p : o["worm"])
+                std::vector<small::vec<dim>> vertices;
+                for (auto& v : o["vertices"])
                 {
-                    pos.push_back(p["position"].get<xt_t>());
-                    q.push_back(p["quaternion"].get<xt_t>());
+                    vertices.push_back(small::to_vec<dim>(v.get<xt_t>()));
                 }
-                worm<dim> w(pos, q, o["worm"][0]["radius"], pos.size());
-                container.push_back(w, o["properties"]);
+                data = std::make_shared<const mesh_data<dim>>(std::move(vertices),
+                                                              o["primitives"].get<std::vector<typename mesh_data<dim>::primitive_type>>());
+            }
+            mesh<dim> m({o["position"].get<xt_t>()}, {o["quaternion"].get<xt_t>()}, data);
+            f(m);
+        }
+        else if (type == "sdf" && o.contains("grid"))
+        {
+            sdf<dim> s({o["position"].get<xt_t>()}, {o["quaternion"].get<xt_t>()}, make_sdf_grid_from_json<dim>(o["grid"]));
+            f(s);
+        }
+        else if (type == "worm")
+        {
+            std::vector<type::position_t<dim>> pos;
+            std::vector<type::quaternion_t> q;
+            for (auto& p : o["worm"])
+            {
+                pos.push_back(p["position"].get<xt_t>());
+                q.push_back(p["quaternion"].get<xt_t>());
             }
+            worm<dim> w(pos, q, o["worm"][0]["radius"], pos.size());
+            f(w);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    template <std::size_t dim>
+    auto from_json(const nl::json& j)
+    {
+        scopi_container<dim> container;
+
+        for (const auto& o : j["objects"])
+        {
+            make_object_from_json<dim>(o,
+                                       [&](const auto& s)
+                                       {
+                                           container.push_back(s, o["properties"]);
+                                       });
         }
         return container;
     }
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <xtensor-blas/xlinalg.hpp>
+#include <xtensor/xfixed.hpp>
+
+#include "container.hpp"
+#include "objects/neighbor.hpp"
+#include "params.hpp"
+#include "solvers/islands.hpp"
+#include "utils.hpp"
+
+namespace scopi
+{
+    /**
+     * @brief Sleeping state of the particles.
+     *
+     * An active particle whose velocity and rotation velocity stay under the thresholds of ScopiParams during
+     * \c sleep_steps iterations is put to sleep, together with the particles of its island (the particles connected
+     * to it by contacts), provided they are all at rest.
+     * A sleeping particle has a zero velocity, is not integrated and is seen as an obstacle by the optimization solver.
+     *
+     * A sleeping particle wakes up when an awake particle which is not at rest can reach it during the time step,
+     * or when the force applied on it changes.
+     *
+     * @tparam dim Dimension (2 or 3).
+     */
+    template <std::size_t dim>
+    class sleep_manager
+    {
+      public:
+
+        using force_type = typename scopi_container<dim>::force_type;
+
+        explicit sleep_manager(const ScopiParams& params)
+            : m_params(params)
+        {
+        }
+
+        /**
+         * @brief Wake up the sleeping particles hit by a moving particle or whose force changed.
+         *
+         * Must be called before the computation of the a priori velocity, so that the velocities of
+         * the awake particles are those of the previous time step.
+         *
+         * @param particles [in] Array of particles.
+         * @param contacts [in] Array of contacts.
+         * @param dt [in] Time step.
+         *
+         * @return Number of particles woken up.
+         */
+        template <class problem_t>
+        std::size_t wake(const scopi_container<dim>& particles, const std::vector<neighbor<dim, problem_t>>& contacts, double dt)
+        {
+            resize(particles);
+            if (m_nb_sleeping == 0)
+            {
+                return 0;
+            }
+
+            std::size_t active_offset = particles.nb_inactive();
+            std::vector<bool> to_wake(m_sleeping.size(), false);
+
+            for (std::size_t i = active_offset; i < m_sleeping.size(); ++i)
+            {
+                if (m_sleeping[i] && xt::any(xt::not_equal(particles.f()(i), m_force[i])))
+                {
+                    to_wake[i] = true;
+                }
+            }
+
+            for (auto& c : contacts)
+            {
+                for (auto [s, a] : {std::make_pair(c.i, c.j), std::make_pair(c.j, c.i)})
+                {
+                    if (s >= active_offset && a >= active_offset && m_sleeping[s] && !m_sleeping[a] && !at_rest(particles, a)
+                        && c.dij <= dt * xt::linalg::norm(particles.v()(a)))
+                    {
+                        to_wake[s] = true;
+                    }
+                }
+            }
+
+            std::size_t nb_woken = 0;
+            for (std::size_t i = active_offset; i < m_sleeping.size(); ++i)
+            {
+                if (to_wake[i])
+                {
+                    m_sleeping[i] = false;
+                    ++nb_woken;
+                }
+            }
+            m_nb_sleeping -= nb_woken;
+            return nb_woken;
+        }
+
+        /**
+         * @brief Set the velocities of the sleeping particles to zero.
+         *
+         * Must be called after the computation of the a priori velocity.
+         *
+         * @param particles [out] Array of particles.
+         */
+        void freeze(scopi_container<dim>& particles) const
+        {
+            if (m_nb_sleeping == 0)
+            {
+                return;
+            }
+            for (std::size_t i = particles.nb_inactive(); i < m_sleeping.size(); ++i)
+            {
+                if (m_sleeping[i])
+                {
+                    particles.v()(i).fill(0.);
+                    if constexpr (dim == 2)
+                    {
+                        particles.omega()(i) = 0.;
+                    }
+                    else
+                    {
+                        particles.omega()(i).fill(0.);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Update the counters of iterations at rest and put the resting islands to sleep.
+         *
+         * Must be called once the velocities of the time step are known.
+         *
+         * @param particles [in] Array of particles.
+         * @param contacts [in] Array of contacts.
+         *
+         * @return Number of particles put to sleep.
+         */
+        template <class problem_t>
+        std::size_t update(const scopi_container<dim>& particles, const std::vector<neighbor<dim, problem_t>>& contacts)
+        {
+            resize(particles);
+            std::size_t active_offset = particles.nb_inactive();
+            std::size_t nb_active     = particles.nb_active();
+
+            for (std::size_t i = active_offset; i < m_sleeping.size(); ++i)
+            {
+                if (!m_sleeping[i])
+                {
+                    m_rest_steps[i] = at_rest(particles, i) ? m_rest_steps[i] + 1 : 0;
+                }
+            }
+
+            // an island falls asleep only if all its particles are at rest for long enough
+            union_find uf(nb_active);
+            for (auto& c : contacts)
+            {
+                if (c.i >= active_offset && c.j >= active_offset && !m_sleeping[c.i] && !m_sleeping[c.j])
+                {
+                    uf.unite(c.i - active_offset, c.j - active_offset);
+                }
+            }
+            std::vector<bool> can_sleep(nb_active, true);
+            for (std::size_t i = active_offset; i < m_sleeping.size(); ++i)
+            {
+                if (!m_sleeping[i] && m_rest_steps[i] < m_params.sleep_steps)
+                {
+                    can_sleep[uf.find(i - active_offset)] = false;
+                }
+            }
+
+            std::size_t nb_slept = 0;
+            for (std::size_t i = active_offset; i < m_sleeping.size(); ++i)
+            {
+                if (!m_sleeping[i] && can_sleep[uf.find(i - active_offset)])
+                {
+                    m_sleeping[i] = true;
+                    m_force[i]    = particles.f()(i);
+                    ++nb_slept;
+                }
+            }
+            m_nb_sleeping += nb_slept;
+            return nb_slept;
+        }
+
+        /**
+         * @brief For each particle of the container, whether it is sleeping.
+         */
+        const std::vector<bool>& sleeping() const
+        {
+            return m_sleeping;
+        }
+
+        bool is_sleeping(std::size_t i) const
+        {
+            return i < m_sleeping.size() && m_sleeping[i];
+        }
+
+        std::size_t nb_sleeping() const
+        {
+            return m_nb_sleeping;
+        }
+
+        /**
+         * @brief For each particle of the container, number of consecutive iterations at rest.
+         */
+        const std::vector<std::size_t>& rest_steps() const
+        {
+            return m_rest_steps;
+        }
+
+        /**
+         * @brief For each particle of the container, force applied when it fell asleep.
+         */
+        const std::vector<force_type>& sleep_forces() const
+        {
+            return m_force;
+        }
+
+        /**
+         * @brief Restore the state saved by a checkpoint (see read_checkpoint).
+         */
+        void restore(std::vector<bool> sleeping, std::vector<std::size_t> rest_steps, std::vector<force_type> forces)
+        {
+            m_sleeping    = std::move(sleeping);
+            m_rest_steps  = std::move(rest_steps);
+            m_force       = std::move(forces);
+            m_nb_sleeping = static_cast<std::size_t>(std::count(m_sleeping.begin(), m_sleeping.end(), true));
+        }
+
+      private:
+
+        bool at_rest(const scopi_container<dim>& particles, std::size_t i) const
+        {
+            return xt::linalg::norm(particles.v()(i)) < m_params.sleep_velocity
+                && xt::linalg::norm(get_omega(particles.omega()(i))) < m_params.sleep_omega;
+        }
+
+        // the container may have been modified (push_back, erase) between two calls: everybody wakes up
+        void resize(const scopi_container<dim>& particles)
+        {
+            std::size_t size = particles.nb_inactive() + particles.nb_active();
+            if (size != m_sleeping.size())
+            {
+                m_sleeping.assign(size, false);
+                m_rest_steps.assign(size, 0);
+                m_force.resize(size);
+                m_nb_sleeping = 0;
+            }
+        }
+
+        const ScopiParams& m_params;
+        std::vector<bool> m_sleeping;
+        std::vector<std::size_t> m_rest_steps;
+        std::vector<force_type> m_force;
+        std::size_t m_nb_sleeping = 0;
+    };
+}
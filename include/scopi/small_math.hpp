@@ -0,0 +1,477 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include <xtensor/xfixed.hpp>
+
+namespace scopi::small
+{
+    /**
+     * @brief Vector of \c N doubles with inlined arithmetic.
+     *
+     * Used in the geometric kernels instead of xtensor, whose BLAS calls (norm, dot, solve) cost more than the
+     * computation itself for 2 to 4 elements.
+     * It is an aggregate of \c N contiguous doubles, so that it can be copied from and to the element types of the
+     * container (see to_vec and to_xtensor) without overhead.
+     *
+     * @tparam N Number of elements.
+     */
+    template <std::size_t N>
+    struct vec
+    {
+        double v[N];
+
+        constexpr double& operator[](std::size_t i)
+        {
+            return v[i];
+        }
+
+        constexpr const double& operator[](std::size_t i) const
+        {
+            return v[i];
+        }
+
+        constexpr vec& operator+=(const vec& rhs)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                v[i] += rhs.v[i];
+            }
+            return *this;
+        }
+
+        constexpr vec& operator-=(const vec& rhs)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                v[i] -= rhs.v[i];
+            }
+            return *this;
+        }
+
+        constexpr vec& operator*=(double a)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                v[i] *= a;
+            }
+            return *this;
+        }
+
+        constexpr vec& operator/=(double a)
+        {
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                v[i] /= a;
+            }
+            return *this;
+        }
+    };
+
+    /**
+     * @brief Square matrix of size \c N stored by rows.
+     *
+     * @tparam N Number of rows and columns.
+     */
+    template <std::size_t N>
+    struct mat
+    {
+        double m[N][N];
+
+        constexpr double& operator()(std::size_t i, std::size_t j)
+        {
+            return m[i][j];
+        }
+
+        constexpr const double& operator()(std::size_t i, std::size_t j) const
+        {
+            return m[i][j];
+        }
+
+        constexpr vec<N> column(std::size_t j) const
+        {
+            vec<N> out{};
+            for (std::size_t i = 0; i < N; ++i)
+            {
+                out[i] = m[i][j];
+            }
+            return out;
+        }
+    };
+
+    /**
+     * @brief Quaternion, with the same ordering as type::quaternion_t.
+     *
+     * The first element is the real part.
+     */
+    struct quat
+    {
+        double q[4];
+
+        constexpr double& operator[](std::size_t i)
+        {
+            return q[i];
+        }
+
+        constexpr const double& operator[](std::size_t i) const
+        {
+            return q[i];
+        }
+    };
+
+    static_assert(sizeof(vec<3>) == 3 * sizeof(double) && std::is_trivially_copyable_v<vec<3>>);
+    static_assert(sizeof(mat<3>) == 9 * sizeof(double) && std::is_trivially_copyable_v<mat<3>>);
+    static_assert(sizeof(quat) == 4 * sizeof(double) && std::is_trivially_copyable_v<quat>);
+
+    ///////////////////////
+    // vector arithmetic //
+    ///////////////////////
+
+    template <std::size_t N>
+    constexpr vec<N> operator+(vec<N> lhs, const vec<N>& rhs)
+    {
+        return lhs += rhs;
+    }
+
+    template <std::size_t N>
+    constexpr vec<N> operator-(vec<N> lhs, const vec<N>& rhs)
+    {
+        return lhs -= rhs;
+    }
+
+    template <std::size_t N>
+    constexpr vec<N> operator-(vec<N> v)
+    {
+        return v *= -1.;
+    }
+
+    template <std::size_t N>
+    constexpr vec<N> operator*(double a, vec<N> v)
+    {
+        return v *= a;
+    }
+
+    template <std::size_t N>
+    constexpr vec<N> operator*(vec<N> v, double a)
+    {
+        return v *= a;
+    }
+
+    template <std::size_t N>
+    constexpr vec<N> operator/(vec<N> v, double a)
+    {
+        return v /= a;
+    }
+
+    template <std::size_t N>
+    constexpr double dot(const vec<N>& a, const vec<N>& b)
+    {
+        double out = 0.;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            out += a[i] * b[i];
+        }
+        return out;
+    }
+
+    template <std::size_t N>
+    constexpr double squared_norm(const vec<N>& a)
+    {
+        return dot(a, a);
+    }
+
+    template <std::size_t N>
+    inline double norm(const vec<N>& a)
+    {
+        return std::sqrt(squared_norm(a));
+    }
+
+    template <std::size_t N>
+    inline vec<N> normalized(const vec<N>& a)
+    {
+        return a / norm(a);
+    }
+
+    constexpr vec<3> cross(const vec<3>& a, const vec<3>& b)
+    {
+        return {
+            {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]}
+        };
+    }
+
+    constexpr double cross(const vec<2>& a, const vec<2>& b)
+    {
+        return a[0] * b[1] - a[1] * b[0];
+    }
+
+    ///////////////////////
+    // matrix arithmetic //
+    ///////////////////////
+
+    template <std::size_t N>
+    constexpr vec<N> operator*(const mat<N>& a, const vec<N>& x)
+    {
+        vec<N> out{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                out[i] += a(i, j) * x[j];
+            }
+        }
+        return out;
+    }
+
+    template <std::size_t N>
+    constexpr mat<N> transpose(const mat<N>& a)
+    {
+        mat<N> out{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                out(i, j) = a(j, i);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Solution of the linear system \f$ A x = b \f$.
+     *
+     * Cramer's rule in 2D, Gaussian elimination with partial pivoting otherwise.
+     * The matrix is assumed to be invertible.
+     *
+     * @param a [in] Matrix \f$ A \f$.
+     * @param b [in] Right-hand side \f$ b \f$.
+     */
+    template <std::size_t N>
+    constexpr vec<N> solve(mat<N> a, vec<N> b)
+    {
+        if constexpr (N == 1)
+        {
+            return {{b[0] / a(0, 0)}};
+        }
+        else if constexpr (N == 2)
+        {
+            double det = a(0, 0) * a(1, 1) - a(0, 1) * a(1, 0);
+            return {
+                {(b[0] * a(1, 1) - b[1] * a(0, 1)) / det, (a(0, 0) * b[1] - a(1, 0) * b[0]) / det}
+            };
+        }
+        else
+        {
+            for (std::size_t k = 0; k < N; ++k)
+            {
+                std::size_t p = k;
+                for (std::size_t i = k + 1; i < N; ++i)
+                {
+                    if ((a(i, k) < 0. ? -a(i, k) : a(i, k)) > (a(p, k) < 0. ? -a(p, k) : a(p, k)))
+                    {
+                        p = i;
+                    }
+                }
+                if (p != k)
+                {
+                    for (std::size_t j = k; j < N; ++j)
+                    {
+                        double tmp = a(k, j);
+                        a(k, j)    = a(p, j);
+                        a(p, j)    = tmp;
+                    }
+                    double tmp = b[k];
+                    b[k]       = b[p];
+                    b[p]       = tmp;
+                }
+                for (std::size_t i = k + 1; i < N; ++i)
+                {
+                    double l = a(i, k) / a(k, k);
+                    for (std::size_t j = k + 1; j < N; ++j)
+                    {
+                        a(i, j) -= l * a(k, j);
+                    }
+                    b[i] -= l * b[k];
+                }
+            }
+            vec<N> x{};
+            for (std::size_t k = N; k-- > 0;)
+            {
+                double s = b[k];
+                for (std::size_t j = k + 1; j < N; ++j)
+                {
+                    s -= a(k, j) * x[j];
+                }
+                x[k] = s / a(k, k);
+            }
+            return x;
+        }
+    }
+
+    //////////////
+    // rotation //
+    //////////////
+
+    /**
+     * @brief Rotation matrix of a quaternion.
+     *
+     * Same formulas as scopi::rotation_matrix.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param q [in] Quaternion.
+     */
+    template <std::size_t dim>
+    constexpr mat<dim> rotation_matrix(const quat& q)
+    {
+        double x = q[0];
+        double w = q[3];
+        if constexpr (dim == 2)
+        {
+            return {
+                {{1 - 2 * w * w, -2 * x * w}, {2 * x * w, 1 - 2 * w * w}}
+            };
+        }
+        else
+        {
+            double y = q[1];
+            double z = q[2];
+            return {
+                {{1 - 2 * z * z - 2 * w * w, 2 * y * z - 2 * x * w, 2 * y * w + 2 * x * z},
+                 {2 * y * z + 2 * x * w, 1 - 2 * y * y - 2 * w * w, 2 * z * w - 2 * x * y},
+                 {2 * y * w - 2 * x * z, 2 * z * w + 2 * x * y, 1 - 2 * y * y - 2 * z * z}}
+            };
+        }
+    }
+
+    /**
+     * @brief Product of two quaternions.
+     *
+     * Same formula as scopi::mult_quaternion.
+     */
+    constexpr quat operator*(const quat& q1, const quat& q2)
+    {
+        return {
+            {q1[0] * q2[0] - q1[1] * q2[1] - q1[2] * q2[2] - q1[3] * q2[3],
+             q1[0] * q2[1] + q2[0] * q1[1] + (q1[2] * q2[3] - q1[3] * q2[2]),
+             q1[0] * q2[2] + q2[0] * q1[2] + (q1[3] * q2[1] - q1[1] * q2[3]),
+             q1[0] * q2[3] + q2[0] * q1[3] + (q1[1] * q2[2] - q1[2] * q2[1])}
+        };
+    }
+
+    inline quat normalized(const quat& q)
+    {
+        double n = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        return {
+            {q[0] / n, q[1] / n, q[2] / n, q[3] / n}
+        };
+    }
+
+    /**
+     * @brief Quaternion of the rotation of the angular velocity \c w during \c dt.
+     *
+     * It is the exponential map of \f$ dt\, w / 2 \f$.
+     */
+    inline quat exp_map(const vec<3>& w, double dt)
+    {
+        double normw = norm(w);
+        if (normw == 0.)
+        {
+            return {
+                {1., 0., 0., 0.}
+            };
+        }
+        double s = std::sin(0.5 * normw * dt) / normw;
+        return {
+            {std::cos(0.5 * normw * dt), s * w[0], s * w[1], s * w[2]}
+        };
+    }
+
+    /////////////////
+    // conversions //
+    /////////////////
+
+    /**
+     * @brief Copy of the first \c N elements of a 1D expression (xtensor_fixed, view of a container, ...).
+     */
+    template <std::size_t N, class E>
+    inline vec<N> to_vec(const E& e)
+    {
+        vec<N> out{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            out[i] = e(i);
+        }
+        return out;
+    }
+
+    /**
+     * @brief Copy of a 2D expression of shape \c (N, N).
+     */
+    template <std::size_t N, class E>
+    inline mat<N> to_mat(const E& e)
+    {
+        mat<N> out{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                out(i, j) = e(i, j);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Copy of a 1D expression of 4 elements.
+     */
+    template <class E>
+    inline quat to_quat(const E& e)
+    {
+        return {
+            {e(0), e(1), e(2), e(3)}
+        };
+    }
+
+    template <std::size_t N>
+    inline xt::xtensor_fixed<double, xt::xshape<N>> to_xtensor(const vec<N>& a)
+    {
+        xt::xtensor_fixed<double, xt::xshape<N>> out;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            out(i) = a[i];
+        }
+        return out;
+    }
+
+    template <std::size_t N>
+    inline xt::xtensor_fixed<double, xt::xshape<N, N>> to_xtensor(const mat<N>& a)
+    {
+        xt::xtensor_fixed<double, xt::xshape<N, N>> out;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (std::size_t j = 0; j < N; ++j)
+            {
+                out(i, j) = a(i, j);
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Size of a 1D fixed size xtensor type, 0 for the other types.
+     */
+    template <class T>
+    struct fixed_size : std::integral_constant<std::size_t, 0>
+    {
+    };
+
+    template <std::size_t N>
+    struct fixed_size<xt::xtensor_fixed<double, xt::xshape<N>>> : std::integral_constant<std::size_t, N>
+    {
+    };
+
+    template <class T>
+    inline constexpr std::size_t fixed_size_v = fixed_size<T>::value;
+}
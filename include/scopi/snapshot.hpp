@@ -0,0 +1,563 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SCOPI_SNAPSHOT_MMAP
+#endif
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include "container.hpp"
+#include "objects/methods/write_objects.hpp"
+
+namespace nl = nlohmann;
+
+namespace scopi
+{
+    /////////////////////
+    // snapshot format //
+    /////////////////////
+    /**
+     * @brief Header of a snapshot file.
+     *
+     * A snapshot is a columnar binary file: the header, a table of \c nb_fields snapshot_field, then one contiguous
+     * array per field, aligned on snapshot_alignment bytes. The numbers are stored in the byte order of the machine
+     * which wrote the file, given by \c byte_order.
+     *
+     * The fields written by write_snapshot are:
+     *  - \c position, \c quaternion, \c velocity, \c omega: one row per particle (\c omega has 1 component in 2D);
+     *  - \c object_offset: first particle of each object, with a last row equal to the number of particles;
+     *  - \c shape_id: hash of the shape of each object (see scopi_container::shape_id);
+     *  - \c shapes: json text, the description of each shape (see write_objects) indexed by its hash;
+     *  - \c contact_i, \c contact_j, \c contact_normal, \c contact_distance: one row per contact;
+     *  - \c contact_lambda: Lagrange multipliers of the contacts, \c dim per contact, empty if they are not known.
+     */
+    struct snapshot_header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t dim;
+        std::uint64_t byte_order;
+        std::uint64_t iteration;
+        std::uint64_t nb_particles;
+        std::uint64_t nb_objects;
+        std::uint64_t nb_contacts;
+        std::uint64_t nb_fields;
+    };
+
+    /**
+     * @brief Type of the elements of a snapshot field.
+     */
+    enum class snapshot_type : std::uint32_t
+    {
+        f64 = 0,
+        u64 = 1,
+        u8  = 2
+    };
+
+    /**
+     * @brief Entry of the table of the fields of a snapshot.
+     *
+     * The field has \c count rows of \c components elements, stored at \c offset bytes from the beginning of the file.
+     */
+    struct snapshot_field
+    {
+        char name[32];
+        snapshot_type type;
+        std::uint32_t components;
+        std::uint64_t count;
+        std::uint64_t offset;
+        std::uint64_t reserved;
+    };
+
+    inline constexpr char snapshot_magic[8]         = {'S', 'C', 'O', 'P', 'I', 'S', 'N', 'P'};
+    inline constexpr std::uint32_t snapshot_version = 1;
+    inline constexpr std::uint64_t snapshot_bom     = 0x0102030405060708;
+    inline constexpr std::size_t snapshot_alignment = 64;
+
+    static_assert(sizeof(snapshot_header) == 64 && sizeof(snapshot_field) == 64);
+
+    namespace detail
+    {
+        template <class T>
+        constexpr snapshot_type snapshot_type_of()
+        {
+            if constexpr (std::is_same_v<T, double>)
+            {
+                return snapshot_type::f64;
+            }
+            else if constexpr (std::is_same_v<T, std::uint64_t>)
+            {
+                return snapshot_type::u64;
+            }
+            else
+            {
+                static_assert(std::is_same_v<T, char>, "snapshot fields are made of double, std::uint64_t or char");
+                return snapshot_type::u8;
+            }
+        }
+
+        inline std::size_t snapshot_type_size(snapshot_type type)
+        {
+            return type == snapshot_type::u8 ? 1 : 8;
+        }
+
+        inline std::uint64_t align_snapshot_offset(std::uint64_t offset)
+        {
+            return (offset + snapshot_alignment - 1) / snapshot_alignment * snapshot_alignment;
+        }
+
+        /**
+         * @brief Field to be written: its entry in the table and the function which fills its array.
+         */
+        struct snapshot_column
+        {
+            snapshot_field field;
+            std::function<void(char*)> fill;
+        };
+
+        /**
+         * @brief Column of \c count rows of \c components elements of type \c T, where \c get(i, c) is the element
+         * \c c of the row \c i.
+         */
+        template <class T, class Get>
+        snapshot_column make_snapshot_column(const std::string& name, std::size_t count, std::size_t components, Get get)
+        {
+            snapshot_column column{};
+            std::strncpy(column.field.name, name.c_str(), sizeof(column.field.name) - 1);
+            column.field.type       = snapshot_type_of<T>();
+            column.field.components = static_cast<std::uint32_t>(components);
+            column.field.count      = count;
+            column.fill             = [count, components, get](char* buffer)
+            {
+                T* out = reinterpret_cast<T*>(buffer);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    for (std::size_t c = 0; c < components; ++c)
+                    {
+                        out[i * components + c] = static_cast<T>(get(i, c));
+                    }
+                }
+            };
+            return column;
+        }
+
+        /**
+         * @brief Description of the shapes of the container, indexed by their hash.
+         *
+         * The description of a shape is written once, from the first object which uses it, without the fields of its
+         * position (they are in the columns of the snapshot).
+         */
+        template <std::size_t dim>
+        std::string snapshot_shapes(const scopi_container<dim>& particles)
+        {
+            nl::json shapes = nl::json::object();
+            for (std::size_t io = 0; io < particles.size(); ++io)
+            {
+                auto key = std::to_string(particles.shape_id(io));
+                if (shapes.contains(key))
+                {
+                    continue;
+                }
+                nl::json object = write_objects_dispatcher<dim>::dispatch(*particles[io], particles.offset(io));
+                for (const auto* field : {"id", "position", "rotation", "quaternion"})
+                {
+                    object.erase(field);
+                }
+                shapes[key] = object;
+            }
+            return shapes.dump();
+        }
+    }
+
+    /////////////////////
+    // snapshot writer //
+    /////////////////////
+    namespace detail
+    {
+        /**
+         * @brief Columns of the fields of a snapshot (see snapshot_header).
+         *
+         * The columns read the arrays of their arguments when they are written.
+         */
+        template <std::size_t dim, class Contacts>
+        std::vector<snapshot_column>
+        snapshot_columns(const scopi_container<dim>& particles, const Contacts& contacts, const xt::xtensor<double, 1>& lambda)
+        {
+            const auto* pos   = particles.pos().data();
+            const auto* q     = particles.q().data();
+            const auto* v     = particles.v().data();
+            const auto* omega = particles.omega().data();
+
+            std::size_t nb_particles = particles.pos().size();
+            std::size_t nb_objects   = particles.size();
+            std::size_t nb_contacts  = contacts.size();
+
+            std::vector<snapshot_column> columns;
+            columns.push_back(make_snapshot_column<double>("position",
+                                                           nb_particles,
+                                                           dim,
+                                                           [=](std::size_t i, std::size_t c)
+                                                           {
+                                                               return pos[i](c);
+                                                           }));
+            columns.push_back(make_snapshot_column<double>("quaternion",
+                                                           nb_particles,
+                                                           4,
+                                                           [=](std::size_t i, std::size_t c)
+                                                           {
+                                                               return q[i](c);
+                                                           }));
+            columns.push_back(make_snapshot_column<double>("velocity",
+                                                           nb_particles,
+                                                           dim,
+                                                           [=](std::size_t i, std::size_t c)
+                                                           {
+                                                               return v[i](c);
+                                                           }));
+            columns.push_back(make_snapshot_column<double>("omega",
+                                                           nb_particles,
+                                                           dim == 2 ? 1 : 3,
+                                                           [=](std::size_t i, [[maybe_unused]] std::size_t c)
+                                                           {
+                                                               if constexpr (dim == 2)
+                                                               {
+                                                                   return omega[i];
+                                                               }
+                                                               else
+                                                               {
+                                                                   return omega[i](c);
+                                                               }
+                                                           }));
+            columns.push_back(make_snapshot_column<std::uint64_t>("object_offset",
+                                                                  nb_objects + 1,
+                                                                  1,
+                                                                  [&particles, nb_objects, nb_particles](std::size_t io, std::size_t)
+                                                                  {
+                                                                      return io < nb_objects ? particles.offset(io) : nb_particles;
+                                                                  }));
+            columns.push_back(make_snapshot_column<std::uint64_t>("shape_id",
+                                                                  nb_objects,
+                                                                  1,
+                                                                  [&particles](std::size_t io, std::size_t)
+                                                                  {
+                                                                      return particles.shape_id(io);
+                                                                  }));
+            auto shapes = std::make_shared<const std::string>(snapshot_shapes(particles));
+            columns.push_back(make_snapshot_column<char>("shapes",
+                                                         shapes->size(),
+                                                         1,
+                                                         [shapes](std::size_t i, std::size_t)
+                                                         {
+                                                             return (*shapes)[i];
+                                                         }));
+            columns.push_back(make_snapshot_column<std::uint64_t>("contact_i",
+                                                                  nb_contacts,
+                                                                  1,
+                                                                  [&contacts](std::size_t ic, std::size_t)
+                                                                  {
+                                                                      return contacts[ic].i;
+                                                                  }));
+            columns.push_back(make_snapshot_column<std::uint64_t>("contact_j",
+                                                                  nb_contacts,
+                                                                  1,
+                                                                  [&contacts](std::size_t ic, std::size_t)
+                                                                  {
+                                                                      return contacts[ic].j;
+                                                                  }));
+            columns.push_back(make_snapshot_column<double>("contact_normal",
+                                                           nb_contacts,
+                                                           dim,
+                                                           [&contacts](std::size_t ic, std::size_t c)
+                                                           {
+                                                               return contacts[ic].nij(c);
+                                                           }));
+            columns.push_back(make_snapshot_column<double>("contact_distance",
+                                                           nb_contacts,
+                                                           1,
+                                                           [&contacts](std::size_t ic, std::size_t)
+                                                           {
+                                                               return contacts[ic].dij;
+                                                           }));
+            columns.push_back(make_snapshot_column<double>("contact_lambda",
+                                                           lambda.size() == dim * nb_contacts ? nb_contacts : 0,
+                                                           dim,
+                                                           [&lambda](std::size_t ic, std::size_t c)
+                                                           {
+                                                               return lambda(dim * ic + c);
+                                                           }));
+            return columns;
+        }
+
+        /**
+         * @brief Write the header, the table of the fields and the arrays of the columns.
+         *
+         * Each field is gathered in a buffer and written with a single call.
+         */
+        inline void write_snapshot_file(const std::string& filename, snapshot_header header, const std::vector<snapshot_column>& columns)
+        {
+            std::memcpy(header.magic, snapshot_magic, sizeof(snapshot_magic));
+            header.version    = snapshot_version;
+            header.byte_order = snapshot_bom;
+            header.nb_fields  = columns.size();
+
+            std::vector<snapshot_field> fields;
+            std::uint64_t offset = align_snapshot_offset(sizeof(snapshot_header) + columns.size() * sizeof(snapshot_field));
+            for (const auto& column : columns)
+            {
+                std::uint64_t size = column.field.count * column.field.components * snapshot_type_size(column.field.type);
+                fields.push_back(column.field);
+                fields.back().offset = offset;
+                offset               = align_snapshot_offset(offset + size);
+            }
+
+            std::ofstream file(filename, std::ios::out | std::ios::binary);
+            if (!file)
+            {
+                throw std::runtime_error(fmt::format("write_snapshot: cannot open {}", filename));
+            }
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(fields.data()), static_cast<std::streamsize>(fields.size() * sizeof(snapshot_field)));
+
+            // the buffer is allocated by new, so that its data is aligned for any type of field
+            std::vector<char> buffer;
+            const char zeros[snapshot_alignment] = {};
+            for (std::size_t k = 0; k < columns.size(); ++k)
+            {
+                std::size_t padding = fields[k].offset - static_cast<std::uint64_t>(file.tellp());
+                file.write(zeros, static_cast<std::streamsize>(padding));
+
+                buffer.resize(fields[k].count * fields[k].components * snapshot_type_size(fields[k].type));
+                columns[k].fill(buffer.data());
+                file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            }
+            if (!file)
+            {
+                throw std::runtime_error(fmt::format("write_snapshot: error while writing {}", filename));
+            }
+        }
+    }
+
+    /**
+     * @brief Write a snapshot of the particles and of the contacts.
+     *
+     * Each field is gathered in a buffer and written with a single call, so that writing a snapshot of a million
+     * particles costs about one pass over the memory of the container.
+     *
+     * @param filename [in] Name of the file.
+     * @param particles [in] Array of particles.
+     * @param contacts [in] Array of contacts.
+     * @param lambda [in] Lagrange multipliers of the contacts, \c dim per contact, or an empty array.
+     * @param iteration [in] Index of the time iteration.
+     */
+    template <std::size_t dim, class Contacts>
+    void write_snapshot(const std::string& filename,
+                        const scopi_container<dim>& particles,
+                        const Contacts& contacts,
+                        const xt::xtensor<double, 1>& lambda,
+                        std::size_t iteration)
+    {
+        snapshot_header header{};
+        header.dim          = dim;
+        header.iteration    = iteration;
+        header.nb_particles = particles.pos().size();
+        header.nb_objects   = particles.size();
+        header.nb_contacts  = contacts.size();
+        detail::write_snapshot_file(filename, header, detail::snapshot_columns(particles, contacts, lambda));
+    }
+
+    /////////////////////
+    // snapshot reader //
+    /////////////////////
+    /**
+     * @brief Read-only view of a field of a snapshot.
+     *
+     * @tparam T Type of the elements.
+     */
+    template <class T>
+    struct snapshot_array
+    {
+        const T* data;
+        std::size_t count;
+        std::size_t components;
+
+        const T& operator()(std::size_t i, std::size_t c = 0) const
+        {
+            return data[i * components + c];
+        }
+
+        std::size_t size() const
+        {
+            return count;
+        }
+    };
+
+    /**
+     * @brief Reader of a snapshot file written by write_snapshot.
+     *
+     * The file is mapped in memory: the fields are read in place, without copy, and only the pages which are used are
+     * loaded. If memory mapping is not available, the file is read in a buffer.
+     */
+    class snapshot_reader
+    {
+      public:
+
+        explicit snapshot_reader(const std::string& filename)
+        {
+#ifdef SCOPI_SNAPSHOT_MMAP
+            int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: cannot open {}", filename));
+            }
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error(fmt::format("snapshot_reader: cannot read the size of {}", filename));
+            }
+            m_size = static_cast<std::size_t>(st.st_size);
+            if (m_size >= sizeof(snapshot_header))
+            {
+                void* data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    m_data = static_cast<const char*>(data);
+                }
+            }
+            ::close(fd);
+            if (m_data == nullptr)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: cannot map {}", filename));
+            }
+#else
+            std::ifstream file(filename, std::ios::in | std::ios::binary);
+            if (!file)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: cannot open {}", filename));
+            }
+            m_buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            m_data = m_buffer.data();
+            m_size = m_buffer.size();
+#endif
+            check(filename);
+        }
+
+        ~snapshot_reader()
+        {
+#ifdef SCOPI_SNAPSHOT_MMAP
+            if (m_data != nullptr)
+            {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+#endif
+        }
+
+        snapshot_reader(const snapshot_reader&)            = delete;
+        snapshot_reader& operator=(const snapshot_reader&) = delete;
+
+        const snapshot_header& header() const
+        {
+            return *reinterpret_cast<const snapshot_header*>(m_data);
+        }
+
+        bool has_field(const std::string& name) const
+        {
+            return find(name) != nullptr;
+        }
+
+        /**
+         * @brief Field \c name, whose elements must be of type \c T.
+         */
+        template <class T>
+        snapshot_array<T> field(const std::string& name) const
+        {
+            const snapshot_field* f = find(name);
+            if (f == nullptr)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: no field {}", name));
+            }
+            if (f->type != detail::snapshot_type_of<T>())
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: wrong type for the field {}", name));
+            }
+            return {reinterpret_cast<const T*>(m_data + f->offset), f->count, f->components};
+        }
+
+        /**
+         * @brief Description of the shapes, indexed by the hash stored in the field \c shape_id.
+         */
+        nl::json shapes() const
+        {
+            auto text = field<char>("shapes");
+            return nl::json::parse(text.data, text.data + text.count);
+        }
+
+      private:
+
+        const snapshot_field* fields() const
+        {
+            return reinterpret_cast<const snapshot_field*>(m_data + sizeof(snapshot_header));
+        }
+
+        const snapshot_field* find(const std::string& name) const
+        {
+            for (std::size_t k = 0; k < header().nb_fields; ++k)
+            {
+                const auto& f = fields()[k];
+                if (name == std::string(f.name, strnlen(f.name, sizeof(f.name))))
+                {
+                    return &f;
+                }
+            }
+            return nullptr;
+        }
+
+        void check(const std::string& filename) const
+        {
+            if (m_size < sizeof(snapshot_header) || std::memcmp(header().magic, snapshot_magic, sizeof(snapshot_magic)) != 0)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: {} is not a snapshot", filename));
+            }
+            if (header().version != snapshot_version || header().byte_order != snapshot_bom)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: {} has an unsupported version or byte order", filename));
+            }
+            if (sizeof(snapshot_header) + header().nb_fields * sizeof(snapshot_field) > m_size)
+            {
+                throw std::runtime_error(fmt::format("snapshot_reader: {} is truncated", filename));
+            }
+            for (std::size_t k = 0; k < header().nb_fields; ++k)
+            {
+                const auto& f = fields()[k];
+                if (f.offset + f.count * f.components * detail::snapshot_type_size(f.type) > m_size)
+                {
+                    throw std::runtime_error(fmt::format("snapshot_reader: {} is truncated", filename));
+                }
+            }
+        }
+
+        const char* m_data = nullptr;
+        std::size_t m_size = 0;
+#ifndef SCOPI_SNAPSHOT_MMAP
+        std::vector<char> m_buffer;
+#endif
+    };
+}
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
 #include <fstream>
 #include <functional>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -18,12 +23,21 @@
 #include <plog/Initializers/RollingFileInitializer.h>
 #include <plog/Log.h>
 
+#include "allocations.hpp"
+#include "analysis.hpp"
+#include "arena.hpp"
+#include "async_writer.hpp"
+#include "checkpoint.hpp"
 #include "container.hpp"
+#include "integration.hpp"
+#include "json_stream.hpp"
 #include "objects/methods/add_contact.hpp"
 #include "objects/methods/closest_points.hpp"
 #include "objects/methods/write_objects.hpp"
 #include "objects/neighbor.hpp"
 #include "quaternion.hpp"
+#include "sleep.hpp"
+#include "snapshot.hpp"
 
 #include "contact/contact_kdtree.hpp"
 #include "contact/property.hpp"
@@ -67,6 +81,37 @@ namespace scopi
     // template<std::size_t dim, class xt_container>
     // void update_velocity_omega(scopi_container<dim>& particles, std::size_t i, const xt_container& wadapt);
 
+    /**
+     * @brief Description of an object in the output files: its shape (see write_objects) and its properties.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @param particles [in] Array of particles.
+     * @param i [in] Index of the object.
+     */
+    template <std::size_t dim>
+    nl::json output_object(const scopi_container<dim>& particles, std::size_t i)
+    {
+        auto offset              = particles.offset(i);
+        nl::json object          = write_objects_dispatcher<dim>::dispatch(*particles[i], offset);
+        nl::json& prop           = object["properties"];
+        prop["velocity"]         = particles.v()(offset);
+        prop["desired_velocity"] = particles.vd()(offset);
+        prop["omega"]            = particles.omega()(offset);
+        prop["desired_omega"]    = particles.desired_omega()(offset);
+        prop["force"]            = particles.f()(offset);
+        prop["mass"]             = particles.m()(offset);
+        prop["moment_inertia"]   = particles.j()(offset);
+        if (offset < particles.nb_inactive())
+        {
+            prop["active"] = false;
+        }
+        else
+        {
+            prop["active"] = true;
+        }
+        return object;
+    }
+
     /**
      * @brief Entry point of SCoPI.
      *
@@ -82,7 +127,8 @@ namespace scopi
      *      - Set a priori velocity: describe how the particles would move if they weren't interacting with the other ones;
      *      - Compute the effective velocity as the solution of an optimization problem under constraint \f$D > 0\f$;
      *      - Use these velocities to move the particles;
-     *      - Store the computed velocities.
+     *      - Store the computed velocities;
+     *      - Optionally, put the particles at rest to sleep (see sleep_manager).
      *
      * The optimization solver \c optim_solver_t describes which algorithm is used to solve the optimization problem.
      * It is itself templated by a \c problem_t that describes which model is used.
@@ -135,6 +181,20 @@ namespace scopi
          */
         void run(double dt, std::size_t total_it, std::size_t initial_iter = 0);
 
+        /**
+         * @brief Restore the state of a simulation from a checkpoint (see write_checkpoint).
+         *
+         * The particles, the contacts of the last time step, the Lagrange multipliers, the sleeping state and the state
+         * of the optimization method are replaced by the ones of the checkpoint, so that the simulation continues
+         * exactly as if it had not stopped:
+         * <tt>solver.run(dt, total_it, solver.restart(filename))</tt>.
+         *
+         * @param filename [in] Name of the checkpoint.
+         *
+         * @return Index of the next time iteration.
+         */
+        std::size_t restart(const std::string& filename);
+
         /**
          * @brief Return the current contacts of the simulation.
          *
@@ -147,6 +207,14 @@ namespace scopi
          */
         params_t get_params();
 
+        /**
+         * @brief Return the observables computed in situ every \c analysis_frequency iterations.
+         *
+         * If no observable is registered when the simulation starts, the kinetic energy, the coordination number and
+         * the distribution of the contact forces are computed.
+         */
+        analysis_pipeline<dim, problem_t>& analysis();
+
       private:
 
         void set_timestep(double dt);
@@ -159,18 +227,66 @@ namespace scopi
         /**
          * @brief Compute the list of contacts.
          *
-         * @return Vector containing all the contacts in a cut-off radius.
+         * @param contacts [out] Vector containing all the contacts in a cut-off radius. It is cleared first, so that
+         * its memory is reused.
          */
-        contact_container_t compute_contacts();
+        void compute_contacts(contact_container_t& contacts);
 
         /**
          * @brief Write output files (json format) for visualization.
          *
+         * If \c m_params.async_output is true, the state is copied in a frame of m_writer and the files are written
+         * by its background thread.
+         *
          * @param contacts [in] List of contacts (only \f$D > 0\f$).
          * @param nite [in] Current index of iteration in time.
          */
         void write_output_files(const contact_container_t& contacts, std::size_t nite);
 
+        /**
+         * @brief Serialize and write the output files of a state.
+         *
+         * It only reads its arguments and the parameters, so that it can run in the background thread.
+         *
+         * @param particles [in] Array of particles.
+         * @param contacts [in] List of contacts.
+         * @param lambda [in] Lagrange multipliers of the contacts.
+         * @param nite [in] Index of iteration in time.
+         */
+        void write_files(const particle_container_t& particles,
+                         const contact_container_t& contacts,
+                         const xt::xtensor<double, 1>& lambda,
+                         std::size_t nite) const;
+
+        /**
+         * @brief Write a checkpoint of the simulation (see write_checkpoint).
+         *
+         * @param nite [in] Index of the next time iteration.
+         */
+        void write_checkpoint_file(std::size_t nite) const;
+
+        /**
+         * @brief Open the time series of the observables.
+         *
+         * The file is appended to if the simulation is restarted, and created with its header otherwise. The header of
+         * an existing file must give the columns of the observables of the simulation.
+         *
+         * @param initial_iter [in] Initial index of iteration.
+         */
+        std::ofstream open_analysis_file(std::size_t initial_iter);
+
+        /**
+         * @brief Compute the observables of the time step and append them to the time series.
+         *
+         * It is called once the velocities are updated, before the particles are moved: the positions are those at
+         * which the contacts were detected.
+         *
+         * @param file [out] Time series.
+         * @param contacts [in] List of contacts.
+         * @param nite [in] Index of the iteration at the end of the time step.
+         */
+        void write_analysis(std::ostream& file, const contact_container_t& contacts, std::size_t nite) const;
+
         /**
          * @brief Use the velocities solution of the optimization problem to move the particles;
          */
@@ -202,7 +318,41 @@ namespace scopi
         contact_method_t m_contact_method;
         vap_t m_vap;
         contact_container_t m_old_contacts;
+        /**
+         * @brief Contacts of the current time step, swapped with m_old_contacts at the end of the step.
+         */
+        contact_container_t m_contacts;
         std::size_t m_current_save = 0;
+        /**
+         * @brief Sleeping state of the particles, used if \c m_params.sleep is true.
+         */
+        sleep_manager<dim> m_sleep;
+        /**
+         * @brief Memory of the temporaries of a time step, released at the beginning of each step.
+         */
+        step_arena m_arena;
+        /**
+         * @brief Observables computed in situ.
+         */
+        analysis_pipeline<dim, problem_t> m_analysis;
+
+        /**
+         * @brief State copied at an output step, written by the background thread.
+         */
+        struct output_frame
+        {
+            particle_container_t particles;
+            contact_container_t contacts;
+            xt::xtensor<double, 1> lambda;
+            std::size_t iteration = 0;
+        };
+
+        /**
+         * @brief Background writer, created at the first output if \c m_params.async_output is true.
+         *
+         * It is the last member, so that the submitted frames are written before the other members are destroyed.
+         */
+        std::unique_ptr<async_writer<output_frame>> m_writer;
     };
 
     template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
@@ -213,6 +363,7 @@ namespace scopi
         , m_optim_solver()
         , m_contact_method()
         , m_vap()
+        , m_sleep(m_params)
     {
         init_options();
     }
@@ -223,6 +374,7 @@ namespace scopi
         , m_optim_solver()
         , m_contact_method()
         , m_vap()
+        , m_sleep(m_params)
     {
         init_options();
     }
@@ -238,21 +390,47 @@ namespace scopi
         }
     };
 
+    /**
+     * @brief Copy the properties of the contacts of the previous time step into the new contacts.
+     *
+     * Two particles can share several contacts (one for each sphere of a clump, one for each close primitive of a
+     * mesh), so a new contact takes the property of the old contact between the same particles whose contact points
+     * are the closest.
+     *
+     * @param m_old_contacts [in] Contacts of the previous time step.
+     * @param contacts [inout] Contacts of the current time step.
+     */
     template <class Contacts>
     void transfer(const Contacts& m_old_contacts, Contacts& contacts)
     {
-        std::unordered_map<std::pair<std::size_t, std::size_t>, std::size_t, pairhash> indices;
+        std::unordered_map<std::pair<std::size_t, std::size_t>, std::vector<std::size_t>, pairhash> indices;
         std::size_t index = 0;
         for (const auto& c : m_old_contacts)
         {
-            indices[{c.i, c.j}] = index++;
+            indices[{c.i, c.j}].push_back(index++);
         }
 
         for (auto& c : contacts)
         {
             if (auto search = indices.find({c.i, c.j}); search != indices.end())
             {
-                c.property = m_old_contacts[search->second].property;
+                std::size_t closest = search->second[0];
+                double min_dist     = std::numeric_limits<double>::max();
+                for (auto k : search->second)
+                {
+                    const auto& old_c = m_old_contacts[k];
+                    double dist       = 0.;
+                    for (std::size_t d = 0; d < c.pi.size(); ++d)
+                    {
+                        dist += (old_c.pi(d) - c.pi(d)) * (old_c.pi(d) - c.pi(d)) + (old_c.pj(d) - c.pj(d)) * (old_c.pj(d) - c.pj(d));
+                    }
+                    if (dist < min_dist)
+                    {
+                        closest  = k;
+                        min_dist = dist;
+                    }
+                }
+                c.property = m_old_contacts[closest].property;
             }
         }
     }
@@ -270,20 +448,41 @@ namespace scopi
         write_output_files(m_old_contacts, initial_iter);
         set_timestep(dt);
         m_optim_solver.set_timestep(m_dt);
+        m_optim_solver.set_memory_resource(&m_arena);
+
+        std::ofstream analysis_file;
+        if (m_params.analysis_frequency != std::size_t(-1))
+        {
+            analysis_file = open_analysis_file(initial_iter);
+        }
 
         for (std::size_t nite = initial_iter; nite < total_it; ++nite)
         {
             PLOG_INFO << "\n\n------------------- Time iteration ----------------> " << nite;
+            m_arena.reset();
+            std::size_t nb_allocations = nb_system_allocations();
 
             displacement_obstacles();
-            auto contacts = compute_contacts();
+            auto& contacts = m_contacts;
+            compute_contacts(contacts);
 
             if (!m_old_contacts.empty())
             {
                 transfer(m_old_contacts, contacts);
             }
 
+            std::size_t nb_woken = 0;
+            if (m_params.sleep)
+            {
+                nb_woken = m_sleep.wake(m_particles, contacts, m_dt);
+            }
+
             m_vap.set_a_priori_velocity(m_dt, m_particles, contacts);
+            if (m_params.sleep)
+            {
+                m_sleep.freeze(m_particles);
+                m_optim_solver.set_sleeping(m_sleep.sleeping());
+            }
             m_optim_solver.extra_steps_before_solve(contacts);
             while (m_optim_solver.should_solve())
             {
@@ -292,13 +491,41 @@ namespace scopi
             }
             m_optim_solver.update_contact_properties(contacts);
             update_velocity();
+            // the contact points are those of the positions before the move
+            if ((nite + 1) % m_params.analysis_frequency == 0 && m_params.analysis_frequency != std::size_t(-1))
+            {
+                write_analysis(analysis_file, contacts, nite + 1);
+            }
             move_active_particles();
 
+            if (m_params.sleep)
+            {
+                std::size_t nb_slept = m_sleep.update(m_particles, contacts);
+                PLOG_INFO << "----> Sleeping particles = " << m_sleep.nb_sleeping() << " (fell asleep: " << nb_slept
+                          << ", woken up: " << nb_woken << ")";
+            }
+
             if ((nite + 1) % m_params.output_frequency == 0 && m_params.output_frequency != std::size_t(-1))
             {
                 write_output_files(contacts, nite + 1); // m_current_save++);
             }
             std::swap(m_old_contacts, contacts);
+            if ((nite + 1) % m_params.checkpoint_frequency == 0 && m_params.checkpoint_frequency != std::size_t(-1))
+            {
+                write_checkpoint_file(nite + 1);
+            }
+            PLOG_INFO << "----> Step arena = " << m_arena.used() << " bytes (peak: " << m_arena.peak()
+                      << " bytes, arena blocks allocated: " << m_arena.nb_system_allocations() << ")";
+#ifdef SCOPI_COUNT_ALLOCATIONS
+            PLOG_INFO << "----> System allocations = " << nb_system_allocations() - nb_allocations;
+#else
+            (void)nb_allocations;
+#endif
+        }
+
+        if (m_writer)
+        {
+            m_writer->flush();
         }
     }
 
@@ -326,44 +553,36 @@ namespace scopi
                         m_vap.get_params());
     }
 
+    template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
+    auto ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::analysis() -> analysis_pipeline<dim, problem_t>&
+    {
+        return m_analysis;
+    }
+
     template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
     void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::displacement_obstacles()
     {
         tic();
-        for (std::size_t i = 0; i < m_particles.nb_inactive(); ++i)
+        std::size_t n = m_particles.nb_inactive();
+        auto never    = [](std::size_t)
         {
-            auto w       = get_omega(m_particles.desired_omega()(i));
-            double normw = xt::linalg::norm(w);
-            if (normw == 0)
-            {
-                normw = 1;
-            }
-            type::quaternion_t expw;
-            auto expw_adapt                       = xt::adapt(expw);
-            expw_adapt(0)                         = std::cos(0.5 * normw * m_dt);
-            xt::view(expw_adapt, xt::range(1, _)) = std::sin(0.5 * normw * m_dt) / normw * w;
-
-            for (std::size_t d = 0; d < dim; ++d)
-            {
-                m_particles.pos()(i)(d) += m_dt * m_particles.vd()(i)(d);
-            }
-            m_particles.q()(i) = mult_quaternion(m_particles.q()(i), expw);
-            normalize(m_particles.q()(i));
-        }
+            return false;
+        };
+        integrate_positions(m_particles.pos().data(), m_particles.vd().data(), n, m_dt, never);
+        integrate_orientations(m_particles.q().data(), m_particles.desired_omega().data(), n, m_dt, never);
         auto duration = toc();
-        PLOG_INFO << "----> CPUTIME : obstacles = " << duration;
+        PLOG_INFO << "----> CPUTIME : obstacles = " << duration << " (" << particles_per_second(n, duration) << " particles/s)";
     }
 
     template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
-    auto ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::compute_contacts() -> contact_container_t
+    void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::compute_contacts(contact_container_t& contacts)
     {
-        auto contacts = m_contact_method.run(m_box, m_particles, m_particles.nb_inactive());
+        m_contact_method.run(m_box, m_particles, m_particles.nb_inactive(), contacts);
         for (std::size_t i = m_particles.object_index(m_particles.nb_inactive()); i < m_particles.size(); ++i)
         {
             add_contact_from_object_dispatcher<dim>::dispatch(*m_particles[i], m_particles.offset(i), contacts);
         }
         PLOG_INFO << "contacts.size() = " << contacts.size() << std::endl;
-        return contacts;
     }
 
     template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
@@ -372,37 +591,96 @@ namespace scopi
     {
         tic();
 
+        if (!m_params.async_output)
+        {
+            write_files(m_particles, contacts, m_optim_solver.lagrange_multiplier(), nite);
+            auto duration = toc();
+            PLOG_INFO << "----> CPUTIME : write output files = " << duration;
+            return;
+        }
+
+        if (!m_writer)
+        {
+            auto write = [this](const output_frame& frame)
+            {
+                auto start = std::chrono::steady_clock::now();
+                write_files(frame.particles, frame.contacts, frame.lambda, frame.iteration);
+                std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+                PLOG_INFO << "----> CPUTIME : write output files " << frame.iteration << " in background = " << duration.count();
+            };
+            m_writer = std::make_unique<async_writer<output_frame>>(write, m_params.output_buffers);
+        }
+
+        // the frames are reused: the copies do not allocate once the sizes are stable
+        auto& frame     = m_writer->acquire();
+        frame.particles = m_particles;
+        frame.contacts  = contacts;
+        frame.lambda    = m_optim_solver.lagrange_multiplier();
+        frame.iteration = nite;
+        m_writer->submit();
+
+        auto duration = toc();
+        PLOG_INFO << "----> CPUTIME : stage output files = " << duration;
+    }
+
+    template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
+    void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::write_files(const particle_container_t& particles,
+                                                                                           const contact_container_t& contacts,
+                                                                                           const xt::xtensor<double, 1>& lambda,
+                                                                                           std::size_t nite) const
+    {
         if (!std::filesystem::exists(m_params.path))
         {
             std::filesystem::create_directories(m_params.path);
         }
 
-        nl::json json_output;
-
-        json_output["objects"] = {};
+        if (m_params.snapshot_output)
+        {
+            write_snapshot(fmt::format("{}_{:04d}.scopi", (m_params.path / m_params.filename).string(), nite),
+                           particles,
+                           contacts,
+                           lambda,
+                           nite);
+            return;
+        }
 
-        for (std::size_t i = 0; i < m_particles.size(); ++i)
+        if (m_params.streaming_output)
         {
-            auto offset              = m_particles.offset(i);
-            nl::json object          = write_objects_dispatcher<dim>::dispatch(*m_particles[i], offset);
-            nl::json& prop           = object["properties"];
-            prop["velocity"]         = m_particles.v()(offset);
-            prop["desired_velocity"] = m_particles.vd()(offset);
-            prop["omega"]            = m_particles.omega()(offset);
-            prop["desired_omega"]    = m_particles.desired_omega()(offset);
-            prop["force"]            = m_particles.f()(offset);
-            prop["mass"]             = m_particles.m()(offset);
-            prop["moment_inertia"]   = m_particles.j()(offset);
-            if (offset < m_particles.nb_inactive())
+            auto object_json = [&](std::size_t i)
             {
-                prop["active"] = false;
+                return output_object(particles, i);
+            };
+            auto contact_json = [&](std::size_t ic)
+            {
+                return contacts[ic].to_json();
+            };
+
+            // the buffer must outlive the file
+            std::vector<char> buffer(std::size_t(1) << 20);
+            std::ofstream file;
+            file.rdbuf()->pubsetbuf(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            if (m_params.binary_output)
+            {
+                file.open(fmt::format("{}_{:04d}.bson", (m_params.path / m_params.filename).string(), nite),
+                          std::ios::out | std::ios::binary);
+                write_bson_stream(file, particles.size(), object_json, contacts.size(), contact_json);
             }
             else
             {
-                prop["active"] = true;
+                file.open(fmt::format("{}_{:04d}.json", (m_params.path / m_params.filename).string(), nite),
+                          std::ios::out | std::ios::binary);
+                write_json_stream(file, particles.size(), object_json, contacts.size(), contact_json);
             }
+            return;
+        }
 
-            json_output["objects"].push_back(object);
+        nl::json json_output;
+
+        json_output["objects"] = {};
+
+        for (std::size_t i = 0; i < particles.size(); ++i)
+        {
+            json_output["objects"].push_back(output_object(particles, i));
         }
 
         json_output["contacts"] = {};
@@ -426,96 +704,118 @@ namespace scopi
             file << std::setw(4) << json_output;
             file.close();
         }
-
-        auto duration = toc();
-        PLOG_INFO << "----> CPUTIME : write output files = " << duration;
     }
 
     template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
-    void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::move_active_particles()
+    void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::write_checkpoint_file(std::size_t nite) const
     {
         tic();
-        std::size_t active_offset = m_particles.nb_inactive();
-
-#pragma omp parallel for
-        for (std::size_t i = 0; i < m_particles.nb_active(); ++i)
+        if (!std::filesystem::exists(m_params.path))
         {
-            xt::xtensor_fixed<double, xt::xshape<3>> w;
-            double normw;
+            std::filesystem::create_directories(m_params.path);
+        }
+        auto solver_state = m_optim_solver.solver_state();
+        write_checkpoint(fmt::format("{}_{:04d}.ckpt", (m_params.path / m_params.filename).string(), nite),
+                         m_particles,
+                         m_old_contacts,
+                         m_optim_solver.lagrange_multiplier(),
+                         nite,
+                         m_params.sleep ? &m_sleep : nullptr,
+                         &solver_state);
+        auto duration = toc();
+        PLOG_INFO << "----> CPUTIME : write checkpoint = " << duration;
+    }
 
-            if constexpr (dim == 2)
-            {
-                w     = {0, 0, m_particles.omega()(i + active_offset)};
-                normw = std::abs(m_particles.omega()(i + active_offset));
-            }
-            else
-            {
-                w     = m_particles.omega()(i + active_offset);
-                normw = xt::linalg::norm(w);
-            }
+    template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
+    std::ofstream ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::open_analysis_file(std::size_t initial_iter)
+    {
+        if (m_analysis.empty())
+        {
+            m_analysis.template emplace<kinetic_energy<dim, problem_t>>();
+            m_analysis.template emplace<coordination_number<dim, problem_t>>();
+            m_analysis.template emplace<contact_force_distribution<dim, problem_t>>();
+        }
 
-            if (normw == 0)
+        if (!std::filesystem::exists(m_params.path))
+        {
+            std::filesystem::create_directories(m_params.path);
+        }
+        auto filename = fmt::format("{}_analysis.csv", (m_params.path / m_params.filename).string());
+        bool append   = initial_iter > 0 && std::filesystem::exists(filename);
+        if (append)
+        {
+            std::ostringstream expected;
+            m_analysis.write_header(expected);
+            auto columns = expected.str().substr(0, expected.str().size() - 1);
+
+            std::ifstream existing(filename);
+            std::string header;
+            std::getline(existing, header);
+            if (header != columns)
             {
-                normw = 1;
+                throw std::runtime_error(
+                    fmt::format("Cannot append to the analysis file {}: its columns are {} instead of {}", filename, header, columns));
             }
+        }
+        std::ofstream file(filename, append ? std::ios::app : std::ios::out);
+        if (!file)
+        {
+            throw std::runtime_error(fmt::format("Cannot open the analysis file {}", filename));
+        }
+        if (!append)
+        {
+            m_analysis.write_header(file);
+        }
+        return file;
+    }
 
-            type::quaternion_t expw;
-            auto expw_adapt                       = xt::adapt(expw);
-            expw_adapt(0)                         = std::cos(0.5 * normw * m_dt);
-            xt::view(expw_adapt, xt::range(1, _)) = std::sin(0.5 * normw * m_dt) / normw * w;
-
-            for (std::size_t d = 0; d < dim; ++d)
-            {
-                m_particles.pos()(i + active_offset)(d) += m_dt * m_particles.v()(i + active_offset)(d);
-            }
+    template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
+    void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::write_analysis(std::ostream& file,
+                                                                                              const contact_container_t& contacts,
+                                                                                              std::size_t nite) const
+    {
+        tic();
+        analysis_state<dim, problem_t> state{m_particles,
+                                             contacts,
+                                             m_optim_solver.lagrange_multiplier(),
+                                             nite,
+                                             m_dt * static_cast<double>(nite)};
+        m_analysis.write_row(file, state);
+        auto duration = toc();
+        PLOG_INFO << "----> CPUTIME : analysis = " << duration;
+    }
 
-            m_particles.q()(i + active_offset) = mult_quaternion(m_particles.q()(i + active_offset), expw);
-            normalize(m_particles.q()(i + active_offset));
-        }
+    template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
+    std::size_t ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::restart(const std::string& filename)
+    {
+        tic();
+        xt::xtensor<double, 1> lambda;
+        std::vector<char> solver_state;
+        std::size_t nite = read_checkpoint(filename, m_particles, m_old_contacts, lambda, &m_sleep, &solver_state);
+        m_optim_solver.set_lagrange_multiplier(lambda);
+        m_optim_solver.set_solver_state(solver_state);
+        auto duration = toc();
+        PLOG_INFO << "----> CPUTIME : read checkpoint = " << duration << " (" << particles_per_second(m_particles.pos().size(), duration)
+                  << " particles/s)";
+        return nite;
+    }
 
-        for (std::size_t io = 0; io < m_particles.size(); ++io)
+    template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
+    void ScopiSolver<dim, problem_t, optim_solver_t, contact_method_t, vap_t>::move_active_particles()
+    {
+        tic();
+        std::size_t active_offset = m_particles.nb_inactive();
+        std::size_t n             = m_particles.nb_active();
+        auto is_sleeping          = [&](std::size_t i)
         {
-            for (std::size_t d = 0; d < dim; ++d)
-            {
-                if (m_box.is_periodic(d))
-                {
-                    std::size_t plus  = 0;
-                    std::size_t minus = 0;
-                    for (std::size_t offset = m_particles.offset(io); offset < m_particles.offset(io + 1); ++offset)
-                    {
-                        const auto& p = m_particles.pos()[offset];
-                        if (p[d] > m_box.upper_bound(d))
-                        {
-                            plus++;
-                        }
-                        if (p[d] < m_box.lower_bound(d))
-                        {
-                            minus++;
-                        }
-                    }
-
-                    auto object_size = m_particles.offset(io + 1) - m_particles.offset(io);
-                    if (plus == object_size)
-                    {
-                        for (std::size_t offset = m_particles.offset(io); offset < m_particles.offset(io + 1); ++offset)
-                        {
-                            auto& p = m_particles.pos()[offset];
-                            p[d] -= m_box.upper_bound(d) - m_box.lower_bound(d);
-                        }
-                    }
-                    if (minus == object_size)
-                    {
-                        for (std::size_t offset = m_particles.offset(io); offset < m_particles.offset(io + 1); ++offset)
-                        {
-                            auto& p = m_particles.pos()[offset];
-                            p[d] += m_box.upper_bound(d) - m_box.lower_bound(d);
-                        }
-                    }
-                }
-            }
-        }
+            return m_sleep.is_sleeping(i + active_offset);
+        };
+        integrate_positions(m_particles.pos().data() + active_offset, m_particles.v().data() + active_offset, n, m_dt, is_sleeping);
+        integrate_orientations(m_particles.q().data() + active_offset, m_particles.omega().data() + active_offset, n, m_dt, is_sleeping);
+        wrap_periodic_objects(m_box, m_particles);
         auto duration = toc();
-        PLOG_INFO << "----> CPUTIME : move active particles = " << duration;
+        PLOG_INFO << "----> CPUTIME : move active particles = " << duration << " (" << particles_per_second(n, duration)
+                  << " particles/s)";
     }
 
     template <std::size_t dim, class problem_t, class optim_solver_t, template <class> class contact_method_t, class vap_t>
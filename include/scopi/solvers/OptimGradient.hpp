@@ -1,12 +1,25 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include <xtensor/xnoalias.hpp>
 #include <xtensor/xtensor.hpp>
 
 #include "../contact/property.hpp"
 #include "../objects/neighbor.hpp"
+#include "../scopi.hpp"
 #include "../utils.hpp"
+#include "anderson.hpp"
+#include "islands.hpp"
 #include "lagrange_multiplier.hpp"
 #include "minimization_problem.hpp"
+#include "solver_state.hpp"
 
 namespace scopi
 {
@@ -17,11 +30,10 @@ namespace scopi
     }
 
     template <std::size_t dim>
-    inline void update_contact_properties_impl(double dt, const xt::xtensor<double, 1>& lambda, std::vector<neighbor<dim, Viscous>>& contacts)
+    inline void
+    update_contact_properties_impl(double dt, const xt::xtensor<double, 1>& lambda_global, std::vector<neighbor<dim, Viscous>>& contacts)
     {
-        auto lagrange      = make_lagrange_multplier<dim, Viscous>(contacts, dt);
-        auto lambda_global = lagrange.local2global(lambda);
-        std::size_t row    = 0;
+        std::size_t row = 0;
 
         for (std::size_t i = 0; i < contacts.size(); ++i)
         {
@@ -30,17 +42,15 @@ namespace scopi
                              - dt * xt::linalg::dot(contacts[i].nij, xt::view(lambda_global, xt::range(row, row + dim)))[0],
                          contacts[i].property.gamma_min),
                 0.);
-            row += 3;
+            row += dim;
         }
     }
 
     template <std::size_t dim>
     inline void
-    update_contact_properties_impl(double dt, const xt::xtensor<double, 1>& lambda, std::vector<neighbor<dim, ViscousFriction>>& contacts)
+    update_contact_properties_impl(double dt, const xt::xtensor<double, 1>& lambda_global, std::vector<neighbor<dim, ViscousFriction>>& contacts)
     {
-        auto lagrange      = make_lagrange_multplier<dim, ViscousFriction>(contacts, dt);
-        auto lambda_global = lagrange.local2global(lambda);
-        std::size_t row    = 0;
+        std::size_t row = 0;
 
         for (std::size_t i = 0; i < contacts.size(); ++i)
         {
@@ -49,8 +59,110 @@ namespace scopi
                              - dt * xt::linalg::dot(contacts[i].nij, xt::view(lambda_global, xt::range(row, row + dim)))[0],
                          contacts[i].property.gamma_min),
                 0.);
-            row += 3;
+            row += dim;
+        }
+    }
+
+    /**
+     * @brief Image of the \c sij of the contacts by the fixed point map.
+     *
+     * @param dt [in] Time step.
+     * @param contacts [in] Array of contacts.
+     * @param AU [in] Relative velocities at the contacts, \c dim rows per contact.
+     * @param s [out] New values of the \c sij.
+     */
+    template <std::size_t dim>
+    inline void fixed_point_map(double dt,
+                                const island_contacts<dim, FrictionFixedPoint>& contacts,
+                                const xt::xtensor<double, 1>& AU,
+                                xt::xtensor<double, 1>& s)
+    {
+        for (std::size_t i = 0, row = 0; i < contacts.size(); ++i, row += dim)
+        {
+            auto nij  = contact_nij(contacts, i);
+            auto AUi  = xt::view(AU, xt::range(row, row + dim));
+            auto TAUi = xt::eval(AUi - nij * (xt::linalg::dot(AUi, nij)[0]));
+            s[i]      = contacts.property(i).mu * dt * xt::norm_l2(TAUi)[0];
+        }
+    }
+
+    template <std::size_t dim>
+    inline void
+    fixed_point_map(double, const island_contacts<dim, ViscousFriction>& contacts, const xt::xtensor<double, 1>& AU, xt::xtensor<double, 1>& s)
+    {
+        for (std::size_t i = 0, row = 0; i < contacts.size(); ++i, row += dim)
+        {
+            const auto& prop = contacts.property(i);
+            if (prop.gamma == prop.gamma_min)
+            {
+                auto nij  = contact_nij(contacts, i);
+                auto AUi  = xt::view(AU, xt::range(row, row + dim));
+                auto TAUi = xt::eval(AUi - nij * (xt::linalg::dot(AUi, nij)[0]));
+                s[i]      = xt::norm_l2(TAUi)[0];
+            }
+            else
+            {
+                s[i] = contacts.sij(i);
+            }
+        }
+    }
+
+    /**
+     * @brief Relative error between two iterates of the fixed point.
+     *
+     * @param dt [in] Time step.
+     * @param contacts [in] Array of contacts.
+     * @param old_s [in] Previous values of the \c sij.
+     * @param new_s [in] New values of the \c sij.
+     */
+    template <std::size_t dim>
+    inline double fixed_point_error(double dt,
+                                    const island_contacts<dim, FrictionFixedPoint>& contacts,
+                                    const xt::xtensor<double, 1>& old_s,
+                                    const xt::xtensor<double, 1>& new_s)
+    {
+        double scale = 1. / (contacts.property(0).mu * dt);
+        return scale * xt::norm_l2(new_s - old_s)[0] / (1 + scale * xt::norm_l2(new_s)[0]);
+    }
+
+    template <std::size_t dim>
+    inline double fixed_point_error(double,
+                                    const island_contacts<dim, ViscousFriction>& contacts,
+                                    const xt::xtensor<double, 1>& old_s,
+                                    const xt::xtensor<double, 1>& new_s)
+    {
+        double diff = 0.;
+        double norm = 0.;
+        for (std::size_t i = 0; i < contacts.size(); ++i)
+        {
+            const auto& prop = contacts.property(i);
+            if (prop.gamma == prop.gamma_min)
+            {
+                diff += (new_s[i] - old_s[i]) * (new_s[i] - old_s[i]);
+                norm += new_s[i] * new_s[i];
+            }
+        }
+        return std::sqrt(diff) / (1 + std::sqrt(norm));
+    }
+
+    /**
+     * @brief Largest violation of the constraints of the contacts with \c gamma = \c gamma_min.
+     */
+    template <std::size_t dim>
+    inline double max_constraint_violation(double dt, const island_contacts<dim, ViscousFriction>& contacts, const xt::xtensor<double, 1>& AU)
+    {
+        double max_contrainte = 0;
+        for (std::size_t i = 0, row = 0; i < contacts.size(); ++i, row += dim)
+        {
+            const auto& prop = contacts.property(i);
+            if (prop.gamma == prop.gamma_min)
+            {
+                auto AUi           = xt::view(AU, xt::range(row, row + dim));
+                double contraintes = contact_dij(contacts, i) + dt * xt::linalg::dot(AUi, contact_nij(contacts, i))[0];
+                max_contrainte     = std::max(std::abs(contraintes), max_contrainte);
+            }
         }
+        return max_contrainte;
     }
 
     template <class Method>
@@ -69,6 +181,54 @@ namespace scopi
         void init_options()
         {
             m_method.init_options();
+
+            auto& app = get_app();
+            if (!check_option(app, "--islands"))
+            {
+                auto* opt = app.add_option_group("OptimGradient options");
+                opt->add_option("--islands", m_use_islands, "Solve each connected component of the contact graph independently")
+                    ->capture_default_str();
+                opt->add_option("--fixed-point-anderson",
+                                m_anderson_depth,
+                                "Depth of the Anderson acceleration of the fixed point iterations (0: plain iterations)")
+                    ->capture_default_str();
+            }
+        }
+
+        /**
+         * @brief Enable or disable the decomposition of the contact graph into islands.
+         */
+        void use_islands(bool value)
+        {
+            m_use_islands = value;
+        }
+
+        /**
+         * @brief Set the memory resource of the temporaries of a solve (islands and their work arrays).
+         *
+         * @param resource [in] Memory resource, typically the step_arena of the solver, reset at each time step.
+         */
+        void set_memory_resource(std::pmr::memory_resource* resource)
+        {
+            m_resource = resource;
+        }
+
+        /**
+         * @brief Set the depth of the Anderson acceleration of the fixed point iterations (0 to disable it).
+         */
+        void set_anderson_depth(std::size_t depth)
+        {
+            m_anderson_depth = depth;
+        }
+
+        /**
+         * @brief Set the sleeping particles, which are treated as obstacles by the next solves.
+         *
+         * @param sleeping [in] For each particle of the container, whether it is sleeping.
+         */
+        void set_sleeping(const std::vector<bool>& sleeping)
+        {
+            m_sleeping = sleeping;
         }
 
         params_t& get_params()
@@ -113,142 +273,38 @@ namespace scopi
             m_should_solve = false;
         }
 
+        /**
+         * @brief Copy the \c sij computed by the fixed point iterations into the contacts.
+         *
+         * The fixed point iterations are done inside run, so that the operators of the time step are built once.
+         */
         template <std::size_t dim>
-        void extra_steps_after_solve(std::vector<neighbor<dim, FrictionFixedPoint>>& contacts, const scopi_container<dim>& particles)
+        void extra_steps_after_solve(std::vector<neighbor<dim, FrictionFixedPoint>>& contacts, const scopi_container<dim>&)
         {
-            if (contacts.size() != 0)
-            {
-                xt::xtensor<double, 1> U = xt::zeros<double>({6 * particles.nb_active()});
-
-                std::size_t offset = 3 * particles.nb_active();
-                for (std::size_t i = 0; i < particles.nb_active(); ++i)
-                {
-                    for (std::size_t d = 0; d < dim; ++d)
-                    {
-                        U[3 * i + d] = m_u(i, d);
-                    }
-                    if constexpr (dim == 2)
-                    {
-                        U[offset + 3 * i + 2] = m_omega(i, 2);
-                    }
-                    else if constexpr (dim == 3)
-                    {
-                        for (std::size_t d = 0; d < dim; ++d)
-                        {
-                            U[offset + 3 * i + d] = m_omega(i, d);
-                        }
-                    }
-                }
-
-                AMatrix A(contacts, particles);
-                xt::xtensor<double, 1> AU    = A.mat_mult(U);
-                double tol_point_fixe        = contacts[0].property.fixed_point_tol;
-                double Niter_max_fixed_point = contacts[0].property.fixed_point_max_iter;
-                double err_point_fixe        = 0;
-                xt::xtensor<double, 1> new_s = xt::zeros<double>({contacts.size()});
-                xt::xtensor<double, 1> old_s = xt::zeros<double>({contacts.size()});
-                for (std::size_t i = 0, row = 0; i < contacts.size(); ++i, row += 3)
-                {
-                    auto AUi       = xt::view(AU, xt::range(row, row + dim));
-                    auto dotResult = xt::linalg::dot(AUi, contacts[i].nij)[0];
-
-                    auto outerProduct = contacts[i].nij * dotResult;
-
-                    auto TAUi       = xt::eval(AUi - contacts[i].nij * (xt::linalg::dot(AUi, contacts[i].nij)[0]));
-                    old_s[i]        = contacts[i].sij;
-                    contacts[i].sij = contacts[i].property.mu * m_dt * xt::norm_l2(TAUi)[0];
-                    new_s[i]        = contacts[i].sij;
-                }
-                err_point_fixe = (1 / (contacts[0].property.mu * m_dt)) * xt::norm_l2(new_s - old_s)[0]
-                               / (1 + (1 / (contacts[0].property.mu * m_dt)) * xt::norm_l2(new_s)[0]);
-                Niter_fixed_point++;
-                if (err_point_fixe < tol_point_fixe || Niter_fixed_point >= Niter_max_fixed_point)
-                {
-                    m_should_solve = false;
-                    // std::cout << "NB ITER PT FIXE = " << Niter_fixed_point << std::endl;
-                }
-            }
-            else
-            {
-                m_should_solve = false;
-            }
+            copy_sij(contacts);
         }
 
         template <std::size_t dim>
-        void extra_steps_after_solve(std::vector<neighbor<dim, ViscousFriction>>& contacts, const scopi_container<dim>& particles)
+        void extra_steps_after_solve(std::vector<neighbor<dim, ViscousFriction>>& contacts, const scopi_container<dim>&)
         {
-            if (contacts.size() != 0)
-            {
-                xt::xtensor<double, 1> U = xt::zeros<double>({6 * particles.nb_active()});
-
-                std::size_t offset = 3 * particles.nb_active();
-                for (std::size_t i = 0; i < particles.nb_active(); ++i)
-                {
-                    for (std::size_t d = 0; d < dim; ++d)
-                    {
-                        U[3 * i + d] = m_u(i, d);
-                    }
-                    if constexpr (dim == 2)
-                    {
-                        U[offset + 3 * i + 2] = m_omega(i, 2);
-                    }
-                    else if constexpr (dim == 3)
-                    {
-                        for (std::size_t d = 0; d < dim; ++d)
-                        {
-                            U[offset + 3 * i + d] = m_omega(i, d);
-                        }
-                    }
-                }
-
-                AMatrix A(contacts, particles);
-                xt::xtensor<double, 1> AU    = A.mat_mult(U);
-                double tol_point_fixe        = contacts[0].property.fixed_point_tol;
-                double Niter_max_fixed_point = contacts[0].property.fixed_point_max_iter;
-                double err_point_fixe        = 0;
-                xt::xtensor<double, 1> new_s = xt::zeros<double>({contacts.size()});
-                xt::xtensor<double, 1> old_s = xt::zeros<double>({contacts.size()});
-                for (std::size_t i = 0, row = 0; i < contacts.size(); ++i, row += 3)
-                {
-                    if (contacts[i].property.gamma == contacts[i].property.gamma_min)
-                    {
-                        auto AUi       = xt::view(AU, xt::range(row, row + dim));
-                        auto dotResult = xt::linalg::dot(AUi, contacts[i].nij)[0];
-
-                        auto outerProduct = contacts[i].nij * dotResult;
-
-                        auto TAUi       = xt::eval(AUi - contacts[i].nij * (xt::linalg::dot(AUi, contacts[i].nij)[0]));
-                        old_s[i]        = contacts[i].sij;
-                        contacts[i].sij = xt::norm_l2(TAUi)[0];
-                        new_s[i]        = contacts[i].sij;
-                    }
-                }
-                err_point_fixe = xt::norm_l2(new_s - old_s)[0] / (1 + xt::norm_l2(new_s)[0]);
-                Niter_fixed_point++;
-                if (err_point_fixe < tol_point_fixe || Niter_fixed_point >= Niter_max_fixed_point)
-                {
-                    double max_contrainte = 0;
-                    for (std::size_t i = 0, row = 0; i < contacts.size(); ++i, row += 3)
-                    {
-                        if (contacts[i].property.gamma == contacts[i].property.gamma_min)
-                        {
-                            auto AUi       = xt::view(AU, xt::range(row, row + dim));
-                            auto dotResult = xt::linalg::dot(AUi, contacts[i].nij)[0];
-
-                            double contraintes = contacts[i].dij + m_dt * dotResult;
-                            max_contrainte     = std::max(std::abs(contraintes), max_contrainte);
-                        }
-                    }
-                    PLOG_INFO << "----> Max Contraintes = " << max_contrainte << std::endl;
-                    m_should_solve = false;
-                }
-            }
-            else
-            {
-                m_should_solve = false;
-            }
+            copy_sij(contacts);
         }
 
+        /**
+         * @brief Solve the optimization problem and compute the new velocities.
+         *
+         * If the islands are enabled, the contact graph is split into connected components (see compute_islands)
+         * which are solved independently and in parallel.
+         * Otherwise, a single problem restricted to the particles involved in a contact is solved (see compact_contacts).
+         * In both cases, the particles without contact keep their a priori velocity.
+         *
+         * For FrictionFixedPoint and ViscousFriction, each problem is solved by fixed point iterations on the \c sij
+         * (see fixed_point): the operators are built once, each solve starts from the previous multipliers and
+         * the sequence of \c sij is accelerated by Anderson's method.
+         *
+         * @param particles [in] Array of particles.
+         * @param contacts [in] Array of contacts.
+         */
         template <std::size_t dim, class problem_t>
         void run(const scopi_container<dim>& particles, const std::vector<neighbor<dim, problem_t>>& contacts, std::size_t)
         {
@@ -258,47 +314,44 @@ namespace scopi
             m_omega.resize({particles.nb_active(), 3});
             m_omega.fill(0);
 
-            if (contacts.size() != 0)
+            for (std::size_t i = 0; i < particles.nb_active(); ++i)
             {
-                auto min_p = make_minimization_problem<problem_t>(m_dt, contacts, particles);
-
-                m_lambda = m_method(min_p);
-
-                auto velocities = min_p.velocities(m_lambda);
-
-                for (std::size_t i = 0; i < particles.nb_active(); ++i)
+                for (std::size_t d = 0; d < dim; ++d)
                 {
-                    for (std::size_t d = 0; d < dim; ++d)
-                    {
-                        m_u(i, d) = particles.v()(i + active_offset)(d) + m_dt * velocities(i * 3 + d);
-
-                        if constexpr (dim == 3)
-                        {
-                            m_omega(i, d) = particles.omega()(i + active_offset)(d) + m_dt * velocities((i + particles.nb_active()) * 3 + d);
-                        }
-                    }
-                    if constexpr (dim == 2)
+                    m_u(i, d) = particles.v()(i + active_offset)(d);
+                    if constexpr (dim == 3)
                     {
-                        m_omega(i, 2) = particles.omega()(i + active_offset) + m_dt * velocities((i + particles.nb_active()) * 3 + 2);
+                        m_omega(i, d) = particles.omega()(i + active_offset)(d);
                     }
                 }
+                if constexpr (dim == 2)
+                {
+                    m_omega(i, 2) = particles.omega()(i + active_offset);
+                }
             }
-            else
+
+            m_lambda.resize({dim * contacts.size()});
+            m_lambda.fill(0.);
+            if constexpr (is_fixed_point_problem_v<problem_t>)
             {
-                for (std::size_t i = 0; i < particles.nb_active(); ++i)
+                m_sij.resize(contacts.size());
+                for (std::size_t i = 0; i < contacts.size(); ++i)
                 {
-                    for (std::size_t d = 0; d < dim; ++d)
-                    {
-                        m_u(i, d) = particles.v()(i + active_offset)(d);
-                        if constexpr (dim == 3)
-                        {
-                            m_omega(i, d) = particles.omega()(i + active_offset)(d);
-                        }
-                    }
-                    if constexpr (dim == 2)
-                    {
-                        m_omega(i, 2) = particles.omega()(i + active_offset);
-                    }
+                    m_sij[i] = contacts[i].sij;
+                }
+            }
+            if (contacts.size() != 0)
+            {
+                if (m_use_islands)
+                {
+                    auto islands = compute_islands(particles, contacts, m_sleeping, m_resource);
+                    solve_islands(particles, contacts, islands);
+                    PLOG_INFO << "----> Number of islands = " << islands.size() << std::endl;
+                }
+                else
+                {
+                    auto islands = compact_contacts(particles, contacts, m_sleeping, m_resource);
+                    solve_islands(particles, contacts, islands);
                 }
             }
             auto duration = toc();
@@ -324,11 +377,72 @@ namespace scopi
             return m_omega;
         }
 
+        /**
+         * @brief Lagrange multipliers of the last solve, \c dim per contact in the order of the contacts.
+         */
         const auto& lagrange_multiplier() const
         {
             return m_lambda;
         }
 
+        /**
+         * @brief Set the Lagrange multipliers of the last solve, when a simulation restarts from a checkpoint.
+         *
+         * They are the ones returned by lagrange_multiplier until the next solve, which starts from the state of the
+         * method (see set_solver_state) and not from these multipliers.
+         */
+        void set_lagrange_multiplier(const xt::xtensor<double, 1>& lambda)
+        {
+            m_lambda = lambda;
+        }
+
+        /**
+         * @brief State kept by the method from one time step to the next, for the checkpoints.
+         *
+         * It is made of the copy of the method of each island of the last solve, with the key of the island
+         * (see island_key). It is empty if the method keeps no state (see has_solver_state).
+         */
+        std::vector<char> solver_state() const
+        {
+            std::vector<char> buffer;
+            if constexpr (has_solver_state_v<method_t>)
+            {
+                solver_state_writer out(buffer);
+                out.write<std::uint64_t>(m_island_methods.size());
+                for (const auto& island : m_island_methods)
+                {
+                    out.write(island.key);
+                    island.method.save_state(out);
+                }
+            }
+            return buffer;
+        }
+
+        /**
+         * @brief Restore the state written by solver_state, so that the next solve continues as in the saved run.
+         */
+        void set_solver_state(const std::vector<char>& buffer)
+        {
+            m_island_methods.clear();
+            if constexpr (has_solver_state_v<method_t>)
+            {
+                if (buffer.empty())
+                {
+                    return;
+                }
+                solver_state_reader in(buffer.data(), buffer.size());
+                auto nb_islands = in.read<std::uint64_t>();
+                m_island_methods.reserve(nb_islands);
+                for (std::size_t k = 0; k < nb_islands; ++k)
+                {
+                    island_method island{{}, m_method};
+                    in.read(island.key);
+                    island.method.load_state(in);
+                    m_island_methods.push_back(std::move(island));
+                }
+            }
+        }
+
         bool should_solve()
         {
             return m_should_solve;
@@ -340,7 +454,316 @@ namespace scopi
 
       private:
 
+        /**
+         * @brief Copy of the method solving an island, with the state it keeps from one solve to the next.
+         *
+         * The buffers of the problem of the island and of its fixed point iterations are kept as well, so that the
+         * solves of the next time steps reuse their memory.
+         */
+        struct island_method
+        {
+            /// Global description of the island (see island_key).
+            std::vector<std::size_t> key;
+            method_t method;
+            problem_workspace workspace;
+            /// Solution of the last solve.
+            xt::xtensor<double, 1> lambda;
+            /// Vectors of the fixed point iterations.
+            xt::xtensor<double, 1> U0;
+            xt::xtensor<double, 1> u;
+            xt::xtensor<double, 1> old_s;
+            xt::xtensor<double, 1> new_s;
+        };
+
+        /**
+         * @brief Identify an island by its particles and its contacts, with their indices in the container.
+         *
+         * Two islands of successive time steps with the same key have the same problem up to the values of its
+         * operators, so that the state of the method of the first one can be used to solve the second one.
+         */
+        template <std::size_t dim, class problem_t>
+        static void island_key(const std::vector<neighbor<dim, problem_t>>& contacts,
+                               const contact_island<dim, problem_t>& island,
+                               std::vector<std::size_t>& key)
+        {
+            key.clear();
+            key.reserve(2 + island.bodies.size() + 2 * island.contact_indices.size());
+            key.push_back(island.nb_inactive);
+            key.push_back(island.bodies.size());
+            key.insert(key.end(), island.bodies.begin(), island.bodies.end());
+            for (auto ic : island.contact_indices)
+            {
+                key.push_back(contacts[ic].i);
+                key.push_back(contacts[ic].j);
+            }
+        }
+
+        /**
+         * @brief Give a copy of the method to each island.
+         *
+         * An island keeps the method of the island of the previous solve with the same key, whatever their positions
+         * in the list of islands. The other islands get a copy of m_method, without state.
+         * When the islands are those of the previous solve in the same order, as in the steady state, nothing is
+         * allocated.
+         */
+        template <std::size_t dim, class problem_t>
+        void set_island_methods(const std::vector<neighbor<dim, problem_t>>& contacts,
+                                const std::vector<contact_island<dim, problem_t>>& islands)
+        {
+            bool same_islands = m_island_methods.size() == islands.size();
+            for (std::size_t k = 0; k < islands.size() && same_islands; ++k)
+            {
+                island_key(contacts, islands[k], m_key);
+                same_islands = (m_key == m_island_methods[k].key);
+            }
+            if (same_islands)
+            {
+                for (auto& island : m_island_methods)
+                {
+                    island.method.get_params() = m_method.get_params();
+                }
+                return;
+            }
+
+            // the islands are disjoint, so that the keys are unique
+            std::map<std::vector<std::size_t>, std::size_t> previous;
+            for (std::size_t k = 0; k < m_island_methods.size(); ++k)
+            {
+                previous.emplace(std::move(m_island_methods[k].key), k);
+            }
+
+            std::vector<island_method> methods;
+            methods.reserve(islands.size());
+            for (const auto& island : islands)
+            {
+                std::vector<std::size_t> key;
+                island_key(contacts, island, key);
+                auto search = previous.find(key);
+                if (search != previous.end())
+                {
+                    methods.push_back(std::move(m_island_methods[search->second]));
+                }
+                else
+                {
+                    methods.push_back({{}, m_method});
+                }
+                methods.back().key                 = std::move(key);
+                methods.back().method.get_params() = m_method.get_params();
+            }
+            m_island_methods = std::move(methods);
+        }
+
+        template <std::size_t dim, class problem_t>
+        void solve_islands(const scopi_container<dim>& particles,
+                           const std::vector<neighbor<dim, problem_t>>& contacts,
+                           std::vector<contact_island<dim, problem_t>>& islands)
+        {
+            set_island_methods(contacts, islands);
+            auto& reports = m_reports;
+            reports.assign(islands.size(), island_report());
+
+#pragma omp parallel for schedule(dynamic)
+            for (std::size_t k = 0; k < islands.size(); ++k)
+            {
+                auto& island = islands[k];
+                island_particles<dim> island_p(particles, island.bodies, island.nb_inactive);
+
+                auto& island_m = m_island_methods[k];
+                auto min_p     = make_minimization_problem<problem_t>(m_dt, island.contacts, island_p, island_m.workspace);
+                auto& l        = island_m.lambda;
+                l              = island_m.method(min_p);
+
+                reports[k].solver_iterations = island_m.method.iterations();
+                if constexpr (is_fixed_point_problem_v<problem_t>)
+                {
+                    fixed_point(min_p, island.contacts, island_p, island_m, reports[k]);
+                    for (std::size_t ic = 0; ic < island.contact_indices.size(); ++ic)
+                    {
+                        m_sij[island.contact_indices[ic]] = island.contacts.sij(ic);
+                    }
+                }
+
+                const auto& lambda_global = min_p.local2global(l);
+                for (std::size_t ic = 0; ic < island.contact_indices.size(); ++ic)
+                {
+                    for (std::size_t d = 0; d < dim; ++d)
+                    {
+                        m_lambda(dim * island.contact_indices[ic] + d) = lambda_global(dim * ic + d);
+                    }
+                }
+
+                // each active particle belongs to one island only: no concurrent writes
+                add_velocities(island_p, min_p.velocities(l), island.bodies.data() + island.nb_inactive, particles.nb_inactive());
+            }
+
+            std::size_t max_solver_iterations   = 0;
+            std::size_t total_solver_iterations = 0;
+            for (auto& report : reports)
+            {
+                max_solver_iterations = std::max(max_solver_iterations, report.solver_iterations);
+                total_solver_iterations += report.solver_iterations;
+            }
+            PLOG_INFO << "----> Solver iterations = " << max_solver_iterations << " (" << total_solver_iterations << " over "
+                      << islands.size() << " problems)" << std::endl;
+
+            if constexpr (is_fixed_point_problem_v<problem_t>)
+            {
+                std::size_t total_iterations = 0;
+                double max_constraint        = 0.;
+                Niter_fixed_point            = 0;
+                for (auto& report : reports)
+                {
+                    Niter_fixed_point = std::max(Niter_fixed_point, report.iterations);
+                    total_iterations += report.iterations;
+                    max_constraint = std::max(max_constraint, report.max_constraint);
+                }
+                PLOG_INFO << "----> Number of fixed point iterations = " << Niter_fixed_point << " (" << total_iterations
+                          << " over all the islands)" << std::endl;
+                if constexpr (std::is_same_v<problem_t, ViscousFriction>)
+                {
+                    PLOG_INFO << "----> Max Contraintes = " << max_constraint << std::endl;
+                }
+            }
+        }
+
+        /**
+         * @brief Summary of the solve of an island, logged by solve_islands.
+         */
+        struct island_report
+        {
+            /// Iterations of the method, summed over the fixed point iterations.
+            std::size_t solver_iterations = 0;
+            /// Fixed point iterations.
+            std::size_t iterations = 0;
+            double max_constraint  = 0.;
+        };
+
+        /**
+         * @brief Fixed point iterations on the \c sij of the contacts of a problem.
+         *
+         * Each iteration computes the velocities given by the current multipliers, the new \c sij (see fixed_point_map)
+         * and solves the problem again with the extrapolated \c sij (see anderson_acceleration), starting from the
+         * current multipliers.
+         * Only the linear term of the problem depends on the \c sij: the other operators are kept.
+         *
+         * @param min_p [in,out] Problem, already solved once with the initial \c sij.
+         * @param contacts [in,out] Contacts of the problem, whose \c sij are updated.
+         * @param particles [in] Particles of the problem.
+         * @param island [in,out] Method used to solve the problem and buffers of the iterations. Its \c lambda is
+         * the solution of the first solve on entry, the solution of the last solve on exit.
+         * @param report [in,out] Number of iterations, added to the iterations of the method, and, for ViscousFriction,
+         * largest constraint violation.
+         */
+        template <class MinP, class Contacts, class Particles>
+        void fixed_point(MinP& min_p, Contacts& contacts, const Particles& particles, island_method& island, island_report& report)
+        {
+            using problem_t              = typename Contacts::problem_t;
+            double tol_point_fixe        = contacts.property(0).fixed_point_tol;
+            double Niter_max_fixed_point = contacts.property(0).fixed_point_max_iter;
+            auto& method                 = island.method;
+            auto& lambda                 = island.lambda;
+            auto& U0                     = island.U0;
+            auto& u                      = island.u;
+            auto& old_s                  = island.old_s;
+            auto& new_s                  = island.new_s;
+            UVector(particles, U0);
+            old_s.resize({contacts.size()});
+            new_s.resize({contacts.size()});
+            anderson_acceleration anderson(m_anderson_depth);
+
+            for (std::size_t i = 0; i < contacts.size(); ++i)
+            {
+                old_s[i] = contacts.sij(i);
+            }
+
+            while (true)
+            {
+                ++report.iterations;
+                xt::noalias(u) = U0 + m_dt * min_p.velocities(lambda);
+                const auto& AU = min_p.relative_velocities(u);
+                fixed_point_map(m_dt, contacts, AU, new_s);
+
+                double err_point_fixe = fixed_point_error(m_dt, contacts, old_s, new_s);
+                if (err_point_fixe < tol_point_fixe || report.iterations >= Niter_max_fixed_point)
+                {
+                    for (std::size_t i = 0; i < contacts.size(); ++i)
+                    {
+                        contacts.set_sij(i, new_s[i]);
+                    }
+                    if constexpr (std::is_same_v<problem_t, ViscousFriction>)
+                    {
+                        report.max_constraint = max_constraint_violation(m_dt, contacts, AU);
+                    }
+                    break;
+                }
+
+                // the sij are norms
+                old_s = xt::maximum(anderson(old_s, new_s), 0.);
+                for (std::size_t i = 0; i < contacts.size(); ++i)
+                {
+                    contacts.set_sij(i, old_s[i]);
+                }
+                min_p.update_S_Vector();
+                lambda = method(min_p, lambda);
+                report.solver_iterations += method.iterations();
+            }
+        }
+
+        template <class Contacts>
+        void copy_sij(Contacts& contacts)
+        {
+            if (m_sij.size() == contacts.size())
+            {
+                for (std::size_t i = 0; i < contacts.size(); ++i)
+                {
+                    contacts[i].sij = m_sij[i];
+                }
+            }
+            m_should_solve = false;
+        }
+
+        /**
+         * @brief Add the velocity corrections of a sub-problem to m_u and m_omega.
+         *
+         * @param particles [in] Particles of the sub-problem.
+         * @param velocities [in] Corrections, \f$M^{-1} A^T \lambda\f$.
+         * @param bodies [in] Index in the container of each active particle of the sub-problem.
+         * @param active_offset [in] Number of inactive particles in the container.
+         */
+        template <class Particles, class Velocities>
+        void add_velocities(const Particles& particles, const Velocities& velocities, const std::size_t* bodies, std::size_t active_offset)
+        {
+            static constexpr std::size_t dim = Particles::dim;
+            std::size_t rot_offset           = dim * particles.nb_active();
+            for (std::size_t i = 0; i < particles.nb_active(); ++i)
+            {
+                std::size_t ig = bodies[i] - active_offset;
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    m_u(ig, d) += m_dt * velocities(i * dim + d);
+
+                    if constexpr (dim == 3)
+                    {
+                        m_omega(ig, d) += m_dt * velocities(rot_offset + i * 3 + d);
+                    }
+                }
+                if constexpr (dim == 2)
+                {
+                    m_omega(ig, 2) += m_dt * velocities(rot_offset + i);
+                }
+            }
+        }
+
         method_t m_method;
+        std::vector<island_method> m_island_methods;
+        /// Work arrays of solve_islands, reused by the next solves.
+        std::vector<std::size_t> m_key;
+        std::vector<island_report> m_reports;
+        bool m_use_islands          = true;
+        std::size_t m_anderson_depth = 5;
+        std::vector<bool> m_sleeping;
+        std::vector<double> m_sij;
+        std::pmr::memory_resource* m_resource = std::pmr::get_default_resource();
         bool m_should_solve = false;
         xt::xtensor<double, 2> m_u;
         xt::xtensor<double, 2> m_omega;
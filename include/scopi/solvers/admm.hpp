@@ -0,0 +1,340 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <CLI/CLI.hpp>
+
+#include <plog/Log.h>
+
+#include <xtensor/xnoalias.hpp>
+#include <xtensor/xnorm.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include "../scopi.hpp"
+#include "../utils.hpp"
+#include "solver_state.hpp"
+
+namespace scopi
+{
+
+    template <class Problem, class Contacts, class Particles>
+    class minimization_problem;
+
+    struct admm_params
+    {
+        void init_options()
+        {
+            auto& app = get_app();
+            auto* opt = app.add_option_group("ADMM options");
+            if (!check_option(app, "--admm-rho"))
+            {
+                opt->add_option("--admm-rho", rho, "Initial penalty parameter (0: computed from the Delassus diagonal)")->capture_default_str();
+                opt->add_option("--admm-max-ite", max_ite, "Maximum number of iterations")->capture_default_str();
+                opt->add_option("--admm-tolerance", tolerance, "Tolerance")->capture_default_str();
+                opt->add_option("--admm-adaptive", adaptive_rho, "Adaptive penalty parameter (true or false)")->capture_default_str();
+                opt->add_option("--admm-mu", mu, "Ratio between the residuals triggering a penalty update")->capture_default_str();
+                opt->add_option("--admm-tau", tau, "Penalty update factor")->capture_default_str();
+                opt->add_option("--admm-cg-max-ite", cg_max_ite, "Maximum number of iterations of the inner conjugate gradient")
+                    ->capture_default_str();
+                opt->add_option("--admm-cg-tolerance", cg_tolerance, "Relative tolerance of the inner conjugate gradient")->capture_default_str();
+            }
+        }
+
+        double rho             = 0.;
+        std::size_t max_ite    = 10000;
+        double tolerance       = 1e-7;
+        bool adaptive_rho      = true;
+        double mu              = 10.;
+        double tau             = 2.;
+        std::size_t cg_max_ite = 200;
+        double cg_tolerance    = 1e-10;
+    };
+
+    /**
+     * @brief Alternating direction method of multipliers.
+     *
+     * Splits the constrained problem into a linear solve with the regularized Delassus operator \f$ W + \rho I \f$
+     * and a projection on the constraint set (see LagrangeMultiplier::projection):
+     * \f{eqnarray*}{
+     *      (W + \rho I) \lambda^{k+1} &=& \rho (z^k - u^k) - c, \\
+     *      z^{k+1} &=& P(\lambda^{k+1} + u^k), \\
+     *      u^{k+1} &=& u^k + \lambda^{k+1} - z^{k+1}.
+     * \f}
+     * The linear system is solved matrix-free by a conjugate gradient preconditioned by the diagonal of \f$ W \f$.
+     * The penalty \f$ \rho \f$ is updated by residual balancing.
+     *
+     * The preconditioner, the penalty and the iterates are kept from one call to the next as long as the contact graph
+     * does not change: the fixed point iterations and the following time steps then start from the previous solution.
+     * OptimGradient gives each island its own copy of the method, identified by the indices of the island's particles
+     * and contacts in the container, so that an island never starts from the state of another one.
+     */
+    class admm
+    {
+      public:
+
+        using params_t = admm_params;
+
+        explicit admm(const params_t& params = params_t())
+            : m_params(params)
+        {
+        }
+
+        void init_options()
+        {
+            m_params.init_options();
+        }
+
+        params_t& get_params()
+        {
+            return m_params;
+        }
+
+        template <class Problem, class Contacts, class Particles>
+        const xt::xtensor<double, 1>& operator()(const minimization_problem<Problem, Contacts, Particles>& min_p)
+        {
+            m_lambda0.resize({min_p.size()});
+            m_lambda0.fill(0.);
+            return (*this)(min_p, m_lambda0);
+        }
+
+        /**
+         * @brief Solve the problem starting from \c lambda0 (warm start).
+         *
+         * \c lambda0 is only used when the contact graph changed: otherwise the iterates of the previous call are kept.
+         * The solution is valid until the next call.
+         */
+        template <class Problem, class Contacts, class Particles>
+        const xt::xtensor<double, 1>& operator()(const minimization_problem<Problem, Contacts, Particles>& min_p,
+                                                 const xt::xtensor<double, 1>& lambda0)
+        {
+            std::size_t ite        = 0;
+            std::size_t cg_ite     = 0;
+            bool converged         = false;
+            double primal_residual = 0.;
+            double dual_residual   = 0.;
+
+            if (min_p.size() != m_z.size() || !same_contact_graph(min_p.contacts()))
+            {
+                set_contact_graph(min_p.contacts());
+                m_diagonal = min_p.diagonal();
+                m_x        = lambda0;
+                m_z        = lambda0;
+                m_u        = xt::zeros<double>({min_p.size()});
+                m_rho      = (m_params.rho > 0.) ? m_params.rho : default_rho();
+            }
+
+            auto& c     = m_c;
+            auto& rhs   = m_rhs;
+            auto& z_old = m_z_old;
+            c           = min_p.linear_term();
+            rhs.resize({min_p.size()});
+            z_old.resize({min_p.size()});
+
+            while (ite < m_params.max_ite)
+            {
+                ++ite;
+
+                xt::noalias(rhs) = m_rho * (m_z - m_u) - c;
+                cg_ite += conjugate_gradient(min_p, rhs);
+
+                std::swap(z_old, m_z);
+                xt::noalias(m_z) = m_x + m_u;
+                min_p.projection(m_z);
+                m_u += m_x - m_z;
+
+                primal_residual = l2_norm(m_x - m_z);
+                dual_residual   = m_rho * l2_norm(m_z - z_old);
+
+                if (primal_residual <= m_params.tolerance * (1. + std::max(l2_norm(m_x), l2_norm(m_z)))
+                    && dual_residual <= m_params.tolerance * (1. + m_rho * l2_norm(m_u)))
+                {
+                    converged = true;
+                    break;
+                }
+
+                if (m_params.adaptive_rho)
+                {
+                    if (primal_residual > m_params.mu * dual_residual)
+                    {
+                        m_rho *= m_params.tau;
+                        m_u /= m_params.tau;
+                    }
+                    else if (dual_residual > m_params.mu * primal_residual)
+                    {
+                        m_rho /= m_params.tau;
+                        m_u *= m_params.tau;
+                    }
+                }
+            }
+            m_iterations = ite;
+            if (converged)
+            {
+                PLOG_DEBUG << fmt::format("admm converged in {} iterations ({} CG iterations, rho = {}).", ite, cg_ite, m_rho) << std::endl;
+            }
+            else
+            {
+                PLOG_WARNING << fmt::format("admm did not converge in {} iterations (primal residual = {}, dual residual = {}, rho = {}).",
+                                            ite,
+                                            primal_residual,
+                                            dual_residual,
+                                            m_rho)
+                             << std::endl;
+            }
+            return m_z;
+        }
+
+        /**
+         * @brief Number of iterations of the last solve.
+         */
+        std::size_t iterations() const
+        {
+            return m_iterations;
+        }
+
+        /**
+         * @brief Write the state kept from one call to the next: contact graph, preconditioner, iterates and penalty.
+         */
+        void save_state(solver_state_writer& out) const
+        {
+            out.write<std::uint64_t>(m_graph.size());
+            for (const auto& [i, j] : m_graph)
+            {
+                out.write<std::uint64_t>(i);
+                out.write<std::uint64_t>(j);
+            }
+            out.write(m_diagonal);
+            out.write(m_x);
+            out.write(m_z);
+            out.write(m_u);
+            out.write(m_rho);
+        }
+
+        /**
+         * @brief Restore the state written by save_state.
+         */
+        void load_state(solver_state_reader& in)
+        {
+            m_graph.resize(in.read<std::uint64_t>());
+            for (auto& [i, j] : m_graph)
+            {
+                i = in.read<std::uint64_t>();
+                j = in.read<std::uint64_t>();
+            }
+            in.read(m_diagonal);
+            in.read(m_x);
+            in.read(m_z);
+            in.read(m_u);
+            m_rho = in.read<double>();
+        }
+
+      private:
+
+        template <class Problem, class Contacts, class Particles>
+        std::size_t conjugate_gradient(const minimization_problem<Problem, Contacts, Particles>& min_p, const xt::xtensor<double, 1>& rhs)
+        {
+            auto& inv_precond = m_cg_inv_precond;
+            auto& r           = m_cg_r;
+            auto& z           = m_cg_z;
+            auto& p           = m_cg_p;
+            auto& Ap          = m_cg_Ap;
+
+            xt::noalias(inv_precond) = 1. / (m_diagonal + m_rho);
+            xt::noalias(r)           = rhs - min_p.linear_operator(m_x) - m_rho * m_x;
+
+            double rhs_norm = std::max(l2_norm(rhs), 1e-30);
+            if (l2_norm(r) <= m_params.cg_tolerance * rhs_norm)
+            {
+                return 0;
+            }
+
+            xt::noalias(z) = inv_precond * r;
+            p              = z;
+            double rz      = dot_product(r, z);
+
+            std::size_t ite = 0;
+            while (ite < m_params.cg_max_ite)
+            {
+                ++ite;
+                xt::noalias(Ap) = min_p.linear_operator(p) + m_rho * p;
+                double alpha    = rz / dot_product(p, Ap);
+                m_x += alpha * p;
+                r -= alpha * Ap;
+
+                if (l2_norm(r) <= m_params.cg_tolerance * rhs_norm)
+                {
+                    break;
+                }
+
+                xt::noalias(z) = inv_precond * r;
+                double rz_new  = dot_product(r, z);
+                xt::noalias(p) = z + (rz_new / rz) * p;
+                rz             = rz_new;
+            }
+            return ite;
+        }
+
+        double default_rho() const
+        {
+            double sum       = 0.;
+            std::size_t size = 0;
+            for (auto d : m_diagonal)
+            {
+                if (d > 0.)
+                {
+                    sum += d;
+                    ++size;
+                }
+            }
+            return (size == 0) ? 1. : sum / size;
+        }
+
+        template <class Contacts>
+        bool same_contact_graph(const Contacts& contacts) const
+        {
+            if (contacts.size() != m_graph.size())
+            {
+                return false;
+            }
+            for (std::size_t i = 0; i < contacts.size(); ++i)
+            {
+                if (contact_i(contacts, i) != m_graph[i].first || contact_j(contacts, i) != m_graph[i].second)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <class Contacts>
+        void set_contact_graph(const Contacts& contacts)
+        {
+            m_graph.resize(contacts.size());
+            for (std::size_t i = 0; i < contacts.size(); ++i)
+            {
+                m_graph[i] = {contact_i(contacts, i), contact_j(contacts, i)};
+            }
+        }
+
+        params_t m_params;
+        std::vector<std::pair<std::size_t, std::size_t>> m_graph;
+        xt::xtensor<double, 1> m_diagonal;
+        xt::xtensor<double, 1> m_x;
+        xt::xtensor<double, 1> m_z;
+        xt::xtensor<double, 1> m_u;
+        double m_rho             = 1.;
+        std::size_t m_iterations = 0;
+        // work arrays, reused by the next calls
+        xt::xtensor<double, 1> m_lambda0;
+        xt::xtensor<double, 1> m_c;
+        xt::xtensor<double, 1> m_rhs;
+        xt::xtensor<double, 1> m_z_old;
+        xt::xtensor<double, 1> m_cg_inv_precond;
+        xt::xtensor<double, 1> m_cg_r;
+        xt::xtensor<double, 1> m_cg_z;
+        xt::xtensor<double, 1> m_cg_p;
+        xt::xtensor<double, 1> m_cg_Ap;
+    };
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+
+#include <xtensor-blas/xlinalg.hpp>
+#include <xtensor/xtensor.hpp>
+
+namespace scopi
+{
+    /**
+     * @brief Anderson acceleration of a fixed point iteration \f$ x_{k+1} = G(x_k) \f$.
+     *
+     * Keeps the differences of the last \c depth residuals \f$ f_k = G(x_k) - x_k \f$ and of the last \c depth values
+     * \f$ G(x_k) \f$, and returns the extrapolation
+     * \f[
+     *      x_{k+1} = G(x_k) - \sum_i \gamma_i \Delta G_i,
+     * \f]
+     * where \f$ \gamma \f$ minimizes \f$ \| f_k - \sum_i \gamma_i \Delta f_i \| \f$.
+     * The least-squares problem is solved with its (regularized) normal equations, which are small.
+     * With a depth of 0, the plain iteration \f$ x_{k+1} = G(x_k) \f$ is recovered.
+     */
+    class anderson_acceleration
+    {
+      public:
+
+        explicit anderson_acceleration(std::size_t depth)
+            : m_depth(depth)
+        {
+        }
+
+        /**
+         * @brief Next iterate.
+         *
+         * @param x [in] Current iterate \f$ x_k \f$.
+         * @param g [in] Image \f$ G(x_k) \f$ of the current iterate.
+         */
+        xt::xtensor<double, 1> operator()(const xt::xtensor<double, 1>& x, const xt::xtensor<double, 1>& g)
+        {
+            if (m_depth == 0)
+            {
+                return g;
+            }
+
+            xt::xtensor<double, 1> f = g - x;
+            if (m_has_previous)
+            {
+                m_df.push_back(f - m_f_previous);
+                m_dg.push_back(g - m_g_previous);
+                if (m_df.size() > m_depth)
+                {
+                    m_df.pop_front();
+                    m_dg.pop_front();
+                }
+            }
+            m_f_previous   = f;
+            m_g_previous   = g;
+            m_has_previous = true;
+
+            if (m_df.empty())
+            {
+                return g;
+            }
+
+            std::size_t m                 = m_df.size();
+            xt::xtensor<double, 2> matrix = xt::zeros<double>({m, m});
+            xt::xtensor<double, 1> rhs    = xt::zeros<double>({m});
+            double trace                  = 0.;
+            for (std::size_t a = 0; a < m; ++a)
+            {
+                for (std::size_t b = 0; b <= a; ++b)
+                {
+                    matrix(a, b) = xt::linalg::dot(m_df[a], m_df[b])[0];
+                    matrix(b, a) = matrix(a, b);
+                }
+                rhs(a) = xt::linalg::dot(m_df[a], f)[0];
+                trace += matrix(a, a);
+            }
+            if (trace == 0.)
+            {
+                return g;
+            }
+            // the differences become nearly collinear close to convergence
+            for (std::size_t a = 0; a < m; ++a)
+            {
+                matrix(a, a) += 1e-10 * trace;
+            }
+
+            xt::xtensor<double, 1> gamma = xt::linalg::solve(matrix, rhs);
+            xt::xtensor<double, 1> out   = g;
+            for (std::size_t a = 0; a < m; ++a)
+            {
+                out -= gamma(a) * m_dg[a];
+            }
+            return out;
+        }
+
+      private:
+
+        std::size_t m_depth;
+        bool m_has_previous = false;
+        xt::xtensor<double, 1> m_f_previous;
+        xt::xtensor<double, 1> m_g_previous;
+        std::deque<xt::xtensor<double, 1>> m_df;
+        std::deque<xt::xtensor<double, 1>> m_dg;
+    };
+}
@@ -58,19 +58,35 @@ namespace scopi
         }
 
         template <class Problem, class Contacts, class Particles>
-        auto operator()(const minimization_problem<Problem, Contacts, Particles>& min_p)
+        const xt::xtensor<double, 1>& operator()(const minimization_problem<Problem, Contacts, Particles>& min_p)
+        {
+            m_lambda0.resize({min_p.size()});
+            m_lambda0.fill(0.);
+            return (*this)(min_p, m_lambda0);
+        }
+
+        /**
+         * @brief Solve the problem starting from \c lambda0 (warm start).
+         *
+         * The iterates are members, reused by the next calls: the solution is valid until the next call.
+         */
+        template <class Problem, class Contacts, class Particles>
+        const xt::xtensor<double, 1>& operator()(const minimization_problem<Problem, Contacts, Particles>& min_p,
+                                                 const xt::xtensor<double, 1>& lambda0)
         {
             std::size_t ite = 0;
 
-            xt::xtensor<double, 1> lambda_n   = xt::zeros<double>({min_p.size()});
-            xt::xtensor<double, 1> lambda_np1 = xt::zeros<double>({min_p.size()});
+            auto& lambda_n   = m_lambda_n;
+            auto& lambda_np1 = m_lambda_np1;
+            lambda_n         = lambda0;
+            lambda_np1       = lambda0;
 
             while (ite < m_params.max_ite)
             {
                 ++ite;
 
-                xt::xtensor<double, 1> dG = min_p.gradient(lambda_n);
-                lambda_np1                = lambda_n - m_params.alpha * dG;
+                const auto& dG          = min_p.gradient(lambda_n);
+                xt::noalias(lambda_np1) = lambda_n - m_params.alpha * dG;
                 min_p.projection(lambda_np1);
 
                 // PLOG_INFO << fmt::format("pgd -> ite: {} residual: {}", ite, xt::norm_l2(lambda_np1 - lambda_n)[0]) << std::endl;
@@ -78,7 +94,7 @@ namespace scopi
                 // PLOG_INFO << fmt::format("dG: {}", xt::norm_linf(dG)) << std::endl;
                 // PLOG_INFO << fmt::format("lambda_n: {}", xt::norm_linf(lambda_np1)) << std::endl;
 
-                if (xt::norm_l2(lambda_np1 - lambda_n)[0] < m_params.tolerance)
+                if (l2_norm(lambda_np1 - lambda_n) < m_params.tolerance)
                 // if (xt::norm_linf(dG)[0] < m_params.tolerance || xt::norm_linf(lambda_np1)[0] < m_params.tolerance)
                 {
                     std::swap(lambda_n, lambda_np1);
@@ -87,13 +103,26 @@ namespace scopi
 
                 std::swap(lambda_n, lambda_np1);
             }
-            PLOG_INFO << fmt::format("pgd converged in {} iterations.", ite) << std::endl;
+            m_iterations = ite;
+            PLOG_DEBUG << fmt::format("pgd converged in {} iterations.", ite) << std::endl;
             return lambda_n;
         }
 
+        /**
+         * @brief Number of iterations of the last solve.
+         */
+        std::size_t iterations() const
+        {
+            return m_iterations;
+        }
+
       private:
 
         params_t m_params;
+        std::size_t m_iterations = 0;
+        xt::xtensor<double, 1> m_lambda0;
+        xt::xtensor<double, 1> m_lambda_n;
+        xt::xtensor<double, 1> m_lambda_np1;
     };
 
     struct apgd_params
@@ -139,18 +168,40 @@ namespace scopi
         }
 
         template <class Problem, class Contacts, class Particles>
-        auto operator()(const minimization_problem<Problem, Contacts, Particles>& min_p)
+        const xt::xtensor<double, 1>& operator()(const minimization_problem<Problem, Contacts, Particles>& min_p)
+        {
+            m_lambda0.resize({min_p.size()});
+            m_lambda0.fill(0.);
+            return (*this)(min_p, m_lambda0);
+        }
+
+        /**
+         * @brief Solve the problem starting from \c lambda0 (warm start).
+         *
+         * The iterates are members, reused by the next calls: the solution is valid until the next call.
+         */
+        template <class Problem, class Contacts, class Particles>
+        const xt::xtensor<double, 1>& operator()(const minimization_problem<Problem, Contacts, Particles>& min_p,
+                                                 const xt::xtensor<double, 1>& lambda0)
         {
             std::size_t ite = 0;
 
-            xt::xtensor<double, 1> lambda_n   = xt::zeros<double>({min_p.size()});
-            xt::xtensor<double, 1> lambda_np1 = xt::zeros<double>({min_p.size()});
+            auto& lambda_n   = m_lambda_n;
+            auto& lambda_np1 = m_lambda_np1;
+            lambda_n         = lambda0;
+            lambda_np1       = lambda0;
 
-            xt::xtensor<double, 1> theta_n   = xt::ones<double>({min_p.size()});
-            xt::xtensor<double, 1> theta_np1 = xt::ones<double>({min_p.size()});
+            auto& theta_n   = m_theta_n;
+            auto& theta_np1 = m_theta_np1;
+            theta_n.resize({min_p.size()});
+            theta_n.fill(1.);
+            theta_np1.resize({min_p.size()});
+            theta_np1.fill(1.);
 
-            xt::xtensor<double, 1> y_n   = xt::zeros<double>({min_p.size()});
-            xt::xtensor<double, 1> y_np1 = xt::zeros<double>({min_p.size()});
+            auto& y_n   = m_y_n;
+            auto& y_np1 = m_y_np1;
+            y_n         = lambda0;
+            y_np1       = lambda0;
 
             double alpha  = m_params.alpha;
             double lipsch = 1. / alpha; // used only if dynamic_descent = true
@@ -159,14 +210,14 @@ namespace scopi
             {
                 ++ite;
 
-                xt::xtensor<double, 1> dG = min_p.gradient(y_n);
-                xt::noalias(lambda_np1)   = y_n - alpha * dG;
+                const auto& dG          = min_p.gradient(y_n);
+                xt::noalias(lambda_np1) = y_n - alpha * dG;
                 min_p.projection(lambda_np1);
 
                 if (m_params.dynamic_descent)
                 {
-                    while (min_p(lambda_np1) >= min_p(y_n) + xt::linalg::dot(dG, lambda_np1 - y_n)[0]
-                                                    + 0.5 * lipsch * std::pow(xt::norm_l2(lambda_np1 - y_n)[0], 2))
+                    while (min_p(lambda_np1) >= min_p(y_n) + dot_product(dG, lambda_np1 - y_n)
+                                                    + 0.5 * lipsch * std::pow(l2_norm(lambda_np1 - y_n), 2))
                     {
                         lipsch *= 2;
                         alpha                   = 1. / lipsch;
@@ -180,7 +231,7 @@ namespace scopi
                 // PLOG_INFO << fmt::format("dG: {}", xt::norm_linf(dG)) << std::endl;
                 // PLOG_INFO << fmt::format("lambda_n: {}", xt::norm_linf(lambda_np1)) << std::endl;
 
-                if (xt::norm_l2(lambda_np1 - lambda_n)[0] < m_params.tolerance)
+                if (l2_norm(lambda_np1 - lambda_n) < m_params.tolerance)
                 // if (xt::norm_linf(dG)[0] < m_params.tolerance || xt::norm_linf(lambda_np1)[0] < m_params.tolerance)
                 {
                     std::swap(lambda_n, lambda_np1);
@@ -193,7 +244,7 @@ namespace scopi
 
                 if (m_params.dynamic_descent)
                 {
-                    if (xt::linalg::dot(dG, lambda_np1 - lambda_n)[0] > 0)
+                    if (dot_product(dG, lambda_np1 - lambda_n) > 0)
                     {
                         y_np1 = lambda_np1;
                         theta_np1.fill(1.);
@@ -205,13 +256,30 @@ namespace scopi
                 std::swap(theta_n, theta_np1);
                 std::swap(y_n, y_np1);
             }
-            PLOG_INFO << fmt::format("apgd converged in {} iterations.", ite) << std::endl;
+            m_iterations = ite;
+            PLOG_DEBUG << fmt::format("apgd converged in {} iterations.", ite) << std::endl;
             return lambda_n;
         }
 
+        /**
+         * @brief Number of iterations of the last solve.
+         */
+        std::size_t iterations() const
+        {
+            return m_iterations;
+        }
+
       private:
 
         params_t m_params;
+        std::size_t m_iterations = 0;
+        xt::xtensor<double, 1> m_lambda0;
+        xt::xtensor<double, 1> m_lambda_n;
+        xt::xtensor<double, 1> m_lambda_np1;
+        xt::xtensor<double, 1> m_theta_n;
+        xt::xtensor<double, 1> m_theta_np1;
+        xt::xtensor<double, 1> m_y_n;
+        xt::xtensor<double, 1> m_y_np1;
     };
 
 }
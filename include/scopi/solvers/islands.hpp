@@ -0,0 +1,545 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "../container.hpp"
+#include "../contact/property.hpp"
+#include "../objects/contact_storage.hpp"
+#include "../objects/neighbor.hpp"
+
+namespace scopi
+{
+    /**
+     * @brief Disjoint-set forest with path halving and union by size.
+     */
+    class union_find
+    {
+      public:
+
+        explicit union_find(std::size_t size, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_parent(size, resource)
+            , m_size(size, 1, resource)
+        {
+            std::iota(m_parent.begin(), m_parent.end(), std::size_t(0));
+        }
+
+        std::size_t find(std::size_t i)
+        {
+            while (m_parent[i] != i)
+            {
+                m_parent[i] = m_parent[m_parent[i]];
+                i           = m_parent[i];
+            }
+            return i;
+        }
+
+        void unite(std::size_t i, std::size_t j)
+        {
+            i = find(i);
+            j = find(j);
+            if (i == j)
+            {
+                return;
+            }
+            if (m_size[i] < m_size[j])
+            {
+                std::swap(i, j);
+            }
+            m_parent[j] = i;
+            m_size[i] += m_size[j];
+        }
+
+      private:
+
+        std::pmr::vector<std::size_t> m_parent;
+        std::pmr::vector<std::size_t> m_size;
+    };
+
+    /**
+     * @brief Read-only access to a field of the container through a local numbering.
+     *
+     * Provides the same \c operator() and \c operator[] as the arrays returned by scopi_container.
+     */
+    template <class Field>
+    class indexed_field
+    {
+      public:
+
+        indexed_field(Field field, const std::pmr::vector<std::size_t>& indices)
+            : m_field(field)
+            , m_indices(indices)
+        {
+        }
+
+        decltype(auto) operator()(std::size_t i) const
+        {
+            return m_field(m_indices[i]);
+        }
+
+        decltype(auto) operator[](std::size_t i) const
+        {
+            return m_field(m_indices[i]);
+        }
+
+      private:
+
+        Field m_field;
+        const std::pmr::vector<std::size_t>& m_indices;
+    };
+
+    template <class Field>
+    auto make_indexed_field(Field field, const std::pmr::vector<std::size_t>& indices)
+    {
+        return indexed_field<Field>(field, indices);
+    }
+
+    /**
+     * @brief Subset of the particles of a container involved in one island.
+     *
+     * The particles are renumbered from 0: the inactive particles (obstacles) touched by the island come first,
+     * then its active particles. This is the interface used by AMatrix, ATMatrix and the minimization problem.
+     */
+    template <std::size_t Dim>
+    class island_particles
+    {
+      public:
+
+        static constexpr std::size_t dim = Dim;
+
+        island_particles(const scopi_container<dim>& particles, const std::pmr::vector<std::size_t>& bodies, std::size_t nb_inactive)
+            : m_particles(particles)
+            , m_bodies(bodies)
+            , m_nb_inactive(nb_inactive)
+        {
+        }
+
+        std::size_t size() const
+        {
+            return m_bodies.size();
+        }
+
+        std::size_t nb_active() const
+        {
+            return m_bodies.size() - m_nb_inactive;
+        }
+
+        std::size_t nb_inactive() const
+        {
+            return m_nb_inactive;
+        }
+
+        auto pos() const
+        {
+            return make_indexed_field(m_particles.pos(), m_bodies);
+        }
+
+        auto q() const
+        {
+            return make_indexed_field(m_particles.q(), m_bodies);
+        }
+
+        auto m() const
+        {
+            return make_indexed_field(m_particles.m(), m_bodies);
+        }
+
+        auto j() const
+        {
+            return make_indexed_field(m_particles.j(), m_bodies);
+        }
+
+        auto v() const
+        {
+            return make_indexed_field(m_particles.v(), m_bodies);
+        }
+
+        auto omega() const
+        {
+            return make_indexed_field(m_particles.omega(), m_bodies);
+        }
+
+      private:
+
+        const scopi_container<dim>& m_particles;
+        const std::pmr::vector<std::size_t>& m_bodies;
+        std::size_t m_nb_inactive;
+    };
+
+    /**
+     * @brief Contacts of an island, read in the global array of contacts.
+     *
+     * The fields of the contacts are not copied: each contact points to its neighbor in the global array, which must
+     * not change while the island is solved. Only the indices of the particles, local to the island, are stored, and
+     * the \c sij for the problems solved by fixed point iterations, which are updated by the island.
+     *
+     * The fields are read through the functions contact_i, contact_nij, ... as for an array of neighbors.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam problem_t Problem to be solved.
+     */
+    template <std::size_t dim, class problem_t_>
+    class island_contacts
+    {
+      public:
+
+        using problem_t     = problem_t_;
+        using neighbor_type = neighbor<dim, problem_t>;
+        using index_type    = std::uint32_t;
+        using property_type = contact_property<problem_t>;
+
+        static constexpr bool has_sij = is_fixed_point_problem_v<problem_t>;
+
+        explicit island_contacts(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : m_contacts(resource)
+            , m_i(resource)
+            , m_j(resource)
+            , m_sij(resource)
+        {
+        }
+
+        std::size_t size() const
+        {
+            return m_contacts.size();
+        }
+
+        bool empty() const
+        {
+            return m_contacts.empty();
+        }
+
+        void reserve(std::size_t size)
+        {
+            m_contacts.reserve(size);
+            m_i.reserve(size);
+            m_j.reserve(size);
+            if constexpr (has_sij)
+            {
+                m_sij.reserve(size);
+            }
+        }
+
+        /**
+         * @brief Append a contact.
+         *
+         * @param c [in] Contact of the global array.
+         * @param i [in] Index of the particle \c i in the island.
+         * @param j [in] Index of the particle \c j in the island.
+         */
+        void push_back(const neighbor_type& c, std::size_t i, std::size_t j)
+        {
+            assert(i <= std::numeric_limits<index_type>::max() && j <= std::numeric_limits<index_type>::max());
+            m_contacts.push_back(&c);
+            m_i.push_back(static_cast<index_type>(i));
+            m_j.push_back(static_cast<index_type>(j));
+            if constexpr (has_sij)
+            {
+                m_sij.push_back(c.sij);
+            }
+        }
+
+        /**
+         * @brief Contact \c k in the global array, with the global indices of the particles.
+         */
+        const neighbor_type& global(std::size_t k) const
+        {
+            return *m_contacts[k];
+        }
+
+        std::size_t i(std::size_t k) const
+        {
+            return m_i[k];
+        }
+
+        std::size_t j(std::size_t k) const
+        {
+            return m_j[k];
+        }
+
+        double sij(std::size_t k) const
+        {
+            if constexpr (has_sij)
+            {
+                return m_sij[k];
+            }
+            else
+            {
+                return 0.;
+            }
+        }
+
+        void set_sij(std::size_t k, double value)
+        {
+            static_assert(has_sij, "the problem does not use sij");
+            m_sij[k] = value;
+        }
+
+        const property_type& property(std::size_t k) const
+        {
+            return m_contacts[k]->property;
+        }
+
+      private:
+
+        std::pmr::vector<const neighbor_type*> m_contacts;
+        std::pmr::vector<index_type> m_i;
+        std::pmr::vector<index_type> m_j;
+        /// Only used if has_sij.
+        std::pmr::vector<double> m_sij;
+    };
+
+    /**
+     * @brief Fields of the contact \c k of an island (see contact_storage.hpp for the other containers).
+     */
+    template <std::size_t dim, class problem_t>
+    std::size_t contact_i(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.i(k);
+    }
+
+    template <std::size_t dim, class problem_t>
+    std::size_t contact_j(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.j(k);
+    }
+
+    template <std::size_t dim, class problem_t>
+    double contact_dij(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.global(k).dij;
+    }
+
+    template <std::size_t dim, class problem_t>
+    double contact_sij(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.sij(k);
+    }
+
+    template <std::size_t dim, class problem_t>
+    const contact_property<problem_t>& property_of(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.property(k);
+    }
+
+    template <std::size_t dim, class problem_t>
+    const xt::xtensor_fixed<double, xt::xshape<dim>>& contact_nij(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.global(k).nij;
+    }
+
+    template <std::size_t dim, class problem_t>
+    const xt::xtensor_fixed<double, xt::xshape<dim>>& contact_pi(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.global(k).pi;
+    }
+
+    template <std::size_t dim, class problem_t>
+    const xt::xtensor_fixed<double, xt::xshape<dim>>& contact_pj(const island_contacts<dim, problem_t>& contacts, std::size_t k)
+    {
+        return contacts.global(k).pj;
+    }
+
+    /**
+     * @brief Connected component of the contact graph.
+     *
+     * @tparam dim Dimension (2 or 3).
+     * @tparam problem_t Problem to be solved.
+     */
+    template <std::size_t dim, class problem_t>
+    struct contact_island
+    {
+        explicit contact_island(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+            : contact_indices(resource)
+            , bodies(resource)
+            , contacts(resource)
+        {
+        }
+
+        /// Indices of the island's contacts in the global list of contacts.
+        std::pmr::vector<std::size_t> contact_indices;
+        /// Indices in the container of the island's particles, inactive and sleeping particles first.
+        std::pmr::vector<std::size_t> bodies;
+        /// Number of inactive and sleeping particles in \c bodies.
+        std::size_t nb_inactive = 0;
+        /// Island's contacts, with particle indices local to \c bodies.
+        island_contacts<dim, problem_t> contacts;
+    };
+
+    namespace detail
+    {
+        /**
+         * @brief Fill the particles and the local contacts of an island from its list of contacts.
+         *
+         * @param island [in,out] Island whose \c contact_indices is set.
+         * @param contacts [in] Global array of contacts.
+         * @param is_static [in] Whether a particle of the container is an obstacle for the island.
+         * @param local_index [in,out] Work array of the size of the container, filled with \c none on entry and on exit.
+         */
+        template <std::size_t dim, class problem_t, class IsStatic>
+        void fill_island(contact_island<dim, problem_t>& island,
+                         const std::vector<neighbor<dim, problem_t>>& contacts,
+                         const IsStatic& is_static,
+                         std::pmr::vector<std::size_t>& local_index)
+        {
+            constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+
+            for (auto ic : island.contact_indices)
+            {
+                for (auto b : {contacts[ic].i, contacts[ic].j})
+                {
+                    if (local_index[b] == none)
+                    {
+                        local_index[b] = 0;
+                        island.bodies.push_back(b);
+                    }
+                }
+            }
+            // static particles first
+            std::sort(island.bodies.begin(),
+                      island.bodies.end(),
+                      [&](std::size_t a, std::size_t b)
+                      {
+                          return std::make_pair(!is_static(a), a) < std::make_pair(!is_static(b), b);
+                      });
+            island.nb_inactive = static_cast<std::size_t>(std::count_if(island.bodies.begin(), island.bodies.end(), is_static));
+            for (std::size_t k = 0; k < island.bodies.size(); ++k)
+            {
+                local_index[island.bodies[k]] = k;
+            }
+
+            island.contacts.reserve(island.contact_indices.size());
+            for (auto ic : island.contact_indices)
+            {
+                island.contacts.push_back(contacts[ic], local_index[contacts[ic].i], local_index[contacts[ic].j]);
+            }
+
+            // obstacles can be shared with the next islands
+            for (auto b : island.bodies)
+            {
+                local_index[b] = none;
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Split the contact graph into connected components.
+     *
+     * Two active particles are in the same island if there is a path of contacts between them.
+     * Inactive particles (obstacles) and sleeping particles do not propagate the connectivity: they can be shared
+     * by several islands, where they are seen as obstacles.
+     * Contacts between two such particles do not involve any unknown and are discarded.
+     * Active particles without contact belong to no island.
+     *
+     * @param particles [in] Container.
+     * @param contacts [in] Array of contacts.
+     * @param sleeping [in] For each particle of the container, whether it is sleeping (may be empty).
+     * @param resource [in] Memory resource of the islands and of the work arrays (e.g. a step_arena).
+     *
+     * @return Array of islands, in the order of their first contact.
+     */
+    template <std::size_t dim, class problem_t>
+    auto compute_islands(const scopi_container<dim>& particles,
+                         const std::vector<neighbor<dim, problem_t>>& contacts,
+                         const std::vector<bool>& sleeping = {},
+                         std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        std::size_t active_offset = particles.nb_inactive();
+        std::size_t nb_active     = particles.nb_active();
+
+        auto is_static = [&](std::size_t i)
+        {
+            return i < active_offset || (!sleeping.empty() && sleeping[i]);
+        };
+
+        union_find uf(nb_active, resource);
+        for (auto& c : contacts)
+        {
+            if (!is_static(c.i) && !is_static(c.j))
+            {
+                uf.unite(c.i - active_offset, c.j - active_offset);
+            }
+        }
+
+        constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        std::pmr::vector<std::size_t> island_of_root(nb_active, none, resource);
+        std::vector<contact_island<dim, problem_t>> islands;
+
+        // contacts are sorted by (i, j), so the islands are created in a deterministic order
+        for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+        {
+            auto& c = contacts[ic];
+            if (is_static(c.i) && is_static(c.j))
+            {
+                continue;
+            }
+            std::size_t root = uf.find((is_static(c.i) ? c.j : c.i) - active_offset);
+            if (island_of_root[root] == none)
+            {
+                island_of_root[root] = islands.size();
+                islands.emplace_back(resource);
+            }
+            islands[island_of_root[root]].contact_indices.push_back(ic);
+        }
+
+        std::pmr::vector<std::size_t> local_index(active_offset + nb_active, none, resource);
+        for (auto& island : islands)
+        {
+            detail::fill_island(island, contacts, is_static, local_index);
+        }
+        return islands;
+    }
+
+    /**
+     * @brief Gather all the contacts into a single island restricted to the particles they involve.
+     *
+     * The unknowns of the resulting problem are the velocities of the active particles touched by a contact,
+     * instead of all the active particles of the container.
+     * As for compute_islands, contacts between two inactive or sleeping particles are discarded.
+     *
+     * @param particles [in] Container.
+     * @param contacts [in] Array of contacts.
+     * @param sleeping [in] For each particle of the container, whether it is sleeping (may be empty).
+     * @param resource [in] Memory resource of the island and of the work arrays (e.g. a step_arena).
+     *
+     * @return Array with at most one island.
+     */
+    template <std::size_t dim, class problem_t>
+    auto compact_contacts(const scopi_container<dim>& particles,
+                          const std::vector<neighbor<dim, problem_t>>& contacts,
+                          const std::vector<bool>& sleeping = {},
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    {
+        std::size_t active_offset = particles.nb_inactive();
+
+        auto is_static = [&](std::size_t i)
+        {
+            return i < active_offset || (!sleeping.empty() && sleeping[i]);
+        };
+
+        std::vector<contact_island<dim, problem_t>> islands;
+        islands.emplace_back(resource);
+        for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+        {
+            if (!is_static(contacts[ic].i) || !is_static(contacts[ic].j))
+            {
+                islands[0].contact_indices.push_back(ic);
+            }
+        }
+        if (islands[0].contact_indices.empty())
+        {
+            islands.clear();
+            return islands;
+        }
+
+        std::pmr::vector<std::size_t> local_index(active_offset + particles.nb_active(), std::numeric_limits<std::size_t>::max(), resource);
+        detail::fill_island(islands[0], contacts, is_static, local_index);
+        return islands;
+    }
+}
@@ -1,10 +1,14 @@
 #pragma once
 
-#include <xtensor/xnorm.hpp>
+#include <cmath>
+
+#include <xtensor/xfixed.hpp>
 #include <xtensor/xtensor.hpp>
 
 #include "../contact/property.hpp"
 #include "../crtp.hpp"
+#include "../objects/contact_storage.hpp"
+#include "problem_workspace.hpp"
 
 namespace scopi
 {
@@ -30,14 +34,95 @@ namespace scopi
 
       protected:
 
-        explicit LagrangeMultiplierBase(const Contacts& contacts)
+        LagrangeMultiplierBase(const Contacts& contacts, problem_workspace& workspace)
             : m_contacts(contacts)
+            , m_workspace(workspace)
         {
         }
 
         const Contacts& m_contacts;
+        /// Buffers of the linear term and of the vectors returned by global2local and local2global.
+        problem_workspace& m_workspace;
     };
 
+    namespace detail
+    {
+        template <class Blocks, class Normal>
+        inline double normal_block_product(const Blocks& blocks, std::size_t i, const Normal& n)
+        {
+            double out = 0.;
+            for (std::size_t d1 = 0; d1 < n.size(); ++d1)
+            {
+                for (std::size_t d2 = 0; d2 < n.size(); ++d2)
+                {
+                    out += n(d1) * blocks(i, d1, d2) * n(d2);
+                }
+            }
+            return out;
+        }
+
+        /**
+         * @brief Normal component of the block \c x(row:row+dim) of a vector of the global space.
+         */
+        template <class X, class Normal>
+        inline double normal_component(const X& x, std::size_t row, const Normal& n)
+        {
+            double out = 0.;
+            for (std::size_t d = 0; d < n.size(); ++d)
+            {
+                out += x[row + d] * n(d);
+            }
+            return out;
+        }
+
+        /**
+         * @brief Projection of the force \c f of a contact on the friction cone of axis \c n and coefficient \c mu.
+         */
+        template <std::size_t dim, class Force, class Normal>
+        inline xt::xtensor_fixed<double, xt::xshape<dim>> cone_projection(const Force& f, const Normal& n, double mu)
+        {
+            double f_n = 0.;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                f_n += f(d) * n(d);
+            }
+            xt::xtensor_fixed<double, xt::xshape<dim>> f_t;
+            double norm = 0.;
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                f_t(d) = f(d) - f_n * n(d);
+                norm += f_t(d) * f_t(d);
+            }
+            norm = std::sqrt(norm);
+
+            xt::xtensor_fixed<double, xt::xshape<dim>> out;
+            if (norm > mu * f_n)
+            {
+                if (f_n <= -mu * norm)
+                {
+                    out.fill(0.);
+                }
+                else
+                {
+                    auto new_norm = (mu * mu) * (norm + f_n / mu) / (mu * mu + 1);
+                    auto new_f_n  = new_norm / mu;
+                    for (std::size_t d = 0; d < dim; ++d)
+                    {
+                        out(d) = new_norm * (f_t(d) / norm) + new_f_n * n(d);
+                    }
+                }
+            }
+            else
+            {
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    out(d) = f(d);
+                }
+            }
+            return out;
+        }
+    } // namespace detail
+
     template <std::size_t dim, class Type, class Contacts>
     class LagrangeMultiplier;
 
@@ -51,42 +136,45 @@ namespace scopi
 
         using base = LagrangeMultiplierBase<Contacts, LagrangeMultiplier<dim_, NoFriction, Contacts>>;
 
-        LagrangeMultiplier(const Contacts& contacts, double)
-            : base(contacts)
+        LagrangeMultiplier(const Contacts& contacts, double, problem_workspace& workspace)
+            : base(contacts, workspace)
         {
-            m_S_Vector    = xt::zeros<double>({size()});
-            m_local_work  = xt::zeros<double>({size()});
-            m_global_work = xt::zeros<double>({3 * contacts.size()});
+            this->m_workspace.S_Vector.resize({size()});
+            this->m_workspace.S_Vector.fill(0.);
         }
 
-        const auto& global2local(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& global2local(const xt::xtensor<double, 1>& x) const
         {
-            assert(x.size() == 3 * this->m_contacts.size());
-            // xt::xtensor<double, 1> out = xt::empty<double>({this->m_contacts.size()});
+            assert(x.size() == dim * this->m_contacts.size());
+            auto& out = this->m_workspace.local;
+            out.resize({size()});
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                // m_local_work[i] = xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
+                const auto& nij = contact_nij(this->m_contacts, i);
 
-                m_local_work[i] = 0;
+                out[i] = 0;
                 for (std::size_t d = 0; d < dim; ++d)
                 {
-                    m_local_work[i] += x[3 * i + d] * this->m_contacts[i].nij[d];
+                    out[i] += x[dim * i + d] * nij[d];
                 }
             }
-            return m_local_work;
+            return out;
         }
 
-        auto local2global(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& local2global(const xt::xtensor<double, 1>& x) const
         {
             assert(x.size() == this->m_contacts.size());
-            xt::xtensor<double, 1> out = xt::empty<double>({3 * this->m_contacts.size()});
+            auto& out = this->m_workspace.global;
+            out.resize({dim * this->m_contacts.size()});
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
+                const auto& nij = contact_nij(this->m_contacts, i);
+
                 for (std::size_t d = 0; d < dim; ++d)
                 {
-                    out(3 * i + d) = x[i] * this->m_contacts[i].nij(d);
+                    out(dim * i + d) = x[i] * nij(d);
                 }
-                // xt::view(out, xt::range(3 * i, 3 * i + dim)) = x[i] * this->m_contacts[i].nij;
+                // xt::view(out, xt::range(dim * i, dim * i + dim)) = x[i] * nij;
             }
             return out;
         }
@@ -98,19 +186,23 @@ namespace scopi
 
         const auto& S_Vector() const
         {
-            return m_S_Vector;
+            return this->m_workspace.S_Vector;
+        }
+
+        xt::xtensor<double, 1> diagonal(const xt::xtensor<double, 3>& blocks) const
+        {
+            xt::xtensor<double, 1> out = xt::empty<double>({size()});
+            for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
+            {
+                out[i] = detail::normal_block_product(blocks, i, contact_nij(this->m_contacts, i));
+            }
+            return out;
         }
 
         void projection(xt::xtensor<double, 1>& lambda) const
         {
             lambda = xt::maximum(lambda, 0.);
         }
-
-      private:
-
-        mutable xt::xtensor<double, 1> m_local_work;
-        mutable xt::xtensor<double, 1> m_global_work;
-        xt::xtensor<double, 1> m_S_Vector;
     };
 
     template <std::size_t dim_, class Contacts>
@@ -122,13 +214,15 @@ namespace scopi
 
         using base = LagrangeMultiplierBase<Contacts, LagrangeMultiplier<dim_, Viscous, Contacts>>;
 
-        LagrangeMultiplier(const Contacts& contacts, double)
-            : base(contacts)
+        LagrangeMultiplier(const Contacts& contacts, double, problem_workspace& workspace)
+            : base(contacts, workspace)
         {
             m_size = 0;
             for (std::size_t i = 0; i < contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
                     m_size += 2;
                 }
@@ -137,47 +231,49 @@ namespace scopi
                     ++m_size;
                 }
             }
-            m_S_Vector = xt::zeros<double>({m_size});
+            this->m_workspace.S_Vector.resize({m_size});
+            this->m_workspace.S_Vector.fill(0.);
         }
 
-        auto global2local(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& global2local(const xt::xtensor<double, 1>& x) const
         {
-            // std::cout << "in global2local " << m_gamma << std::endl;
-            assert(x.size() == 3 * this->m_contacts.size());
-            xt::xtensor<double, 1> out = xt::empty<double>({size()});
+            assert(x.size() == dim * this->m_contacts.size());
+            auto& out = this->m_workspace.local;
+            out.resize({size()});
             std::size_t next_gamma_neg = this->m_contacts.size();
 
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
-                {
-                    out[i]                = xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
-                    out[next_gamma_neg++] = -xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
-                }
-                else
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                out[i] = detail::normal_component(x, dim * i, nij);
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    out[i] = xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
+                    out[next_gamma_neg++] = -out[i];
                 }
             }
             return out;
         }
 
-        auto local2global(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& local2global(const xt::xtensor<double, 1>& x) const
         {
-            // std::cout << "in local2global " << m_gamma << std::endl;
-
             assert(x.size() == size());
-            xt::xtensor<double, 1> out = xt::empty<double>({3 * this->m_contacts.size()});
+            auto& out = this->m_workspace.global;
+            out.resize({dim * this->m_contacts.size()});
             std::size_t next_gamma_neg = this->m_contacts.size();
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    xt::view(out, xt::range(3 * i, 3 * i + dim)) = (x[i] - x[next_gamma_neg++]) * this->m_contacts[i].nij;
+                    xt::view(out, xt::range(dim * i, dim * i + dim)) = (x[i] - x[next_gamma_neg++]) * nij;
                 }
                 else
                 {
-                    xt::view(out, xt::range(3 * i, 3 * i + dim)) = x[i] * this->m_contacts[i].nij;
+                    xt::view(out, xt::range(dim * i, dim * i + dim)) = x[i] * nij;
                 }
             }
             return out;
@@ -190,7 +286,25 @@ namespace scopi
 
         const auto& S_Vector() const
         {
-            return m_S_Vector;
+            return this->m_workspace.S_Vector;
+        }
+
+        xt::xtensor<double, 1> diagonal(const xt::xtensor<double, 3>& blocks) const
+        {
+            xt::xtensor<double, 1> out = xt::empty<double>({size()});
+            std::size_t next_gamma_neg = this->m_contacts.size();
+            for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
+            {
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                out[i] = detail::normal_block_product(blocks, i, nij);
+                if (prop.gamma < -prop.gamma_tol)
+                {
+                    out[next_gamma_neg++] = out[i];
+                }
+            }
+            return out;
         }
 
         void projection(xt::xtensor<double, 1>& lambda) const
@@ -202,7 +316,6 @@ namespace scopi
       private:
 
         std::size_t m_size;
-        xt::xtensor<double, 1> m_S_Vector;
     };
 
     template <std::size_t dim_, class Contacts>
@@ -214,62 +327,60 @@ namespace scopi
 
         using base = LagrangeMultiplierBase<Contacts, LagrangeMultiplier<dim_, Friction, Contacts>>;
 
-        LagrangeMultiplier(const Contacts& contacts, double)
-            : base(contacts)
+        LagrangeMultiplier(const Contacts& contacts, double, problem_workspace& workspace)
+            : base(contacts, workspace)
         {
-            m_S_Vector = xt::zeros<double>({size()});
+            this->m_workspace.S_Vector.resize({size()});
+            this->m_workspace.S_Vector.fill(0.);
         }
 
-        auto global2local(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& global2local(const xt::xtensor<double, 1>& x) const
         {
             return x;
         }
 
-        auto local2global(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& local2global(const xt::xtensor<double, 1>& x) const
         {
             return x;
         }
 
         std::size_t size() const
         {
-            return 3 * this->m_contacts.size();
+            return dim * this->m_contacts.size();
         }
 
         const auto& S_Vector() const
         {
-            return m_S_Vector;
+            return this->m_workspace.S_Vector;
+        }
+
+        xt::xtensor<double, 1> diagonal(const xt::xtensor<double, 3>& blocks) const
+        {
+            xt::xtensor<double, 1> out = xt::empty<double>({size()});
+            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += dim)
+            {
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    out[row + d] = blocks(i, d, d);
+                }
+            }
+            return out;
         }
 
         void projection(xt::xtensor<double, 1>& lambda) const
         {
             assert(lambda.size() == size());
-            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += 3)
+            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += dim)
             {
                 auto lambda_i = xt::view(lambda, xt::range(row, row + dim));
-                auto lambda_n = xt::linalg::dot(lambda_i, this->m_contacts[i].nij)[0];
-                auto lambda_t = xt::eval(lambda_i - lambda_n * this->m_contacts[i].nij);
-                auto norm     = xt::norm_l2(lambda_t)[0];
-                double mu     = this->m_contacts[i].property.mu;
-                if (norm > mu * lambda_n)
+                double mu     = property_of(this->m_contacts, i).mu;
+                auto proj     = detail::cone_projection<dim>(lambda_i, contact_nij(this->m_contacts, i), mu);
+                for (std::size_t d = 0; d < dim; ++d)
                 {
-                    if (lambda_n <= -mu * norm)
-                    {
-                        lambda_i = 0;
-                    }
-                    else
-                    {
-                        auto new_norm     = (mu * mu) * (norm + lambda_n / mu) / (mu * mu + 1);
-                        auto new_lambda_n = new_norm / mu;
-                        lambda_t /= norm;
-                        lambda_i = new_norm * lambda_t + new_lambda_n * this->m_contacts[i].nij;
-                    }
+                    lambda[row + d] = proj(d);
                 }
             }
         }
-
-      private:
-
-        xt::xtensor<double, 1> m_S_Vector;
     };
 
     template <std::size_t dim_, class Contacts>
@@ -282,66 +393,69 @@ namespace scopi
 
         using base = LagrangeMultiplierBase<Contacts, LagrangeMultiplier<dim_, FrictionFixedPoint, Contacts>>;
 
-        LagrangeMultiplier(const Contacts& contacts, [[maybe_unused]] double dt)
-            : base(contacts)
+        LagrangeMultiplier(const Contacts& contacts, double dt, problem_workspace& workspace)
+            : base(contacts, workspace)
         {
-            m_S_Vector = xt::zeros<double>({size()});
-            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += 3)
+            update_S_Vector(dt);
+        }
+
+        void update_S_Vector(double)
+        {
+            auto& S_Vector = this->m_workspace.S_Vector;
+            S_Vector.resize({size()});
+            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += dim)
             {
-                xt::view(m_S_Vector, xt::range(row, row + dim)) = this->m_contacts[i].sij * this->m_contacts[i].nij;
+                xt::view(S_Vector, xt::range(row, row + dim)) = contact_sij(this->m_contacts, i) * contact_nij(this->m_contacts, i);
             }
         }
 
-        auto global2local(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& global2local(const xt::xtensor<double, 1>& x) const
         {
             return x;
         }
 
-        auto local2global(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& local2global(const xt::xtensor<double, 1>& x) const
         {
             return x;
         }
 
         std::size_t size() const
         {
-            return 3 * this->m_contacts.size();
+            return dim * this->m_contacts.size();
         }
 
         const auto& S_Vector() const
         {
-            return m_S_Vector;
+            return this->m_workspace.S_Vector;
+        }
+
+        xt::xtensor<double, 1> diagonal(const xt::xtensor<double, 3>& blocks) const
+        {
+            xt::xtensor<double, 1> out = xt::empty<double>({size()});
+            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += dim)
+            {
+                for (std::size_t d = 0; d < dim; ++d)
+                {
+                    out[row + d] = blocks(i, d, d);
+                }
+            }
+            return out;
         }
 
         void projection(xt::xtensor<double, 1>& lambda) const
         {
             assert(lambda.size() == size());
-            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += 3)
+            for (std::size_t i = 0, row = 0; i < this->m_contacts.size(); ++i, row += dim)
             {
                 auto lambda_i = xt::view(lambda, xt::range(row, row + dim));
-                auto lambda_n = xt::linalg::dot(lambda_i, this->m_contacts[i].nij)[0];
-                auto lambda_t = xt::eval(lambda_i - lambda_n * this->m_contacts[i].nij);
-                auto norm     = xt::norm_l2(lambda_t)[0];
-                double mu     = this->m_contacts[i].property.mu;
-                if (norm > mu * lambda_n)
+                double mu     = property_of(this->m_contacts, i).mu;
+                auto proj     = detail::cone_projection<dim>(lambda_i, contact_nij(this->m_contacts, i), mu);
+                for (std::size_t d = 0; d < dim; ++d)
                 {
-                    if (lambda_n <= -mu * norm)
-                    {
-                        lambda_i = 0;
-                    }
-                    else
-                    {
-                        auto new_norm     = (mu * mu) * (norm + lambda_n / mu) / (mu * mu + 1);
-                        auto new_lambda_n = new_norm / mu;
-                        lambda_t /= norm;
-                        lambda_i = new_norm * lambda_t + new_lambda_n * this->m_contacts[i].nij;
-                    }
+                    lambda[row + d] = proj(d);
                 }
             }
         }
-
-      private:
-
-        xt::xtensor<double, 1> m_S_Vector;
     };
 
     template <std::size_t dim_, class Contacts>
@@ -354,21 +468,23 @@ namespace scopi
 
         using base = LagrangeMultiplierBase<Contacts, LagrangeMultiplier<dim_, ViscousFriction, Contacts>>;
 
-        LagrangeMultiplier(const Contacts& contacts, double dt) // cppcheck-suppress uninitMemberVar
-            : base(contacts)
+        LagrangeMultiplier(const Contacts& contacts, double dt, problem_workspace& workspace) // cppcheck-suppress uninitMemberVar
+            : base(contacts, workspace)
         {
             m_size = 0;
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    if (this->m_contacts[i].property.gamma != this->m_contacts[i].property.gamma_min)
+                    if (prop.gamma != prop.gamma_min)
                     {
                         m_size += 2;
                     }
                     else
                     {
-                        m_size += 4;
+                        m_size += 1 + dim;
                     }
                 }
                 else
@@ -376,21 +492,30 @@ namespace scopi
                     ++m_size;
                 }
             }
-            m_S_Vector      = xt::zeros<double>({size()});
+            update_S_Vector(dt);
+        }
+
+        void update_S_Vector(double dt)
+        {
+            auto& S_Vector = this->m_workspace.S_Vector;
+            S_Vector.resize({size()});
+            S_Vector.fill(0.);
             std::size_t row = 0;
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    if (this->m_contacts[i].property.gamma != this->m_contacts[i].property.gamma_min)
+                    if (prop.gamma != prop.gamma_min)
                     {
                         row += 2;
                     }
                     else
                     {
-                        xt::view(m_S_Vector, xt::range(row + 1, row + 1 + dim)) = dt * this->m_contacts[i].property.mu
-                                                                                * this->m_contacts[i].sij * this->m_contacts[i].nij;
-                        row += 4;
+                        xt::view(S_Vector, xt::range(row + 1, row + 1 + dim)) = dt * prop.mu * contact_sij(this->m_contacts, i) * nij;
+                        row += 1 + dim;
                     }
                 }
                 else
@@ -400,61 +525,72 @@ namespace scopi
             }
         }
 
-        auto global2local(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& global2local(const xt::xtensor<double, 1>& x) const
         {
-            assert(x.size() == 3 * this->m_contacts.size());
-            xt::xtensor<double, 1> out = xt::zeros<double>({size()});
-            std::size_t row            = 0;
+            assert(x.size() == dim * this->m_contacts.size());
+            auto& out = this->m_workspace.local;
+            out.resize({size()});
+            out.fill(0.);
+            std::size_t row = 0;
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    if (this->m_contacts[i].property.gamma != this->m_contacts[i].property.gamma_min)
+                    if (prop.gamma != prop.gamma_min)
                     {
-                        out[row]     = xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
-                        out[row + 1] = -xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
+                        out[row]     = detail::normal_component(x, dim * i, nij);
+                        out[row + 1] = -out[row];
                         row += 2;
                     }
                     else
                     {
-                        out[row] = -xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
-                        xt::view(out, xt::range(row + 1, row + 1 + dim)) = xt::view(x, xt::range(3 * i, 3 * i + dim));
-                        row += 4;
+                        out[row] = -detail::normal_component(x, dim * i, nij);
+                        for (std::size_t d = 0; d < dim; ++d)
+                        {
+                            out[row + 1 + d] = x[dim * i + d];
+                        }
+                        row += 1 + dim;
                     }
                 }
                 else
                 {
-                    out[row] = xt::linalg::dot(xt::view(x, xt::range(3 * i, 3 * i + dim)), this->m_contacts[i].nij)[0];
+                    out[row] = detail::normal_component(x, dim * i, nij);
                     ++row;
                 }
             }
             return out;
         }
 
-        auto local2global(const xt::xtensor<double, 1>& x) const
+        const xt::xtensor<double, 1>& local2global(const xt::xtensor<double, 1>& x) const
         {
             assert(x.size() == size());
-            xt::xtensor<double, 1> out = xt::zeros<double>({3 * this->m_contacts.size()});
-            std::size_t row            = 0;
+            auto& out = this->m_workspace.global;
+            out.resize({dim * this->m_contacts.size()});
+            std::size_t row = 0;
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    if (this->m_contacts[i].property.gamma != this->m_contacts[i].property.gamma_min)
+                    if (prop.gamma != prop.gamma_min)
                     {
-                        xt::view(out, xt::range(3 * i, 3 * i + dim)) = (x[row] - x[row + 1]) * this->m_contacts[i].nij;
+                        xt::view(out, xt::range(dim * i, dim * i + dim)) = (x[row] - x[row + 1]) * nij;
                         row += 2;
                     }
                     else
                     {
-                        xt::view(out, xt::range(3 * i, 3 * i + dim)) = (-x[row]) * this->m_contacts[i].nij
-                                                                     + xt::view(x, xt::range(row + 1, row + 1 + dim));
-                        row += 4;
+                        xt::view(out, xt::range(dim * i, dim * i + dim)) = (-x[row]) * nij + xt::view(x, xt::range(row + 1, row + 1 + dim));
+                        row += 1 + dim;
                     }
                 }
                 else
                 {
-                    xt::view(out, xt::range(3 * i, 3 * i + dim)) = x[row] * this->m_contacts[i].nij;
+                    xt::view(out, xt::range(dim * i, dim * i + dim)) = x[row] * nij;
                     row++;
                 }
             }
@@ -468,7 +604,44 @@ namespace scopi
 
         const auto& S_Vector() const
         {
-            return m_S_Vector;
+            return this->m_workspace.S_Vector;
+        }
+
+        xt::xtensor<double, 1> diagonal(const xt::xtensor<double, 3>& blocks) const
+        {
+            xt::xtensor<double, 1> out = xt::zeros<double>({size()});
+            std::size_t row            = 0;
+            for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
+            {
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                double nBn = detail::normal_block_product(blocks, i, nij);
+                if (prop.gamma < -prop.gamma_tol)
+                {
+                    if (prop.gamma != prop.gamma_min)
+                    {
+                        out[row]     = nBn;
+                        out[row + 1] = nBn;
+                        row += 2;
+                    }
+                    else
+                    {
+                        out[row] = nBn;
+                        for (std::size_t d = 0; d < dim; ++d)
+                        {
+                            out[row + 1 + d] = blocks(i, d, d);
+                        }
+                        row += 1 + dim;
+                    }
+                }
+                else
+                {
+                    out[row] = nBn;
+                    ++row;
+                }
+            }
+            return out;
         }
 
         void projection(xt::xtensor<double, 1>& lambda) const
@@ -477,9 +650,12 @@ namespace scopi
             std::size_t row = 0;
             for (std::size_t i = 0; i < this->m_contacts.size(); ++i)
             {
-                if (this->m_contacts[i].property.gamma < -this->m_contacts[i].property.gamma_tol)
+                const auto& nij  = contact_nij(this->m_contacts, i);
+                const auto& prop = property_of(this->m_contacts, i);
+
+                if (prop.gamma < -prop.gamma_tol)
                 {
-                    if (this->m_contacts[i].property.gamma != this->m_contacts[i].property.gamma_min)
+                    if (prop.gamma != prop.gamma_min)
                     {
                         auto lambda_visqu = xt::view(lambda, xt::range(row, row + 2));
                         lambda_visqu      = xt::maximum(lambda_visqu, 0.);
@@ -487,44 +663,35 @@ namespace scopi
                     }
                     else
                     {
-                        auto lambda_i                           = xt::view(lambda, xt::range(row, row + 1 + dim));
-                        auto lambda_f_i                         = xt::view(lambda, xt::range(row + 1, row + 1 + dim));
-                        auto lambda_n                           = xt::linalg::dot(lambda_f_i, this->m_contacts[i].nij)[0];
-                        auto lambda_t                           = xt::eval(lambda_f_i - lambda_n * this->m_contacts[i].nij);
-                        auto norm                               = xt::norm_l2(lambda_t)[0];
-                        double mu                               = this->m_contacts[i].property.mu;
-                        xt::xtensor<double, 1> lambda_proj_fric = xt::zeros<double>({1 + dim});
-                        auto lambda_fproj                       = xt::view(lambda_proj_fric, xt::range(1, 1 + dim));
-                        if (norm > mu * lambda_n)
-                        {
-                            if (lambda_n <= -mu * norm)
-                            {
-                                lambda_fproj = xt::zeros<double>({dim});
-                            }
-                            else
-                            {
-                                auto new_norm     = (mu * mu) * (norm + lambda_n / mu) / (mu * mu + 1);
-                                auto new_lambda_n = new_norm / mu;
-                                lambda_t /= norm;
-                                lambda_fproj = new_norm * lambda_t + new_lambda_n * this->m_contacts[i].nij;
-                            }
-                        }
-                        else
+                        // projections on the friction cone (with no normal force) and on the half line of the normal force
+                        auto lambda_f_i   = xt::view(lambda, xt::range(row + 1, row + 1 + dim));
+                        auto lambda_fproj = detail::cone_projection<dim>(lambda_f_i, nij, prop.mu);
+                        double moins_0    = std::max(lambda[row], 0.);
+
+                        double dist_fric  = lambda[row] * lambda[row];
+                        double dist_moins = (moins_0 - lambda[row]) * (moins_0 - lambda[row]);
+                        for (std::size_t d = 0; d < dim; ++d)
                         {
-                            lambda_fproj = lambda_f_i;
+                            dist_fric += (lambda_fproj(d) - lambda_f_i(d)) * (lambda_fproj(d) - lambda_f_i(d));
+                            dist_moins += lambda_f_i(d) * lambda_f_i(d);
                         }
-
-                        xt::xtensor<double, 1> lambda_proj_moins = xt::zeros<double>({1 + dim});
-                        lambda_proj_moins[0]                     = std::max(lambda[row], 0.);
-                        if (xt::norm_l2(xt::eval(lambda_proj_fric - lambda_i))[0] < xt::norm_l2(xt::eval(lambda_proj_moins - lambda_i))[0])
+                        if (dist_fric < dist_moins)
                         {
-                            lambda_i = lambda_proj_fric;
+                            lambda[row] = 0.;
+                            for (std::size_t d = 0; d < dim; ++d)
+                            {
+                                lambda[row + 1 + d] = lambda_fproj(d);
+                            }
                         }
                         else
                         {
-                            lambda_i = lambda_proj_moins;
+                            lambda[row] = moins_0;
+                            for (std::size_t d = 0; d < dim; ++d)
+                            {
+                                lambda[row + 1 + d] = 0.;
+                            }
                         }
-                        row += 4;
+                        row += 1 + dim;
                     }
                 }
                 else
@@ -538,13 +705,12 @@ namespace scopi
       private:
 
         std::size_t m_size = 0;
-        xt::xtensor<double, 1> m_S_Vector;
     };
 
     template <std::size_t dim, class Type, class Contacts>
-    auto make_lagrange_multplier(const Contacts& contacts, double dt)
+    auto make_lagrange_multplier(const Contacts& contacts, double dt, problem_workspace& workspace)
     {
-        return LagrangeMultiplier<dim, Type, Contacts>(contacts, dt);
+        return LagrangeMultiplier<dim, Type, Contacts>(contacts, dt, workspace);
     }
 
 }
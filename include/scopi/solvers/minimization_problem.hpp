@@ -4,96 +4,216 @@
 
 #include "../matrix/velocities.hpp"
 #include "lagrange_multiplier.hpp"
+#include "problem_workspace.hpp"
 
 namespace scopi
 {
+    /**
+     * @brief Diagonal of the inverse of the mass matrix of the active particles, written in \c out.
+     */
+    template <class Particles>
+    inline void M_inverse(const Particles& particles, xt::xtensor<double, 1>& out)
+    {
+        static constexpr std::size_t dim = Particles::dim;
+        static constexpr std::size_t rot = detail::rotation_dofs<dim>;
+
+        out.resize({(dim + rot) * particles.nb_active()});
+
+        std::size_t offset = dim * particles.nb_active();
+        for (std::size_t i = 0; i < particles.nb_active(); ++i)
+        {
+            xt::view(out, xt::range(dim * i, dim * i + dim))                   = 1. / particles.m()[particles.nb_inactive() + i];
+            xt::view(out, xt::range(offset + rot * i, offset + rot * i + rot)) = 1. / particles.j()[particles.nb_inactive() + i];
+        }
+    }
+
     template <class Particles>
     inline auto M_inverse(const Particles& particles)
+    {
+        xt::xtensor<double, 1> out;
+        M_inverse(particles, out);
+        return out;
+    }
+
+    /**
+     * @brief Velocities of the active particles, written in \c U.
+     */
+    template <class Particles>
+    void UVector(const Particles& particles, xt::xtensor<double, 1>& U)
     {
         static constexpr std::size_t dim = Particles::dim;
 
-        xt::xtensor<double, 1> out = xt::zeros<double>({6 * particles.nb_active()});
+        U.resize({(dim + detail::rotation_dofs<dim>) * particles.nb_active()});
 
-        std::size_t offset = 3 * particles.nb_active();
+        std::size_t offset = dim * particles.nb_active();
         for (std::size_t i = 0; i < particles.nb_active(); ++i)
         {
-            xt::view(out, xt::range(3 * i, 3 * i + dim)) = 1. / particles.m()[particles.nb_inactive() + i];
+            xt::view(U, xt::range(dim * i, dim * i + dim)) = particles.v()[particles.nb_inactive() + i];
             if constexpr (dim == 2)
             {
-                out[offset + 3 * i + 2] = 1. / particles.j()[particles.nb_inactive() + i];
+                U[offset + i] = particles.omega()[particles.nb_inactive() + i];
             }
             else if constexpr (dim == 3)
             {
-                xt::view(out, xt::range(offset + 3 * i, offset + 3 * i + dim)) = 1. / particles.j()[particles.nb_inactive() + i];
+                xt::view(U, xt::range(offset + 3 * i, offset + 3 * i + dim)) = particles.omega()[particles.nb_inactive() + i];
+            }
+        }
+    }
+
+    template <class Particles>
+    auto UVector(const Particles& particles)
+    {
+        xt::xtensor<double, 1> U;
+        UVector(particles, U);
+        return U;
+    }
+
+    /**
+     * @brief Linear term \f$ D n + \Delta t A U \f$ of the objective, written in \c out.
+     *
+     * @param dt [in] Time step.
+     * @param contacts [in] Array of contacts.
+     * @param AU [in] Product of AMatrix with the velocities of the particles (see UVector).
+     * @param out [out] Linear term, \c dim rows per contact.
+     */
+    template <class Contacts>
+    void CVector(double dt, const Contacts& contacts, const xt::xtensor<double, 1>& AU, xt::xtensor<double, 1>& out)
+    {
+        static constexpr std::size_t dim = detail::contact_dim<Contacts>;
+
+        out.resize({dim * contacts.size()});
+        for (std::size_t i = 0; i < contacts.size(); ++i)
+        {
+            const auto& nij = contact_nij(contacts, i);
+            double dij      = contact_dij(contacts, i);
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                out[dim * i + d] = dij * nij(d) + dt * AU[dim * i + d];
             }
         }
-        return out;
     }
 
     template <class Contacts, class Particles>
     auto CVector(double dt, const Contacts& contacts, const Particles& particles)
     {
-        static constexpr std::size_t dim = Particles::dim;
         AMatrix A(contacts, particles);
-        DMatrix D(contacts);
+        xt::xtensor<double, 1> U = UVector(particles);
+        xt::xtensor<double, 1> value;
+        CVector(dt, contacts, A.mat_mult(U), value);
+        return value;
+    }
 
-        xt::xtensor<double, 1> U = xt::zeros<double>({6 * particles.nb_active()});
+    template <class Contacts, class Particles>
+    auto DelassusDiagonalBlocks(double dt, const Contacts& contacts, const Particles& particles)
+    {
+        static constexpr std::size_t dim = Particles::dim;
 
-        std::size_t offset = 3 * particles.nb_active();
-        for (std::size_t i = 0; i < particles.nb_active(); ++i)
+        xt::xtensor<double, 1> invM = M_inverse(particles);
+        xt::xtensor<double, 3> out  = xt::zeros<double>({contacts.size(), dim, dim});
+
+        std::size_t active_offset = particles.nb_inactive();
+        std::size_t rot_offset    = dim * particles.nb_active();
+        auto pos                  = particles.pos();
+        auto q                    = particles.q();
+
+        // contribution of one body to the dim x dim block of the contact ic, the sign of the body in A vanishes in A M^{-1} A^T
+        auto add_body = [&](std::size_t ic, std::size_t body, const auto& point)
         {
-            xt::view(U, xt::range(3 * i, 3 * i + dim)) = particles.v()[particles.nb_inactive() + i];
+            std::size_t k                                  = body - active_offset;
+            xt::xtensor_fixed<double, xt::xshape<dim>> rij = point - pos(body);
+
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                out(ic, d, d) += invM[dim * k + d];
+            }
             if constexpr (dim == 2)
             {
-                U[offset + 3 * i + 2] = particles.omega()[particles.nb_inactive() + i];
+                double invJ = invM[rot_offset + k];
+                // lever arm of the rotation around z
+                xt::xtensor_fixed<double, xt::xshape<2>> g = {rij(1), -rij(0)};
+                for (std::size_t d1 = 0; d1 < 2; ++d1)
+                {
+                    for (std::size_t d2 = 0; d2 < 2; ++d2)
+                    {
+                        out(ic, d1, d2) += invJ * g(d1) * g(d2);
+                    }
+                }
             }
-            else if constexpr (dim == 3)
+            else
             {
-                xt::view(U, xt::range(offset + 3 * i, offset + 3 * i + dim)) = particles.omega()[particles.nb_inactive() + i];
+                auto R = rotation_matrix<3>(q(body));
+                for (std::size_t e = 0; e < 3; ++e)
+                {
+                    double invJ = invM[rot_offset + 3 * k + e];
+                    if (invJ == 0.)
+                    {
+                        continue;
+                    }
+                    xt::xtensor_fixed<double, xt::xshape<3>> Re = {R(0, e), R(1, e), R(2, e)};
+                    auto g                                      = detail::cross<dim>(rij, Re);
+                    for (std::size_t d1 = 0; d1 < 3; ++d1)
+                    {
+                        for (std::size_t d2 = 0; d2 < 3; ++d2)
+                        {
+                            out(ic, d1, d2) += invJ * g(d1) * g(d2);
+                        }
+                    }
+                }
             }
-        }
+        };
 
-        xt::xtensor<double, 1> normal = xt::zeros<double>({3 * contacts.size()});
-        for (std::size_t i = 0; i < contacts.size(); ++i)
+        for (std::size_t ic = 0; ic < contacts.size(); ++ic)
         {
-            xt::view(normal, xt::range(3 * i, 3 * i + dim)) = contacts[i].nij;
+            std::size_t i = contact_i(contacts, ic);
+            std::size_t j = contact_j(contacts, ic);
+            if (i >= active_offset)
+            {
+                add_body(ic, i, contact_pi(contacts, ic));
+            }
+            if (j >= active_offset)
+            {
+                add_body(ic, j, contact_pj(contacts, ic));
+            }
         }
-
-        // std::cout << "normal " << normal << std::endl;
-        // std::cout << "U " << U << std::endl;
-        // std::cout << "D " << D.mat_mult(normal) << std::endl;
-        // std::cout << "dt " << dt << std::endl;
-        // std::cout << "A " << dt * A.mat_mult(U) << std::endl;
-
-        xt::xtensor<double, 1> value = D.mat_mult(normal) + dt * A.mat_mult(U);
-        return value;
+        out *= dt * dt;
+        return out;
     }
 
+    /**
+     * @brief Delassus operator \f$ \Delta t^2 A M^{-1} A^T \f$, whose buffers are those of a problem_workspace.
+     */
     template <class Contacts, class Particles>
     struct QMatrix
     {
       public:
 
-        QMatrix(double dt, const Contacts& contacts, const Particles& particles)
+        QMatrix(double dt, const Contacts& contacts, const Particles& particles, problem_workspace& workspace)
             : m_dt(dt)
-            , m_A(contacts, particles)
-            , m_AT(contacts, particles)
-            , m_invM(M_inverse(particles))
+            , m_A(contacts, particles, workspace.A_work)
+            , m_AT(contacts, particles, workspace.AT_work)
+            , m_invM(workspace.invM)
+            , m_velocities(workspace.velocities)
         {
+            M_inverse(particles, m_invM);
         }
 
+        /**
+         * @brief Image of \c lambda, as an expression valid until the next product.
+         */
         inline auto operator()(const xt::xtensor<double, 1>& lambda) const
         {
-            // std::cout << std::endl << "lambda " << lambda << std::endl;
-            // std::cout << std::endl << "m_At lambda " << m_AT.mat_mult(lambda) << std::endl;
-            // std::cout << std::endl << "invM  " << m_invM << std::endl;
-            // std::cout << std::endl << "m_A  " << m_A.mat_mult(m_invM * m_AT.mat_mult(lambda)) << std::endl;
-            return m_dt * m_dt * m_A.mat_mult(m_invM * m_AT.mat_mult(lambda));
+            return m_dt * m_dt * m_A.mat_mult(velocities(lambda));
         }
 
-        inline auto velocities(const xt::xtensor<double, 1>& lambda) const
+        inline const auto& velocities(const xt::xtensor<double, 1>& lambda) const
         {
-            return xt::eval(m_invM * m_AT.mat_mult(lambda));
+            xt::noalias(m_velocities) = m_invM * m_AT.mat_mult(lambda);
+            return m_velocities;
+        }
+
+        inline const auto& relative_velocities(const xt::xtensor<double, 1>& u) const
+        {
+            return m_A.mat_mult(u);
         }
 
       private:
@@ -101,9 +221,17 @@ namespace scopi
         double m_dt;
         AMatrix<Contacts, Particles> m_A;
         ATMatrix<Contacts, Particles> m_AT;
-        xt::xtensor<double, 1> m_invM;
+        xt::xtensor<double, 1>& m_invM;
+        xt::xtensor<double, 1>& m_velocities;
     };
 
+    /**
+     * @brief Quadratic problem of the Lagrange multipliers of the contacts of a time step.
+     *
+     * The problem does not own its vectors: they are those of the problem_workspace given to the constructor, which
+     * the caller keeps from one time step to the next. The vectors returned by reference (gradient, velocities, ...)
+     * are valid until the next call of the same function.
+     */
     template <class Problem, class Contacts, class Particles>
     class minimization_problem
     {
@@ -111,33 +239,105 @@ namespace scopi
 
         static constexpr std::size_t dim = Particles::dim;
 
-        inline minimization_problem(double dt, const Contacts& contacts, const Particles& particles)
-            : m_Q(dt, contacts, particles)
-            , m_C(CVector(dt, contacts, particles))
-            , m_lagrange(make_lagrange_multplier<Particles::dim, Problem>(contacts, dt))
+        inline minimization_problem(double dt, const Contacts& contacts, const Particles& particles, problem_workspace& workspace)
+            : m_Q(dt, contacts, particles, workspace)
+            , m_lagrange(make_lagrange_multplier<Particles::dim, Problem>(contacts, dt, workspace))
+            , m_dt(dt)
+            , m_contacts(contacts)
+            , m_particles(particles)
+            , m_workspace(workspace)
         {
-            PLOG_DEBUG << "m_C " << m_C << " " << m_lagrange.global2local(m_C) << std::endl;
+            UVector(particles, m_workspace.U);
+            CVector(dt, contacts, m_Q.relative_velocities(m_workspace.U), m_workspace.C);
+            PLOG_DEBUG << "m_C " << m_workspace.C << " " << m_lagrange.global2local(m_workspace.C) << std::endl;
         }
 
-        inline xt::xtensor<double, 1> gradient(const xt::xtensor<double, 1>& lambda) const
+        inline const xt::xtensor<double, 1>& gradient(const xt::xtensor<double, 1>& lambda) const
         {
-            // std::cout << "local2global " << m_lagrange.local2global(lambda) << std::endl;
-            // std::cout << "Q " << m_Q(m_lagrange.local2global(lambda)) << std::endl;
-            // std::cout << "Q +C" << m_Q(m_lagrange.local2global(lambda) + m_C) << std::endl;
-            return m_lagrange.global2local(m_Q(m_lagrange.local2global(lambda)) + m_C) + m_lagrange.S_Vector();
+            xt::noalias(m_workspace.global_product) = m_Q(m_lagrange.local2global(lambda)) + m_workspace.C;
+            xt::noalias(m_workspace.gradient)       = m_lagrange.global2local(m_workspace.global_product) + m_lagrange.S_Vector();
+            return m_workspace.gradient;
         }
 
         inline double operator()(const xt::xtensor<double, 1>& lambda) const
         {
-            auto lambda_global = m_lagrange.local2global(lambda);
-            return xt::linalg::dot(lambda_global, 0.5 * m_Q(lambda_global) + m_C)[0] + xt::linalg::dot(lambda, m_lagrange.S_Vector())[0];
+            const auto& lambda_global = m_lagrange.local2global(lambda);
+            auto Q_lambda             = m_Q(lambda_global);
+            const auto& S_Vector      = m_lagrange.S_Vector();
+
+            double value = 0.;
+            for (std::size_t i = 0; i < lambda_global.size(); ++i)
+            {
+                value += lambda_global[i] * (0.5 * Q_lambda[i] + m_workspace.C[i]);
+            }
+            for (std::size_t i = 0; i < lambda.size(); ++i)
+            {
+                value += lambda[i] * S_Vector[i];
+            }
+            return value;
         }
 
-        inline auto velocities(const xt::xtensor<double, 1>& lambda) const
+        inline const auto& velocities(const xt::xtensor<double, 1>& lambda) const
         {
             return m_Q.velocities(m_lagrange.local2global(lambda));
         }
 
+        /**
+         * @brief Product of the matrix \f$A\f$ with velocities \f$u\f$ (see UVector), \c dim rows per contact.
+         */
+        inline const auto& relative_velocities(const xt::xtensor<double, 1>& u) const
+        {
+            return m_Q.relative_velocities(u);
+        }
+
+        /**
+         * @brief Recompute the linear term after a change of the contacts' \c sij (fixed point iterations).
+         *
+         * The other operators do not depend on \c sij and are kept.
+         */
+        void update_S_Vector()
+        {
+            m_lagrange.update_S_Vector(m_dt);
+        }
+
+        /**
+         * @brief Lagrange multipliers in the global space, \c dim per contact.
+         */
+        inline const xt::xtensor<double, 1>& local2global(const xt::xtensor<double, 1>& lambda) const
+        {
+            return m_lagrange.local2global(lambda);
+        }
+
+        /**
+         * @brief Product of the quadratic part of the objective with a vector of the local space.
+         *
+         * The gradient is affine: gradient(lambda) = linear_operator(lambda) + linear_term().
+         */
+        inline const xt::xtensor<double, 1>& linear_operator(const xt::xtensor<double, 1>& lambda) const
+        {
+            xt::noalias(m_workspace.global_product) = m_Q(m_lagrange.local2global(lambda));
+            return m_lagrange.global2local(m_workspace.global_product);
+        }
+
+        inline const xt::xtensor<double, 1>& linear_term() const
+        {
+            xt::noalias(m_workspace.linear_term) = m_lagrange.global2local(m_workspace.C) + m_lagrange.S_Vector();
+            return m_workspace.linear_term;
+        }
+
+        /**
+         * @brief Diagonal of linear_operator, used as a Jacobi preconditioner.
+         */
+        inline xt::xtensor<double, 1> diagonal() const
+        {
+            return m_lagrange.diagonal(DelassusDiagonalBlocks(m_dt, m_contacts, m_particles));
+        }
+
+        const Contacts& contacts() const
+        {
+            return m_contacts;
+        }
+
         void projection(xt::xtensor<double, 1>& lambda) const
         {
             m_lagrange.projection(lambda);
@@ -151,13 +351,16 @@ namespace scopi
       private:
 
         const QMatrix<Contacts, Particles> m_Q;
-        const xt::xtensor<double, 1> m_C;
-        const LagrangeMultiplier<Particles::dim, Problem, Contacts> m_lagrange;
+        LagrangeMultiplier<Particles::dim, Problem, Contacts> m_lagrange;
+        double m_dt;
+        const Contacts& m_contacts;
+        const Particles& m_particles;
+        problem_workspace& m_workspace;
     };
 
     template <class Problem, class Contacts, class Particles>
-    auto make_minimization_problem(double dt, const Contacts& contacts, const Particles& particles)
+    auto make_minimization_problem(double dt, const Contacts& contacts, const Particles& particles, problem_workspace& workspace)
     {
-        return minimization_problem<Problem, Contacts, Particles>(dt, contacts, particles);
+        return minimization_problem<Problem, Contacts, Particles>(dt, contacts, particles, workspace);
     }
 }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <xtensor/xtensor.hpp>
+
+namespace scopi
+{
+    /**
+     * @brief Buffers of a minimization_problem and of its operators, kept by the caller from one time step to the next.
+     *
+     * Each problem resizes the buffers to its size: their memory is only reallocated when the number of contacts or
+     * of particles of the problem changes. The results returned by reference by the problem (gradient, velocities,
+     * ...) are stored here and are valid until the next call of the same function.
+     */
+    struct problem_workspace
+    {
+        /// Diagonal of the inverse of the mass matrix (see M_inverse).
+        xt::xtensor<double, 1> invM;
+        /// Velocities of the particles (see UVector).
+        xt::xtensor<double, 1> U;
+        /// Linear term in the global space (see CVector).
+        xt::xtensor<double, 1> C;
+        /// Product by AMatrix.
+        xt::xtensor<double, 1> A_work;
+        /// Product by ATMatrix.
+        xt::xtensor<double, 1> AT_work;
+        /// Velocities \f$ M^{-1} A^T \lambda \f$.
+        xt::xtensor<double, 1> velocities;
+        /// Linear term of the LagrangeMultiplier.
+        xt::xtensor<double, 1> S_Vector;
+        /// Vector of the local space returned by LagrangeMultiplier::global2local.
+        xt::xtensor<double, 1> local;
+        /// Vector of the global space returned by LagrangeMultiplier::local2global.
+        xt::xtensor<double, 1> global;
+        /// Image of a vector by the quadratic part of the objective, in the global space.
+        xt::xtensor<double, 1> global_product;
+        /// Linear term in the local space.
+        xt::xtensor<double, 1> linear_term;
+        /// Gradient of the objective in the local space.
+        xt::xtensor<double, 1> gradient;
+    };
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <xtensor/xtensor.hpp>
+
+namespace scopi
+{
+    /**
+     * @brief Serialize the state that a method keeps from one solve to the next, such as the iterates of admm.
+     *
+     * The values are appended in binary to a buffer, so that they are restored bit for bit by solver_state_reader.
+     */
+    class solver_state_writer
+    {
+      public:
+
+        explicit solver_state_writer(std::vector<char>& buffer)
+            : m_buffer(buffer)
+        {
+        }
+
+        template <class T>
+        void write(const T& value)
+        {
+            static_assert(std::is_arithmetic_v<T>, "the state is made of arithmetic values");
+            write_bytes(&value, sizeof(T));
+        }
+
+        template <class T>
+        void write(const std::vector<T>& values)
+        {
+            static_assert(std::is_arithmetic_v<T>, "the state is made of arithmetic values");
+            write<std::uint64_t>(values.size());
+            write_bytes(values.data(), values.size() * sizeof(T));
+        }
+
+        void write(const xt::xtensor<double, 1>& values)
+        {
+            write<std::uint64_t>(values.size());
+            write_bytes(values.data(), values.size() * sizeof(double));
+        }
+
+      private:
+
+        void write_bytes(const void* data, std::size_t size)
+        {
+            auto first = static_cast<const char*>(data);
+            m_buffer.insert(m_buffer.end(), first, first + size);
+        }
+
+        std::vector<char>& m_buffer;
+    };
+
+    /**
+     * @brief Read a state written by solver_state_writer, in the same order.
+     */
+    class solver_state_reader
+    {
+      public:
+
+        solver_state_reader(const char* data, std::size_t size)
+            : m_data(data)
+            , m_size(size)
+        {
+        }
+
+        template <class T>
+        T read()
+        {
+            static_assert(std::is_arithmetic_v<T>, "the state is made of arithmetic values");
+            T value;
+            read_bytes(&value, sizeof(T));
+            return value;
+        }
+
+        template <class T>
+        void read(std::vector<T>& values)
+        {
+            values.resize(read<std::uint64_t>());
+            read_bytes(values.data(), values.size() * sizeof(T));
+        }
+
+        void read(xt::xtensor<double, 1>& values)
+        {
+            values.resize({static_cast<std::size_t>(read<std::uint64_t>())});
+            read_bytes(values.data(), values.size() * sizeof(double));
+        }
+
+      private:
+
+        void read_bytes(void* data, std::size_t size)
+        {
+            if (m_position + size > m_size)
+            {
+                throw std::runtime_error("solver_state_reader: the state is truncated");
+            }
+            std::memcpy(data, m_data + m_position, size);
+            m_position += size;
+        }
+
+        const char* m_data;
+        std::size_t m_size;
+        std::size_t m_position = 0;
+    };
+
+    /**
+     * @brief Whether a method keeps a state from one solve to the next, which it saves with \c save_state and
+     * restores with \c load_state.
+     */
+    template <class method_t, class = void>
+    struct has_solver_state : std::false_type
+    {
+    };
+
+    template <class method_t>
+    struct has_solver_state<method_t,
+                            std::void_t<decltype(std::declval<const method_t&>().save_state(std::declval<solver_state_writer&>()))>>
+        : std::true_type
+    {
+    };
+
+    template <class method_t>
+    inline constexpr bool has_solver_state_v = has_solver_state<method_t>::value;
+}
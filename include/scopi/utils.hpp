@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
@@ -17,6 +18,8 @@
 
 #include <CLI/CLI.hpp>
 
+#include "small_math.hpp"
+
 /////////////////////////////
 // Functions for the timer //
 /////////////////////////////
@@ -82,12 +85,38 @@ auto newton_method(U u0, F f, DF grad_f, A args, int itermax, double ftol, doubl
 {
     // std::cout << "newton_method : u0 = " << u0 << std::endl;
     // std::cout << "newton_method : args = " << args << std::endl;
+    // the systems of the closest points are 2x2 or 4x4: they are solved in closed form rather than with LAPACK
+    constexpr std::size_t n = scopi::small::fixed_size_v<U>;
+    auto solve              = [&](const auto& u)
+    {
+        if constexpr (n > 0)
+        {
+            return scopi::small::to_xtensor(
+                scopi::small::solve(scopi::small::to_mat<n>(grad_f(u, args)), -scopi::small::to_vec<n>(f(u, args))));
+        }
+        else
+        {
+            return xt::eval(xt::linalg::solve(grad_f(u, args), -f(u, args)));
+        }
+    };
+    auto norm = [](const auto& e)
+    {
+        if constexpr (n > 0)
+        {
+            return scopi::small::norm(scopi::small::to_vec<n>(e));
+        }
+        else
+        {
+            return static_cast<double>(xt::linalg::norm(e));
+        }
+    };
+
     int cc = 0;
     auto u = u0;
     while (cc < itermax)
     {
-        auto d   = xt::linalg::solve(grad_f(u, args), -f(u, args));
-        auto var = xt::linalg::norm(d);
+        auto d   = solve(u);
+        auto var = norm(d);
         if (var < xtol)
         {
             // std::cout << "newton_method : cvgce (xtol) after " << cc << " iterations => RETURN u = " << u << std::endl;
@@ -96,14 +125,14 @@ auto newton_method(U u0, F f, DF grad_f, A args, int itermax, double ftol, doubl
         // std::cout << "newton_method : iteration " << cc << " => d = " << d << " var = " << var << std::endl;
         // linesearch
         double t  = 1;
-        auto ferr = xt::linalg::norm(f(u, args));
+        auto ferr = norm(f(u, args));
         // std::cout << "newton_method : iteration " << cc << " => ferr = " << ferr << std::endl;
         if (ferr < ftol)
         {
             // std::cout << "newton_method : cvgce (ftol) after " << cc << " iterations => RETURN u = " << u << std::endl;
             return std::make_tuple(u, cc);
         }
-        while ((xt::linalg::norm(f(u + t * d, args)) > ferr) && (t > 0.01))
+        while ((norm(f(U(u + t * d), args)) > ferr) && (t > 0.01))
         {
             t -= 0.01;
         }
@@ -256,6 +285,29 @@ namespace scopi
         }
     }
 
+    /**
+     * @brief Dot product of two vectors (or expressions) of the same size, without temporary.
+     */
+    template <class E1, class E2>
+    double dot_product(const E1& x, const E2& y)
+    {
+        double out = 0.;
+        for (std::size_t i = 0; i < x.size(); ++i)
+        {
+            out += x[i] * y[i];
+        }
+        return out;
+    }
+
+    /**
+     * @brief Euclidean norm of a vector (or an expression), without temporary.
+     */
+    template <class E>
+    double l2_norm(const E& x)
+    {
+        return std::sqrt(dot_product(x, x));
+    }
+
     template <class out_t, typename... Args>
     void print_indented(out_t& out, int indent, fmt::format_string<Args...> format_str, Args&&... args)
     {
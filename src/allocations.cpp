@@ -0,0 +1,86 @@
+#include <scopi/allocations.hpp>
+
+#ifdef SCOPI_COUNT_ALLOCATIONS
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<std::size_t> nb_allocations{0};
+
+    void* counted_allocate(std::size_t size, std::size_t alignment)
+    {
+        nb_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (size == 0)
+        {
+            size = 1;
+        }
+        void* ptr = nullptr;
+        if (alignment <= alignof(std::max_align_t))
+        {
+            ptr = std::malloc(size);
+        }
+        else
+        {
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+        }
+        if (!ptr)
+        {
+            throw std::bad_alloc();
+        }
+        return ptr;
+    }
+}
+
+// the array and nothrow forms call these ones
+void* operator new(std::size_t size)
+{
+    return counted_allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace scopi
+{
+    std::size_t nb_system_allocations()
+    {
+        return nb_allocations.load(std::memory_order_relaxed);
+    }
+}
+
+#else
+
+namespace scopi
+{
+    std::size_t nb_system_allocations()
+    {
+        return 0;
+    }
+}
+
+#endif
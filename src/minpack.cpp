@@ -240,7 +240,7 @@ void dogleg(int n, double r[], int, double diag[], double qtb[], double delta, d
 
 //****************************************************************************80
 
-void qform(int m, int n, double q[], int ldq)
+void qform(int m, int n, double q[], int ldq, double wa[])
 {
     int i;
     int j;
@@ -248,7 +248,6 @@ void qform(int m, int n, double q[], int ldq)
     int minmn;
     double sum;
     double temp;
-    double* wa;
     //
     //  Zero out the upper triangle of Q in the first min(M,N) columns.
     //
@@ -275,8 +274,6 @@ void qform(int m, int n, double q[], int ldq)
     //
     //  Accumulate Q from its factored form.
     //
-    wa = new double[m];
-
     for (k = minmn - 1; 0 <= k; k--)
     {
         for (i = k; i < m; i++)
@@ -303,11 +300,6 @@ void qform(int m, int n, double q[], int ldq)
             }
         }
     }
-    //
-    //  Free memory.
-    //
-    delete[] wa;
-
     return;
 }
 
@@ -543,7 +535,7 @@ bool r1updt(int m, int n, double s[], int, double u[], double v[], double w[])
 
 //****************************************************************************80
 
-void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, double rdiag[], double acnorm[])
+void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, double rdiag[], double acnorm[], double wa[])
 {
     double ajnorm;
     double epsmch;
@@ -555,7 +547,6 @@ void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, doubl
     const double p05 = 0.05;
     double sum;
     double temp;
-    double* wa;
     //
     //  EPSMCH is the machine precision.
     //
@@ -563,8 +554,6 @@ void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, doubl
     //
     //  Compute the initial column norms and initialize several arrays.
     //
-    wa = new double[n];
-
     for (j = 0; j < n; j++)
     {
         acnorm[j] = enorm(m, a + j * lda);
@@ -656,11 +645,6 @@ void qrfac(int m, int n, double a[], int lda, bool pivot, int ipvt[], int, doubl
         }
         rdiag[j] = -ajnorm;
     }
-    //
-    //  Free memory.
-    //
-    delete[] wa;
-
     return;
 }
 
@@ -5,10 +5,20 @@ namespace scopi
 {
     ScopiParams::ScopiParams()
         : output_frequency(1)
+        , checkpoint_frequency(std::size_t(-1))
+        , analysis_frequency(std::size_t(-1))
         , path(std::filesystem::current_path() / "Results")
         , filename("scopi_objects")
         , write_velocity(false)
         , binary_output(false)
+        , snapshot_output(false)
+        , streaming_output(false)
+        , async_output(false)
+        , output_buffers(2)
+        , sleep(false)
+        , sleep_velocity(1e-4)
+        , sleep_omega(1e-4)
+        , sleep_steps(50)
     {
     }
 
@@ -21,8 +31,22 @@ namespace scopi
             opt->add_option("--path", path, "Path where to store the results")->capture_default_str();
             opt->add_option("--filename", filename, "Name of the outputs")->capture_default_str();
             opt->add_option("--freq", output_frequency, "Output frequency (in iterations)")->capture_default_str();
+            opt->add_option("--checkpoint-freq", checkpoint_frequency, "Checkpoint frequency (in iterations)")->capture_default_str();
+            opt->add_option("--analysis-freq", analysis_frequency, "Observables frequency (in iterations)")->capture_default_str();
             opt->add_flag("--write-velocity", write_velocity, "Write the velocity of objects")->capture_default_str();
             opt->add_flag("--binary-output", binary_output, "Write bson output file instead of json")->capture_default_str();
+            opt->add_flag("--snapshot-output", snapshot_output, "Write columnar binary snapshots instead of json")->capture_default_str();
+            opt->add_flag("--streaming-output", streaming_output, "Stream the json or bson files object by object")->capture_default_str();
+            opt->add_flag("--async-output", async_output, "Write the output files in a background thread")->capture_default_str();
+            opt->add_option("--output-buffers", output_buffers, "Number of output frames of the background thread")->capture_default_str();
+        }
+        auto* sleep_opt = app.add_option_group("Sleeping options");
+        if (!check_option(app, "--sleep"))
+        {
+            sleep_opt->add_flag("--sleep", sleep, "Put the resting particles to sleep")->capture_default_str();
+            sleep_opt->add_option("--sleep-velocity", sleep_velocity, "Velocity under which a particle is at rest")->capture_default_str();
+            sleep_opt->add_option("--sleep-omega", sleep_omega, "Rotation velocity under which a particle is at rest")->capture_default_str();
+            sleep_opt->add_option("--sleep-steps", sleep_steps, "Number of iterations at rest before falling asleep")->capture_default_str();
         }
     }
 
@@ -0,0 +1,182 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <xtensor/xtensor.hpp>
+
+#include <scopi/analysis.hpp>
+#include <scopi/contact/contact_brute_force.hpp>
+#include <scopi/container.hpp>
+#include <scopi/objects/types/plane.hpp>
+#include <scopi/objects/types/sphere.hpp>
+#include <scopi/solver.hpp>
+
+#include "utils.hpp"
+
+namespace scopi
+{
+    TEST_CASE("analysis observables")
+    {
+        static constexpr std::size_t dim = 2;
+        scopi_container<dim> particles;
+
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            PI / 2.);
+        sphere<dim> s1(
+            {
+                {0., 0.5}
+        },
+            0.5);
+        sphere<dim> s2(
+            {
+                {0., 1.5}
+        },
+            0.5);
+        particles.push_back(p, property<dim>().deactivate());
+        particles.push_back(s1, property<dim>().velocity({1., 2.}).omega(2.).mass(1.).moment_inertia(0.5));
+        particles.push_back(s2, property<dim>().velocity({0., -1.}).mass(2.).moment_inertia(0.5));
+
+        ContactsParams<contact_brute_force<NoFriction>> params;
+        params.dmax = 0.5;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() == 2);
+
+        // only the first contact has a force
+        xt::xtensor<double, 1> lambda = xt::zeros<double>({dim * contacts.size()});
+        lambda(0)                     = 3.;
+        lambda(1)                     = 4.;
+        analysis_state<dim, NoFriction> state{particles, contacts, lambda, 10, 0.5};
+
+        SUBCASE("kinetic energy")
+        {
+            double value = 0.;
+            kinetic_energy<dim, NoFriction>().compute(state, &value);
+            REQUIRE(value == doctest::Approx(0.5 * (1. * 5. + 0.5 * 4. + 2. * 1.)));
+        }
+
+        SUBCASE("coordination number")
+        {
+            double value = 0.;
+            coordination_number<dim, NoFriction>().compute(state, &value);
+            std::size_t nb_active_ends = (contacts[0].i >= particles.nb_inactive()) + (contacts[0].j >= particles.nb_inactive());
+            REQUIRE(value == doctest::Approx(static_cast<double>(nb_active_ends) / 2.));
+        }
+
+        SUBCASE("packing fraction")
+        {
+            double value = 0.;
+            packing_fraction<dim, NoFriction>(6., 0.5).compute(state, &value);
+            REQUIRE(value == doctest::Approx(1.));
+        }
+
+        SUBCASE("contact forces")
+        {
+            contact_force_distribution<dim, NoFriction> forces(4, 0.5);
+            REQUIRE(forces.columns().size() == 6);
+            std::vector<double> values(6);
+            forces.compute(state, values.data());
+            REQUIRE(values[0] == doctest::Approx(5.));
+            REQUIRE(values[1] == doctest::Approx(5.));
+            // f / <f> = 1 is in the third bin
+            REQUIRE(values[2] == 0.);
+            REQUIRE(values[4] == 1.);
+        }
+
+        SUBCASE("stress tensor")
+        {
+            stress_tensor<dim, NoFriction> stress(2.);
+            std::vector<double> values(dim * dim);
+            stress.compute(state, values.data());
+
+            const auto& c = contacts[0];
+            for (std::size_t a = 0; a < dim; ++a)
+            {
+                for (std::size_t b = 0; b < dim; ++b)
+                {
+                    double expected = 0.;
+                    if (c.i >= particles.nb_inactive())
+                    {
+                        expected += lambda(a) * (c.pi(b) - particles.pos()(c.i)(b));
+                    }
+                    if (c.j >= particles.nb_inactive())
+                    {
+                        expected -= lambda(a) * (c.pj(b) - particles.pos()(c.j)(b));
+                    }
+                    REQUIRE(values[a * dim + b] == doctest::Approx(expected / 2.));
+                }
+            }
+        }
+
+        SUBCASE("pipeline")
+        {
+            analysis_pipeline<dim, NoFriction> pipeline;
+            pipeline.emplace<kinetic_energy<dim, NoFriction>>();
+            pipeline.emplace<packing_fraction<dim, NoFriction>>(6., 0.5);
+
+            std::ostringstream out;
+            pipeline.write_header(out);
+            pipeline.write_row(out, state);
+            REQUIRE(out.str() == "iteration,time,kinetic_energy,packing_fraction\n10,0.5,4.5,1\n");
+        }
+    }
+
+    TEST_CASE("analysis during a simulation")
+    {
+        static constexpr std::size_t dim = 2;
+        auto path                        = std::filesystem::temp_directory_path() / "scopi_test_analysis";
+        scopi_container<dim> particles;
+
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            PI / 2.);
+        sphere<dim> s(
+            {
+                {0., 0.6}
+        },
+            0.5);
+        particles.push_back(p, property<dim>().deactivate());
+        particles.push_back(s, property<dim>().force({0., -1.}).mass(1.).moment_inertia(0.1));
+
+        ScopiSolver<dim> solver(particles);
+        auto params                             = solver.get_params();
+        params.solver_params.path               = path;
+        params.solver_params.output_frequency   = std::size_t(-1);
+        params.solver_params.analysis_frequency = 5;
+        solver.run(0.05, 20);
+        // restart at the iteration of the last row, which is not written twice
+        solver.run(0.05, 30, 20);
+
+        std::ifstream file(path / "scopi_objects_analysis.csv");
+        std::string line;
+        std::getline(file, line);
+        REQUIRE(line.rfind("iteration,time,kinetic_energy,coordination_number,force_mean,force_max,force_hist_0", 0) == 0);
+        std::size_t nb_rows = 0;
+        while (std::getline(file, line))
+        {
+            REQUIRE(line.rfind(std::to_string(5 * (nb_rows + 1)) + ",", 0) == 0);
+            ++nb_rows;
+        }
+        REQUIRE(nb_rows == 6);
+
+        // the observables of the restart are not the columns of the file
+        ScopiSolver<dim> other_solver(particles);
+        auto other_params                             = other_solver.get_params();
+        other_params.solver_params.path               = path;
+        other_params.solver_params.output_frequency   = std::size_t(-1);
+        other_params.solver_params.analysis_frequency = 5;
+        other_solver.analysis().emplace<kinetic_energy<dim, NoFriction>>();
+        REQUIRE_THROWS_AS(other_solver.run(0.05, 40, 30), std::runtime_error);
+        std::filesystem::remove_all(path);
+    }
+}
@@ -0,0 +1,65 @@
+#include <doctest/doctest.h>
+
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <scopi/async_writer.hpp>
+
+namespace scopi
+{
+    TEST_CASE("async writer")
+    {
+        std::mutex mutex;
+        std::vector<int> written;
+
+        SUBCASE("frames are written in order")
+        {
+            {
+                async_writer<std::vector<int>> writer(
+                    [&](const std::vector<int>& frame)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        written.push_back(frame[0]);
+                    },
+                    2);
+                for (int i = 0; i < 10; ++i)
+                {
+                    auto& frame = writer.acquire();
+                    frame.assign(100, i);
+                    writer.submit();
+                }
+                writer.flush();
+                REQUIRE(written.size() == 10);
+
+                // written by the destructor
+                writer.acquire().assign(1, 10);
+                writer.submit();
+            }
+            REQUIRE(written.size() == 11);
+            for (int i = 0; i < 11; ++i)
+            {
+                REQUIRE(written[i] == i);
+            }
+        }
+
+        SUBCASE("errors are reported to the solver")
+        {
+            async_writer<int> writer(
+                [](const int& frame)
+                {
+                    if (frame == 1)
+                    {
+                        throw std::runtime_error("cannot write");
+                    }
+                },
+                1);
+            writer.acquire() = 0;
+            writer.submit();
+            writer.acquire() = 1;
+            writer.submit();
+            REQUIRE_THROWS_AS(writer.flush(), std::runtime_error);
+            writer.flush();
+        }
+    }
+}
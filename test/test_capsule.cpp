@@ -0,0 +1,188 @@
+#include "utils.hpp"
+#include <doctest/doctest.h>
+
+#include <scopi/container.hpp>
+#include <scopi/contact/property.hpp>
+#include <scopi/objects/methods/closest_points.hpp>
+#include <scopi/objects/types/capsule.hpp>
+
+namespace scopi
+{
+    TEST_CASE("capsule_capsule_2d parallel")
+    {
+        static constexpr std::size_t dim = 2;
+        capsule<dim> c1(
+            {
+                {0., 0.}
+        },
+            0.1,
+            0.4);
+        capsule<dim> c2(
+            {
+                {0., 0.3}
+        },
+            0.1,
+            0.4);
+
+        auto out = closest_points<NoFriction>(c1, c2);
+
+        REQUIRE(out.pi(0) == doctest::Approx(-0.2));
+        REQUIRE(out.pi(1) == doctest::Approx(0.1));
+        REQUIRE(out.pj(0) == doctest::Approx(-0.2));
+        REQUIRE(out.pj(1) == doctest::Approx(0.2));
+        REQUIRE(out.nij(0) == doctest::Approx(0.));
+        REQUIRE(out.nij(1) == doctest::Approx(-1.));
+        REQUIRE(out.dij == doctest::Approx(0.1));
+    }
+
+    TEST_CASE("capsule_capsule_3d crossing")
+    {
+        static constexpr std::size_t dim = 3;
+        capsule<dim> c1(
+            {
+                {0., 0., 0.}
+        },
+            0.1,
+            1.);
+        capsule<dim> c2(
+            {
+                {0., 0., 0.5}
+        },
+            {quaternion(PI / 2.)},
+            0.2,
+            1.);
+
+        auto out = closest_points<NoFriction>(c1, c2);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.));
+        REQUIRE(out.pi(1) == doctest::Approx(0.));
+        REQUIRE(out.pi(2) == doctest::Approx(0.1));
+        REQUIRE(out.pj(2) == doctest::Approx(0.3));
+        REQUIRE(out.nij(2) == doctest::Approx(-1.));
+        REQUIRE(out.dij == doctest::Approx(0.2));
+    }
+
+    TEST_CASE("sphere_capsule_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        sphere<dim> s(
+            {
+                {0.5, 0.2}
+        },
+            0.1);
+        capsule<dim> c(
+            {
+                {0., 0.}
+        },
+            0.05,
+            0.6);
+
+        auto out = closest_points<NoFriction>(s, c);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.5 - 0.1 / std::sqrt(2.)));
+        REQUIRE(out.pi(1) == doctest::Approx(0.2 - 0.1 / std::sqrt(2.)));
+        REQUIRE(out.pj(0) == doctest::Approx(0.3 + 0.05 / std::sqrt(2.)));
+        REQUIRE(out.pj(1) == doctest::Approx(0.05 / std::sqrt(2.)));
+        REQUIRE(out.nij(0) == doctest::Approx(1. / std::sqrt(2.)));
+        REQUIRE(out.nij(1) == doctest::Approx(1. / std::sqrt(2.)));
+        REQUIRE(out.dij == doctest::Approx(0.2 * std::sqrt(2.) - 0.15));
+
+        auto reverse = closest_points<NoFriction>(c, s);
+        REQUIRE(reverse.pi(0) == doctest::Approx(out.pj(0)));
+        REQUIRE(reverse.pj(0) == doctest::Approx(out.pi(0)));
+        REQUIRE(reverse.nij(0) == doctest::Approx(-1. / std::sqrt(2.)));
+        REQUIRE(reverse.dij == doctest::Approx(out.dij));
+    }
+
+    TEST_CASE("capsule_plane_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        capsule<dim> c(
+            {
+                {0.5, 0.}
+        },
+            {quaternion(PI / 4.)},
+            0.1,
+            0.4);
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            0.);
+
+        auto out = closest_points<NoFriction>(c, p);
+
+        double h = 0.2 / std::sqrt(2.);
+        REQUIRE(out.pi(0) == doctest::Approx(0.4 - h));
+        REQUIRE(out.pi(1) == doctest::Approx(-h));
+        REQUIRE(out.pj(0) == doctest::Approx(0.));
+        REQUIRE(out.pj(1) == doctest::Approx(-h));
+        REQUIRE(out.nij(0) == doctest::Approx(1.));
+        REQUIRE(out.nij(1) == doctest::Approx(0.));
+        REQUIRE(out.dij == doctest::Approx(0.4 - h));
+
+        auto reverse = closest_points<NoFriction>(p, c);
+        REQUIRE(reverse.pi(0) == doctest::Approx(0.));
+        REQUIRE(reverse.pj(0) == doctest::Approx(0.4 - h));
+        REQUIRE(reverse.nij(0) == doctest::Approx(-1.));
+        REQUIRE(reverse.dij == doctest::Approx(0.4 - h));
+    }
+
+    TEST_CASE("capsule_superellipsoid_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        // a capsule of length 0 is a disk
+        capsule<dim> c(
+            {
+                {0.5, 0.}
+        },
+            0.1,
+            0.);
+        superellipsoid<dim> e(
+            {
+                {0., 0.}
+        },
+            {quaternion(0.)},
+            {{.2, .1}},
+            1);
+
+        auto out = closest_points<NoFriction>(c, e);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.4));
+        REQUIRE(out.pj(0) == doctest::Approx(0.2));
+        REQUIRE(out.nij(0) == doctest::Approx(1.));
+        REQUIRE(out.dij == doctest::Approx(0.2));
+    }
+
+    TEST_CASE("capsule_capsule_2d dispatch")
+    {
+        static constexpr std::size_t dim = 2;
+        capsule<dim> c1(
+            {
+                {0., 0.}
+        },
+            0.1,
+            0.4);
+        capsule<dim> c2(
+            {
+                {0.2, 0.5}
+        },
+            {quaternion(PI / 2.)},
+            0.1,
+            0.4);
+
+        scopi_container<dim> particles;
+        particles.push_back(c1);
+        particles.push_back(c2);
+
+        auto out = closest_points_dispatcher<NoFriction, dim>::dispatch(*particles[0], *particles[1]);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.2));
+        REQUIRE(out.pi(1) == doctest::Approx(0.1));
+        REQUIRE(out.pj(0) == doctest::Approx(0.2));
+        REQUIRE(out.pj(1) == doctest::Approx(0.2));
+        REQUIRE(out.nij(0) == doctest::Approx(0.));
+        REQUIRE(out.nij(1) == doctest::Approx(-1.));
+        REQUIRE(out.dij == doctest::Approx(0.1));
+    }
+}
@@ -0,0 +1,183 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+
+#include <xtensor/xbuilder.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include <scopi/checkpoint.hpp>
+#include <scopi/contact/contact_brute_force.hpp>
+#include <scopi/container.hpp>
+#include <scopi/objects/types/plane.hpp>
+#include <scopi/objects/types/sdf.hpp>
+#include <scopi/objects/types/sphere.hpp>
+#include <scopi/solver.hpp>
+#include <scopi/solvers/admm.hpp>
+
+#include "utils.hpp"
+
+namespace scopi
+{
+    TEST_CASE("checkpoint round trip")
+    {
+        static constexpr std::size_t dim = 2;
+        scopi_container<dim> particles;
+
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            PI / 2.);
+        sphere<dim> s1(
+            {
+                {0., 0.45}
+        },
+            0.5);
+        sphere<dim> s2(
+            {
+                {0.9, 0.55}
+        },
+            0.5);
+        particles.push_back(p, property<dim>().deactivate());
+        particles.push_back(s1, property<dim>().velocity({1. / 3., 2.}).omega(0.5).mass(1.).moment_inertia(0.1));
+        particles.push_back(s2, property<dim>().desired_velocity({0., -1.}).force({0., -1.}).mass(2.).moment_inertia(0.2));
+
+        ContactsParams<contact_brute_force<Viscous>> params;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() > 1);
+        contacts[0].property.gamma = -1. / 3.;
+        contacts[1].sij            = 0.7;
+
+        xt::xtensor<double, 1> lambda = xt::arange<double>(dim * contacts.size()) / 3.;
+
+        auto filename = (std::filesystem::temp_directory_path() / "scopi_test_checkpoint.ckpt").string();
+        write_checkpoint(filename, particles, contacts, lambda, 42);
+
+        scopi_container<dim> restored;
+        std::vector<neighbor<dim, Viscous>> restored_contacts;
+        xt::xtensor<double, 1> restored_lambda;
+        REQUIRE(read_checkpoint(filename, restored, restored_contacts, restored_lambda) == 42);
+        std::filesystem::remove(filename);
+
+        REQUIRE(restored.size() == particles.size());
+        REQUIRE(restored.nb_inactive() == particles.nb_inactive());
+        for (std::size_t i = 0; i < particles.pos().size(); ++i)
+        {
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                REQUIRE(restored.pos()(i)(d) == particles.pos()(i)(d));
+                REQUIRE(restored.v()(i)(d) == particles.v()(i)(d));
+                REQUIRE(restored.vd()(i)(d) == particles.vd()(i)(d));
+                REQUIRE(restored.f()(i)(d) == particles.f()(i)(d));
+            }
+            for (std::size_t k = 0; k < 4; ++k)
+            {
+                REQUIRE(restored.q()(i)(k) == particles.q()(i)(k));
+            }
+            REQUIRE(restored.omega()(i) == particles.omega()(i));
+            REQUIRE(restored.m()(i) == particles.m()(i));
+            REQUIRE(restored.j()(i) == particles.j()(i));
+        }
+
+        // the shapes are rebuilt
+        REQUIRE(dynamic_cast<const sphere<dim, false>&>(*restored[2]).radius() == 0.5);
+        REQUIRE(restored[2]->pos()(0) == 0.9);
+
+        REQUIRE(restored_contacts.size() == contacts.size());
+        for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+        {
+            REQUIRE(restored_contacts[ic].i == contacts[ic].i);
+            REQUIRE(restored_contacts[ic].j == contacts[ic].j);
+            REQUIRE(restored_contacts[ic].dij == contacts[ic].dij);
+            REQUIRE(restored_contacts[ic].sij == contacts[ic].sij);
+            REQUIRE(restored_contacts[ic].pi(1) == contacts[ic].pi(1));
+            REQUIRE(restored_contacts[ic].property.gamma == contacts[ic].property.gamma);
+        }
+        REQUIRE(restored_lambda == lambda);
+    }
+
+    // admm keeps its iterates from one time step to the next: they are in the checkpoint,
+    // and the grid of the sdf is rebuilt from the shape table
+    TEST_CASE_TEMPLATE("restart from a checkpoint",
+                       SolverType,
+                       ScopiSolver<2>,
+                       ScopiSolver<2, Friction, OptimGradient<admm>>,
+                       ScopiSolver<2, ViscousFriction, OptimGradient<admm>>)
+    {
+        static constexpr std::size_t dim = 2;
+        double dt                        = 0.05;
+        std::size_t total_it             = 20;
+        auto path                        = std::filesystem::temp_directory_path() / "scopi_test_restart";
+
+        auto make_particles = []()
+        {
+            scopi_container<dim> particles;
+            plane<dim> p(
+                {
+                    {0., 0.}
+            },
+                PI / 2.);
+            particles.push_back(p, property<dim>().deactivate());
+            for (std::size_t i = 0; i < 3; ++i)
+            {
+                sphere<dim> s(
+                    {
+                        {0.3 * static_cast<double>(i), 0.6 + 1.05 * static_cast<double>(i)}
+                },
+                    0.5);
+                particles.push_back(s, property<dim>().force({0., -1.}).mass(1.).moment_inertia(0.1));
+            }
+            auto grid = make_sdf_grid<dim>(
+                [](const small::vec<dim>& p)
+                {
+                    return small::norm(p) - 0.5;
+                },
+                {
+                    {-1., -1.}
+            },
+                {
+                    {1., 1.}
+            },
+                0.05);
+            sdf<dim> f(
+                {
+                    {3., 0.6}
+            },
+                grid);
+            particles.push_back(f, property<dim>().force({0., -1.}).mass(1.).moment_inertia(0.1));
+            return particles;
+        };
+
+        auto particles = make_particles();
+        SolverType solver(particles);
+        auto params                               = solver.get_params();
+        params.solver_params.path                 = path;
+        params.solver_params.output_frequency     = std::size_t(-1);
+        params.solver_params.checkpoint_frequency = 10;
+        solver.run(dt, total_it);
+
+        auto restarted = make_particles();
+        SolverType restarted_solver(restarted);
+        auto restarted_params                           = restarted_solver.get_params();
+        restarted_params.solver_params.path             = path;
+        restarted_params.solver_params.output_frequency = std::size_t(-1);
+        std::size_t nite = restarted_solver.restart((path / "scopi_objects_0010.ckpt").string());
+        REQUIRE(nite == 10);
+        restarted_solver.run(dt, total_it, nite);
+
+        // the restarted simulation is the same, bit for bit
+        for (std::size_t i = 0; i < particles.pos().size(); ++i)
+        {
+            for (std::size_t d = 0; d < dim; ++d)
+            {
+                REQUIRE(restarted.pos()(i)(d) == particles.pos()(i)(d));
+                REQUIRE(restarted.v()(i)(d) == particles.v()(i)(d));
+            }
+            REQUIRE(restarted.omega()(i) == particles.omega()(i));
+        }
+        REQUIRE(dynamic_cast<const sdf<dim, false>&>(*restarted[4]).grid().values()
+                == dynamic_cast<const sdf<dim, false>&>(*particles[4]).grid().values());
+        std::filesystem::remove_all(path);
+    }
+}
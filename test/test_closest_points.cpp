@@ -3,6 +3,7 @@
 
 #include <scopi/contact/property.hpp>
 #include <scopi/container.hpp>
+#include <scopi/objects/methods/bounding_volume.hpp>
 #include <scopi/objects/methods/closest_points.hpp>
 #include <scopi/objects/types/sphere.hpp>
 #include <scopi/objects/types/superellipsoid.hpp>
@@ -2421,4 +2422,128 @@ namespace scopi
     }
 */
 
+    TEST_CASE("hybrd fixed size")
+    {
+        // intersection of the unit circle with the first bisector
+        auto f = [](auto u, auto)
+        {
+            return xt::xtensor_fixed<double, xt::xshape<2>>{u(0) * u(0) + u(1) * u(1) - 1., u(0) - u(1)};
+        };
+        auto grad_f = [](auto u, auto)
+        {
+            return xt::xtensor_fixed<double, xt::xshape<2, 2>>{
+                {2. * u(0), 2. * u(1)},
+                {1.,        -1.      }
+            };
+        };
+        xt::xtensor_fixed<double, xt::xshape<2>> u0 = {1., 0.5};
+        xt::xtensor_fixed<double, xt::xshape<1>> args = {0.};
+
+        auto [u, report] = hybrd<2>(u0, f, grad_f, args);
+        REQUIRE(report.converged());
+        REQUIRE(report.iterations > 0);
+        REQUIRE(report.fnorm < 1e-8);
+        REQUIRE(u(0) == doctest::Approx(std::sqrt(2.) / 2.));
+        REQUIRE(u(1) == doctest::Approx(std::sqrt(2.) / 2.));
+    }
+
+    TEST_CASE("early rejection superellipsoid_superellipsoid_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        double dmax                      = 0.1;
+        superellipsoid<dim> s1(
+            {
+                {0., 0.}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+        superellipsoid<dim> far(
+            {
+                {2., 0.}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+        superellipsoid<dim> above(
+            {
+                {0., 0.3}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+        superellipsoid<dim> close(
+            {
+                {0., 0.15}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+
+        REQUIRE(early_rejection(s1, far, dmax) == rejection_tier::sphere);
+        REQUIRE(early_rejection(s1, above, dmax) == rejection_tier::oriented_box);
+        REQUIRE(early_rejection(s1, close, dmax) == rejection_tier::none);
+    }
+
+    TEST_CASE("early rejection sphere_superellipsoid_2d dispatch")
+    {
+        static constexpr std::size_t dim = 2;
+        double dmax                      = 0.1;
+        sphere<dim> s(
+            {
+                {0., 0.3}
+        },
+            0.05);
+        superellipsoid<dim> e(
+            {
+                {0., 0.}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+
+        scopi_container<dim> particles;
+        particles.push_back(s);
+        particles.push_back(e);
+
+        REQUIRE(early_rejection_dispatcher<dim>::dispatch(*particles[0], *particles[1], dmax) == rejection_tier::oriented_box);
+        REQUIRE(early_rejection_dispatcher<dim>::dispatch(*particles[1], *particles[0], dmax) == rejection_tier::oriented_box);
+        REQUIRE(early_rejection_dispatcher<dim>::dispatch(*particles[0], *particles[0], dmax) == rejection_tier::none);
+    }
+
+    TEST_CASE("early rejection superellipsoid_plane_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        double dmax                      = 0.1;
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            0.);
+        superellipsoid<dim> far(
+            {
+                {0.7, 0.}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+        superellipsoid<dim> rotated(
+            {
+                {0.3, 0.}
+        },
+            {quaternion(PI / 2.)},
+            {{.5, .05}},
+            1);
+        superellipsoid<dim> close(
+            {
+                {0.3, 0.}
+        },
+            {quaternion(0.)},
+            {{.5, .05}},
+            1);
+
+        REQUIRE(early_rejection(far, p, dmax) == rejection_tier::sphere);
+        REQUIRE(early_rejection(rotated, p, dmax) == rejection_tier::oriented_box);
+        REQUIRE(early_rejection(close, p, dmax) == rejection_tier::none);
+    }
 }
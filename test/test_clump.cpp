@@ -0,0 +1,128 @@
+#include "utils.hpp"
+#include <doctest/doctest.h>
+
+#include <algorithm>
+
+#include <scopi/contact/contact_brute_force.hpp>
+#include <scopi/contact/property.hpp>
+#include <scopi/container.hpp>
+#include <scopi/matrix/velocities.hpp>
+#include <scopi/objects/types/clump.hpp>
+#include <scopi/objects/types/plane.hpp>
+#include <scopi/solver.hpp>
+
+namespace scopi
+{
+    TEST_CASE("clump spheres")
+    {
+        static constexpr std::size_t dim = 2;
+        clump<dim> c(
+            {
+                {1., 0.}
+        },
+            {quaternion(PI / 2.)},
+            {{{-0.2, 0.}}, {{0.2, 0.}}},
+            {0.1, 0.15});
+
+        REQUIRE(c.size() == 1);
+        REQUIRE(c.nb_spheres() == 2);
+        REQUIRE(c.sphere_position(0)(0) == doctest::Approx(1.));
+        REQUIRE(c.sphere_position(0)(1) == doctest::Approx(-0.2));
+        REQUIRE(c.sphere_position(1)(0) == doctest::Approx(1.));
+        REQUIRE(c.sphere_position(1)(1) == doctest::Approx(0.2));
+        REQUIRE(c.bounding_radius() == doctest::Approx(0.35));
+    }
+
+    TEST_CASE("clump plane contacts")
+    {
+        static constexpr std::size_t dim = 2;
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            PI / 2.);
+        clump<dim> c(
+            {
+                {0., 0.15}
+        },
+            {{{-0.2, 0.}}, {{0.2, 0.}}},
+            {0.1, 0.1});
+
+        scopi_container<dim> particles;
+        particles.push_back(p, property<dim>().deactivate());
+        particles.push_back(c, property<dim>().mass(1.).moment_inertia(0.1));
+
+        ContactsParams<contact_brute_force<NoFriction>> params;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, particles.nb_inactive());
+
+        // one contact for each sphere, both attached to the clump
+        REQUIRE(contacts.size() == 2);
+        for (const auto& contact : contacts)
+        {
+            REQUIRE(contact.i == 0);
+            REQUIRE(contact.j == 1);
+            REQUIRE(contact.dij == doctest::Approx(0.05));
+            REQUIRE(std::abs(contact.pj(0)) == doctest::Approx(0.2));
+            REQUIRE(contact.pj(1) == doctest::Approx(0.05));
+        }
+
+        SUBCASE("lever arm")
+        {
+            // rotation of the clump around its center
+            xt::xtensor<double, 1> u = xt::zeros<double>({3});
+            u(2)                     = 1.;
+
+            AMatrix A(contacts, particles);
+            const auto& out = A.mat_mult(u);
+            for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+            {
+                double rx = contacts[ic].pj(0);
+                double ry = contacts[ic].pj(1) - 0.15;
+                REQUIRE(out(2 * ic) == doctest::Approx(ry));
+                REQUIRE(out(2 * ic + 1) == doctest::Approx(-rx));
+            }
+        }
+    }
+
+    TEST_CASE("clump contacts keep their own history")
+    {
+        static constexpr std::size_t dim = 2;
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            PI / 2.);
+        clump<dim> c(
+            {
+                {0., 0.15}
+        },
+            {{{-0.2, 0.}}, {{0.2, 0.}}},
+            {0.1, 0.1});
+
+        scopi_container<dim> particles;
+        particles.push_back(p, property<dim>().deactivate());
+        particles.push_back(c, property<dim>().mass(1.).moment_inertia(0.1));
+
+        ContactsParams<contact_brute_force<Viscous>> params;
+        contact_brute_force<Viscous> cont(params);
+        auto old_contacts = cont.run(particles, particles.nb_inactive());
+        REQUIRE(old_contacts.size() == 2);
+        for (auto& contact : old_contacts)
+        {
+            contact.property.gamma = (contact.pj(0) < 0.) ? -1. : -0.5;
+        }
+
+        // the clump slides, and the contacts are found in the reverse order
+        particles.pos()(1)(0) = 0.05;
+        auto contacts         = cont.run(particles, particles.nb_inactive());
+        REQUIRE(contacts.size() == 2);
+        std::reverse(contacts.begin(), contacts.end());
+        transfer(old_contacts, contacts);
+
+        for (const auto& contact : contacts)
+        {
+            REQUIRE(contact.property.gamma == ((contact.pj(0) < 0.) ? -1. : -0.5));
+        }
+    }
+}
@@ -302,4 +302,73 @@ namespace scopi
             REQUIRE(cross_product_superellipsoid(2) == doctest::Approx(PI * PI / 12. * 0.1));
         }
     }
+
+    TEST_CASE("Superellipsoid samples shared by shape")
+    {
+        static constexpr std::size_t dim = 2;
+        superellipsoid<dim> s1(
+            {
+                {-0.2, 0.1}
+        },
+            {quaternion(PI / 3)},
+            {{.2, .05}},
+            1);
+        superellipsoid<dim> s2(
+            {
+                {0.2, 0.05}
+        },
+            {quaternion(PI / 4)},
+            {{.2, .05}},
+            1);
+        superellipsoid<dim> s3(
+            {
+                {0.6, 0.05}
+        },
+            {quaternion(PI / 4)},
+            {{.1, .05}},
+            1);
+        scopi_container<dim> particles;
+        auto p = property<dim>().mass(1.).moment_inertia(0.1);
+        particles.push_back(s1, p);
+        particles.push_back(s2, p);
+        particles.push_back(s3, p);
+
+        auto o1        = particles[0];
+        auto o2        = particles[1];
+        const auto& e1 = dynamic_cast<const superellipsoid<dim, false>&>(*o1);
+        const auto& e2 = dynamic_cast<const superellipsoid<dim, false>&>(*o2);
+        REQUIRE(&s1.samples() == &s2.samples());
+        REQUIRE(&s1.samples() != &s3.samples());
+        REQUIRE(&e1.samples() == &s1.samples());
+        REQUIRE(&e2.samples() == &s1.samples());
+        REQUIRE(s1.samples().b.size() == s1.samples().points.size());
+    }
+
+    TEST_CASE("Container copy")
+    {
+        static constexpr std::size_t dim = 2;
+        sphere<dim> s1(
+            {
+                {0.2, 0.05}
+        },
+            0.1);
+        scopi_container<dim> particles;
+        particles.push_back(s1, property<dim>().velocity({{0.4, 0.5}}));
+
+        scopi_container<dim> copy;
+        copy = particles;
+        particles.pos()(0)(0) = 1.;
+        particles.v()(0)(1)   = 2.;
+
+        REQUIRE(copy.size() == 1);
+        REQUIRE(copy.shape_id(0) == particles.shape_id(0));
+        REQUIRE(copy.pos()(0)(0) == doctest::Approx(0.2));
+        REQUIRE(copy.v()(0)(1) == doctest::Approx(0.5));
+
+        // the objects of the copy are built on its own arrays
+        const auto& const_copy = copy;
+        auto o                 = const_copy[0];
+        REQUIRE(o->pos()(0) == doctest::Approx(0.2));
+        REQUIRE(dynamic_cast<const sphere<dim, false>&>(*o).radius() == doctest::Approx(0.1));
+    }
 }
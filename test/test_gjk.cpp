@@ -0,0 +1,168 @@
+#include "utils.hpp"
+#include <doctest/doctest.h>
+
+#include <scopi/contact/property.hpp>
+#include <scopi/objects/methods/closest_points.hpp>
+#include <scopi/objects/methods/gjk.hpp>
+
+namespace scopi
+{
+    TEST_CASE("gjk support superellipsoid_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        superellipsoid<dim> ellipse(
+            {
+                {0., 0.}
+        },
+            {quaternion(0.)},
+            {{.2, .1}},
+            1);
+        small::vec<dim> d = {
+            {1., 1.}
+        };
+
+        auto p = support(ellipse, d);
+        REQUIRE(p[0] == doctest::Approx(0.04 / std::sqrt(0.05)));
+        REQUIRE(p[1] == doctest::Approx(0.01 / std::sqrt(0.05)));
+
+        superellipsoid<dim> square(
+            {
+                {0., 0.}
+        },
+            {quaternion(0.)},
+            {{.2, .1}},
+            0.5);
+        p = support(square, d);
+        REQUIRE(std::pow(p[0] / 0.2, 4) + std::pow(p[1] / 0.1, 4) == doctest::Approx(1.));
+    }
+
+    TEST_CASE("gjk support superellipsoid_3d")
+    {
+        static constexpr std::size_t dim = 3;
+        superellipsoid<dim> ellipsoid(
+            {
+                {0., 0., 0.}
+        },
+            {quaternion(0.)},
+            {{.3, .2, .1}},
+            {{1., 1.}});
+        small::vec<dim> d = {
+            {1., 1., 1.}
+        };
+
+        auto p = support(ellipsoid, d);
+        REQUIRE(p[0] == doctest::Approx(0.09 / std::sqrt(0.14)));
+        REQUIRE(p[1] == doctest::Approx(0.04 / std::sqrt(0.14)));
+        REQUIRE(p[2] == doctest::Approx(0.01 / std::sqrt(0.14)));
+    }
+
+    TEST_CASE("gjk sphere_sphere_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        sphere<dim> s1(
+            {
+                {-0.2, 0.0}
+        },
+            0.1);
+        sphere<dim> s2(
+            {
+                {0.2, 0.0}
+        },
+            0.1);
+
+        auto out = gjk_closest_points<NoFriction>(s1, s2);
+
+        REQUIRE(out.pi(0) == doctest::Approx(-0.1));
+        REQUIRE(out.pi(1) == doctest::Approx(0.));
+        REQUIRE(out.pj(0) == doctest::Approx(0.1));
+        REQUIRE(out.pj(1) == doctest::Approx(0.));
+        REQUIRE(out.nij(0) == doctest::Approx(-1.));
+        REQUIRE(out.nij(1) == doctest::Approx(0.));
+        REQUIRE(out.dij == doctest::Approx(0.2));
+    }
+
+    TEST_CASE("gjk sphere_sphere_3d penetration")
+    {
+        static constexpr std::size_t dim = 3;
+        sphere<dim> s1(
+            {
+                {0., 0., 0.}
+        },
+            0.2);
+        sphere<dim> s2(
+            {
+                {0.3, 0., 0.}
+        },
+            0.2);
+
+        auto out = gjk_closest_points<NoFriction>(s1, s2);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.2));
+        REQUIRE(out.pj(0) == doctest::Approx(0.1));
+        REQUIRE(out.nij(0) == doctest::Approx(-1.));
+        REQUIRE(out.dij == doctest::Approx(-0.1));
+    }
+
+    TEST_CASE("gjk segment_segment_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        segment<dim> s1({0., 0.}, {1., 0.});
+        segment<dim> s2({0.5, 0.3}, {0.5, 1.});
+
+        auto out = closest_points<NoFriction>(s1, s2);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.5));
+        REQUIRE(out.pi(1) == doctest::Approx(0.));
+        REQUIRE(out.pj(0) == doctest::Approx(0.5));
+        REQUIRE(out.pj(1) == doctest::Approx(0.3));
+        REQUIRE(out.nij(0) == doctest::Approx(0.));
+        REQUIRE(out.nij(1) == doctest::Approx(-1.));
+        REQUIRE(out.dij == doctest::Approx(0.3));
+    }
+
+    TEST_CASE("gjk segment_plane_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        segment<dim> seg({0.2, -0.5}, {0.4, 0.5});
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            0.);
+
+        auto out = closest_points<NoFriction>(seg, p);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.2));
+        REQUIRE(out.pi(1) == doctest::Approx(-0.5));
+        REQUIRE(out.pj(0) == doctest::Approx(0.));
+        REQUIRE(out.pj(1) == doctest::Approx(-0.5));
+        REQUIRE(out.nij(0) == doctest::Approx(1.));
+        REQUIRE(out.dij == doctest::Approx(0.2));
+    }
+
+    TEST_CASE("gjk superellipsoid_superellipsoid_2d")
+    {
+        static constexpr std::size_t dim = 2;
+        superellipsoid<dim> s1(
+            {
+                {-0.2, 0.}
+        },
+            {quaternion(0.)},
+            {{.1, .05}},
+            1);
+        superellipsoid<dim> s2(
+            {
+                {0.2, 0.}
+        },
+            {quaternion(0.)},
+            {{.1, .05}},
+            1);
+
+        auto out = gjk_closest_points<NoFriction>(s1, s2);
+
+        REQUIRE(out.pi(0) == doctest::Approx(-0.1));
+        REQUIRE(out.pj(0) == doctest::Approx(0.1));
+        REQUIRE(out.nij(0) == doctest::Approx(-1.));
+        REQUIRE(out.dij == doctest::Approx(0.2));
+    }
+}
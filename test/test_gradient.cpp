@@ -9,6 +9,7 @@
 
 #include <scopi/contact/contact_brute_force.hpp>
 #include <scopi/solvers/OptimGradient.hpp>
+#include <scopi/solvers/admm.hpp>
 #include <scopi/solvers/apgd.hpp>
 
 #include "analytical_solution.hpp"
@@ -281,6 +282,167 @@ namespace scopi
         REQUIRE(error_omega <= doctest::Approx(tol_analytical));
     }
 
+    TEST_CASE("sphere - plane friction fixed point admm")
+    {
+        constexpr std::size_t dim = 2;
+
+        scopi_container<dim> particles;
+
+        double radius        = 1.;
+        double g             = 1.;
+        double dt            = 0.01;
+        std::size_t total_it = 500;
+        double h             = 2. * radius;
+        double alpha         = PI / 4;
+        plane<dim> plane(
+            {
+                {0., 0.}
+        },
+            PI / 2);
+        sphere<dim> sphere(
+            {
+                {0, h}
+        },
+            radius);
+        particles.push_back(plane, property<dim>().deactivate());
+        particles.push_back(sphere,
+                            property<dim>()
+                                .mass(1)
+                                .moment_inertia(1. * radius * radius / 2.)
+                                .force({
+                                    {g * sin(alpha), -g * cos(alpha)}
+        }));
+
+        using problem_t    = FrictionFixedPoint;
+        using optim_solver = OptimGradient<admm>;
+        using vap_t        = vap_fpd;
+        ScopiSolver<dim, problem_t, optim_solver, contact_kdtree, vap_t> solver(particles);
+
+        auto params = solver.get_params();
+
+        params.optim_params.tolerance    = 1e-9;
+        params.optim_params.max_ite      = 10000;
+        params.optim_params.adaptive_rho = true;
+
+        double mu                                            = 0.5;
+        params.default_contact_property.mu                   = mu;
+        params.default_contact_property.fixed_point_tol      = 1e-6;
+        params.default_contact_property.fixed_point_max_iter = 1000;
+        solver.run(dt, total_it);
+
+        auto pos              = particles.pos();
+        auto q                = particles.q();
+        auto tmp              = analytical_solution_sphere_plane_friction(alpha, mu, dt * (total_it), radius, g, h);
+        auto pos_analytical   = tmp.first;
+        auto q_analytical     = quaternion(tmp.second);
+        double error_pos      = xt::linalg::norm(pos(1) - pos_analytical) / xt::linalg::norm(pos_analytical);
+        double error_q        = xt::linalg::norm(q(1) - q_analytical) / xt::linalg::norm(q_analytical);
+        auto v                = particles.v();
+        auto omega            = particles.omega();
+        tmp                   = analytical_solution_sphere_plane_velocity_friction(alpha, mu, dt * (total_it), radius, g, h);
+        auto v_analytical     = tmp.first;
+        auto omega_analytical = tmp.second;
+        double error_v        = xt::linalg::norm(v(1) - v_analytical) / xt::linalg::norm(v_analytical);
+        double error_omega    = std::norm(omega(1) - omega_analytical) / std::norm(omega_analytical);
+        REQUIRE(error_pos <= doctest::Approx(1e-2));
+        REQUIRE(error_q <= doctest::Approx(1e-2));
+        REQUIRE(error_v <= doctest::Approx(1e-6));
+        REQUIRE(error_omega <= doctest::Approx(1e-6));
+    }
+
+    /**
+     * Sphere on the inclined plane of "sphere - plane friction fixed point", solved by \c method_t.
+     * If \c total_it_2 is not 0, the force is reversed for \c total_it_2 more iterations, as in
+     * "sphere - plane viscous friction".
+     */
+    template <class problem_t, class method_t>
+    scopi_container<2> sphere_plane_with_method(std::size_t total_it, std::size_t total_it_2)
+    {
+        constexpr std::size_t dim = 2;
+
+        scopi_container<dim> particles;
+
+        double radius = 1.;
+        double g      = 1.;
+        double dt     = 0.01;
+        double h      = 2. * radius;
+        double alpha  = PI / 4;
+        plane<dim> plane(
+            {
+                {0., 0.}
+        },
+            PI / 2);
+        sphere<dim> sphere(
+            {
+                {0, h}
+        },
+            radius);
+        particles.push_back(plane, property<dim>().deactivate());
+        particles.push_back(sphere,
+                            property<dim>()
+                                .mass(1)
+                                .moment_inertia(1. * radius * radius / 2.)
+                                .force({
+                                    {g * sin(alpha), -g * cos(alpha)}
+        }));
+
+        using optim_solver = OptimGradient<method_t>;
+        using vap_t        = vap_fpd;
+        ScopiSolver<dim, problem_t, optim_solver, contact_kdtree, vap_t> solver(particles);
+        auto params = solver.get_params();
+
+        params.optim_params.tolerance = 1e-9;
+        params.optim_params.max_ite   = 10000;
+        if constexpr (std::is_same_v<method_t, apgd>)
+        {
+            params.optim_params.alpha           = 0.01;
+            params.optim_params.dynamic_descent = true;
+        }
+        else
+        {
+            params.optim_params.adaptive_rho = true;
+        }
+
+        params.default_contact_property.mu = 0.5;
+        if constexpr (std::is_same_v<problem_t, ViscousFriction>)
+        {
+            params.default_contact_property.fixed_point_tol      = 1e-6;
+            params.default_contact_property.fixed_point_max_iter = 1000;
+            params.default_contact_property.gamma                = 0;
+            params.default_contact_property.gamma_min            = -1.4;
+            params.default_contact_property.gamma_tol            = 1e-6;
+        }
+
+        solver.run(dt, total_it);
+        if (total_it_2 != 0)
+        {
+            particles.f()(1) = {-g * sin(alpha), g * cos(alpha)};
+            solver.run(dt, total_it_2);
+        }
+        return particles;
+    }
+
+    TEST_CASE_TEMPLATE("sphere - plane admm vs apgd", problem_t, Friction, ViscousFriction)
+    {
+        std::size_t total_it   = 500;
+        std::size_t total_it_2 = std::is_same_v<problem_t, ViscousFriction> ? 100 : 0;
+
+        auto particles_apgd = sphere_plane_with_method<problem_t, apgd>(total_it, total_it_2);
+        auto particles_admm = sphere_plane_with_method<problem_t, admm>(total_it, total_it_2);
+
+        auto pos_apgd      = particles_apgd.pos();
+        auto pos_admm      = particles_admm.pos();
+        auto v_apgd        = particles_apgd.v();
+        auto v_admm        = particles_admm.v();
+        double error_pos   = xt::linalg::norm(pos_admm(1) - pos_apgd(1)) / xt::linalg::norm(pos_apgd(1));
+        double error_v     = xt::linalg::norm(v_admm(1) - v_apgd(1)) / xt::linalg::norm(v_apgd(1));
+        double error_omega = std::abs(particles_admm.omega()(1) - particles_apgd.omega()(1));
+
+        REQUIRE(error_pos <= doctest::Approx(1e-4));
+        REQUIRE(error_v <= doctest::Approx(1e-4));
+        REQUIRE(error_omega <= doctest::Approx(1e-4));
+    }
+
     TEST_CASE("sphere - plane viscous friction")
     {
         constexpr std::size_t dim = 2;
@@ -641,4 +803,235 @@ namespace scopi
 
         CHECK(check_reference_file(path, filename, total_it, tol));
     }
+
+    TEST_CASE("islands match the monolithic solve")
+    {
+        constexpr std::size_t dim = 2;
+
+        scopi_container<dim> particles;
+
+        double radius = 0.5;
+        for (auto x : {0., 10.})
+        {
+            sphere<dim> s1(
+                {
+                    {x, 0.}
+            },
+                radius);
+            sphere<dim> s2(
+                {
+                    {x + 0.9, 0.1 * x}
+            },
+                radius);
+            particles.push_back(s1,
+                                property<dim>()
+                                    .mass(1)
+                                    .moment_inertia(0.1)
+                                    .velocity({
+                                        {1., 0.}
+            }));
+            particles.push_back(s2, property<dim>().mass(2).moment_inertia(0.1));
+        }
+        sphere<dim> s_free(
+            {
+                {20., 0.}
+        },
+            radius);
+        particles.push_back(s_free,
+                            property<dim>()
+                                .mass(1)
+                                .moment_inertia(0.1)
+                                .velocity({
+                                    {0., 1.}
+        }));
+
+        ContactsParams<contact_brute_force<Friction>> contact_params;
+        contact_brute_force<Friction> cont(contact_params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() == 2);
+
+        double dt = 0.01;
+        OptimGradient<apgd> monolithic;
+        monolithic.set_timestep(dt);
+        monolithic.use_islands(false);
+        monolithic.get_params().tolerance = 1e-10;
+        monolithic.run(particles, contacts, 0);
+
+        OptimGradient<apgd> islands;
+        islands.set_timestep(dt);
+        islands.use_islands(true);
+        islands.get_params().tolerance = 1e-10;
+        islands.run(particles, contacts, 0);
+
+        REQUIRE(xt::allclose(monolithic.get_uadapt(), islands.get_uadapt(), 1e-6, 1e-8));
+        REQUIRE(xt::allclose(monolithic.get_wadapt(), islands.get_wadapt(), 1e-6, 1e-8));
+        REQUIRE(xt::allclose(monolithic.lagrange_multiplier(), islands.lagrange_multiplier(), 1e-6, 1e-8));
+        REQUIRE(islands.get_uadapt()(4, 1) == doctest::Approx(1.));
+    }
+
+    TEST_CASE("admm state follows the islands")
+    {
+        constexpr std::size_t dim = 2;
+
+        scopi_container<dim> particles;
+
+        double radius = 0.5;
+        // two pairs of spheres: their islands have the same local contact graph
+        for (auto x : {0., 10.})
+        {
+            sphere<dim> s1(
+                {
+                    {x, 0.}
+            },
+                radius);
+            sphere<dim> s2(
+                {
+                    {x + 0.9, 0.1 * x}
+            },
+                radius);
+            particles.push_back(s1,
+                                property<dim>()
+                                    .mass(1)
+                                    .moment_inertia(0.1)
+                                    .velocity({
+                                        {1., 0.}
+            }));
+            particles.push_back(s2, property<dim>().mass(2).moment_inertia(0.1));
+        }
+
+        ContactsParams<contact_brute_force<Friction>> contact_params;
+        contact_brute_force<Friction> cont(contact_params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() == 2);
+        std::vector<neighbor<dim, Friction>> second_pair = {contacts[1]};
+        REQUIRE(second_pair[0].i == 2);
+
+        double dt        = 0.01;
+        auto make_solver = [&]()
+        {
+            OptimGradient<admm> solver;
+            solver.set_timestep(dt);
+            solver.use_islands(true);
+            return solver;
+        };
+
+        // the island of the second pair is the second island, then the first one
+        auto both = make_solver();
+        both.run(particles, contacts, 0);
+        both.run(particles, second_pair, 1);
+
+        auto alone = make_solver();
+        alone.run(particles, second_pair, 0);
+        alone.run(particles, second_pair, 1);
+
+        // the second solve starts from the state of the same island in both cases
+        REQUIRE(both.lagrange_multiplier() == alone.lagrange_multiplier());
+    }
+
+    TEST_CASE("anderson acceleration of the fixed point")
+    {
+        constexpr std::size_t dim = 2;
+
+        scopi_container<dim> particles;
+
+        double radius = 1.;
+        plane<dim> plane(
+            {
+                {0., 0.}
+        },
+            PI / 2);
+        sphere<dim> sphere(
+            {
+                {0., radius}
+        },
+            radius);
+        particles.push_back(plane, property<dim>().deactivate());
+        particles.push_back(sphere,
+                            property<dim>()
+                                .mass(1)
+                                .moment_inertia(1. * radius * radius / 2.)
+                                .velocity({
+                                    {1., -1.}
+        }));
+
+        ContactsParams<contact_brute_force<FrictionFixedPoint>> contact_params;
+        contact_brute_force<FrictionFixedPoint> cont(contact_params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() == 1);
+        contacts[0].property.mu                   = 0.5;
+        contacts[0].property.fixed_point_tol      = 1e-10;
+        contacts[0].property.fixed_point_max_iter = 1000;
+        auto contacts_anderson                    = contacts;
+
+        double dt = 0.01;
+        OptimGradient<apgd> plain;
+        plain.set_timestep(dt);
+        plain.set_anderson_depth(0);
+        plain.get_params().tolerance = 1e-12;
+        plain.extra_steps_before_solve(contacts);
+        plain.run(particles, contacts, 0);
+        plain.extra_steps_after_solve(contacts, particles);
+
+        OptimGradient<apgd> anderson;
+        anderson.set_timestep(dt);
+        anderson.set_anderson_depth(5);
+        anderson.get_params().tolerance = 1e-12;
+        anderson.extra_steps_before_solve(contacts_anderson);
+        anderson.run(particles, contacts_anderson, 0);
+        anderson.extra_steps_after_solve(contacts_anderson, particles);
+
+        REQUIRE_FALSE(anderson.should_solve());
+        REQUIRE(contacts_anderson[0].sij == doctest::Approx(contacts[0].sij).epsilon(1e-6));
+        REQUIRE(xt::allclose(plain.get_uadapt(), anderson.get_uadapt(), 1e-6, 1e-8));
+        REQUIRE(xt::allclose(plain.lagrange_multiplier(), anderson.lagrange_multiplier(), 1e-6, 1e-8));
+    }
+
+    TEST_CASE("sphere - plane sleeping")
+    {
+        constexpr std::size_t dim = 2;
+
+        scopi_container<dim> particles;
+
+        double radius = 1.;
+        double dt     = 0.01;
+        plane<dim> plane(
+            {
+                {0., 0.}
+        },
+            PI / 2);
+        sphere<dim> sphere(
+            {
+                {0., radius}
+        },
+            radius);
+        particles.push_back(plane, property<dim>().deactivate());
+        particles.push_back(sphere,
+                            property<dim>()
+                                .mass(1)
+                                .moment_inertia(1. * radius * radius / 2.)
+                                .force({
+                                    {0., -1.}
+        }));
+
+        ScopiSolver<dim, NoFriction, OptimGradient<apgd>, contact_kdtree, vap_fpd> solver(particles);
+        auto params                           = solver.get_params();
+        params.solver_params.output_frequency = std::size_t(-1);
+        params.solver_params.sleep            = true;
+        params.solver_params.sleep_steps      = 10;
+
+        solver.run(dt, 100);
+
+        // asleep: neither solved nor integrated
+        auto pos = particles.pos();
+        auto v   = particles.v();
+        REQUIRE(v(1)(0) == 0.);
+        REQUIRE(v(1)(1) == 0.);
+        REQUIRE(pos(1)(1) == doctest::Approx(radius));
+
+        // a new force wakes it up
+        particles.f()(1) = {1., -1.};
+        solver.run(dt, 200, 100);
+        REQUIRE(v(1)(0) == doctest::Approx(1.).epsilon(1e-2));
+        REQUIRE(pos(1)(1) == doctest::Approx(radius).epsilon(1e-4));
+    }
 }
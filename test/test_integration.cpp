@@ -0,0 +1,82 @@
+#include <doctest/doctest.h>
+
+#include <scopi/box.hpp>
+#include <scopi/container.hpp>
+#include <scopi/integration.hpp>
+#include <scopi/objects/types/sphere.hpp>
+#include <scopi/quaternion.hpp>
+
+#include "utils.hpp"
+
+namespace scopi
+{
+    TEST_CASE("integrate rigid bodies")
+    {
+        static constexpr std::size_t dim = 2;
+        scopi_container<dim> particles;
+
+        sphere<dim> s1(
+            {
+                {0., 0.}
+        },
+            0.1);
+        sphere<dim> s2(
+            {
+                {1., 0.}
+        },
+            0.1);
+        particles.push_back(s1, property<dim>().velocity({1., 2.}).omega(0.5));
+        particles.push_back(s2, property<dim>().velocity({1., 2.}).omega(0.5));
+
+        // the second particle is skipped, as a sleeping one
+        auto skip = [](std::size_t i)
+        {
+            return i == 1;
+        };
+        std::size_t n = particles.nb_active();
+        integrate_positions(particles.pos().data(), particles.v().data(), n, 0.1, skip);
+        integrate_orientations(particles.q().data(), particles.omega().data(), n, 0.1, skip);
+
+        REQUIRE(particles.pos()(0)(0) == doctest::Approx(0.1));
+        REQUIRE(particles.pos()(0)(1) == doctest::Approx(0.2));
+        REQUIRE(particles.pos()(1)(0) == doctest::Approx(1.));
+        REQUIRE(particles.pos()(1)(1) == doctest::Approx(0.));
+
+        auto q0 = quaternion(0.05);
+        auto q1 = quaternion(0.);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            REQUIRE(particles.q()(0)(i) == doctest::Approx(q0(i)));
+            REQUIRE(particles.q()(1)(i) == doctest::Approx(q1(i)));
+        }
+    }
+
+    TEST_CASE("periodic wrapping")
+    {
+        static constexpr std::size_t dim = 2;
+        BoxDomain<dim> box({0., 0.}, {1., 1.});
+        box.with_periodicity(0);
+
+        scopi_container<dim> particles;
+        for (double x : {1.2, 0.5, -0.1})
+        {
+            sphere<dim> s(
+                {
+                    {x, 1.5}
+            },
+                0.1);
+            particles.push_back(s);
+        }
+
+        wrap_periodic_objects(box, particles);
+
+        REQUIRE(particles.pos()(0)(0) == doctest::Approx(0.2));
+        REQUIRE(particles.pos()(1)(0) == doctest::Approx(0.5));
+        REQUIRE(particles.pos()(2)(0) == doctest::Approx(0.9));
+        // the axis y is not periodic
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            REQUIRE(particles.pos()(i)(1) == doctest::Approx(1.5));
+        }
+    }
+}
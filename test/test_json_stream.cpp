@@ -0,0 +1,79 @@
+#include <doctest/doctest.h>
+
+#include <sstream>
+
+#include <scopi/contact/contact_brute_force.hpp>
+#include <scopi/container.hpp>
+#include <scopi/json_stream.hpp>
+#include <scopi/objects/types/sphere.hpp>
+#include <scopi/solver.hpp>
+
+#include "utils.hpp"
+
+namespace scopi
+{
+    TEST_CASE("json stream")
+    {
+        static constexpr std::size_t dim = 2;
+        scopi_container<dim> particles;
+        for (std::size_t i = 0; i < 5; ++i)
+        {
+            sphere<dim> s(
+                {
+                    {0.9 * static_cast<double>(i), 0.1}
+            },
+                0.5);
+            particles.push_back(s, property<dim>().velocity({0.1, -0.2}).mass(1.).moment_inertia(0.1));
+        }
+
+        ContactsParams<contact_brute_force<NoFriction>> params;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() > 0);
+
+        auto object_json = [&](std::size_t i)
+        {
+            return output_object(particles, i);
+        };
+        auto contact_json = [&](std::size_t ic)
+        {
+            return contacts[ic].to_json();
+        };
+
+        nl::json json_output;
+        json_output["objects"] = {};
+        for (std::size_t i = 0; i < particles.size(); ++i)
+        {
+            json_output["objects"].push_back(object_json(i));
+        }
+        json_output["contacts"] = {};
+        for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+        {
+            json_output["contacts"].push_back(contact_json(ic));
+        }
+
+        SUBCASE("json")
+        {
+            // blocks smaller than the arrays
+            std::ostringstream out;
+            write_json_stream(out, particles.size(), object_json, contacts.size(), contact_json, 2);
+            REQUIRE(out.str() == json_output.dump());
+        }
+
+        SUBCASE("bson")
+        {
+            std::ostringstream out(std::ios::out | std::ios::binary);
+            write_bson_stream(out, particles.size(), object_json, contacts.size(), contact_json, 2);
+            auto bson = nl::json::to_bson(json_output);
+            REQUIRE(out.str() == std::string(bson.begin(), bson.end()));
+        }
+
+        SUBCASE("no contact")
+        {
+            std::ostringstream out;
+            write_json_stream(out, particles.size(), object_json, 0, contact_json);
+            json_output["contacts"] = {};
+            REQUIRE(out.str() == json_output.dump());
+        }
+    }
+}
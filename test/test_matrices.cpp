@@ -8,6 +8,7 @@
 #include <scopi/contact/contact_brute_force.hpp>
 #include <scopi/container.hpp>
 #include <scopi/matrix/velocities.hpp>
+#include <scopi/objects/contact_storage.hpp>
 #include <scopi/objects/types/sphere.hpp>
 
 #include "utils.hpp"
@@ -46,6 +47,40 @@ namespace scopi
         REQUIRE(xt::linalg::dot(a.mat_mult(u), f)[0] == doctest::Approx(xt::linalg::dot(u, at.mat_mult(f))[0]));
     }
 
+    TEST_CASE("Matrix A 2D")
+    {
+        static constexpr std::size_t dim = 2;
+        scopi_container<dim> particles;
+
+        sphere<dim> s1(
+            {
+                {0., 0.}
+        },
+            0.1);
+        sphere<dim> s2(
+            {
+                {1., 1.}
+        },
+            0.2);
+
+        particles.push_back(s1, scopi::property<dim>().mass(1).moment_inertia(0.1));
+        particles.push_back(s2, scopi::property<dim>().mass(1).moment_inertia(0.1));
+
+        ContactsParams<contact_brute_force<NoFriction>> params;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, 0);
+
+        AMatrix a(contacts, particles);
+        ATMatrix at(contacts, particles);
+
+        // vx, vy and omega per particle, 2 rows per contact
+        xt::xtensor<double, 1> u = xt::random::rand<double>({3 * particles.nb_active()});
+        xt::xtensor<double, 1> f = xt::random::rand<double>({2 * contacts.size()});
+
+        REQUIRE(a.mat_mult(u).size() == 2 * contacts.size());
+        REQUIRE(xt::linalg::dot(a.mat_mult(u), f)[0] == doctest::Approx(xt::linalg::dot(u, at.mat_mult(f))[0]));
+    }
+
     TEST_CASE("Matrix A case 2")
     {
         static constexpr std::size_t dim = 2;
@@ -70,10 +105,51 @@ namespace scopi
         auto contacts = cont.run(particles, 0);
 
         AMatrix a(contacts, particles);
-        xt::xtensor<double, 1> u{0.187562190766376, -1.184390935327111, 0., 0., 0., -0.00453709103433};
+        xt::xtensor<double, 1> u{0.187562190766376, -1.184390935327111, -0.00453709103433};
         auto sol = a.mat_mult(u);
         REQUIRE(sol[0] == doctest::Approx(-0.18595809));
         REQUIRE(sol[1] == doctest::Approx(1.18278683));
     }
 
+    TEST_CASE("Matrix A with contact storage")
+    {
+        static constexpr std::size_t dim = 3;
+        scopi_container<dim> particles;
+
+        sphere<dim> s1(
+            {
+                {0., 0., 0.}
+        },
+            0.5);
+        sphere<dim> s2(
+            {
+                {0.9, 0.2, 0.1}
+        },
+            0.5);
+
+        particles.push_back(s1, scopi::property<dim>().mass(1).moment_inertia(0.1));
+        particles.push_back(s2, scopi::property<dim>().mass(1).moment_inertia(0.1));
+
+        ContactsParams<contact_brute_force<Friction>> params;
+        contact_brute_force<Friction> cont(params);
+        auto contacts = cont.run(particles, 0);
+        contact_storage<dim, Friction> storage(contacts);
+        REQUIRE(storage.size() == contacts.size());
+        REQUIRE(contact_i(storage, 0) == contacts[0].i);
+        REQUIRE(contact_j(storage, 0) == contacts[0].j);
+        REQUIRE(property_of(storage, 0).mu == contacts[0].property.mu);
+        REQUIRE(xt::allclose(contact_nij(storage, 0), contacts[0].nij));
+
+        AMatrix a(contacts, particles);
+        AMatrix a_storage(storage, particles);
+        ATMatrix at(contacts, particles);
+        ATMatrix at_storage(storage, particles);
+
+        xt::xtensor<double, 1> u = xt::random::rand<double>({6 * particles.nb_active()});
+        xt::xtensor<double, 1> f = xt::random::rand<double>({3 * contacts.size()});
+
+        REQUIRE(xt::allclose(a.mat_mult(u), a_storage.mat_mult(u)));
+        REQUIRE(xt::allclose(at.mat_mult(f), at_storage.mat_mult(f)));
+    }
+
 } // namespace scopi
@@ -0,0 +1,150 @@
+#include "utils.hpp"
+#include <doctest/doctest.h>
+
+#include <cstdio>
+#include <fstream>
+
+#include <scopi/contact/contact_brute_force.hpp>
+#include <scopi/contact/property.hpp>
+#include <scopi/container.hpp>
+#include <scopi/objects/methods/mesh_contacts.hpp>
+#include <scopi/objects/types/mesh.hpp>
+#include <scopi/objects/types/sphere.hpp>
+
+namespace scopi
+{
+    // floor z = 0 made of n x n unit squares, each of them split in two triangles along its diagonal
+    auto floor_mesh(std::size_t n)
+    {
+        std::vector<small::vec<3>> vertices;
+        std::vector<mesh_data<3>::primitive_type> triangles;
+        for (std::size_t i = 0; i <= n; ++i)
+        {
+            for (std::size_t j = 0; j <= n; ++j)
+            {
+                vertices.push_back({
+                    {static_cast<double>(i), static_cast<double>(j), 0.}
+                });
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < n; ++j)
+            {
+                std::size_t v = i * (n + 1) + j;
+                triangles.push_back({v, v + n + 1, v + n + 2});
+                triangles.push_back({v, v + n + 2, v + 1});
+            }
+        }
+        return std::make_shared<const mesh_data<3>>(std::move(vertices), std::move(triangles));
+    }
+
+    TEST_CASE("mesh close primitives")
+    {
+        auto data = floor_mesh(10);
+        REQUIRE(data->size() == 200);
+
+        std::vector<std::size_t> found;
+        data->for_each_close_primitive({
+                                           {4.5, 4.5, 0.2}
+        },
+                                       0.3,
+                                       [&](std::size_t p)
+                                       {
+                                           found.push_back(p);
+                                       });
+
+        // the primitives of the square containing the point must be found, far primitives must not
+        REQUIRE(found.size() < 20);
+        std::size_t square = 4 * 10 + 4;
+        REQUIRE(std::find(found.begin(), found.end(), 2 * square) != found.end());
+        REQUIRE(std::find(found.begin(), found.end(), 2 * square + 1) != found.end());
+    }
+
+    TEST_CASE("sphere mesh contact")
+    {
+        static constexpr std::size_t dim = 3;
+        mesh<dim> m(
+            {
+                {0., 0., 0.}
+        },
+            floor_mesh(4));
+        // above the diagonal of a square: both triangles give the same contact
+        sphere<dim> s(
+            {
+                {1.3, 1.3, 0.15}
+        },
+            0.1);
+
+        scopi_container<dim> particles;
+        particles.push_back(m, property<dim>().deactivate());
+        particles.push_back(s, property<dim>().mass(1.).moment_inertia(0.1));
+
+        ContactsParams<contact_brute_force<NoFriction>> params;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, particles.nb_inactive());
+
+        REQUIRE(contacts.size() == 1);
+        REQUIRE(contacts[0].i == 0);
+        REQUIRE(contacts[0].j == 1);
+        REQUIRE(contacts[0].dij == doctest::Approx(0.05));
+        REQUIRE(contacts[0].pi(0) == doctest::Approx(1.3));
+        REQUIRE(contacts[0].pi(1) == doctest::Approx(1.3));
+        REQUIRE(contacts[0].pi(2) == doctest::Approx(0.));
+        REQUIRE(contacts[0].pj(2) == doctest::Approx(0.05));
+        REQUIRE(contacts[0].nij(0) == doctest::Approx(0.));
+        REQUIRE(contacts[0].nij(1) == doctest::Approx(0.));
+        REQUIRE(contacts[0].nij(2) == doctest::Approx(-1.));
+    }
+
+    TEST_CASE("sphere mesh_2d corner")
+    {
+        static constexpr std::size_t dim = 2;
+        auto data = std::make_shared<const mesh_data<dim>>(std::vector<small::vec<dim>>{{{0., 1.}}, {{0., 0.}}, {{1., 0.}}},
+                                                           std::vector<mesh_data<dim>::primitive_type>{{0, 1}, {1, 2}});
+        mesh<dim> m(
+            {
+                {0., 0.}
+        },
+            data);
+        sphere<dim> s(
+            {
+                {0.15, 0.15}
+        },
+            0.1);
+
+        auto contacts = mesh_closest_points<NoFriction>(s, m, 0.1);
+
+        // one contact with each wall
+        REQUIRE(contacts.size() == 2);
+        for (const auto& c : contacts)
+        {
+            REQUIRE(c.dij == doctest::Approx(0.05));
+            REQUIRE(std::min(c.pj(0), c.pj(1)) == doctest::Approx(0.));
+            REQUIRE(std::max(c.pj(0), c.pj(1)) == doctest::Approx(0.15));
+        }
+    }
+
+    TEST_CASE("mesh load_obj")
+    {
+        std::string filename = "test_mesh_square.obj";
+        {
+            std::ofstream file(filename);
+            file << "# unit square\n";
+            file << "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\n";
+            file << "f 1/1/1 2/2/1 3/3/1 4/4/1\n";
+        }
+
+        auto data = load_obj<3>(filename);
+        std::remove(filename.c_str());
+
+        REQUIRE(data->size() == 2);
+        REQUIRE(data->vertices().size() == 4);
+        REQUIRE(data->source() == filename);
+        auto t = data->primitive(1);
+        REQUIRE(t[2][0] == doctest::Approx(0.));
+        REQUIRE(t[2][1] == doctest::Approx(1.));
+
+        CHECK_THROWS_AS(load_obj<3>("does_not_exist.obj"), std::runtime_error);
+    }
+}
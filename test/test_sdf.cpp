@@ -0,0 +1,178 @@
+#include "utils.hpp"
+#include <doctest/doctest.h>
+
+#include <scopi/container.hpp>
+#include <scopi/contact/property.hpp>
+#include <scopi/objects/methods/closest_points.hpp>
+#include <scopi/objects/types/capsule.hpp>
+#include <scopi/objects/types/plane.hpp>
+#include <scopi/objects/types/sdf.hpp>
+#include <scopi/objects/types/sphere.hpp>
+
+namespace scopi
+{
+    // disk of radius 0.5 centered at the origin of the frame
+    template <std::size_t dim>
+    auto disk_grid(sdf_interpolation interpolation = sdf_interpolation::cubic)
+    {
+        small::vec<dim> lower;
+        small::vec<dim> upper;
+        for (std::size_t d = 0; d < dim; ++d)
+        {
+            lower[d] = -1.;
+            upper[d] = 1.;
+        }
+        return make_sdf_grid<dim>(
+            [](const small::vec<dim>& p)
+            {
+                return small::norm(p) - 0.5;
+            },
+            lower,
+            upper,
+            0.05,
+            interpolation);
+    }
+
+    TEST_CASE("sdf grid")
+    {
+        for (auto interpolation : {sdf_interpolation::linear, sdf_interpolation::cubic})
+        {
+            auto grid = disk_grid<2>(interpolation);
+
+            small::vec<2> p{
+                {0.23, -0.31}
+            };
+            small::vec<2> gradient;
+            double value = grid->value(p, gradient);
+            REQUIRE(value == doctest::Approx(small::norm(p) - 0.5).epsilon(1e-2));
+            REQUIRE(gradient[0] == doctest::Approx(p[0] / small::norm(p)).epsilon(5e-2));
+            REQUIRE(gradient[1] == doctest::Approx(p[1] / small::norm(p)).epsilon(5e-2));
+
+            // outside the grid
+            REQUIRE(grid->value({
+                        {1.5, 0.}
+            })
+                    == doctest::Approx(1.));
+
+            REQUIRE(!grid->surface_points().empty());
+            for (const auto& s : grid->surface_points())
+            {
+                REQUIRE(small::norm(s) == doctest::Approx(0.5).epsilon(1e-2));
+            }
+            REQUIRE(grid->bounding_radius() >= 0.5);
+            REQUIRE(grid->bounding_radius() <= 0.5 + 2. * 0.05);
+        }
+    }
+
+    TEST_CASE("sdf shared grid")
+    {
+        static constexpr std::size_t dim = 2;
+        sdf<dim> f1(
+            {
+                {0., 0.}
+        },
+            disk_grid<dim>());
+        sdf<dim> f2(
+            {
+                {2., 0.}
+        },
+            disk_grid<dim>());
+        REQUIRE(f1.hash() == f2.hash());
+
+        scopi_container<dim> particles;
+        particles.push_back(f1, property<dim>().mass(1.).moment_inertia(0.1));
+        particles.push_back(f2, property<dim>().mass(1.).moment_inertia(0.1));
+        REQUIRE(&dynamic_cast<const sdf<dim, false>&>(*particles[0]).grid() == &dynamic_cast<const sdf<dim, false>&>(*particles[1]).grid());
+    }
+
+    TEST_CASE("sphere sdf")
+    {
+        static constexpr std::size_t dim = 2;
+        sphere<dim> s(
+            {
+                {0.7, 0.}
+        },
+            0.1);
+        sdf<dim> f(
+            {
+                {0., 0.}
+        },
+            disk_grid<dim>());
+
+        auto out = closest_points_dispatcher<NoFriction, dim>::dispatch(s, f);
+
+        REQUIRE(out.pi(0) == doctest::Approx(0.6));
+        REQUIRE(out.pi(1) == doctest::Approx(0.));
+        REQUIRE(out.pj(0) == doctest::Approx(0.5));
+        REQUIRE(out.pj(1) == doctest::Approx(0.));
+        REQUIRE(out.nij(0) == doctest::Approx(1.));
+        REQUIRE(out.nij(1) == doctest::Approx(0.));
+        REQUIRE(out.dij == doctest::Approx(0.1));
+    }
+
+    TEST_CASE("sdf plane")
+    {
+        static constexpr std::size_t dim = 2;
+        sdf<dim> f(
+            {
+                {0., 0.6}
+        },
+            disk_grid<dim>());
+        plane<dim> p(
+            {
+                {0., 0.}
+        },
+            PI / 2.);
+
+        auto out = closest_points_dispatcher<NoFriction, dim>::dispatch(f, p);
+
+        REQUIRE(out.dij == doctest::Approx(0.1).epsilon(5e-2));
+        REQUIRE(out.pj(1) == doctest::Approx(0.));
+        REQUIRE(out.nij(0) == doctest::Approx(0.));
+        REQUIRE(out.nij(1) == doctest::Approx(1.));
+    }
+
+    TEST_CASE("sdf sdf")
+    {
+        static constexpr std::size_t dim = 2;
+        sdf<dim> f1(
+            {
+                {0., 0.}
+        },
+            disk_grid<dim>());
+        sdf<dim> f2(
+            {
+                {1.1, 0.}
+        },
+            {quaternion(PI / 3.)},
+            disk_grid<dim>());
+
+        auto out = closest_points_dispatcher<NoFriction, dim>::dispatch(f1, f2);
+
+        REQUIRE(out.dij == doctest::Approx(0.1).epsilon(5e-2));
+        REQUIRE(out.nij(0) == doctest::Approx(-1.).epsilon(5e-2));
+        REQUIRE(out.pi(0) == doctest::Approx(0.5).epsilon(1e-2));
+        REQUIRE(out.pj(0) == doctest::Approx(0.6).epsilon(1e-2));
+    }
+
+    TEST_CASE("sdf capsule")
+    {
+        static constexpr std::size_t dim = 2;
+        sdf<dim> f(
+            {
+                {0., 0.}
+        },
+            disk_grid<dim>());
+        capsule<dim> c(
+            {
+                {0., 0.8}
+        },
+            0.1,
+            0.4);
+
+        auto out = closest_points_dispatcher<NoFriction, dim>::dispatch(f, c);
+
+        REQUIRE(out.dij == doctest::Approx(0.2).epsilon(5e-2));
+        REQUIRE(out.nij(1) == doctest::Approx(-1.).epsilon(5e-2));
+    }
+}
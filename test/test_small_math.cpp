@@ -0,0 +1,90 @@
+#include <doctest/doctest.h>
+#include <scopi/quaternion.hpp>
+#include <scopi/small_math.hpp>
+#include <xtensor-blas/xlinalg.hpp>
+
+#include "utils.hpp"
+
+namespace scopi
+{
+    TEST_CASE("small solve 2x2")
+    {
+        constexpr small::mat<2> a = {
+            {{4., 1.}, {2., 3.}}
+        };
+        constexpr small::vec<2> b = {
+            {1., 2.}
+        };
+        constexpr auto x = small::solve(a, b);
+        static_assert(x[0] == 0.1 && x[1] == 0.6);
+        REQUIRE(x[0] == doctest::Approx(0.1));
+        REQUIRE(x[1] == doctest::Approx(0.6));
+    }
+
+    TEST_CASE("small solve 4x4")
+    {
+        // the first pivot is zero
+        xt::xtensor_fixed<double, xt::xshape<4, 4>> a = {
+            {0., 1., 0., 1.},
+            {2., 5., 1., 0.},
+            {0., 1., 6., 2.},
+            {1., 0., 2., 7.}
+        };
+        xt::xtensor_fixed<double, xt::xshape<4>> b = {1., 2., 3., 4.};
+
+        auto x         = small::solve(small::to_mat<4>(a), small::to_vec<4>(b));
+        auto reference = xt::eval(xt::linalg::solve(a, b));
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            REQUIRE(x[i] == doctest::Approx(reference(i)));
+        }
+    }
+
+    TEST_CASE("small rotation matrix")
+    {
+        auto q = quaternion(PI / 3., xt::xtensor_fixed<double, xt::xshape<3>>{1., 2., 3.});
+        auto r = small::rotation_matrix<3>(small::to_quat(q));
+        auto x = xt::xtensor_fixed<double, xt::xshape<3>>{1., -1., 0.5};
+
+        auto rx        = r * small::to_vec<3>(x);
+        auto reference = xt::eval(xt::linalg::dot(rotation_matrix<3>(q), x));
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            REQUIRE(rx[i] == doctest::Approx(reference(i)));
+        }
+        REQUIRE(small::norm(rx) == doctest::Approx(xt::linalg::norm(x)));
+    }
+
+    TEST_CASE("small quaternion product")
+    {
+        auto q1 = quaternion(PI / 3., xt::xtensor_fixed<double, xt::xshape<3>>{1., 2., 3.});
+        auto q2 = quaternion(PI / 5., xt::xtensor_fixed<double, xt::xshape<3>>{-1., 0.5, 2.});
+
+        auto q         = small::to_quat(q1) * small::to_quat(q2);
+        auto reference = mult_quaternion(q1, q2);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            REQUIRE(q[i] == doctest::Approx(reference(i)));
+        }
+    }
+
+    TEST_CASE("small exponential map")
+    {
+        // a rotation of angle 0.35 around z in 100 steps
+        small::quat q = {
+            {1., 0., 0., 0.}
+        };
+        small::vec<3> w = {
+            {0., 0., 0.7}
+        };
+        for (std::size_t n = 0; n < 100; ++n)
+        {
+            q = small::normalized(q * small::exp_map(w, 0.005));
+        }
+        auto reference = quaternion(0.35);
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            REQUIRE(q[i] == doctest::Approx(reference(i)));
+        }
+    }
+}
@@ -0,0 +1,93 @@
+#include <doctest/doctest.h>
+
+#include <filesystem>
+
+#include <xtensor/xbuilder.hpp>
+#include <xtensor/xtensor.hpp>
+
+#include <scopi/contact/contact_brute_force.hpp>
+#include <scopi/container.hpp>
+#include <scopi/objects/types/sphere.hpp>
+#include <scopi/snapshot.hpp>
+
+#include "utils.hpp"
+
+namespace scopi
+{
+    TEST_CASE("snapshot round trip")
+    {
+        static constexpr std::size_t dim = 2;
+        scopi_container<dim> particles;
+
+        sphere<dim> s1(
+            {
+                {0., 0.}
+        },
+            0.5);
+        sphere<dim> s2(
+            {
+                {0.9, 0.2}
+        },
+            0.5);
+        sphere<dim> s3(
+            {
+                {3., 0.}
+        },
+            0.5);
+
+        particles.push_back(s1, property<dim>().velocity({1., 2.}).omega(0.5));
+        particles.push_back(s2, property<dim>().velocity({-1., 0.}));
+        particles.push_back(s3);
+
+        ContactsParams<contact_brute_force<NoFriction>> params;
+        contact_brute_force cont(params);
+        auto contacts = cont.run(particles, 0);
+        REQUIRE(contacts.size() > 0);
+
+        xt::xtensor<double, 1> lambda = xt::arange<double>(dim * contacts.size());
+
+        auto filename = (std::filesystem::temp_directory_path() / "scopi_test_snapshot.scopi").string();
+        write_snapshot(filename, particles, contacts, lambda, 12);
+
+        {
+            snapshot_reader reader(filename);
+            REQUIRE(reader.header().dim == dim);
+            REQUIRE(reader.header().iteration == 12);
+            REQUIRE(reader.header().nb_particles == 3);
+            REQUIRE(reader.header().nb_contacts == contacts.size());
+
+            auto pos = reader.field<double>("position");
+            auto v   = reader.field<double>("velocity");
+            auto w   = reader.field<double>("omega");
+            REQUIRE(pos.size() == 3);
+            REQUIRE(pos.components == dim);
+            REQUIRE(pos(1, 0) == 0.9);
+            REQUIRE(pos(1, 1) == 0.2);
+            REQUIRE(v(0, 1) == 2.);
+            REQUIRE(w(0) == 0.5);
+
+            // the three spheres have the same shape
+            auto shape_id = reader.field<std::uint64_t>("shape_id");
+            auto shapes   = reader.shapes();
+            REQUIRE(shapes.size() == 1);
+            REQUIRE(shapes[std::to_string(shape_id(2))]["radius"] == 0.5);
+            REQUIRE(reader.field<std::uint64_t>("object_offset")(3) == 3);
+
+            auto i           = reader.field<std::uint64_t>("contact_i");
+            auto j           = reader.field<std::uint64_t>("contact_j");
+            auto dij         = reader.field<double>("contact_distance");
+            auto lambda_read = reader.field<double>("contact_lambda");
+            for (std::size_t ic = 0; ic < contacts.size(); ++ic)
+            {
+                REQUIRE(i(ic) == contacts[ic].i);
+                REQUIRE(j(ic) == contacts[ic].j);
+                REQUIRE(dij(ic) == contacts[ic].dij);
+                REQUIRE(lambda_read(ic, 1) == lambda(dim * ic + 1));
+            }
+
+            REQUIRE_THROWS(reader.field<std::uint64_t>("position"));
+            REQUIRE_FALSE(reader.has_field("force"));
+        }
+        std::filesystem::remove(filename);
+    }
+}
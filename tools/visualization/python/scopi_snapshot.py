@@ -0,0 +1,43 @@
+import json
+import mmap
+import struct
+
+import numpy as np
+
+# layout of include/scopi/snapshot.hpp
+HEADER = struct.Struct("=8sIIQQQQQQ")
+FIELD = struct.Struct("=32sIIQQQ")
+MAGIC = b"SCOPISNP"
+BOM = 0x0102030405060708
+TYPES = {0: np.float64, 1: np.uint64, 2: np.uint8}
+
+
+class Snapshot:
+    """Memory-mapped reader of a snapshot written by scopi::write_snapshot.
+
+    The fields are numpy arrays which view the file without copy.
+    """
+
+    def __init__(self, filename):
+        with open(filename, "rb") as f:
+            self.buffer = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        (magic, version, self.dim, bom, self.iteration, self.nb_particles,
+         self.nb_objects, self.nb_contacts, nb_fields) = HEADER.unpack_from(self.buffer, 0)
+        if magic != MAGIC:
+            raise ValueError(filename + " is not a snapshot")
+        if version != 1 or bom != BOM:
+            raise ValueError(filename + " has an unsupported version or byte order")
+
+        self.fields = {}
+        for k in range(nb_fields):
+            name, kind, components, count, offset, _ = FIELD.unpack_from(self.buffer, HEADER.size + k*FIELD.size)
+            array = np.frombuffer(self.buffer, dtype=TYPES[kind], count=count*components, offset=offset)
+            self.fields[name.rstrip(b"\0").decode()] = array.reshape((count, components)) if components > 1 else array
+
+    def __getitem__(self, name):
+        return self.fields[name]
+
+    def shapes(self):
+        """Description of the shapes, indexed by the hash stored in the field shape_id."""
+        return json.loads(self.fields["shapes"].tobytes())